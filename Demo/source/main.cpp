@@ -1,20 +1,49 @@
 #include <Windows.h>
 #include <Core.h>
-#include <thread>
 
 #include <Memory/StackAllocator.h>
+#include <Memory/PerThreadStackAllocator.h>
 #include <Utils/Timer.h>
+#include <Utils/FramePacer.h>
+#include <Utils/FramePipeline.h>
 #include <Utils/Defer.h>
+#include <Utils/XXHash64.h>
+#include <Profiling/Profiler.h>
+#include <Profiling/FrameStats.h>
+#include <Logging/Logger.h>
+#include <Jobs/JobSystem.h>
+#include <Jobs/TaskGraph.h>
 #include <Window/Window.h>
 
 // Rendergraph
 #include <Renderer/Renderers/DX12/RendererDX12.h>
+#include <Renderer/Renderers/Null/RendererNull.h>
+#include <Renderer/RenderSnapshot.h>
+#include <Renderer/DrawList.h>
+#include <Renderer/CommandBundle.h>
+#include <Renderer/CommandReplay.h>
+
+#include <thread>
 
 #include "Camera.h"
 
 const u32 MAIN_RENDER_LAYER = "MainLayer"_h; // _h will compiletime hash the string into a u32
 const size_t FRAME_ALLOCATOR_SIZE = 8 * 1024 * 1024; // 8 MB
+const size_t RENDER_GRAPH_ALLOCATOR_SIZE = 1 * 1024 * 1024; // 1 MB, holds the RenderGraph's passes for as long as the application runs
+const size_t THREAD_FRAME_ALLOCATOR_SIZE = 2 * 1024 * 1024; // 2 MB per thread, used for recording RenderPasses in parallel
 const u8 TARGET_UPDATE_RATE = 60;
+const u32 FRAME_STATS_CSV_INTERVAL = 600; // Write a frame stats summary every 10 seconds at our target update rate
+const u32 MAX_INSTANCES = 4096; // Instances the depth prepass can draw per frame
+const u32 NUM_VIEWS = 1; // Views both passes render, only the camera's for now
+const f32 CAMERA_NEAR_CLIP = 0.1f;
+const f32 CAMERA_FAR_CLIP = 10.0f; // Also what draws normalize their sort depth by, so the whole visible range gets the depth key's precision
+const bool PIPELINED_RENDERING = true; // Simulate frame N+1 on the main thread while a render thread records and presents frame N
+const u32 PIPELINE_LATENCY = 1; // How many frames the simulation is allowed to run ahead of rendering
+const f32 ASYNC_LOAD_BUDGET_MS = 2.0f; // How much of every rendered frame can go to creating resources that finished loading
+const u64 CAPTURE_FRAME = 0; // Set to a rendered frame, like 600, to capture its command lists and replay them REPLAY_ITERATIONS times at exit. 0 turns capturing off
+const char* const CAPTURE_PATH = "frame.ncap";
+const u32 REPLAY_ITERATIONS = 100;
+const bool NULL_RENDERER = false; // Render headless with RendererNull, nothing reaches a GPU but every command still gets counted and validated
 
 INT WinMain(HINSTANCE hInstance, HINSTANCE /*hPrevInstance*/,
     PSTR /*lpCmdLine*/, INT nCmdShow)
@@ -24,12 +53,32 @@ INT WinMain(HINSTANCE hInstance, HINSTANCE /*hPrevInstance*/,
     _CrtSetDbgFlag(_CRTDBG_ALLOC_MEM_DF | _CRTDBG_LEAK_CHECK_DF);
 #endif
 
+    Logging::LoggerDesc loggerDesc;
+    loggerDesc.filePath = "log.txt";
+    Logging::Logger::Init(loggerDesc);
+
+    Profiling::Profiler::SetThreadName("Main");
+    Profiling::FrameStats::SetCSVOutput("framestats.csv", FRAME_STATS_CSV_INTERVAL);
+
+    Jobs::JobSystemDesc jobSystemDesc; // Defaults to one worker per core
+    Jobs::JobSystem::Init(jobSystemDesc);
+
     const int width = 1280;
     const int height = 720;
 
     Window mainWindow(hInstance, nCmdShow, Vector2(width, height));
 
-    Renderer::Renderer* renderer = new Renderer::RendererDX12();
+    Renderer::Renderer* renderer = nullptr;
+    Renderer::RendererNull* nullRenderer = nullptr;
+    if constexpr (NULL_RENDERER)
+    {
+        nullRenderer = new Renderer::RendererNull();
+        renderer = nullRenderer;
+    }
+    else
+    {
+        renderer = new Renderer::RendererDX12();
+    }
     renderer->InitWindow(&mainWindow);
 
     Camera camera(Vector3(0,0,10));
@@ -49,10 +98,6 @@ INT WinMain(HINSTANCE hInstance, HINSTANCE /*hPrevInstance*/,
     mainDepthDesc.format = Renderer::DEPTH_IMAGE_FORMAT_D32_FLOAT;
     mainDepthDesc.sampleCount = Renderer::SAMPLE_COUNT_1;
 
-    Renderer::DepthImageID mainDepth = renderer->CreateDepthImage(mainDepthDesc);
-
-    Renderer::RenderLayer& mainLayer = renderer->GetRenderLayer(MAIN_RENDER_LAYER);
-
     Renderer::MaterialDesc cubeMaterialDesc;
     cubeMaterialDesc.path = "Data/materials/DebugBasicPBS.material";
     Renderer::MaterialID cubeMaterial = renderer->LoadMaterial(cubeMaterialDesc);
@@ -60,7 +105,7 @@ INT WinMain(HINSTANCE hInstance, HINSTANCE /*hPrevInstance*/,
     Renderer::ModelDesc cubeModelDesc;
     cubeModelDesc.path = "Data/models/cube.model";
 
-    Renderer::ModelID cubeModel = renderer->LoadModel(cubeModelDesc);
+    Renderer::AsyncHandle<Renderer::ModelID> cubeModel = renderer->LoadModelAsync(cubeModelDesc); // The cube pops in once it's loaded
     Renderer::InstanceData cubeInstance(renderer);
     cubeInstance.position = Vector3(0, 1, 0);
     //cubeInstance.rotation = Vector3(45, 45, 0);
@@ -76,6 +121,15 @@ INT WinMain(HINSTANCE hInstance, HINSTANCE /*hPrevInstance*/,
     groundInstance.rotation = Vector3(270, 0, 0);
     groundInstance.scale = Vector3(10, 10, 1);
 
+    // The ground never moves, so instead of going through the snapshot every frame both passes record its draws once into bundles and execute those.
+    // Constant and instance buffers are per frame index, so there's a bundle per frame index and the ground only gets applied again for one when it changed.
+    // Views record in parallel and bind their own constant buffer, so every view has its own bundles too instead of recording over one another's
+    Renderer::InstanceBuffer groundInstanceBuffer = renderer->CreateInstanceBuffer(1);
+    Renderer::InstanceRange groundInstances[2]; // Where each frame index wrote the ground's instance, gpuResource is null until it has
+    u64 groundTransforms[2] = {}; // The transform hash each frame index applied
+    Renderer::CommandBundle groundDepthBundles[NUM_VIEWS][2] = { { renderer, renderer } };
+    Renderer::CommandBundle groundMainBundles[NUM_VIEWS][2] = { { renderer, renderer } };
+
     // ViewConstantBuffer will be a constant buffer which holds information about our Camera, like our View and Projection matrices
     struct ViewConstantBuffer
     {
@@ -86,14 +140,15 @@ INT WinMain(HINSTANCE hInstance, HINSTANCE /*hPrevInstance*/,
     };
 
     Renderer::ConstantBuffer<ViewConstantBuffer> viewConstantBuffer = renderer->CreateConstantBuffer<ViewConstantBuffer>();
+    Renderer::InstanceBuffer instanceBuffer = renderer->CreateInstanceBuffer(MAX_INSTANCES);
 
     // Set viewConstantBuffer
     {
         Matrix& projMatrix = viewConstantBuffer.resource.projMatrix;
 
         const f32 fov = (68.0f) / 2.0f;
-        const f32 nearClip = 0.1f;
-        const f32 farClip = 10.0f;
+        const f32 nearClip = CAMERA_NEAR_CLIP;
+        const f32 farClip = CAMERA_FAR_CLIP;
         f32 aspectRatio = static_cast<f32>(width) / static_cast<f32>(height);
 
         f32 tanFov = Math::Tan(Math::DegToRad(fov));
@@ -112,239 +167,459 @@ INT WinMain(HINSTANCE hInstance, HINSTANCE /*hPrevInstance*/,
     Memory::StackAllocator frameAllocator(FRAME_ALLOCATOR_SIZE);
     frameAllocator.Init();
 
+    Memory::StackAllocator renderGraphAllocator(RENDER_GRAPH_ALLOCATOR_SIZE);
+    renderGraphAllocator.Init();
+
+    Memory::PerThreadStackAllocator threadFrameAllocator(THREAD_FRAME_ALLOCATOR_SIZE, "ThreadFrameAllocator");
+    threadFrameAllocator.Init();
+
     Timer timer;
-    f32 targetDelta = 1.0f / TARGET_UPDATE_RATE;
-    u32 frameIndex = 0;
-    while (true)
+    FramePacer framePacer(TARGET_UPDATE_RATE);
+    f32 deltaTime = 0.0f;
+    u32 frameIndex = 0; // Only touched by the render side
+
+    // What the simulation hands over to the render side every frame
+    struct FrameSnapshot
     {
-        f32 deltaTime = timer.GetDeltaTime();
-        timer.Tick();
+        Renderer::RenderSnapshot renderSnapshot;
+        Matrix viewMatrix;
+    };
+    FramePipeline<FrameSnapshot> framePipeline(PIPELINE_LATENCY);
 
-        frameAllocator.Reset(); // Reset the frame allocator at the start of every frame
+    FrameSnapshot* simulationSnapshot = nullptr; // The snapshot the simulation graph is filling in
+    FrameSnapshot* renderSnapshot = nullptr; // The snapshot the render graph is drawing
 
-        if (mainWindow.WantsToExit())
+    // The per-frame work, ordered by what each task reads and writes so independent tasks can run at the same time
+    Jobs::TaskGraph simulationGraph;
+    simulationGraph.AddTask("Camera", [&]()
+    {
+        camera.Update(deltaTime);
+        simulationSnapshot->viewMatrix = camera.GetViewMatrix();
+    }).Writes("Camera");
+
+    simulationGraph.AddTask("Register Models", [&]()
+    {
+        // The snapshot copies the instances, so the simulation is free to move them again next frame while this one renders
+        if (cubeModel.IsReady())
         {
-            mainWindow.ConfirmExit();
-            break;
+            simulationSnapshot->renderSnapshot.RegisterModel(MAIN_RENDER_LAYER, cubeMaterial, cubeModel.Get(), cubeInstance);
         }
-        mainWindow.Update(deltaTime);
+    }).Writes("MainLayer");
 
-        // Lets update our camera and the view constantbuffer
-        camera.Update(deltaTime);
-        viewConstantBuffer.resource.viewMatrix = camera.GetViewMatrix().Transposed();
-        viewConstantBuffer.Apply(frameIndex);
+    simulationGraph.Compile();
 
-        // Register models to be rendered
-        mainLayer.RegisterModel(cubeMaterial, cubeModel, &cubeInstance);
-        mainLayer.RegisterModel(cubeMaterial, groundModel, &groundInstance);
+    // Build the RenderGraph once, every frame sets it up again and it only recompiles if that changed anything. The passes draw whatever renderSnapshot points at
+    Renderer::RenderGraphDesc renderGraphDesc;
+    renderGraphDesc.allocator = &renderGraphAllocator;
+    renderGraphDesc.frameAllocator = &frameAllocator;
+    renderGraphDesc.threadAllocator = &threadFrameAllocator; // Lets Execute record the passes in parallel
+    Renderer::RenderGraph renderGraph = renderer->CreateRenderGraph(renderGraphDesc);
 
-        // Create a framegraph
-        Renderer::RenderGraphDesc renderGraphDesc;
-        renderGraphDesc.allocator = &frameAllocator;
-        Renderer::RenderGraph renderGraph = renderer->CreateRenderGraph(renderGraphDesc);
+    Renderer::DepthImageID mainDepth = Renderer::DepthImageID::Invalid(); // Transient, only lives while the graph executes
 
-        // Depth Prepass
+    // Both passes run once per view they declare, the camera's is the only one. Their constant buffers and visibility lists get filled in every frame
+    Renderer::RenderView views[NUM_VIEWS];
+    Renderer::RenderView& mainView = views[0];
+    mainView.viewport = { 0.0f, 0.0f, static_cast<f32>(width), static_cast<f32>(height), 0.0f, 1.0f };
+    mainView.scissorRect = { 0, 0, width, height };
+
+    // Gathers everything a view can see into a sorted DrawList, getPipeline picks the pipeline for each material or is null if the pass sets its own
+    auto buildDrawList = [&](const Renderer::RenderView& view, const std::function<Renderer::MaterialPipelineID(Renderer::MaterialID)>& getPipeline)
+    {
+        Renderer::RenderLayer::Materials& materials = view.visibleLayer->GetMaterials();
+
+        size_t numDraws = 0;
+        for (auto const& material : materials)
         {
-            struct DepthPrepassData
+            for (auto const& model : material.second)
             {
-                Renderer::RenderPassMutableResource depth;
-            };
+                numDraws += model.second.size();
+            }
+        }
 
-            renderGraph.AddPass<DepthPrepassData>("Depth Prepass",
-            [&](DepthPrepassData& data, Renderer::RenderGraphBuilder& builder) // Setup runs singlethreaded first, here we register what resources we're going to use
-            { 
-                data.depth = builder.Write(mainDepth, Renderer::RenderGraphBuilder::WriteMode::WRITE_MODE_RENDERTARGET, Renderer::RenderGraphBuilder::LoadMode::LOAD_MODE_CLEAR);
+        Renderer::DrawList drawList(threadFrameAllocator.Get(), numDraws);
+
+        Matrix& viewMatrix = renderSnapshot->viewMatrix;
+        Vector3 forward = viewMatrix.at * -1.0f; // The camera moves forward along -at
+
+        for (auto const& material : materials)
+        {
+            Renderer::DrawPacket packet;
+            if (getPipeline)
+            {
+                packet.material = Renderer::MaterialID(material.first);
+                packet.materialPipeline = getPipeline(packet.material);
+            }
+
+            for (auto const& model : material.second)
+            {
+                packet.model = Renderer::ModelID(model.first);
+
+                for (auto const& instance : model.second)
+                {
+                    packet.depth = (instance->position - viewMatrix.pos).Dot(forward) / CAMERA_FAR_CLIP;
+                    packet.constantBuffer = instance->GetGPUResource(frameIndex);
+                    packet.instance = instance;
+                    drawList.AddDraw(packet);
+                }
+            }
+        }
+
+        drawList.Sort();
+        return drawList;
+    };
+
+    // Hashes everything a ground bundle gets recorded from, the bundle gets recorded again whenever the hash changes
+    auto getGroundInputsHash = [&](const auto& pipeline, void* viewConstantBuffer)
+    {
+        XXHash64 hash(0);
+        hash.add(&pipeline, sizeof(pipeline));
+        hash.add(&groundModel, sizeof(Renderer::ModelID));
+        hash.add(&groundTransforms[frameIndex], sizeof(u64));
+        hash.add(&viewConstantBuffer, sizeof(void*));
+        return hash.hash();
+    };
+
+    // Depth Prepass
+    {
+        struct DepthPrepassData
+        {
+            Renderer::RenderPassMutableResource depth;
+            Renderer::GraphicsPipelineID pipeline = Renderer::GraphicsPipelineID::Invalid();
+        };
+
+        renderGraph.AddPass<DepthPrepassData>("Depth Prepass",
+        [&](DepthPrepassData& data, Renderer::RenderGraphBuilder& builder) // Setup runs singlethreaded first, here we register what resources we're going to use
+        { 
+            mainDepth = builder.Create(mainDepthDesc);
+            data.depth = builder.Write(mainDepth, Renderer::RenderGraphBuilder::WriteMode::WRITE_MODE_RENDERTARGET, Renderer::RenderGraphBuilder::LoadMode::LOAD_MODE_CLEAR); // Cleared to its depthClearValue when the render pass begins
+            builder.SetViews(views, NUM_VIEWS);
+
+            return true; // Return true from setup to enable this pass, return false to disable it
+        },
+        [&](DepthPrepassData& data, Renderer::CommandList& commandList) // Execute will run parallel, here we build an API-agnostic commandlist (which will be merged and executed afterwards). It runs once and every view shares what it sets
+        {
+            Renderer::GraphicsPipelineDesc pipelineDesc;
+            renderGraph.InitializePipelineDesc(pipelineDesc);
+
+            // Shaders
+            Renderer::VertexShaderDesc vertexShaderDesc;
+            vertexShaderDesc.path = "Data/shaders/depthPrepassInstanced.vs.hlsl.cso";
+            pipelineDesc.states.vertexShader = renderer->LoadShader(vertexShaderDesc); // This will load shader or use cached loaded shader
+
+            // Constant buffers  TODO: Improve on this, if I set state 0 and 3 it won't work etc...
+            pipelineDesc.states.constantBufferStates[0].enabled = true; // ViewCB
+            pipelineDesc.states.constantBufferStates[0].shaderVisibility = Renderer::ShaderVisibility::SHADER_VISIBILITY_VERTEX;
+
+            // Model matrices come from the instance buffer, so every cube shares one draw
+            pipelineDesc.states.instanceBufferState.enabled = true;
+            pipelineDesc.states.instanceBufferState.shaderVisibility = Renderer::ShaderVisibility::SHADER_VISIBILITY_VERTEX;
+
+            // Input layouts TODO: Improve on this, if I set state 0 and 3 it won't work etc... Maybe responsibility for this should be moved to ModelHandler and the cooker?
+            pipelineDesc.states.inputLayouts[0].enabled = true;
+            pipelineDesc.states.inputLayouts[0].SetName("POSITION");
+            pipelineDesc.states.inputLayouts[0].format = Renderer::InputFormat::INPUT_FORMAT_R32G32B32_FLOAT;
+            pipelineDesc.states.inputLayouts[0].inputClassification = Renderer::InputClassification::INPUT_CLASSIFICATION_PER_VERTEX;
+            pipelineDesc.states.inputLayouts[1].enabled = true;
+            pipelineDesc.states.inputLayouts[1].SetName("NORMAL");
+            pipelineDesc.states.inputLayouts[1].format = Renderer::InputFormat::INPUT_FORMAT_R32G32B32_FLOAT;
+            pipelineDesc.states.inputLayouts[1].inputClassification = Renderer::InputClassification::INPUT_CLASSIFICATION_PER_VERTEX;
+            pipelineDesc.states.inputLayouts[2].enabled = true;
+            pipelineDesc.states.inputLayouts[2].SetName("TEXCOORD");
+            pipelineDesc.states.inputLayouts[2].format = Renderer::InputFormat::INPUT_FORMAT_R32G32_FLOAT;
+            pipelineDesc.states.inputLayouts[2].inputClassification = Renderer::InputClassification::INPUT_CLASSIFICATION_PER_VERTEX;
+
+            // Depth state
+            pipelineDesc.states.depthStencilState.depthEnable = true;
+            pipelineDesc.states.depthStencilState.depthWriteEnable = true;
+            pipelineDesc.states.depthStencilState.depthFunc = Renderer::ComparisonFunc::COMPARISON_FUNC_LESS;
+
+            // Rasterizer state
+            pipelineDesc.states.rasterizerState.cullMode = Renderer::CullMode::CULL_MODE_BACK;
+
+            // Render targets
+            pipelineDesc.depthStencil = data.depth;
+
+            // Set pipeline
+            data.pipeline = renderer->CreatePipeline(pipelineDesc); // This will compile the pipeline and return the ID, or just return ID of cached pipeline
+            commandList.SetPipeline(data.pipeline);
+        },
+        [&](DepthPrepassData& data, Renderer::CommandList& commandList, const Renderer::RenderView& view) // Execute view runs once per view, with the view's viewport, scissor rect and constant buffer already bound
+        {
+            // Render what the view can see front to back, the pipeline was set above so draws only sort by model and depth
+            Renderer::DrawList drawList = buildDrawList(view, nullptr);
+            drawList.Submit(commandList, instanceBuffer); // Consecutive draws of the same model get merged into one instanced draw
+
+            // The bundle doesn't know what was bound before it, so it binds everything the ground needs itself
+            Renderer::CommandBundle& groundBundle = groundDepthBundles[&view - views][frameIndex]; // RenderGraph hands back the views it was given, so the offset is the view's index
+            u64 groundInputs = getGroundInputsHash(data.pipeline, view.constantBuffer);
+            if (groundBundle.NeedsRecording(groundInputs))
+            {
+                groundBundle.Record(groundInputs, [&](Renderer::CommandList& bundleCommandList)
+                {
+                    bundleCommandList.SetPipeline(data.pipeline);
+                    bundleCommandList.SetConstantBuffer(0, view.constantBuffer);
+                    bundleCommandList.DrawInstanced(groundModel, groundInstances[frameIndex]);
+                });
+            }
+            commandList.ExecuteBundle(groundBundle);
+        });
+    }
+
+    // Main Pass
+    {
+        struct MainPassData
+        {
+            Renderer::RenderPassMutableResource mainColor;
+            Renderer::RenderPassMutableResource depth;
+        };
+
+        renderGraph.AddPass<MainPassData>("Main Pass",
+            [&](MainPassData& data, Renderer::RenderGraphBuilder& builder) // Setup
+            {
+                data.mainColor = builder.Write(mainColor, Renderer::RenderGraphBuilder::WriteMode::WRITE_MODE_RENDERTARGET, Renderer::RenderGraphBuilder::LoadMode::LOAD_MODE_CLEAR);
+                data.depth = builder.Write(mainDepth, Renderer::RenderGraphBuilder::WriteMode::WRITE_MODE_RENDERTARGET, Renderer::RenderGraphBuilder::LoadMode::LOAD_MODE_LOAD); // TODO: Should this one be Read? Maybe?
+
+                builder.SetViews(views, NUM_VIEWS);
 
                 return true; // Return true from setup to enable this pass, return false to disable it
             },
-            [&](DepthPrepassData& data, Renderer::CommandList& commandList) // Execute will run parallel, here we build an API-agnostic commandlist (which will be merged and executed afterwards)
+            nullptr, // Pipelines depend on the materials a view sees, so there's nothing to share between views
+            [&](MainPassData& data, Renderer::CommandList& commandList, const Renderer::RenderView& view) // Execute view
             {
-                Renderer::GraphicsPipelineDesc pipelineDesc;
-                renderGraph.InitializePipelineDesc(pipelineDesc);
-
-                // Shaders
-                Renderer::VertexShaderDesc vertexShaderDesc;
-                vertexShaderDesc.path = "Data/shaders/depthPrepass.vs.hlsl.cso";
-                pipelineDesc.states.vertexShader = renderer->LoadShader(vertexShaderDesc); // This will load shader or use cached loaded shader
-
-                // Constant buffers  TODO: Improve on this, if I set state 0 and 3 it won't work etc...
-                pipelineDesc.states.constantBufferStates[0].enabled = true; // ViewCB
-                pipelineDesc.states.constantBufferStates[0].shaderVisibility = Renderer::ShaderVisibility::SHADER_VISIBILITY_VERTEX;
-                pipelineDesc.states.constantBufferStates[1].enabled = true; // ModelCB
-                pipelineDesc.states.constantBufferStates[1].shaderVisibility = Renderer::ShaderVisibility::SHADER_VISIBILITY_VERTEX;
-
-                // Input layouts TODO: Improve on this, if I set state 0 and 3 it won't work etc... Maybe responsibility for this should be moved to ModelHandler and the cooker?
-                pipelineDesc.states.inputLayouts[0].enabled = true;
-                pipelineDesc.states.inputLayouts[0].SetName("POSITION");
-                pipelineDesc.states.inputLayouts[0].format = Renderer::InputFormat::INPUT_FORMAT_R32G32B32_FLOAT;
-                pipelineDesc.states.inputLayouts[0].inputClassification = Renderer::InputClassification::INPUT_CLASSIFICATION_PER_VERTEX;
-                pipelineDesc.states.inputLayouts[1].enabled = true;
-                pipelineDesc.states.inputLayouts[1].SetName("NORMAL");
-                pipelineDesc.states.inputLayouts[1].format = Renderer::InputFormat::INPUT_FORMAT_R32G32B32_FLOAT;
-                pipelineDesc.states.inputLayouts[1].inputClassification = Renderer::InputClassification::INPUT_CLASSIFICATION_PER_VERTEX;
-                pipelineDesc.states.inputLayouts[2].enabled = true;
-                pipelineDesc.states.inputLayouts[2].SetName("TEXCOORD");
-                pipelineDesc.states.inputLayouts[2].format = Renderer::InputFormat::INPUT_FORMAT_R32G32_FLOAT;
-                pipelineDesc.states.inputLayouts[2].inputClassification = Renderer::InputClassification::INPUT_CLASSIFICATION_PER_VERTEX;
-
-                // Depth state
-                pipelineDesc.states.depthStencilState.depthEnable = true;
-                pipelineDesc.states.depthStencilState.depthWriteEnable = true;
-                pipelineDesc.states.depthStencilState.depthFunc = Renderer::ComparisonFunc::COMPARISON_FUNC_LESS;
-
-                // Rasterizer state
-                pipelineDesc.states.rasterizerState.cullMode = Renderer::CullMode::CULL_MODE_BACK;
-
-                // Render targets
-                pipelineDesc.depthStencil = data.depth;
-
-                // Set pipeline
-                Renderer::GraphicsPipelineID pipeline = renderer->CreatePipeline(pipelineDesc); // This will compile the pipeline and return the ID, or just return ID of cached pipeline
-                commandList.SetPipeline(pipeline);
-
-                // Set viewport and scissor rect
-                commandList.SetScissorRect(0, width, 0, height);
-                commandList.SetViewport(0, 0, static_cast<f32>(width), static_cast<f32>(height), 0.0f, 1.0f);
-
-                // Set view constant buffer
-                commandList.SetConstantBuffer(0, viewConstantBuffer.GetGPUResource(frameIndex));
-
-                // Clear depth to 1.0f (furthest from camera)
-                commandList.Clear(mainDepth, 1.0f);
-
-                // Render main layer
-                Renderer::RenderLayer& mainLayer = renderer->GetRenderLayer(MAIN_RENDER_LAYER);
-
-                for (auto const& material : mainLayer.GetMaterials())
+                // Every material gets its own pipeline, the DrawList sorts by them so each one only gets set once
+                auto getPipeline = [&](Renderer::MaterialID materialID)
                 {
-                    auto const& models = material.second;
+                    Renderer::MaterialPipelineDesc pipelineDesc;
+                    renderGraph.InitializePipelineDesc(pipelineDesc);
 
-                    for (auto const& model : models)
-                    {
-                        auto const& modelID = Renderer::ModelID(model.first);
-                        auto const& instances = model.second;
+                    pipelineDesc.material = materialID;
+
+                    // Depth state
+                    pipelineDesc.states.depthStencilState.depthEnable = true;
+                    pipelineDesc.states.depthStencilState.depthFunc = Renderer::ComparisonFunc::COMPARISON_FUNC_EQUAL;
+
+                    // Rasterizer state
+                    pipelineDesc.states.rasterizerState.cullMode = Renderer::CullMode::CULL_MODE_BACK;
 
-                        for (auto const& instance : instances)
-                        {
-                            // Update model constant buffer
-                            instance->Apply(frameIndex);
+                    // Render targets
+                    pipelineDesc.renderTargets[0] = data.mainColor;
+                    pipelineDesc.depthStencil = data.depth;
 
-                            // Set model constant buffer
-                            commandList.SetConstantBuffer(1, instance->GetGPUResource(frameIndex));
+                    return renderer->CreatePipeline(pipelineDesc); // This will compile the pipeline and return the ID, or just return ID of cached pipeline
+                };
 
-                            // Draw
-                            commandList.Draw(modelID);
-                        }
-                    }
+                // Render what the view can see. Material shaders read the instance from its constant buffer, so unlike the depth prepass every instance is its own draw
+                Renderer::DrawList drawList = buildDrawList(view, getPipeline);
+                drawList.Submit(commandList, 1, [&](Renderer::CommandList& pipelineCommandList)
+                {
+                    // Set viewport and scissor rect
+                    pipelineCommandList.SetScissorRect(0, width, 0, height);
+                    pipelineCommandList.SetViewport(0, 0, static_cast<f32>(width), static_cast<f32>(height), 0.0f, 1.0f);
+
+                    // Setting a pipeline resets its bindings, so the view constant buffer goes back in
+                    pipelineCommandList.SetConstantBuffer(0, view.constantBuffer);
+                });
+
+                // The ground is drawn with the cube's material
+                Renderer::MaterialPipelineID groundPipeline = getPipeline(cubeMaterial);
+                Renderer::CommandBundle& groundBundle = groundMainBundles[&view - views][frameIndex];
+                u64 groundInputs = getGroundInputsHash(groundPipeline, view.constantBuffer);
+                if (groundBundle.NeedsRecording(groundInputs))
+                {
+                    groundBundle.Record(groundInputs, [&](Renderer::CommandList& bundleCommandList)
+                    {
+                        bundleCommandList.SetPipeline(groundPipeline);
+                        bundleCommandList.SetScissorRect(0, width, 0, height);
+                        bundleCommandList.SetViewport(0, 0, static_cast<f32>(width), static_cast<f32>(height), 0.0f, 1.0f);
+                        bundleCommandList.SetConstantBuffer(0, view.constantBuffer);
+                        bundleCommandList.SetConstantBuffer(1, groundInstance.GetGPUResource(frameIndex));
+                        bundleCommandList.Draw(groundModel);
+                    });
                 }
-            });
-        }
+                commandList.ExecuteBundle(groundBundle);
+        });
+    }
+
+    Jobs::TaskGraph renderFrameGraph;
+    renderFrameGraph.AddTask("View Constants", [&]()
+    {
+        viewConstantBuffer.resource.viewMatrix = renderSnapshot->viewMatrix.Transposed();
+        viewConstantBuffer.Apply(frameIndex);
 
-        // Main Pass
+        mainView.constantBuffer = viewConstantBuffer.GetGPUResource(frameIndex);
+        mainView.visibleLayer = &renderSnapshot->renderSnapshot.GetRenderLayer(MAIN_RENDER_LAYER);
+    }).Writes("ViewConstants");
+
+    renderFrameGraph.AddTask("Model Constants", [&]()
+    {
+        // Update model constant buffers here once, both passes read them and might be recording at the same time
+        renderSnapshot->renderSnapshot.ApplyInstances(frameIndex);
+        instanceBuffer.Reset(frameIndex); // The depth prepass writes its instances while recording
+
+        // Only the render side touches the ground, it gets applied when it changed since this frame index last applied it and its bundles record again
+        u64 groundTransform = groundInstance.GetTransformHash();
+        if (groundInstances[frameIndex].gpuResource == nullptr || groundTransforms[frameIndex] != groundTransform)
         {
-            struct MainPassData
-            {
-                Renderer::RenderPassMutableResource mainColor;
-                Renderer::RenderPassMutableResource depth;
-            };
+            groundInstance.Apply(frameIndex);
 
-            renderGraph.AddPass<MainPassData>("Main Pass",
-                [&](MainPassData& data, Renderer::RenderGraphBuilder& builder) // Setup
-                {
-                    data.mainColor = builder.Write(mainColor, Renderer::RenderGraphBuilder::WriteMode::WRITE_MODE_RENDERTARGET, Renderer::RenderGraphBuilder::LoadMode::LOAD_MODE_CLEAR);
-                    data.depth = builder.Write(mainDepth, Renderer::RenderGraphBuilder::WriteMode::WRITE_MODE_RENDERTARGET, Renderer::RenderGraphBuilder::LoadMode::LOAD_MODE_LOAD); // TODO: Should this one be Read? Maybe?
+            groundInstanceBuffer.Reset(frameIndex);
+            groundInstances[frameIndex] = groundInstanceBuffer.Allocate(1);
+            groundInstanceBuffer.Write(groundInstances[frameIndex], 0, groundInstance.GetInstanceConstants());
+            groundTransforms[frameIndex] = groundTransform;
+        }
+    }).Writes("ModelConstants");
 
-                    return true; // Return true from setup to enable this pass, return false to disable it
-                },
-                [&](MainPassData& data, Renderer::CommandList& commandList) // Execute
-                {
-                    // Clear mainColor TODO: This should be handled by the parameter in Setup, and it should definitely not act on ImageID and DepthImageID
-                    commandList.Clear(mainColor, Vector4(0, 0, 0, 1));
+    renderFrameGraph.AddTask("RenderGraph", [&]()
+    {
+        renderGraph.Setup();
+        renderGraph.Execute();
+    }).Reads("ViewConstants").Reads("ModelConstants").Writes("MainColor");
 
-                    // Render main layer
-                    Renderer::RenderLayer& mainLayer = renderer->GetRenderLayer(MAIN_RENDER_LAYER);
+    renderFrameGraph.Compile();
+    Jobs::JobSystemTaskExecutor frameGraphExecutor;
 
-                    for (auto const& material : mainLayer.GetMaterials())
-                    {
-                        // Set Material pipeline
-                        auto const& materialID = Renderer::MaterialID(material.first);
+    // Records and presents one simulated frame, this runs on the render thread in pipelined mode and on the main thread otherwise
+    u64 numRenderedFrames = 0;
+    auto renderFrame = [&](FrameSnapshot& snapshot)
+    {
+        PROFILE_SCOPE("Render Frame");
 
-                        Renderer::MaterialPipelineDesc pipelineDesc;
-                        renderGraph.InitializePipelineDesc(pipelineDesc);
+        frameAllocator.Reset(); // Reset the frame allocators at the start of every rendered frame
+        threadFrameAllocator.Reset();
 
-                        pipelineDesc.material = materialID;
+        // Create resources for async loads that are done reading
+        renderer->FinalizeAsyncLoads(ASYNC_LOAD_BUDGET_MS);
 
-                        // Depth state
-                        pipelineDesc.states.depthStencilState.depthEnable = true;
-                        pipelineDesc.states.depthStencilState.depthFunc = Renderer::ComparisonFunc::COMPARISON_FUNC_EQUAL;
+        // Update the view and model constantbuffers and Setup and Execute the RenderGraph
+        bool isCaptured = ++numRenderedFrames == CAPTURE_FRAME;
+        if (isCaptured)
+        {
+            renderer->GetCommandCapture().Begin(CAPTURE_PATH);
+        }
 
-                        // Rasterizer state
-                        pipelineDesc.states.rasterizerState.cullMode = Renderer::CullMode::CULL_MODE_BACK;
+        renderSnapshot = &snapshot;
+        renderFrameGraph.Execute(frameGraphExecutor);
+        renderSnapshot = nullptr;
 
-                        // Render targets
-                        pipelineDesc.renderTargets[0] = data.mainColor;
-                        pipelineDesc.depthStencil = data.depth;
+        if (isCaptured)
+        {
+            renderer->GetCommandCapture().End();
+        }
 
-                        // Set pipeline
-                        Renderer::MaterialPipelineID pipeline = renderer->CreatePipeline(pipelineDesc); // This will compile the pipeline and return the ID, or just return ID of cached pipeline
-                        commandList.SetPipeline(pipeline);
+        // Present to Window
+        {
+            PROFILE_SCOPE("Present");
+            renderer->Present(&mainWindow, mainColor);
+        }
 
-                        // Set viewport and scissor rect
-                        commandList.SetScissorRect(0, width, 0, height);
-                        commandList.SetViewport(0, 0, static_cast<f32>(width), static_cast<f32>(height), 0.0f, 1.0f);
+        frameIndex = !frameIndex; // Flip between 0 and 1
+    };
 
-                        // Set view constant buffer
-                        commandList.SetConstantBuffer(0, viewConstantBuffer.GetGPUResource(frameIndex));
+    std::thread renderThread;
+    if constexpr (PIPELINED_RENDERING)
+    {
+        renderThread = std::thread([&]()
+        {
+            Profiling::Profiler::SetThreadName("Render");
+            Jobs::JobSystem::RegisterThread(); // Lets the render thread run its task graph and record passes in parallel like a worker would
 
-                        auto const& models = material.second;
+            while (FrameSnapshot* snapshot = framePipeline.BeginRead())
+            {
+                renderFrame(*snapshot);
+                framePipeline.EndRead();
+            }
 
-                        for (auto const& model : models)
-                        {
-                            auto const& modelID = Renderer::ModelID(model.first);
-                            auto const& instances = model.second;
+            Jobs::JobSystem::UnregisterThread();
+        });
+    }
 
-                            for (auto const& instance : instances)
-                            {
-                                // Update model constant buffer
-                                instance->Apply(frameIndex);
+    while (true)
+    {
+        PROFILE_FRAME();
+        Profiling::FrameStats::EndFrame();
 
-                                // Set model constant buffer
-                                commandList.SetConstantBuffer(1, instance->GetGPUResource(frameIndex));
+        deltaTime = timer.GetDeltaTime();
+        timer.Tick();
 
-                                // Draw
-                                commandList.Draw(modelID);
-                            }
-                        }
-                    }
-            });
+        if (mainWindow.WantsToExit())
+        {
+            mainWindow.ConfirmExit();
+            break;
         }
+        mainWindow.Update(deltaTime);
 
-        // Setup and Execute RenderGraph
-        renderGraph.Setup();
-        renderGraph.Execute();
+        // Simulate into the next free snapshot, in pipelined mode this only waits if the render thread falls more than PIPELINE_LATENCY frames behind
+        FrameSnapshot& snapshot = framePipeline.BeginWrite();
+        snapshot.renderSnapshot.Reset();
 
-        // Present to Window
-        renderer->Present(&mainWindow, mainColor);
-        //renderer->Present(&mainWindow, mainDepth);
+        simulationSnapshot = &snapshot;
+        simulationGraph.Execute(frameGraphExecutor);
+        simulationSnapshot = nullptr;
 
-        // Reset layers
-        mainLayer.Reset();
+        framePipeline.EndWrite();
 
-        // Wait for update rate, this might be an overkill implementation but it has the most even update rate I've seen - MPursche
-        for (deltaTime = timer.GetDeltaTime(); deltaTime < targetDelta - 0.0025f; deltaTime = timer.GetDeltaTime())
+        if constexpr (!PIPELINED_RENDERING)
         {
-            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            renderFrame(*framePipeline.BeginRead());
+            framePipeline.EndRead();
         }
 
-        for (deltaTime = timer.GetDeltaTime(); deltaTime < targetDelta; deltaTime = timer.GetDeltaTime())
+        // Wait for update rate, the pacer sleeps against an absolute deadline and only spins for the last fraction of a millisecond
         {
-            std::this_thread::yield();
+            PROFILE_SCOPE("Wait");
+            framePacer.WaitForNextFrame();
         }
+    }
 
-        frameIndex = !frameIndex; // Flip between 0 and 1
+    // Let the render thread finish whatever was already simulated
+    framePipeline.Stop();
+    if (renderThread.joinable())
+    {
+        renderThread.join();
+    }
+
+    const FramePacerStats& pacerStats = framePacer.GetStats();
+    LOG_INFO(LOG_CATEGORY_GENERAL, "Frame pacing: %llu frames, %llu missed, jitter avg %.1f us max %.1f us, spin avg %.1f us",
+        static_cast<unsigned long long>(pacerStats.frames), static_cast<unsigned long long>(pacerStats.missedDeadlines), pacerStats.averageJitterUS, pacerStats.maxJitterUS, pacerStats.averageSpinUS);
+
+    LOG_INFO(LOG_CATEGORY_GENERAL, "Frame pipeline: %llu frames, simulation waited %.1f ms, rendering waited %.1f ms",
+        static_cast<unsigned long long>(framePipeline.GetFramesRead()), static_cast<f64>(framePipeline.GetProducerWaitNS()) / 1000000.0, static_cast<f64>(framePipeline.GetConsumerWaitNS()) / 1000000.0);
+
+    for (Jobs::TaskGraph* frameGraph : { &simulationGraph, &renderFrameGraph })
+    {
+        const Jobs::TaskGraphReport& frameGraphReport = frameGraph->GetLastReport();
+        LOG_INFO(LOG_CATEGORY_GENERAL, "Last frame graph: %.2f ms wall, %.2f ms critical path, %.2f ms of tasks",
+            static_cast<f64>(frameGraphReport.wallTimeNS) / 1000000.0, static_cast<f64>(frameGraphReport.criticalPathNS) / 1000000.0, static_cast<f64>(frameGraphReport.totalTaskTimeNS) / 1000000.0);
+        for (Jobs::TaskID task : frameGraphReport.criticalPath)
+        {
+            LOG_INFO(LOG_CATEGORY_GENERAL, "  Critical path: %s", frameGraph->GetTaskName(task));
+        }
+    }
+
+    // Replay the captured frame as a benchmark, against the renderer that captured it so every ID in it is still valid
+    if (CAPTURE_FRAME != 0 && numRenderedFrames >= CAPTURE_FRAME)
+    {
+        Renderer::CommandReplay replay;
+        if (replay.Load(CAPTURE_PATH))
+        {
+            replay.Replay(renderer, REPLAY_ITERATIONS);
+            replay.LogStats();
+        }
     }
 
+#ifdef PROFILER_ENABLED
+    Profiling::Profiler::ExportChromeTrace("profile.json");
+#endif
+
     renderer->Deinit();
+    if (nullRenderer != nullptr)
+    {
+        nullRenderer->LogStats();
+    }
     delete renderer;
+
+    Jobs::JobSystem::Shutdown();
+    Logging::Logger::Shutdown();
     return 0;
 }
\ No newline at end of file
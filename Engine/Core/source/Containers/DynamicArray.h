@@ -49,6 +49,12 @@ public:
         _count--;
     }
 
+    // Remove every object, keeping the memory so the array can be filled again without allocating
+    void Clear()
+    {
+        _count = 0;
+    }
+
     size_t Count()
     {
         return _count;
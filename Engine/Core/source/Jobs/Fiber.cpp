@@ -0,0 +1,230 @@
+#include "Fiber.h"
+#include <cassert>
+#include <cstdlib>
+
+#if defined(_WIN32)
+#include <Windows.h>
+#elif defined(__linux__) && defined(__x86_64__)
+#include <sys/mman.h>
+#include <unistd.h>
+#define FIBER_X86_64_SYSV
+#endif
+
+// ThreadSanitizer needs to be told about stack switches or it mixes up the fibers' histories
+#if defined(__SANITIZE_THREAD__)
+#define FIBER_TSAN
+#elif defined(__has_feature)
+#if __has_feature(thread_sanitizer)
+#define FIBER_TSAN
+#endif
+#endif
+
+#if defined(FIBER_TSAN)
+extern "C" void* __tsan_get_current_fiber();
+extern "C" void* __tsan_create_fiber(unsigned flags);
+extern "C" void __tsan_destroy_fiber(void* fiber);
+extern "C" void __tsan_switch_to_fiber(void* fiber, unsigned flags);
+#endif
+
+#if defined(FIBER_X86_64_SYSV)
+extern "C" void JobsSwitchContext(void** fromStackPointer, void* toStackPointer);
+extern "C" void JobsFiberStart();
+
+// Pushes the callee-saved registers plus MXCSR and the x87 control word onto the current stack, saves the stack pointer,
+// loads the other one and pops the same state back off. Everything else is caller-saved in the System V ABI, so this is the whole context.
+asm(R"(
+    .text
+    .globl JobsSwitchContext
+    .type JobsSwitchContext, @function
+JobsSwitchContext:
+    pushq %rbp
+    pushq %rbx
+    pushq %r12
+    pushq %r13
+    pushq %r14
+    pushq %r15
+    subq $8, %rsp
+    stmxcsr (%rsp)
+    fnstcw 4(%rsp)
+    movq %rsp, (%rdi)
+    movq %rsi, %rsp
+    ldmxcsr (%rsp)
+    fldcw 4(%rsp)
+    addq $8, %rsp
+    popq %r15
+    popq %r14
+    popq %r13
+    popq %r12
+    popq %rbx
+    popq %rbp
+    ret
+    .size JobsSwitchContext, .-JobsSwitchContext
+
+    .globl JobsFiberStart
+    .type JobsFiberStart, @function
+JobsFiberStart:
+    movq %r12, %rdi
+    callq *%r13
+    ud2
+    .size JobsFiberStart, .-JobsFiberStart
+)");
+#endif
+
+namespace Jobs
+{
+#if defined(_WIN32)
+    void __stdcall WindowsFiberEntry(void* parameter)
+    {
+        Fiber* fiber = static_cast<Fiber*>(parameter);
+        fiber->_function(fiber->_userData);
+        assert(false); // Fiber functions are not allowed to return
+        abort();
+    }
+#endif
+
+    Fiber* Fiber::Create(u32 stackSize, FiberFunction function, void* userData)
+    {
+        if (!IsSupported())
+            return nullptr;
+
+        Fiber* fiber = new Fiber();
+        fiber->_function = function;
+        fiber->_userData = userData;
+
+#if defined(_WIN32)
+        // Windows reserves the stack with its own guard page
+        fiber->_context = CreateFiberEx(stackSize, stackSize, FIBER_FLAG_FLOAT_SWITCH, &WindowsFiberEntry, fiber);
+        if (fiber->_context == nullptr)
+        {
+            delete fiber;
+            return nullptr;
+        }
+#elif defined(FIBER_X86_64_SYSV)
+        size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        size_t stackBytes = (static_cast<size_t>(stackSize) + pageSize - 1) & ~(pageSize - 1);
+        size_t mappingSize = stackBytes + pageSize;
+
+        void* mapping = mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK, -1, 0);
+        if (mapping == MAP_FAILED)
+        {
+            delete fiber;
+            return nullptr;
+        }
+
+        // Stacks grow down, so the guard page goes at the lowest address
+        if (mprotect(mapping, pageSize, PROT_NONE) != 0)
+        {
+            munmap(mapping, mappingSize);
+            delete fiber;
+            return nullptr;
+        }
+
+        fiber->_stack = mapping;
+        fiber->_stackMappingSize = mappingSize;
+
+        // Lay out the stack as if JobsSwitchContext had switched away from JobsFiberStart, the first switch to it pops these and returns into it
+        u64* top = reinterpret_cast<u64*>(static_cast<u8*>(mapping) + mappingSize);
+        top[-1] = reinterpret_cast<u64>(&JobsFiberStart); // Return address, rsp ends up 16 byte aligned like JobsFiberStart's call expects
+        top[-2] = 0; // rbp
+        top[-3] = 0; // rbx
+        top[-4] = reinterpret_cast<u64>(fiber); // r12, the argument
+        top[-5] = reinterpret_cast<u64>(&Fiber::Entry); // r13, the function to call
+        top[-6] = 0; // r14
+        top[-7] = 0; // r15
+        top[-8] = 0x0000037F00001F80ull; // Default MXCSR in the low half, default x87 control word in the high half
+        fiber->_context = &top[-8];
+#if defined(FIBER_TSAN)
+        fiber->_tsanFiber = __tsan_create_fiber(0);
+#endif
+#else
+        (void)stackSize;
+#endif
+
+        return fiber;
+    }
+
+    Fiber* Fiber::ConvertCurrentThread()
+    {
+        if (!IsSupported())
+            return nullptr;
+
+        Fiber* fiber = new Fiber();
+        fiber->_isThreadFiber = true;
+
+#if defined(_WIN32)
+        fiber->_context = ConvertThreadToFiberEx(nullptr, FIBER_FLAG_FLOAT_SWITCH);
+        if (fiber->_context == nullptr)
+        {
+            delete fiber;
+            return nullptr;
+        }
+#endif
+        // On Linux the thread's own stack is used as is, _context gets filled in the first time we switch away from it
+#if defined(FIBER_TSAN)
+        fiber->_tsanFiber = __tsan_get_current_fiber();
+#endif
+
+        return fiber;
+    }
+
+    void Fiber::Destroy(Fiber* fiber)
+    {
+        if (fiber == nullptr)
+            return;
+
+#if defined(_WIN32)
+        if (fiber->_isThreadFiber)
+        {
+            ConvertFiberToThread();
+        }
+        else
+        {
+            DeleteFiber(fiber->_context);
+        }
+#elif defined(FIBER_X86_64_SYSV)
+        if (!fiber->_isThreadFiber)
+        {
+            munmap(fiber->_stack, fiber->_stackMappingSize);
+#if defined(FIBER_TSAN)
+            __tsan_destroy_fiber(fiber->_tsanFiber);
+#endif
+        }
+#endif
+
+        delete fiber;
+    }
+
+    void Fiber::Switch(Fiber* from, Fiber* to)
+    {
+        assert(from != to); // Switching to ourselves would save over the context we're about to load
+#if defined(_WIN32)
+        (void)from;
+        SwitchToFiber(to->_context);
+#elif defined(FIBER_X86_64_SYSV)
+#if defined(FIBER_TSAN)
+        __tsan_switch_to_fiber(to->_tsanFiber, 0);
+#endif
+        JobsSwitchContext(&from->_context, to->_context);
+#else
+        (void)from;
+        (void)to;
+        assert(false); // Fibers are not supported on this platform, check IsSupported
+#endif
+    }
+
+    bool Fiber::IsSupported()
+    {
+#if defined(_WIN32) || defined(FIBER_X86_64_SYSV)
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    void Fiber::Entry(Fiber* fiber)
+    {
+        fiber->_function(fiber->_userData);
+        assert(false); // Fiber functions are not allowed to return
+        abort();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,49 @@
+#pragma once
+#include "../Core.h"
+
+namespace Jobs
+{
+    typedef void (*FiberFunction)(void* userData);
+
+    // A fiber is a stack plus saved registers that we switch to and from in user mode, without involving the OS scheduler.
+    // On x86-64 Linux the switch is a handful of instructions saving the callee-saved registers, on Windows it uses the Win32 fiber API.
+    class Fiber
+    {
+    public:
+        // Creates a fiber with its own stack, the lowest page of the stack is a guard page so overflowing it faults instead of corrupting memory.
+        // The function must never return, switch away from the fiber instead.
+        static Fiber* Create(u32 stackSize, FiberFunction function, void* userData);
+
+        // Turns the calling thread into a fiber so it can switch to other fibers and later be switched back to
+        static Fiber* ConvertCurrentThread();
+
+        // Destroys a fiber from Create or converts a thread back from ConvertCurrentThread, never call this on the running fiber
+        static void Destroy(Fiber* fiber);
+
+        // Saves the running fiber into from and resumes to, returns when something switches back to from
+        static void Switch(Fiber* from, Fiber* to);
+
+        // False on platforms we don't have a context switch for
+        static bool IsSupported();
+
+    private:
+        Fiber() {}
+        Fiber(const Fiber&) = delete;
+        Fiber& operator=(const Fiber&) = delete;
+
+        static void Entry(Fiber* fiber);
+
+    private:
+        void* _context = nullptr; // The saved stack pointer on Linux, the fiber handle on Windows
+        void* _stack = nullptr;
+        size_t _stackMappingSize = 0;
+        FiberFunction _function = nullptr;
+        void* _userData = nullptr;
+        bool _isThreadFiber = false;
+        void* _tsanFiber = nullptr; // Only used when building with ThreadSanitizer
+
+#if defined(_WIN32)
+        friend void __stdcall WindowsFiberEntry(void* parameter);
+#endif
+    };
+}
\ No newline at end of file
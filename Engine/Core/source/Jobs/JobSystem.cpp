@@ -0,0 +1,718 @@
+#include "JobSystem.h"
+#include "WorkStealingDeque.h"
+#include "Fiber.h"
+#include "../Logging/Logger.h"
+#include "../Profiling/Profiler.h"
+#include <cassert>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define CPU_PAUSE() _mm_pause()
+#elif defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define CPU_PAUSE() _mm_pause()
+#else
+#define CPU_PAUSE() ((void)0)
+#endif
+
+// Fibers can move between threads, so thread_local reads must not be cached across a switch
+#if defined(_MSC_VER)
+#define JOBS_NOINLINE __declspec(noinline)
+#else
+#define JOBS_NOINLINE __attribute__((noinline))
+#endif
+
+namespace Jobs
+{
+    namespace
+    {
+        const u32 DEQUE_CAPACITY = 4096; // Needs to be a power of two
+        const u32 JOB_ARENA_SIZE = 4096; // Needs to be a power of two
+        const u32 EXTERNAL_JOB_ARENA_SIZE = 1024; // Needs to be a power of two
+        const u32 IDLE_SPIN_COUNT = 256; // How many failed attempts to find work before a worker goes to sleep
+
+        // What the fiber we switch to has to do with the fiber we switched away from, it can only be done once we're off its stack
+        enum PendingFiberAction
+        {
+            PENDING_FIBER_ACTION_NONE,
+            PENDING_FIBER_ACTION_RELEASE, // Return it to the pool
+            PENDING_FIBER_ACTION_PARK // Add it to the waiting list
+        };
+
+        struct alignas(64) ThreadContext
+        {
+            WorkStealingDeque<Job, DEQUE_CAPACITY> deque;
+            Job arena[JOB_ARENA_SIZE];
+            u32 nextJob = 0;
+            u32 randomState = 0;
+
+            Fiber* threadFiber = nullptr; // The worker's own stack, switched back to on shutdown
+            Fiber* currentFiber = nullptr;
+            PendingFiberAction pendingAction = PENDING_FIBER_ACTION_NONE;
+            Fiber* pendingFiber = nullptr;
+            JobCounter* pendingCounter = nullptr;
+        };
+
+        struct WaitingFiber
+        {
+            Fiber* fiber;
+            JobCounter* counter;
+        };
+
+        struct JobSystemState
+        {
+            std::vector<ThreadContext*> contexts;
+            std::vector<std::thread> workers;
+            u32 numThreads = 0;
+            u32 numWorkers = 0;
+            bool initialized = false;
+
+            std::mutex registeredThreadsMutex;
+            std::vector<bool> registeredThreadSlots; // Which of the slots after the workers are taken
+
+            // Threads the job system doesn't own can still schedule jobs, those go through a locked queue
+            std::mutex externalMutex;
+            std::deque<Job*> externalQueue;
+            std::atomic<u32> externalQueueSize = 0;
+            Job externalArena[EXTERNAL_JOB_ARENA_SIZE];
+            std::atomic<u32> nextExternalJob = 0;
+
+            std::mutex sleepMutex;
+            std::condition_variable wakeCondition;
+            u64 wakeGeneration = 0;
+            std::atomic<u32> numSleeping = 0;
+            std::atomic<bool> stop = false;
+
+            bool fibersEnabled = false;
+            u32 fiberStackSize = 0;
+            std::vector<Fiber*> fibers;
+            std::mutex freeFibersMutex;
+            std::vector<Fiber*> freeFibers;
+
+            // Fibers parked in WaitForCounter, any worker resumes them once their counter is done
+            std::mutex waitingFibersMutex;
+            std::vector<WaitingFiber> waitingFibers;
+            std::atomic<u32> numWaitingFibers = 0;
+        };
+
+        JobSystemState& GetState()
+        {
+            static JobSystemState state;
+            return state;
+        }
+
+        thread_local u32 _threadIndex = JobSystem::INVALID_THREAD_INDEX;
+
+        JOBS_NOINLINE ThreadContext* GetThreadContext()
+        {
+            u32 threadIndex = _threadIndex;
+            return threadIndex != JobSystem::INVALID_THREAD_INDEX ? GetState().contexts[threadIndex] : nullptr;
+        }
+
+        u32 NextRandom(u32& state)
+        {
+            // xorshift32
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            return state;
+        }
+
+        Job* StealJob(JobSystemState& state, u32 threadIndex)
+        {
+            u32 numThreads = state.numThreads;
+            u32 start = 0;
+            if (threadIndex != JobSystem::INVALID_THREAD_INDEX)
+            {
+                start = NextRandom(state.contexts[threadIndex]->randomState) % numThreads;
+            }
+
+            for (u32 i = 0; i < numThreads; i++)
+            {
+                u32 victim = (start + i) % numThreads;
+                if (victim == threadIndex)
+                    continue;
+
+                if (Job* job = state.contexts[victim]->deque.Steal())
+                    return job;
+            }
+
+            return nullptr;
+        }
+
+        Job* PopExternalJob(JobSystemState& state)
+        {
+            if (state.externalQueueSize.load(std::memory_order_acquire) == 0)
+                return nullptr;
+
+            std::lock_guard<std::mutex> lock(state.externalMutex);
+            if (state.externalQueue.empty())
+                return nullptr;
+
+            Job* job = state.externalQueue.front();
+            state.externalQueue.pop_front();
+            state.externalQueueSize.fetch_sub(1, std::memory_order_release);
+            return job;
+        }
+
+        Fiber* AcquireFiber(JobSystemState& state)
+        {
+            std::lock_guard<std::mutex> lock(state.freeFibersMutex);
+            if (state.freeFibers.empty())
+                return nullptr;
+
+            Fiber* fiber = state.freeFibers.back();
+            state.freeFibers.pop_back();
+            return fiber;
+        }
+
+        void ReleaseFiber(JobSystemState& state, Fiber* fiber)
+        {
+            std::lock_guard<std::mutex> lock(state.freeFibersMutex);
+            state.freeFibers.push_back(fiber);
+        }
+
+        Fiber* PopReadyFiber(JobSystemState& state)
+        {
+            if (state.numWaitingFibers.load(std::memory_order_acquire) == 0)
+                return nullptr;
+
+            std::lock_guard<std::mutex> lock(state.waitingFibersMutex);
+            for (size_t i = 0; i < state.waitingFibers.size(); i++)
+            {
+                if (state.waitingFibers[i].counter->IsDone())
+                {
+                    Fiber* fiber = state.waitingFibers[i].fiber;
+                    state.waitingFibers.erase(state.waitingFibers.begin() + static_cast<std::ptrdiff_t>(i)); // Keep them in order so long chains resume oldest first
+                    state.numWaitingFibers.fetch_sub(1, std::memory_order_release);
+                    return fiber;
+                }
+            }
+            return nullptr;
+        }
+
+        bool HasReadyFiber(JobSystemState& state)
+        {
+            if (state.numWaitingFibers.load(std::memory_order_seq_cst) == 0)
+                return false;
+
+            std::lock_guard<std::mutex> lock(state.waitingFibersMutex);
+            for (const WaitingFiber& waitingFiber : state.waitingFibers)
+            {
+                if (waitingFiber.counter->IsDone())
+                    return true;
+            }
+            return false;
+        }
+
+        // Runs first thing after every switch, on the fiber we switched to
+        void FinishFiberSwitch()
+        {
+            JobSystemState& state = GetState();
+            ThreadContext* context = GetThreadContext();
+
+            switch (context->pendingAction)
+            {
+                case PENDING_FIBER_ACTION_NONE:
+                    break;
+                case PENDING_FIBER_ACTION_RELEASE:
+                    ReleaseFiber(state, context->pendingFiber);
+                    break;
+                case PENDING_FIBER_ACTION_PARK:
+                {
+                    std::lock_guard<std::mutex> lock(state.waitingFibersMutex);
+                    state.waitingFibers.push_back({ context->pendingFiber, context->pendingCounter });
+                    state.numWaitingFibers.fetch_add(1, std::memory_order_release);
+                    break;
+                }
+            }
+
+            context->pendingAction = PENDING_FIBER_ACTION_NONE;
+            context->pendingFiber = nullptr;
+            context->pendingCounter = nullptr;
+        }
+
+        // Switches from the running fiber to another, the action is applied to the fiber we leave once we're safely off its stack
+        void SwitchFiber(Fiber* to, PendingFiberAction action, JobCounter* counter)
+        {
+            ThreadContext* context = GetThreadContext();
+            Fiber* from = context->currentFiber;
+
+            context->pendingAction = action;
+            context->pendingFiber = from;
+            context->pendingCounter = counter;
+            context->currentFiber = to;
+
+            Profiling::ScopedZone* zones = Profiling::Profiler::SuspendZones();
+            Fiber::Switch(from, to);
+
+            // We may be on a different thread now
+            FinishFiberSwitch();
+            Profiling::Profiler::ResumeZones(zones);
+        }
+
+        bool HasWork(JobSystemState& state)
+        {
+            if (state.externalQueueSize.load(std::memory_order_seq_cst) > 0)
+                return true;
+
+            for (u32 i = 0; i < state.numThreads; i++)
+            {
+                if (!state.contexts[i]->deque.IsEmpty())
+                    return true;
+            }
+            return HasReadyFiber(state);
+        }
+
+        void WakeWorker(JobSystemState& state)
+        {
+            // Pairs with the fence in SleepUntilWork, either the sleeper sees the new job or we see the sleeper
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (state.numSleeping.load(std::memory_order_relaxed) == 0)
+                return;
+
+            {
+                std::lock_guard<std::mutex> lock(state.sleepMutex);
+                state.wakeGeneration++;
+            }
+            state.wakeCondition.notify_one();
+        }
+
+        void SleepUntilWork(JobSystemState& state)
+        {
+            std::unique_lock<std::mutex> lock(state.sleepMutex);
+            u64 generation = state.wakeGeneration;
+
+            state.numSleeping.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            // Re-check after announcing ourselves, a job pushed before that would not have woken us
+            if (!HasWork(state) && !state.stop.load(std::memory_order_acquire))
+            {
+                state.wakeCondition.wait(lock, [&]() { return state.wakeGeneration != generation || state.stop.load(std::memory_order_acquire); });
+            }
+
+            state.numSleeping.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+    bool JobSystem::Init(const JobSystemDesc& desc)
+    {
+        JobSystemState& state = GetState();
+        assert(!state.initialized); // Init called twice
+
+        u32 numWorkers = desc.numWorkers;
+        if (numWorkers == 0)
+        {
+            u32 numCores = std::thread::hardware_concurrency();
+            numWorkers = numCores > 1 ? numCores - 1 : 0;
+        }
+
+        state.numWorkers = numWorkers;
+        state.numThreads = numWorkers + 1 + desc.maxRegisteredThreads;
+        state.registeredThreadSlots.assign(desc.maxRegisteredThreads, false);
+        state.contexts.resize(state.numThreads);
+        for (u32 i = 0; i < state.numThreads; i++)
+        {
+            state.contexts[i] = new ThreadContext();
+            state.contexts[i]->randomState = 0x9E3779B9u * (i + 1); // xorshift needs a non zero seed
+        }
+
+        state.fibersEnabled = desc.useFibers && numWorkers > 0 && Fiber::IsSupported();
+        if (state.fibersEnabled)
+        {
+            state.fiberStackSize = desc.fiberStackSize;
+
+            // Every worker needs one fiber to run its loop on, the rest is what jobs can park
+            u32 numFibers = desc.numFibers + numWorkers;
+            state.fibers.reserve(numFibers);
+            state.freeFibers.reserve(numFibers);
+            for (u32 i = 0; i < numFibers; i++)
+            {
+                Fiber* fiber = Fiber::Create(desc.fiberStackSize, &JobSystem::FiberMain, nullptr);
+                if (fiber == nullptr)
+                    break;
+
+                state.fibers.push_back(fiber);
+                state.freeFibers.push_back(fiber);
+            }
+
+            if (state.fibers.size() < numWorkers)
+            {
+                LOG_WARNING(LOG_CATEGORY_JOBS, "Could only create %u fibers, running without fibers", static_cast<u32>(state.fibers.size()));
+                for (Fiber* fiber : state.fibers)
+                {
+                    Fiber::Destroy(fiber);
+                }
+                state.fibers.clear();
+                state.freeFibers.clear();
+                state.fibersEnabled = false;
+            }
+        }
+        else if (desc.useFibers && numWorkers > 0)
+        {
+            LOG_WARNING(LOG_CATEGORY_JOBS, "Fibers are not supported on this platform, WaitForCounter will block its worker");
+        }
+
+        state.stop.store(false, std::memory_order_relaxed);
+        state.initialized = true;
+
+        // The thread calling Init becomes thread 0, it runs jobs whenever it waits
+        _threadIndex = 0;
+
+        state.workers.reserve(numWorkers);
+        for (u32 i = 1; i <= numWorkers; i++)
+        {
+            state.workers.emplace_back(&JobSystem::WorkerThread, i);
+        }
+
+        LOG_INFO(LOG_CATEGORY_JOBS, "Job system started with %u workers and %u fibers", numWorkers, static_cast<u32>(state.fibers.size()));
+        return true;
+    }
+
+    void JobSystem::Shutdown()
+    {
+        JobSystemState& state = GetState();
+        if (!state.initialized)
+            return;
+
+        assert(_threadIndex == 0); // Shutdown needs to be called from the thread that called Init
+
+        // Finish whatever is still queued so no counter is left hanging
+        while (TryRunJob()) {}
+
+        {
+            std::lock_guard<std::mutex> lock(state.sleepMutex);
+            state.stop.store(true, std::memory_order_release);
+            state.wakeGeneration++;
+        }
+        state.wakeCondition.notify_all();
+
+        for (std::thread& worker : state.workers)
+        {
+            worker.join();
+        }
+        state.workers.clear();
+
+        assert(state.waitingFibers.empty()); // Shutting down while jobs are still parked in WaitForCounter
+        for (Fiber* fiber : state.fibers)
+        {
+            Fiber::Destroy(fiber);
+        }
+        state.fibers.clear();
+        state.freeFibers.clear();
+        state.fibersEnabled = false;
+
+        for (ThreadContext* context : state.contexts)
+        {
+            delete context;
+        }
+        state.contexts.clear();
+
+        state.numThreads = 0;
+        state.numWorkers = 0;
+        state.registeredThreadSlots.clear();
+        state.initialized = false;
+        _threadIndex = INVALID_THREAD_INDEX;
+    }
+
+    bool JobSystem::IsInitialized()
+    {
+        return GetState().initialized;
+    }
+
+    u32 JobSystem::GetNumThreads()
+    {
+        return GetState().numThreads;
+    }
+
+    JOBS_NOINLINE u32 JobSystem::GetThreadIndex()
+    {
+        return _threadIndex;
+    }
+
+    bool JobSystem::RegisterThread()
+    {
+        JobSystemState& state = GetState();
+        assert(state.initialized); // Registering a thread before Init
+        assert(_threadIndex == INVALID_THREAD_INDEX); // This thread already has a thread index
+
+        std::lock_guard<std::mutex> lock(state.registeredThreadsMutex);
+        for (u32 i = 0; i < state.registeredThreadSlots.size(); i++)
+        {
+            if (!state.registeredThreadSlots[i])
+            {
+                state.registeredThreadSlots[i] = true;
+                _threadIndex = state.numWorkers + 1 + i;
+                return true;
+            }
+        }
+
+        LOG_WARNING(LOG_CATEGORY_JOBS, "No free slots to register a thread in, raise JobSystemDesc::maxRegisteredThreads");
+        return false;
+    }
+
+    void JobSystem::UnregisterThread()
+    {
+        JobSystemState& state = GetState();
+        u32 threadIndex = _threadIndex;
+        assert(threadIndex > state.numWorkers && threadIndex != INVALID_THREAD_INDEX); // Only threads from RegisterThread can unregister
+
+        // Nobody would pop these anymore, stealing would still get them but we might as well run them ourselves
+        while (Job* job = state.contexts[threadIndex]->deque.Pop())
+        {
+            RunJob(job);
+        }
+
+        _threadIndex = INVALID_THREAD_INDEX;
+
+        std::lock_guard<std::mutex> lock(state.registeredThreadsMutex);
+        state.registeredThreadSlots[threadIndex - state.numWorkers - 1] = false;
+    }
+
+    void JobSystem::Wait(JobCounter* counter)
+    {
+        u32 idleCount = 0;
+        while (!counter->IsDone())
+        {
+            if (TryRunJob())
+            {
+                idleCount = 0;
+                continue;
+            }
+
+            // Whatever we're waiting on is running on another thread
+            if (++idleCount < IDLE_SPIN_COUNT)
+            {
+                CPU_PAUSE();
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void JobSystem::WaitForCounter(JobCounter* counter)
+    {
+        if (counter->IsDone())
+            return;
+
+        JobSystemState& state = GetState();
+        ThreadContext* context = GetThreadContext();
+        if (!state.fibersEnabled || context == nullptr || context->currentFiber == nullptr)
+        {
+            Wait(counter);
+            return;
+        }
+
+        // Rather than blocking, hand this worker to a fiber that was already waiting or a fresh one that picks up new jobs
+        Fiber* next = PopReadyFiber(state);
+        if (next == nullptr)
+        {
+            next = AcquireFiber(state);
+        }
+
+        if (next == nullptr)
+        {
+            // Pool exhausted, help out on this stack instead
+            Wait(counter);
+            return;
+        }
+
+        SwitchFiber(next, PENDING_FIBER_ACTION_PARK, counter);
+        assert(counter->IsDone()); // We only get resumed once the counter is done
+    }
+
+    bool JobSystem::TryRunJob()
+    {
+        JobSystemState& state = GetState();
+        u32 threadIndex = GetThreadIndex();
+
+        Job* job = nullptr;
+        if (threadIndex != INVALID_THREAD_INDEX)
+        {
+            job = state.contexts[threadIndex]->deque.Pop();
+        }
+
+        if (job == nullptr)
+        {
+            job = StealJob(state, threadIndex);
+        }
+
+        if (job == nullptr)
+        {
+            job = PopExternalJob(state);
+        }
+
+        if (job == nullptr)
+            return false;
+
+        RunJob(job);
+        return true;
+    }
+
+    Job* JobSystem::AllocateJob()
+    {
+        JobSystemState& state = GetState();
+        assert(state.initialized); // Scheduling a job before Init
+
+        while (true)
+        {
+            // Re-read the context every attempt, helping out below can park us and resume us on another thread
+            Job* job = nullptr;
+            if (ThreadContext* context = GetThreadContext())
+            {
+                job = &context->arena[context->nextJob++ & (JOB_ARENA_SIZE - 1)];
+            }
+            else
+            {
+                job = &state.externalArena[state.nextExternalJob.fetch_add(1, std::memory_order_relaxed) & (EXTERNAL_JOB_ARENA_SIZE - 1)];
+            }
+
+            u32 expected = 0;
+            if (job->inUse.compare_exchange_strong(expected, 1, std::memory_order_acquire, std::memory_order_relaxed))
+                return job;
+
+            // The arena wrapped around onto a job that hasn't run yet, help out until one frees up
+            if (!TryRunJob())
+            {
+                CPU_PAUSE();
+            }
+        }
+    }
+
+    void JobSystem::Submit(Job* job)
+    {
+        JobSystemState& state = GetState();
+
+        if (job->counter != nullptr)
+        {
+            job->counter->value.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        u32 threadIndex = GetThreadIndex();
+        if (threadIndex != INVALID_THREAD_INDEX)
+        {
+            if (!state.contexts[threadIndex]->deque.Push(job))
+            {
+                // Our deque is full, running it right away is the cheapest way to make room
+                RunJob(job);
+                return;
+            }
+        }
+        else
+        {
+            std::lock_guard<std::mutex> lock(state.externalMutex);
+            state.externalQueue.push_back(job);
+            state.externalQueueSize.fetch_add(1, std::memory_order_release);
+        }
+
+        WakeWorker(state);
+    }
+
+    void JobSystem::RunJob(Job* job)
+    {
+        job->function(job->data);
+
+        // The slot can be reused and the counter can go out of scope as soon as we release them, so don't touch the job after this
+        JobCounter* counter = job->counter;
+        job->inUse.store(0, std::memory_order_release);
+
+        if (counter != nullptr && counter->value.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            // Pairs with the fence in SleepUntilWork, a fiber parked on this counter must not be left with every worker asleep
+            JobSystemState& state = GetState();
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (state.numWaitingFibers.load(std::memory_order_relaxed) > 0)
+            {
+                WakeWorker(state);
+            }
+        }
+    }
+
+    void JobSystem::WorkerThread(u32 threadIndex)
+    {
+        JobSystemState& state = GetState();
+        _threadIndex = threadIndex;
+
+        char threadName[32];
+        snprintf(threadName, sizeof(threadName), "Worker %u", threadIndex);
+        Profiling::Profiler::SetThreadName(threadName);
+
+        if (state.fibersEnabled)
+        {
+            ThreadContext* context = state.contexts[threadIndex];
+            context->threadFiber = Fiber::ConvertCurrentThread();
+            context->currentFiber = context->threadFiber;
+
+            // Run the loop on a pool fiber, we get back here once it sees the stop flag
+            Fiber* fiber = AcquireFiber(state);
+            assert(fiber != nullptr); // Init creates at least one fiber per worker
+            SwitchFiber(fiber, PENDING_FIBER_ACTION_NONE, nullptr);
+
+            context->currentFiber = nullptr;
+            Fiber::Destroy(context->threadFiber);
+            context->threadFiber = nullptr;
+        }
+        else
+        {
+            WorkerLoop();
+        }
+
+        _threadIndex = INVALID_THREAD_INDEX;
+    }
+
+    void JobSystem::WorkerLoop()
+    {
+        JobSystemState& state = GetState();
+
+        u32 idleCount = 0;
+        while (!state.stop.load(std::memory_order_acquire))
+        {
+            // Parked jobs that can continue go first, they are further along than anything in the deques
+            if (Fiber* readyFiber = PopReadyFiber(state))
+            {
+                SwitchFiber(readyFiber, PENDING_FIBER_ACTION_RELEASE, nullptr);
+                idleCount = 0;
+                continue;
+            }
+
+            if (TryRunJob())
+            {
+                idleCount = 0;
+                continue;
+            }
+
+            if (++idleCount < IDLE_SPIN_COUNT)
+            {
+                CPU_PAUSE();
+                continue;
+            }
+
+            SleepUntilWork(state);
+            idleCount = 0;
+        }
+    }
+
+    void JobSystem::FiberMain(void* /*userData*/)
+    {
+        FinishFiberSwitch();
+
+        // Fibers go back to the pool suspended right here during shutdown, so if one gets picked up again it just goes around once more
+        while (true)
+        {
+            WorkerLoop();
+
+            // Shutting down, return to whichever worker thread we ended up on
+            ThreadContext* context = GetThreadContext();
+            SwitchFiber(context->threadFiber, PENDING_FIBER_ACTION_RELEASE, nullptr);
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,137 @@
+#pragma once
+#include "../Core.h"
+#include <atomic>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace Jobs
+{
+    struct JobSystemDesc
+    {
+        u32 numWorkers = 0; // 0 means one worker per core, not counting the thread calling Init which also runs jobs while waiting
+        u32 maxRegisteredThreads = 2; // Slots for long lived threads we don't own (like a render thread) to join through RegisterThread
+
+        // Workers run jobs on fibers so WaitForCounter can park a job instead of blocking its worker, ignored where fibers aren't supported
+        bool useFibers = true;
+        u32 numFibers = 128; // Upper bound on jobs parked in WaitForCounter at once, when the pool runs dry WaitForCounter falls back to Wait
+        u32 fiberStackSize = 256 * 1024;
+    };
+
+    // Counts the outstanding jobs of a group, wait on it to know when every job in the group has finished
+    struct JobCounter
+    {
+        std::atomic<u32> value = 0;
+
+        bool IsDone() const { return value.load(std::memory_order_acquire) == 0; }
+    };
+
+    typedef void (*JobFunction)(void* data);
+
+    // A job is exactly one cache line, small callables are stored inline so scheduling never touches the heap
+    struct alignas(64) Job
+    {
+        static const u32 MAX_DATA_SIZE = 40;
+
+        JobFunction function = nullptr;
+        JobCounter* counter = nullptr;
+        std::atomic<u32> inUse = 0; // Cleared once the job has run so the arena slot can be reused
+        alignas(8) u8 data[MAX_DATA_SIZE];
+    };
+    static_assert(sizeof(Job) == 64, "Job is supposed to be exactly one cache line");
+
+    // Work-stealing job system, every thread owns a deque it pushes to and pops from while idle threads steal from the others.
+    // Jobs are allocated from a ring buffer arena owned by the scheduling thread, so they are free to create and free to release.
+    class JobSystem
+    {
+    public:
+        static bool Init(const JobSystemDesc& desc);
+        static void Shutdown();
+
+        static bool IsInitialized();
+
+        // Workers plus the thread that called Init plus the slots for registered threads, thread indices are always below this
+        static u32 GetNumThreads();
+
+        // 0 is the thread that called Init, then the workers, then registered threads. Threads the job system doesn't know about get INVALID_THREAD_INDEX
+        static u32 GetThreadIndex();
+        static const u32 INVALID_THREAD_INDEX = 0xFFFFFFFF;
+
+        // Schedules function to run on any thread, counter (if any) is incremented now and decremented once the function has returned
+        template <typename Function>
+        static void Schedule(Function&& function, JobCounter* counter = nullptr)
+        {
+            using FunctionType = std::decay_t<Function>;
+            static_assert(sizeof(FunctionType) <= Job::MAX_DATA_SIZE, "This job captures too much, capture by reference or pass a pointer to the data instead");
+            static_assert(alignof(FunctionType) <= 8, "This job needs a stricter alignment than the inline job data provides");
+
+            Job* job = AllocateJob();
+            job->function = [](void* data)
+            {
+                FunctionType* storedFunction = static_cast<FunctionType*>(data);
+                (*storedFunction)();
+                storedFunction->~FunctionType();
+            };
+            job->counter = counter;
+            new (job->data) FunctionType(std::forward<Function>(function));
+
+            Submit(job);
+        }
+
+        // Gives the calling thread its own deque, job arena and thread index so it can schedule and run jobs like a worker would.
+        // Returns false if every slot is taken, call UnregisterThread before the thread exits.
+        static bool RegisterThread();
+        static void UnregisterThread();
+
+        // Runs other jobs on this thread until the counter reaches zero
+        static void Wait(JobCounter* counter);
+
+        // Parks the calling job until the counter reaches zero and lets its worker pick up other work in the meantime, the job resumes on whichever worker notices first.
+        // Outside of a worker fiber (thread 0, or fibers disabled) this is the same as Wait. Don't hold locks or thread_local pointers across it.
+        static void WaitForCounter(JobCounter* counter);
+
+        // Splits [0, count) into chunks of at least grainSize and calls function(begin, end) for each chunk, returns when all chunks are done.
+        // The calling thread takes the first chunk itself and helps out with the rest while waiting.
+        template <typename Function>
+        static void ParallelFor(u32 count, u32 grainSize, const Function& function)
+        {
+            if (count == 0)
+                return;
+
+            // Cap the number of jobs so big ranges with a tiny grain can't flood the arena
+            u32 minGrainSize = (count + MAX_JOBS_PER_PARALLEL_FOR - 1) / MAX_JOBS_PER_PARALLEL_FOR;
+            grainSize = grainSize < minGrainSize ? minGrainSize : grainSize;
+            grainSize = grainSize == 0 ? 1 : grainSize;
+
+            if (count <= grainSize || GetNumThreads() <= 1)
+            {
+                function(0u, count);
+                return;
+            }
+
+            JobCounter counter;
+            for (u32 begin = grainSize; begin < count; begin += grainSize)
+            {
+                u32 end = (count - begin) > grainSize ? begin + grainSize : count;
+                Schedule([&function, begin, end]() { function(begin, end); }, &counter);
+            }
+
+            function(0u, grainSize);
+            Wait(&counter);
+        }
+
+        // Pops or steals one job and runs it, returns false if there was nothing to run
+        static bool TryRunJob();
+
+    private:
+        static Job* AllocateJob();
+        static void Submit(Job* job);
+        static void RunJob(Job* job);
+        static void WorkerThread(u32 threadIndex);
+        static void WorkerLoop();
+        static void FiberMain(void* userData);
+
+    private:
+        static const u32 MAX_JOBS_PER_PARALLEL_FOR = 1024;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,308 @@
+#include "TaskGraph.h"
+#include "JobSystem.h"
+#include "../Containers/RobinHood.h"
+#include "../Logging/Logger.h"
+#include "../Profiling/Profiler.h"
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <thread>
+
+namespace Jobs
+{
+    using TaskIndex = type_safe::underlying_type<TaskID>;
+
+    void JobSystemTaskExecutor::Submit(TaskExecutorFunction function, void* data)
+    {
+        JobSystem::Schedule([function, data]() { function(data); });
+    }
+
+    void JobSystemTaskExecutor::WaitUntilZero(const std::atomic<u32>& remaining)
+    {
+        while (remaining.load(std::memory_order_acquire) != 0)
+        {
+            if (!JobSystem::TryRunJob())
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void SerialTaskExecutor::Submit(TaskExecutorFunction function, void* data)
+    {
+        _queue.push_back(std::make_pair(function, data));
+    }
+
+    void SerialTaskExecutor::WaitUntilZero(const std::atomic<u32>& remaining)
+    {
+        // Tasks submit their dependents while running, so keep going until nothing new shows up
+        for (size_t i = 0; i < _queue.size(); i++)
+        {
+            std::pair<TaskExecutorFunction, void*> item = _queue[i];
+            item.first(item.second);
+        }
+        _queue.clear();
+
+        assert(remaining.load(std::memory_order_acquire) == 0); // Something never got submitted
+        (void)remaining;
+    }
+
+    TaskGraph::TaskBuilder& TaskGraph::TaskBuilder::Reads(StringID data)
+    {
+        assert(!_graph->_compiled); // The graph can't change after Compile
+        _graph->_tasks[static_cast<TaskIndex>(_id)].reads.push_back(data);
+        return *this;
+    }
+
+    TaskGraph::TaskBuilder& TaskGraph::TaskBuilder::Writes(StringID data)
+    {
+        assert(!_graph->_compiled); // The graph can't change after Compile
+        _graph->_tasks[static_cast<TaskIndex>(_id)].writes.push_back(data);
+        return *this;
+    }
+
+    TaskGraph::TaskBuilder& TaskGraph::TaskBuilder::After(TaskID task)
+    {
+        assert(!_graph->_compiled); // The graph can't change after Compile
+        assert(static_cast<TaskIndex>(task) < static_cast<TaskIndex>(_id)); // Tasks can only come after tasks that were added before them, this keeps the graph acyclic
+        _graph->_tasks[static_cast<TaskIndex>(_id)].after.push_back(task);
+        return *this;
+    }
+
+    TaskGraph::TaskBuilder TaskGraph::AddTask(const char* name, const TaskFunction& function)
+    {
+        assert(!_compiled); // The graph can't change after Compile
+        assert(_tasks.size() < std::numeric_limits<TaskIndex>::max()); // Ran out of TaskIDs
+
+        TaskID id = TaskID(static_cast<TaskIndex>(_tasks.size()));
+
+        Task& task = _tasks.emplace_back();
+        task.name = name;
+        task.function = function;
+
+        return TaskBuilder(this, id);
+    }
+
+    bool TaskGraph::Compile()
+    {
+        assert(!_compiled); // Compile called twice
+
+        struct DataState
+        {
+            TaskID lastWriter = TaskID::Invalid();
+            std::vector<TaskID> readersSinceWrite;
+            bool everWritten = false;
+        };
+        robin_hood::unordered_node_map<u32, DataState> dataStates;
+
+        auto addDependency = [this](TaskIndex from, TaskIndex to)
+        {
+            if (from == to)
+                return;
+
+            std::vector<TaskID>& dependencies = _tasks[to].dependencies;
+            if (std::find(dependencies.begin(), dependencies.end(), TaskID(from)) != dependencies.end())
+                return;
+
+            dependencies.push_back(TaskID(from));
+            _tasks[from].dependents.push_back(TaskID(to));
+        };
+
+        // Declaration order decides who goes first, which makes this a walk in topological order and the graph acyclic by construction
+        for (TaskIndex i = 0; i < static_cast<TaskIndex>(_tasks.size()); i++)
+        {
+            Task& task = _tasks[i];
+
+            for (TaskID after : task.after)
+            {
+                addDependency(static_cast<TaskIndex>(after), i);
+            }
+
+            // Read after write
+            for (StringID data : task.reads)
+            {
+                DataState& state = dataStates[data.GetHash()];
+                if (state.lastWriter != TaskID::Invalid())
+                {
+                    addDependency(static_cast<TaskIndex>(state.lastWriter), i);
+                }
+                state.readersSinceWrite.push_back(TaskID(i));
+            }
+
+            // Write after read and write after write
+            for (StringID data : task.writes)
+            {
+                DataState& state = dataStates[data.GetHash()];
+                if (!state.readersSinceWrite.empty())
+                {
+                    for (TaskID reader : state.readersSinceWrite)
+                    {
+                        addDependency(static_cast<TaskIndex>(reader), i);
+                    }
+                }
+                else if (state.lastWriter != TaskID::Invalid())
+                {
+                    addDependency(static_cast<TaskIndex>(state.lastWriter), i);
+                }
+
+                state.lastWriter = TaskID(i);
+                state.readersSinceWrite.clear();
+                state.everWritten = true;
+            }
+        }
+
+        bool valid = true;
+        for (const Task& task : _tasks)
+        {
+            for (StringID data : task.reads)
+            {
+                if (!dataStates[data.GetHash()].everWritten)
+                {
+                    // Not fatal, the data might be written outside of the graph, but it's usually a typo
+                    LOG_WARNING(LOG_CATEGORY_JOBS, "TaskGraph: Task \"%s\" reads \"%s\" which no task writes", task.name.c_str(), data.GetDebugName());
+                }
+            }
+
+            if (!task.function)
+            {
+                LOG_ERROR(LOG_CATEGORY_JOBS, "TaskGraph: Task \"%s\" has no function", task.name.c_str());
+                valid = false;
+            }
+        }
+
+        if (!valid)
+            return false;
+
+        _taskStates = std::make_unique<TaskState[]>(_tasks.size());
+        for (TaskIndex i = 0; i < static_cast<TaskIndex>(_tasks.size()); i++)
+        {
+            _taskStates[i].graph = this;
+            _taskStates[i].index = i;
+
+            if (_tasks[i].dependencies.empty())
+            {
+                _rootTasks.push_back(TaskID(i));
+            }
+        }
+
+        _pathLengths.resize(_tasks.size());
+        _pathPredecessors.resize(_tasks.size());
+        _report.criticalPath.reserve(_tasks.size());
+
+        _compiled = true;
+        return true;
+    }
+
+    void TaskGraph::Execute(ITaskExecutor& executor)
+    {
+        assert(_compiled); // Compile the graph before executing it
+        PROFILE_SCOPE("TaskGraph::Execute");
+
+        if (_tasks.empty())
+            return;
+
+        u64 start = Profiling::Profiler::GetTimestamp();
+
+        _executor = &executor;
+        for (size_t i = 0; i < _tasks.size(); i++)
+        {
+            _taskStates[i].remainingDependencies.store(static_cast<u32>(_tasks[i].dependencies.size()), std::memory_order_relaxed);
+        }
+        _remainingTasks.store(static_cast<u32>(_tasks.size()), std::memory_order_relaxed);
+
+        for (TaskID root : _rootTasks)
+        {
+            executor.Submit(&TaskGraph::RunTask, &_taskStates[static_cast<TaskIndex>(root)]);
+        }
+
+        executor.WaitUntilZero(_remainingTasks);
+        _executor = nullptr;
+
+        u64 end = Profiling::Profiler::GetTimestamp();
+        BuildReport(start, end);
+    }
+
+    const char* TaskGraph::GetTaskName(TaskID task) const
+    {
+        return _tasks[static_cast<TaskIndex>(task)].name.c_str();
+    }
+
+    const std::vector<TaskID>& TaskGraph::GetDependencies(TaskID task) const
+    {
+        return _tasks[static_cast<TaskIndex>(task)].dependencies;
+    }
+
+    void TaskGraph::RunTask(void* data)
+    {
+        TaskState* state = static_cast<TaskState*>(data);
+        TaskGraph* graph = state->graph;
+        const Task& task = graph->_tasks[state->index];
+
+        {
+            PROFILE_SCOPE_COPY(task.name.c_str());
+            state->start = Profiling::Profiler::GetTimestamp();
+            task.function();
+            state->end = Profiling::Profiler::GetTimestamp();
+        }
+
+        for (TaskID dependent : task.dependents)
+        {
+            TaskState& dependentState = graph->_taskStates[static_cast<TaskIndex>(dependent)];
+            if (dependentState.remainingDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                graph->_executor->Submit(&TaskGraph::RunTask, &dependentState);
+            }
+        }
+
+        // Execute can return as soon as this hits zero, so this has to be the last thing we touch
+        graph->_remainingTasks.fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+    void TaskGraph::BuildReport(u64 start, u64 end)
+    {
+        _report.wallTimeNS = end - start;
+        _report.totalTaskTimeNS = 0;
+
+        // Tasks are stored in topological order, so one pass is enough to find the longest chain
+        u16 lastOnPath = 0;
+        for (u16 i = 0; i < static_cast<u16>(_tasks.size()); i++)
+        {
+            u64 duration = _taskStates[i].end - _taskStates[i].start;
+            _report.totalTaskTimeNS += duration;
+
+            u64 longestDependency = 0;
+            u16 predecessor = i;
+            for (TaskID dependency : _tasks[i].dependencies)
+            {
+                TaskIndex dependencyIndex = static_cast<TaskIndex>(dependency);
+                if (_pathLengths[dependencyIndex] >= longestDependency)
+                {
+                    longestDependency = _pathLengths[dependencyIndex];
+                    predecessor = dependencyIndex;
+                }
+            }
+
+            _pathLengths[i] = longestDependency + duration;
+            _pathPredecessors[i] = predecessor;
+
+            if (_pathLengths[i] > _pathLengths[lastOnPath])
+            {
+                lastOnPath = i;
+            }
+        }
+
+        _report.criticalPathNS = _pathLengths[lastOnPath];
+        _report.criticalPath.clear();
+
+        u16 current = lastOnPath;
+        while (true)
+        {
+            _report.criticalPath.push_back(TaskID(current));
+            if (_pathPredecessors[current] == current)
+                break;
+
+            current = _pathPredecessors[current];
+        }
+        std::reverse(_report.criticalPath.begin(), _report.criticalPath.end());
+    }
+}
\ No newline at end of file
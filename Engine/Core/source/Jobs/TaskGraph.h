@@ -0,0 +1,143 @@
+#pragma once
+#include "../Core.h"
+#include "../Utils/StrongTypedef.h"
+#include "../Utils/StringID.h"
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Jobs
+{
+    STRONG_TYPEDEF(TaskID, u16);
+
+    typedef void (*TaskExecutorFunction)(void* data);
+
+    // Whatever runs the tasks of a TaskGraph, implement this to run a graph on any thread pool
+    class ITaskExecutor
+    {
+    public:
+        virtual ~ITaskExecutor() {}
+
+        // Runs function(data) on any thread, this gets called from inside running tasks as well
+        virtual void Submit(TaskExecutorFunction function, void* data) = 0;
+
+        // Called on the thread executing the graph, return once remaining reaches zero. Pools that can should run tasks here rather than block
+        virtual void WaitUntilZero(const std::atomic<u32>& remaining) = 0;
+    };
+
+    // Runs tasks on the JobSystem, the executing thread helps out while waiting
+    class JobSystemTaskExecutor : public ITaskExecutor
+    {
+    public:
+        void Submit(TaskExecutorFunction function, void* data) override;
+        void WaitUntilZero(const std::atomic<u32>& remaining) override;
+    };
+
+    // Runs every task on the executing thread, useful for debugging ordering issues
+    class SerialTaskExecutor : public ITaskExecutor
+    {
+    public:
+        void Submit(TaskExecutorFunction function, void* data) override;
+        void WaitUntilZero(const std::atomic<u32>& remaining) override;
+
+    private:
+        std::vector<std::pair<TaskExecutorFunction, void*>> _queue;
+    };
+
+    struct TaskGraphReport
+    {
+        u64 wallTimeNS = 0; // From Execute being called until the last task finished
+        u64 totalTaskTimeNS = 0; // Sum of every task's duration, divide by wallTimeNS for the average parallelism we got
+        u64 criticalPathNS = 0; // Sum of the durations along the longest dependency chain, the graph can never run faster than this
+        std::vector<TaskID> criticalPath; // The tasks on that chain, first to last
+    };
+
+    // A graph of per-frame tasks, ordered by what named data they read and write rather than by hand.
+    // Tasks that write something run after every earlier task touching it, tasks that read something run after its earlier writers,
+    // and everything else is free to run concurrently. Add tasks, Compile once, then Execute every frame.
+    class TaskGraph
+    {
+    public:
+        typedef std::function<void()> TaskFunction;
+
+        class TaskBuilder
+        {
+        public:
+            TaskBuilder& Reads(StringID data);
+            TaskBuilder& Writes(StringID data);
+            TaskBuilder& After(TaskID task); // An explicit ordering for dependencies that don't go through named data
+
+            TaskID GetID() const { return _id; }
+
+        private:
+            TaskBuilder(TaskGraph* graph, TaskID id) : _graph(graph), _id(id) {}
+
+            TaskGraph* _graph;
+            TaskID _id;
+
+            friend class TaskGraph;
+        };
+
+        TaskGraph() {}
+        TaskGraph(const TaskGraph&) = delete;
+        TaskGraph& operator=(const TaskGraph&) = delete;
+
+        // The order tasks get added in decides who goes first when two of them touch the same data
+        TaskBuilder AddTask(const char* name, const TaskFunction& function);
+
+        // Builds and validates the dependencies, after this the graph can't be changed anymore
+        bool Compile();
+        bool IsCompiled() const { return _compiled; }
+
+        // Runs every task once and returns when they're all done, no validation or allocation happens here
+        void Execute(ITaskExecutor& executor);
+
+        const TaskGraphReport& GetLastReport() const { return _report; }
+
+        u32 GetNumTasks() const { return static_cast<u32>(_tasks.size()); }
+        const char* GetTaskName(TaskID task) const;
+        const std::vector<TaskID>& GetDependencies(TaskID task) const;
+
+    private:
+        struct Task
+        {
+            std::string name;
+            TaskFunction function;
+            std::vector<StringID> reads;
+            std::vector<StringID> writes;
+            std::vector<TaskID> after;
+
+            // Filled in by Compile
+            std::vector<TaskID> dependencies;
+            std::vector<TaskID> dependents;
+        };
+
+        // Per task state touched while executing, kept apart from Task so building the graph doesn't need to move atomics around
+        struct TaskState
+        {
+            TaskGraph* graph = nullptr;
+            u16 index = 0;
+            std::atomic<u32> remainingDependencies = 0;
+            u64 start = 0;
+            u64 end = 0;
+        };
+
+        static void RunTask(void* data);
+        void BuildReport(u64 start, u64 end);
+
+    private:
+        std::vector<Task> _tasks;
+        std::vector<TaskID> _rootTasks;
+        std::unique_ptr<TaskState[]> _taskStates;
+        bool _compiled = false;
+
+        ITaskExecutor* _executor = nullptr;
+        std::atomic<u32> _remainingTasks = 0;
+
+        TaskGraphReport _report;
+        std::vector<u64> _pathLengths;
+        std::vector<u16> _pathPredecessors;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,98 @@
+#pragma once
+#include "../Core.h"
+#include <atomic>
+#include <cassert>
+
+namespace Jobs
+{
+    // Fixed capacity Chase-Lev work-stealing deque, based on "Correct and Efficient Work-Stealing for Weak Memory Models" (Le et al. 2013).
+    // The owning thread pushes and pops at the bottom, any other thread can steal from the top.
+    template <typename T, u32 Capacity>
+    class WorkStealingDeque
+    {
+        static_assert((Capacity & (Capacity - 1)) == 0, "Capacity needs to be a power of two");
+
+    public:
+        WorkStealingDeque()
+            : _top(0)
+            , _bottom(0)
+        {
+            for (std::atomic<T*>& item : _items)
+            {
+                item.store(nullptr, std::memory_order_relaxed);
+            }
+        }
+
+        // Owner only, returns false if the deque is full
+        bool Push(T* item)
+        {
+            i64 bottom = _bottom.load(std::memory_order_relaxed);
+            i64 top = _top.load(std::memory_order_acquire);
+
+            if (bottom - top >= static_cast<i64>(Capacity))
+                return false;
+
+            _items[bottom & (Capacity - 1)].store(item, std::memory_order_relaxed);
+            _bottom.store(bottom + 1, std::memory_order_release); // Publishes the item to thieves
+
+            return true;
+        }
+
+        // Owner only, pops the most recently pushed item
+        T* Pop()
+        {
+            i64 bottom = _bottom.load(std::memory_order_relaxed) - 1;
+            _bottom.store(bottom, std::memory_order_seq_cst);
+            i64 top = _top.load(std::memory_order_seq_cst);
+
+            if (top > bottom)
+            {
+                // Empty
+                _bottom.store(bottom + 1, std::memory_order_relaxed);
+                return nullptr;
+            }
+
+            T* item = _items[bottom & (Capacity - 1)].load(std::memory_order_relaxed);
+            if (top == bottom)
+            {
+                // Last item, race against thieves for it
+                if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                {
+                    item = nullptr;
+                }
+                _bottom.store(bottom + 1, std::memory_order_relaxed);
+            }
+
+            return item;
+        }
+
+        // Any thread, steals the oldest item
+        T* Steal()
+        {
+            i64 top = _top.load(std::memory_order_seq_cst);
+            i64 bottom = _bottom.load(std::memory_order_seq_cst);
+
+            if (top >= bottom)
+                return nullptr;
+
+            T* item = _items[top & (Capacity - 1)].load(std::memory_order_relaxed);
+            if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            {
+                // Another thief or the owner got it first
+                return nullptr;
+            }
+
+            return item;
+        }
+
+        bool IsEmpty() const
+        {
+            return _top.load(std::memory_order_relaxed) >= _bottom.load(std::memory_order_relaxed);
+        }
+
+    private:
+        alignas(64) std::atomic<i64> _top;
+        alignas(64) std::atomic<i64> _bottom;
+        alignas(64) std::atomic<T*> _items[Capacity];
+    };
+}
\ No newline at end of file
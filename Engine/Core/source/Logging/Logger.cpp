@@ -0,0 +1,282 @@
+#include "Logger.h"
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <cstdarg>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Logging
+{
+    std::atomic<LogSeverity> Logger::_minSeverity = LOG_SEVERITY_INFO;
+    std::atomic<u32> Logger::_categoryMask = LOG_CATEGORY_ALL;
+
+    namespace
+    {
+        struct LoggerState
+        {
+            // Only taken when registering a thread or when draining, never when writing a message
+            std::mutex registryMutex;
+            std::mutex drainMutex;
+            std::vector<LogThreadBuffer*> buffers;
+
+            LoggerDesc desc;
+            FILE* file = nullptr;
+            bool initialized = false;
+
+            std::thread flushThread;
+            std::mutex flushThreadMutex;
+            std::condition_variable flushThreadCondition;
+            bool stopFlushThread = false;
+
+            std::vector<std::pair<LogThreadBuffer*, LogMessage*>> pending;
+        };
+
+        LoggerState& GetState()
+        {
+            static LoggerState state;
+            return state;
+        }
+
+        thread_local LogThreadBuffer* _threadBuffer = nullptr;
+
+        u64 GetTimestamp()
+        {
+            return static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+        }
+
+        const char* SeverityToString(u8 severity)
+        {
+            switch (severity)
+            {
+                case LOG_SEVERITY_TRACE: return "TRACE";
+                case LOG_SEVERITY_DEBUG: return "DEBUG";
+                case LOG_SEVERITY_INFO: return "INFO";
+                case LOG_SEVERITY_WARNING: return "WARNING";
+                case LOG_SEVERITY_ERROR: return "ERROR";
+                case LOG_SEVERITY_FATAL: return "FATAL";
+                default:
+                    assert(false); // Invalid severity, did we just add to the enum?
+            }
+            return "";
+        }
+
+        const char* CategoryToString(u32 category)
+        {
+            switch (category)
+            {
+                case LOG_CATEGORY_GENERAL: return "General";
+                case LOG_CATEGORY_MEMORY: return "Memory";
+                case LOG_CATEGORY_RENDERER: return "Renderer";
+                case LOG_CATEGORY_PROFILING: return "Profiling";
+                case LOG_CATEGORY_JOBS: return "Jobs";
+                case LOG_CATEGORY_ASSETS: return "Assets";
+                default: return "Unknown";
+            }
+        }
+
+        void Output(LoggerState& state, u32 threadIndex, const LogMessage& message)
+        {
+            char line[LogMessage::MAX_LENGTH + 64];
+            int length = snprintf(line, sizeof(line), "[%.6f][%s][%s][T%u] %.*s\n", static_cast<f64>(message.timestamp) / 1000000000.0,
+                SeverityToString(message.severity), CategoryToString(message.category), threadIndex, static_cast<int>(message.length), message.text);
+
+            if (length <= 0)
+                return;
+
+            size_t size = std::min(static_cast<size_t>(length), sizeof(line) - 1);
+            if (state.desc.logToStdout)
+            {
+                fwrite(line, 1, size, stdout);
+            }
+            if (state.file != nullptr)
+            {
+                fwrite(line, 1, size, state.file);
+            }
+        }
+    }
+
+    bool Logger::Init(const LoggerDesc& desc)
+    {
+        LoggerState& state = GetState();
+        assert(!state.initialized); // We already initialized the logger!
+
+        state.desc = desc;
+        SetMinSeverity(desc.minSeverity);
+        SetCategoryMask(desc.categoryMask);
+
+        if (!desc.filePath.empty())
+        {
+            state.file = fopen(desc.filePath.c_str(), "w");
+            if (state.file == nullptr)
+                return false;
+        }
+
+        state.stopFlushThread = false;
+        state.flushThread = std::thread(&Logger::FlushThread);
+        state.initialized = true;
+
+        return true;
+    }
+
+    void Logger::Shutdown()
+    {
+        LoggerState& state = GetState();
+        if (!state.initialized)
+            return;
+
+        {
+            std::lock_guard<std::mutex> lock(state.flushThreadMutex);
+            state.stopFlushThread = true;
+        }
+        state.flushThreadCondition.notify_one();
+        state.flushThread.join();
+
+        Flush();
+
+        if (state.file != nullptr)
+        {
+            fclose(state.file);
+            state.file = nullptr;
+        }
+        state.initialized = false;
+    }
+
+    void Logger::Write(LogSeverity severity, LogCategory category, const char* format, ...)
+    {
+        LogThreadBuffer* buffer = GetThreadBuffer();
+
+        u64 writeIndex = buffer->writeIndex.load(std::memory_order_relaxed);
+        u64 readIndex = buffer->readIndex.load(std::memory_order_acquire);
+
+        if (writeIndex - readIndex >= LogThreadBuffer::CAPACITY)
+        {
+            buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+        else
+        {
+            LogMessage& message = buffer->messages[writeIndex & (LogThreadBuffer::CAPACITY - 1)];
+            message.timestamp = GetTimestamp();
+            message.severity = static_cast<u8>(severity);
+            message.category = static_cast<u32>(category);
+
+            va_list args;
+            va_start(args, format);
+            int length = vsnprintf(message.text, LogMessage::MAX_LENGTH, format, args);
+            va_end(args);
+
+            // Messages longer than MAX_LENGTH get truncated
+            message.length = static_cast<u16>(std::min(std::max(length, 0), LogMessage::MAX_LENGTH - 1));
+
+            buffer->writeIndex.store(writeIndex + 1, std::memory_order_release);
+        }
+
+        if (severity == LOG_SEVERITY_FATAL)
+        {
+            Flush();
+        }
+    }
+
+    void Logger::Flush()
+    {
+        LoggerState& state = GetState();
+        std::lock_guard<std::mutex> drainLock(state.drainMutex);
+
+        // Gather everything that has been published so far
+        std::vector<std::pair<LogThreadBuffer*, u64>> readEnds;
+        {
+            std::lock_guard<std::mutex> registryLock(state.registryMutex);
+            for (LogThreadBuffer* buffer : state.buffers)
+            {
+                u64 readIndex = buffer->readIndex.load(std::memory_order_relaxed);
+                u64 writeIndex = buffer->writeIndex.load(std::memory_order_acquire);
+
+                for (u64 i = readIndex; i < writeIndex; i++)
+                {
+                    state.pending.push_back(std::make_pair(buffer, &buffer->messages[i & (LogThreadBuffer::CAPACITY - 1)]));
+                }
+                readEnds.push_back(std::make_pair(buffer, writeIndex));
+            }
+        }
+
+        if (state.pending.empty())
+            return;
+
+        // Interleave messages from different threads in the order they were written
+        std::stable_sort(state.pending.begin(), state.pending.end(), [](const std::pair<LogThreadBuffer*, LogMessage*>& a, const std::pair<LogThreadBuffer*, LogMessage*>& b)
+        {
+            return a.second->timestamp < b.second->timestamp;
+        });
+
+        for (const std::pair<LogThreadBuffer*, LogMessage*>& entry : state.pending)
+        {
+            Output(state, entry.first->threadIndex, *entry.second);
+        }
+        state.pending.clear();
+
+        if (state.desc.logToStdout)
+        {
+            fflush(stdout);
+        }
+        if (state.file != nullptr)
+        {
+            fflush(state.file);
+        }
+
+        // Hand the slots back to the producers
+        for (const std::pair<LogThreadBuffer*, u64>& readEnd : readEnds)
+        {
+            readEnd.first->readIndex.store(readEnd.second, std::memory_order_release);
+        }
+    }
+
+    u64 Logger::GetDroppedCount()
+    {
+        LoggerState& state = GetState();
+        std::lock_guard<std::mutex> registryLock(state.registryMutex);
+
+        u64 dropped = 0;
+        for (LogThreadBuffer* buffer : state.buffers)
+        {
+            dropped += buffer->dropped.load(std::memory_order_relaxed);
+        }
+
+        return dropped;
+    }
+
+    LogThreadBuffer* Logger::GetThreadBuffer()
+    {
+        if (_threadBuffer == nullptr)
+        {
+            // Thread buffers are never freed so messages from threads that have exited still get flushed
+            LogThreadBuffer* buffer = new LogThreadBuffer();
+
+            LoggerState& state = GetState();
+            std::lock_guard<std::mutex> lock(state.registryMutex);
+            buffer->threadIndex = static_cast<u32>(state.buffers.size());
+            state.buffers.push_back(buffer);
+
+            _threadBuffer = buffer;
+        }
+
+        return _threadBuffer;
+    }
+
+    void Logger::FlushThread()
+    {
+        LoggerState& state = GetState();
+
+        std::unique_lock<std::mutex> lock(state.flushThreadMutex);
+        while (!state.stopFlushThread)
+        {
+            state.flushThreadCondition.wait_for(lock, std::chrono::milliseconds(state.desc.flushIntervalMS));
+
+            lock.unlock();
+            Flush();
+            lock.lock();
+        }
+    }
+}
\ No newline at end of file
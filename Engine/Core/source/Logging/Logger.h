@@ -0,0 +1,136 @@
+#pragma once
+#include "../Core.h"
+#include <atomic>
+#include <string>
+
+enum LogSeverity
+{
+    LOG_SEVERITY_TRACE,
+    LOG_SEVERITY_DEBUG,
+    LOG_SEVERITY_INFO,
+    LOG_SEVERITY_WARNING,
+    LOG_SEVERITY_ERROR,
+    LOG_SEVERITY_FATAL
+};
+
+// Categories are bits so they can be filtered as a mask at runtime
+enum LogCategory
+{
+    LOG_CATEGORY_GENERAL = 1,
+    LOG_CATEGORY_MEMORY = 2,
+    LOG_CATEGORY_RENDERER = 4,
+    LOG_CATEGORY_PROFILING = 8,
+    LOG_CATEGORY_JOBS = 16,
+    LOG_CATEGORY_ASSETS = 32,
+
+    LOG_CATEGORY_ALL = 0xFFFFFFFF
+};
+
+// Everything below this severity is compiled out, override it by defining LOG_COMPILE_MIN_SEVERITY before including this header
+#ifndef LOG_COMPILE_MIN_SEVERITY
+#if defined(FINAL)
+#define LOG_COMPILE_MIN_SEVERITY 3 // LOG_SEVERITY_WARNING
+#elif defined(_DEBUG)
+#define LOG_COMPILE_MIN_SEVERITY 0 // LOG_SEVERITY_TRACE
+#else
+#define LOG_COMPILE_MIN_SEVERITY 1 // LOG_SEVERITY_DEBUG
+#endif
+#endif
+
+namespace Logging
+{
+    struct LoggerDesc
+    {
+        bool logToStdout = true;
+        std::string filePath = ""; // Leave empty to not log to a file
+        u32 flushIntervalMS = 5;
+        LogSeverity minSeverity = LOG_SEVERITY_INFO;
+        u32 categoryMask = LOG_CATEGORY_ALL;
+    };
+
+    struct LogMessage
+    {
+        static const int MAX_LENGTH = 240;
+
+        u64 timestamp = 0;
+        u16 length = 0;
+        u8 severity = 0;
+        u32 category = 0;
+        char text[MAX_LENGTH];
+    };
+
+    // Single producer (the owning thread), single consumer (whoever flushes) ring buffer
+    struct LogThreadBuffer
+    {
+        static const u32 CAPACITY = 4096; // Needs to be a power of two
+
+        LogMessage messages[CAPACITY];
+        alignas(64) std::atomic<u64> writeIndex = 0;
+        alignas(64) std::atomic<u64> readIndex = 0;
+        std::atomic<u64> dropped = 0;
+        u32 threadIndex = 0;
+    };
+
+    // Messages get formatted on the calling thread into that thread's ring buffer without taking any locks,
+    // a background thread drains all buffers and writes them to stdout and/or a file.
+    // If a ring buffer is full the message is dropped and counted instead of stalling the caller.
+    class Logger
+    {
+    public:
+        static bool Init(const LoggerDesc& desc);
+        static void Shutdown();
+
+        static bool ShouldLog(LogSeverity severity, LogCategory category)
+        {
+            return severity >= _minSeverity.load(std::memory_order_relaxed) && (category & _categoryMask.load(std::memory_order_relaxed)) != 0;
+        }
+
+        static void SetMinSeverity(LogSeverity severity) { _minSeverity.store(severity, std::memory_order_relaxed); }
+        static void SetCategoryMask(u32 categoryMask) { _categoryMask.store(categoryMask, std::memory_order_relaxed); }
+
+        static void Write(LogSeverity severity, LogCategory category, const char* format, ...);
+
+        // Synchronously drains every buffer, fatal messages call this automatically
+        static void Flush();
+
+        static u64 GetDroppedCount();
+
+    private:
+        static LogThreadBuffer* GetThreadBuffer();
+        static void FlushThread();
+
+    private:
+        static std::atomic<LogSeverity> _minSeverity;
+        static std::atomic<u32> _categoryMask;
+    };
+}
+
+#define _LOG(severity, category, ...) do { if (Logging::Logger::ShouldLog(severity, category)) { Logging::Logger::Write(severity, category, __VA_ARGS__); } } while (0)
+
+#if LOG_COMPILE_MIN_SEVERITY <= 0
+#define LOG_TRACE(category, ...) _LOG(LOG_SEVERITY_TRACE, category, __VA_ARGS__)
+#else
+#define LOG_TRACE(category, ...) ((void)0)
+#endif
+
+#if LOG_COMPILE_MIN_SEVERITY <= 1
+#define LOG_DEBUG(category, ...) _LOG(LOG_SEVERITY_DEBUG, category, __VA_ARGS__)
+#else
+#define LOG_DEBUG(category, ...) ((void)0)
+#endif
+
+#if LOG_COMPILE_MIN_SEVERITY <= 2
+#define LOG_INFO(category, ...) _LOG(LOG_SEVERITY_INFO, category, __VA_ARGS__)
+#else
+#define LOG_INFO(category, ...) ((void)0)
+#endif
+
+#if LOG_COMPILE_MIN_SEVERITY <= 3
+#define LOG_WARNING(category, ...) _LOG(LOG_SEVERITY_WARNING, category, __VA_ARGS__)
+#else
+#define LOG_WARNING(category, ...) ((void)0)
+#endif
+
+// Errors and fatals are never compiled out
+#define LOG_ERROR(category, ...) _LOG(LOG_SEVERITY_ERROR, category, __VA_ARGS__)
+#define LOG_FATAL(category, ...) _LOG(LOG_SEVERITY_FATAL, category, __VA_ARGS__)
\ No newline at end of file
@@ -0,0 +1,52 @@
+#include "PerThreadStackAllocator.h"
+#include "../Jobs/JobSystem.h"
+#include <cassert>
+
+namespace Memory
+{
+    PerThreadStackAllocator::PerThreadStackAllocator(const std::size_t sizePerThread, std::string name)
+        : _sizePerThread(sizePerThread)
+        , _name(name)
+    {
+
+    }
+
+    PerThreadStackAllocator::~PerThreadStackAllocator()
+    {
+        for (StackAllocator* allocator : _allocators)
+        {
+            delete allocator;
+        }
+        _allocators.clear();
+    }
+
+    void PerThreadStackAllocator::Init()
+    {
+        assert(_allocators.empty()); // We already initialized this allocator!
+        assert(Jobs::JobSystem::IsInitialized()); // We need to know how many threads there are
+
+        u32 numThreads = Jobs::JobSystem::GetNumThreads();
+        _allocators.reserve(numThreads);
+        for (u32 i = 0; i < numThreads; i++)
+        {
+            StackAllocator* allocator = new StackAllocator(_sizePerThread, _name + " " + std::to_string(i));
+            allocator->Init();
+            _allocators.push_back(allocator);
+        }
+    }
+
+    void PerThreadStackAllocator::Reset()
+    {
+        for (StackAllocator* allocator : _allocators)
+        {
+            allocator->Reset();
+        }
+    }
+
+    Allocator* PerThreadStackAllocator::Get()
+    {
+        u32 threadIndex = Jobs::JobSystem::GetThreadIndex();
+        assert(threadIndex < _allocators.size()); // Either this isn't a JobSystem thread or Init hasn't been called
+        return _allocators[threadIndex];
+    }
+}
\ No newline at end of file
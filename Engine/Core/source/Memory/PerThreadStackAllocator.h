@@ -0,0 +1,32 @@
+#pragma once
+#include "../Core.h"
+#include "StackAllocator.h"
+#include <string>
+#include <vector>
+
+namespace Memory
+{
+    // One StackAllocator per JobSystem thread, so jobs can grab frame memory without any locking.
+    // Init it after the JobSystem, and Reset it once per frame when no jobs are using it.
+    class PerThreadStackAllocator
+    {
+    public:
+        PerThreadStackAllocator(const std::size_t sizePerThread, std::string name = "");
+        ~PerThreadStackAllocator();
+
+        void Init();
+        void Reset();
+
+        // The allocator belonging to the calling thread, only JobSystem threads have one
+        Allocator* Get();
+
+    private:
+        PerThreadStackAllocator(const PerThreadStackAllocator&) = delete;
+        PerThreadStackAllocator& operator=(const PerThreadStackAllocator&) = delete;
+
+    private:
+        std::size_t _sizePerThread;
+        std::string _name;
+        std::vector<StackAllocator*> _allocators;
+    };
+}
\ No newline at end of file
@@ -25,10 +25,8 @@
 #include "StackAllocator.h"
 #include <stdlib.h>
 #include <algorithm>
-#ifdef _DEBUG
-#include <iostream>
-#endif
 #include <cassert>
+#include "../Logging/Logger.h"
 
 namespace Memory
 {
@@ -112,7 +110,7 @@ namespace Memory
 #ifdef _DEBUG
         if (_debug)
         {
-            std::cout << _name << "\tAllocated " << "\t@C " << reinterpret_cast<void*>(currentAddress) << "\t@R " << reinterpret_cast<void*>(nextAddress) << "\tO " << _offset << "\tP " << padding << std::endl;
+            LOG_INFO(LOG_CATEGORY_MEMORY, "%s\tAllocated \t@C %p\t@R %p\tO %zu\tP %zu", _name.c_str(), reinterpret_cast<void*>(currentAddress), reinterpret_cast<void*>(nextAddress), _offset, padding);
         }
 #endif
         _used = _offset;
@@ -134,7 +132,7 @@ namespace Memory
 #ifdef _DEBUG
         if (_debug)
         {
-            std::cout << _name << "\tFreed " << "\t@C " << (void*)currentAddress << "\t@F " << (void*)((char*)_startPtr + _offset) << "\tO " << _offset << std::endl;
+            LOG_INFO(LOG_CATEGORY_MEMORY, "%s\tFreed \t@C %p\t@F %p\tO %zu", _name.c_str(), (void*)currentAddress, (void*)((char*)_startPtr + _offset), _offset);
         }
 #endif
     }
@@ -0,0 +1,229 @@
+#include "FrameStats.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <vector>
+
+namespace Profiling
+{
+    FrameStats::FrameRecord FrameStats::_frames[FrameStats::WINDOW_SIZE];
+    u64 FrameStats::_frameCount = 0;
+    u64 FrameStats::_lastFrameTimestamp = 0;
+    std::atomic<u64> FrameStats::_currentCounters[FRAME_COUNTER_COUNT] = {};
+    u64 FrameStats::_histogram[FrameStats::HISTOGRAM_BUCKETS] = {};
+    std::string FrameStats::_csvPath = "";
+    u32 FrameStats::_csvInterval = 0;
+
+    const char* FrameCounterToString(FrameCounter counter)
+    {
+        switch (counter)
+        {
+            case FRAME_COUNTER_DRAWS: return "Draws";
+            case FRAME_COUNTER_DRAWS_BATCHED: return "DrawsBatched";
+            case FRAME_COUNTER_PIPELINE_BINDS: return "PipelineBinds";
+            case FRAME_COUNTER_CONSTANT_BUFFER_BINDS: return "ConstantBufferBinds";
+            case FRAME_COUNTER_COMMANDS_RECORDED: return "CommandsRecorded";
+            case FRAME_COUNTER_COMMANDS_FILTERED: return "CommandsFiltered";
+            case FRAME_COUNTER_RENDERGRAPH_PASSES_EXECUTED: return "PassesExecuted";
+            case FRAME_COUNTER_RENDERGRAPH_PASSES_CULLED: return "PassesCulled";
+            case FRAME_COUNTER_RENDERGRAPH_COMPILES: return "GraphCompiles";
+            case FRAME_COUNTER_RENDERGRAPH_PASSES_MERGED: return "PassesMerged";
+            case FRAME_COUNTER_RENDERGRAPH_VIEWS: return "ViewsRecorded";
+            case FRAME_COUNTER_RESOURCE_BARRIERS: return "ResourceBarriers";
+            case FRAME_COUNTER_RENDER_PASSES: return "RenderPasses";
+            case FRAME_COUNTER_TRANSIENT_BYTES_SAVED: return "TransientBytesSaved";
+            case FRAME_COUNTER_BYTES_UPLOADED: return "BytesUploaded";
+            case FRAME_COUNTER_BUNDLES_RECORDED: return "BundlesRecorded";
+            case FRAME_COUNTER_BUNDLES_EXECUTED: return "BundlesExecuted";
+            default:
+                assert(false); // Invalid counter, did we just add to the enum?
+        }
+        return "";
+    }
+
+    void FrameStats::EndFrame()
+    {
+        u64 now = Profiler::GetTimestamp();
+
+        // The very first frame has nothing to measure against
+        if (_lastFrameTimestamp == 0)
+        {
+            _lastFrameTimestamp = now;
+            for (std::atomic<u64>& counter : _currentCounters)
+            {
+                counter.store(0, std::memory_order_relaxed);
+            }
+            return;
+        }
+
+        u64 frameTime = now - _lastFrameTimestamp;
+        _lastFrameTimestamp = now;
+
+        EndFrame(frameTime);
+    }
+
+    void FrameStats::EndFrame(u64 frameTimeNS)
+    {
+        FrameRecord& record = _frames[_frameCount & (WINDOW_SIZE - 1)];
+        record.frameTimeNS = frameTimeNS;
+
+        for (u32 i = 0; i < FRAME_COUNTER_COUNT; i++)
+        {
+            record.counters[i] = _currentCounters[i].exchange(0, std::memory_order_relaxed);
+        }
+
+        f32 frameTimeMS = static_cast<f32>(static_cast<f64>(frameTimeNS) / 1000000.0);
+        u32 bucket = std::min(static_cast<u32>(frameTimeMS / HISTOGRAM_BUCKET_WIDTH), HISTOGRAM_BUCKETS - 1);
+        _histogram[bucket]++;
+
+        _frameCount++;
+
+        if (_csvInterval > 0 && (_frameCount % _csvInterval) == 0)
+        {
+            WriteCSVRow();
+        }
+    }
+
+    f32 FrameStats::GetFrameTimePercentile(f32 percentile)
+    {
+        u32 numFrames = static_cast<u32>(std::min<u64>(_frameCount, WINDOW_SIZE));
+        if (numFrames == 0)
+            return 0.0f;
+
+        std::vector<u64> frameTimes(numFrames);
+        for (u32 i = 0; i < numFrames; i++)
+        {
+            frameTimes[i] = _frames[i].frameTimeNS;
+        }
+
+        // Nearest-rank percentile
+        f32 clampedPercentile = std::min(std::max(percentile, 0.0f), 100.0f);
+        u32 rank = static_cast<u32>((clampedPercentile / 100.0f) * static_cast<f32>(numFrames - 1) + 0.5f);
+
+        std::nth_element(frameTimes.begin(), frameTimes.begin() + rank, frameTimes.end());
+        return static_cast<f32>(static_cast<f64>(frameTimes[rank]) / 1000000.0);
+    }
+
+    FrameStatsSummary FrameStats::GetSummary()
+    {
+        FrameStatsSummary summary;
+        summary.numFrames = static_cast<u32>(std::min<u64>(_frameCount, WINDOW_SIZE));
+        if (summary.numFrames == 0)
+            return summary;
+
+        std::vector<u64> frameTimes(summary.numFrames);
+        u64 totalFrameTime = 0;
+        u64 counterTotals[FRAME_COUNTER_COUNT] = {};
+
+        for (u32 i = 0; i < summary.numFrames; i++)
+        {
+            const FrameRecord& record = _frames[i];
+            frameTimes[i] = record.frameTimeNS;
+            totalFrameTime += record.frameTimeNS;
+
+            for (u32 j = 0; j < FRAME_COUNTER_COUNT; j++)
+            {
+                counterTotals[j] += record.counters[j];
+            }
+        }
+
+        std::sort(frameTimes.begin(), frameTimes.end());
+
+        auto percentile = [&](f32 p)
+        {
+            u32 rank = static_cast<u32>((p / 100.0f) * static_cast<f32>(summary.numFrames - 1) + 0.5f);
+            return static_cast<f32>(static_cast<f64>(frameTimes[rank]) / 1000000.0);
+        };
+
+        summary.average = static_cast<f32>(static_cast<f64>(totalFrameTime) / summary.numFrames / 1000000.0);
+        summary.p50 = percentile(50.0f);
+        summary.p95 = percentile(95.0f);
+        summary.p99 = percentile(99.0f);
+        summary.max = static_cast<f32>(static_cast<f64>(frameTimes.back()) / 1000000.0);
+
+        for (u32 i = 0; i < FRAME_COUNTER_COUNT; i++)
+        {
+            summary.counters[i] = static_cast<f64>(counterTotals[i]) / summary.numFrames;
+        }
+
+        return summary;
+    }
+
+    u64 FrameStats::GetLastFrameCounter(FrameCounter counter)
+    {
+        if (_frameCount == 0)
+            return 0;
+
+        return _frames[(_frameCount - 1) & (WINDOW_SIZE - 1)].counters[counter];
+    }
+
+    u64 FrameStats::GetHistogramBucket(u32 bucket)
+    {
+        assert(bucket < HISTOGRAM_BUCKETS); // Bucket out of range
+        return _histogram[bucket];
+    }
+
+    bool FrameStats::SetCSVOutput(const std::string& path, u32 intervalFrames)
+    {
+        _csvPath = path;
+        _csvInterval = path.empty() ? 0 : intervalFrames;
+
+        if (_csvPath.empty())
+            return true;
+
+        // Start the file with a header
+        FILE* file = fopen(_csvPath.c_str(), "w");
+        if (file == nullptr)
+        {
+            _csvInterval = 0;
+            return false;
+        }
+
+        fprintf(file, "Frame,AverageMS,P50MS,P95MS,P99MS,MaxMS");
+        for (u32 i = 0; i < FRAME_COUNTER_COUNT; i++)
+        {
+            fprintf(file, ",%s", FrameCounterToString(static_cast<FrameCounter>(i)));
+        }
+        fprintf(file, "\n");
+        fclose(file);
+
+        return true;
+    }
+
+    bool FrameStats::WriteCSVRow()
+    {
+        if (_csvPath.empty())
+            return false;
+
+        FILE* file = fopen(_csvPath.c_str(), "a");
+        if (file == nullptr)
+            return false;
+
+        FrameStatsSummary summary = GetSummary();
+        fprintf(file, "%llu,%.3f,%.3f,%.3f,%.3f,%.3f", static_cast<unsigned long long>(_frameCount), summary.average, summary.p50, summary.p95, summary.p99, summary.max);
+        for (u32 i = 0; i < FRAME_COUNTER_COUNT; i++)
+        {
+            fprintf(file, ",%.1f", summary.counters[i]);
+        }
+        fprintf(file, "\n");
+        fclose(file);
+
+        return true;
+    }
+
+    void FrameStats::Reset()
+    {
+        _frameCount = 0;
+        _lastFrameTimestamp = 0;
+
+        for (std::atomic<u64>& counter : _currentCounters)
+        {
+            counter.store(0, std::memory_order_relaxed);
+        }
+        for (u64& bucket : _histogram)
+        {
+            bucket = 0;
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,102 @@
+#pragma once
+#include "../Core.h"
+#include <atomic>
+#include <string>
+
+namespace Profiling
+{
+    enum FrameCounter
+    {
+        FRAME_COUNTER_DRAWS,
+        FRAME_COUNTER_DRAWS_BATCHED,
+        FRAME_COUNTER_PIPELINE_BINDS,
+        FRAME_COUNTER_CONSTANT_BUFFER_BINDS,
+        FRAME_COUNTER_COMMANDS_RECORDED,
+        FRAME_COUNTER_COMMANDS_FILTERED,
+        FRAME_COUNTER_RENDERGRAPH_PASSES_EXECUTED,
+        FRAME_COUNTER_RENDERGRAPH_PASSES_CULLED,
+        FRAME_COUNTER_RENDERGRAPH_COMPILES,
+        FRAME_COUNTER_RENDERGRAPH_PASSES_MERGED,
+        FRAME_COUNTER_RENDERGRAPH_VIEWS,
+        FRAME_COUNTER_RESOURCE_BARRIERS,
+        FRAME_COUNTER_RENDER_PASSES,
+        FRAME_COUNTER_TRANSIENT_BYTES_SAVED,
+        FRAME_COUNTER_BYTES_UPLOADED,
+        FRAME_COUNTER_BUNDLES_RECORDED,
+        FRAME_COUNTER_BUNDLES_EXECUTED,
+
+        FRAME_COUNTER_COUNT
+    };
+
+    const char* FrameCounterToString(FrameCounter counter);
+
+    struct FrameStatsSummary
+    {
+        u32 numFrames = 0; // Number of frames in the rolling window
+
+        // Frame times in milliseconds
+        f32 average = 0.0f;
+        f32 p50 = 0.0f;
+        f32 p95 = 0.0f;
+        f32 p99 = 0.0f;
+        f32 max = 0.0f;
+
+        // Per-frame averages over the rolling window
+        f64 counters[FRAME_COUNTER_COUNT] = {};
+    };
+
+    // Keeps a rolling window of frame times and per-frame counters.
+    // Counters can be added to from any thread, everything else should be called from the thread driving the main loop.
+    class FrameStats
+    {
+    public:
+        static const u32 WINDOW_SIZE = 1024; // Number of frames kept in the rolling window, needs to be a power of two
+        static const u32 HISTOGRAM_BUCKETS = 64;
+        static constexpr f32 HISTOGRAM_BUCKET_WIDTH = 0.5f; // Milliseconds per bucket, the last bucket also counts everything above it
+
+        static void AddCounter(FrameCounter counter, u64 value)
+        {
+            _currentCounters[counter].fetch_add(value, std::memory_order_relaxed);
+        }
+
+        // Ends the current frame, measuring the time since the last call
+        static void EndFrame();
+        // Ends the current frame with an externally measured frame time
+        static void EndFrame(u64 frameTimeNS);
+
+        static u64 GetFrameCount() { return _frameCount; }
+
+        // Percentile is in the range [0, 100], returns milliseconds
+        static f32 GetFrameTimePercentile(f32 percentile);
+        static FrameStatsSummary GetSummary();
+
+        // Returns the counter values of the last finished frame
+        static u64 GetLastFrameCounter(FrameCounter counter);
+
+        // Histogram of all frame times since the last Reset
+        static u64 GetHistogramBucket(u32 bucket);
+
+        // Appends a summary row to a CSV file every intervalFrames frames, an empty path disables it
+        static bool SetCSVOutput(const std::string& path, u32 intervalFrames);
+        static bool WriteCSVRow();
+
+        static void Reset();
+
+    private:
+        struct FrameRecord
+        {
+            u64 frameTimeNS = 0;
+            u64 counters[FRAME_COUNTER_COUNT] = {};
+        };
+
+        static FrameRecord _frames[WINDOW_SIZE];
+        static u64 _frameCount;
+        static u64 _lastFrameTimestamp;
+
+        static std::atomic<u64> _currentCounters[FRAME_COUNTER_COUNT];
+        static u64 _histogram[HISTOGRAM_BUCKETS];
+
+        static std::string _csvPath;
+        static u32 _csvInterval;
+    };
+}
\ No newline at end of file
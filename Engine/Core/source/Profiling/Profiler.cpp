@@ -0,0 +1,208 @@
+#include "Profiler.h"
+#include <cassert>
+#include <cstring>
+#include <cstdio>
+#include <mutex>
+#include <vector>
+
+namespace Profiling
+{
+    std::atomic<bool> Profiler::_enabled = true;
+    std::atomic<u64> Profiler::_frameCount = 0;
+
+    namespace
+    {
+        const u32 MAX_FRAME_MARKERS = 1024; // Needs to be a power of two
+
+        // Registration only happens once per thread, so a mutex is fine here
+        std::mutex& GetRegistryMutex()
+        {
+            static std::mutex mutex;
+            return mutex;
+        }
+
+        std::vector<ProfilerThreadBuffer*>& GetThreadBuffers()
+        {
+            static std::vector<ProfilerThreadBuffer*> buffers;
+            return buffers;
+        }
+
+        u64 _frameMarkers[MAX_FRAME_MARKERS];
+        thread_local ProfilerThreadBuffer* _threadBuffer = nullptr;
+
+        void WriteEscaped(FILE* file, const char* str)
+        {
+            for (const char* c = str; *c != '\0'; c++)
+            {
+                if (*c == '"' || *c == '\\')
+                {
+                    fputc('\\', file);
+                }
+                fputc(*c, file);
+            }
+        }
+    }
+
+    void Profiler::SetThreadName(const char* name)
+    {
+        ProfilerThreadBuffer* buffer = GetThreadBuffer();
+        strncpy(buffer->threadName, name, sizeof(buffer->threadName) - 1);
+    }
+
+    void Profiler::MarkFrame()
+    {
+        u64 frame = _frameCount.load(std::memory_order_relaxed);
+        _frameMarkers[frame & (MAX_FRAME_MARKERS - 1)] = GetTimestamp();
+        _frameCount.store(frame + 1, std::memory_order_release);
+    }
+
+    void Profiler::RecordEvent(ProfilerThreadBuffer* buffer, const char* name, u64 start, u64 end, bool copyName)
+    {
+        u64 index = buffer->writeIndex.load(std::memory_order_relaxed);
+        ProfilerEvent& event = buffer->events[index & (ProfilerThreadBuffer::CAPACITY - 1)];
+
+        event.start = start;
+        event.end = end;
+        event.depth = buffer->depth;
+
+        if (copyName)
+        {
+            strncpy(event.copiedName, name, ProfilerEvent::MAX_COPIED_NAME_LENGTH - 1);
+            event.copiedName[ProfilerEvent::MAX_COPIED_NAME_LENGTH - 1] = '\0';
+            event.name = event.copiedName;
+        }
+        else
+        {
+            event.name = name;
+        }
+
+        // Publish the event, the exporter only reads events below writeIndex
+        buffer->writeIndex.store(index + 1, std::memory_order_release);
+    }
+
+    ProfilerThreadBuffer* Profiler::GetThreadBuffer()
+    {
+        if (_threadBuffer == nullptr)
+        {
+            _threadBuffer = RegisterThread();
+        }
+
+        return _threadBuffer;
+    }
+
+    ScopedZone* Profiler::SuspendZones()
+    {
+        // Threads that never opened a zone don't need a buffer
+        ProfilerThreadBuffer* buffer = _threadBuffer;
+        if (buffer == nullptr || buffer->openZone == nullptr)
+            return nullptr;
+
+        ScopedZone* zones = buffer->openZone;
+        u64 end = GetTimestamp();
+
+        // Innermost first, the same order they would have closed in
+        for (ScopedZone* zone = zones; zone != nullptr; zone = zone->_parent)
+        {
+            buffer->depth--;
+            RecordEvent(buffer, zone->_name, zone->_start, end, zone->_copyName);
+        }
+
+        buffer->openZone = nullptr;
+        return zones;
+    }
+
+    void Profiler::ResumeZones(ScopedZone* zones)
+    {
+        if (zones == nullptr)
+            return;
+
+        ProfilerThreadBuffer* buffer = GetThreadBuffer();
+        assert(buffer->openZone == nullptr); // Fibers only resume on threads that suspended the zones of the fiber they switched away from
+        u64 start = GetTimestamp();
+
+        for (ScopedZone* zone = zones; zone != nullptr; zone = zone->_parent)
+        {
+            buffer->depth++;
+            zone->_buffer = buffer;
+            zone->_start = start;
+        }
+
+        buffer->openZone = zones;
+    }
+
+    ProfilerThreadBuffer* Profiler::RegisterThread()
+    {
+        // Thread buffers are never freed so events recorded by threads that have exited can still be exported
+        ProfilerThreadBuffer* buffer = new ProfilerThreadBuffer();
+
+        std::lock_guard<std::mutex> lock(GetRegistryMutex());
+        std::vector<ProfilerThreadBuffer*>& buffers = GetThreadBuffers();
+
+        buffer->threadIndex = static_cast<u32>(buffers.size()) + 1; // Thread index 0 is used for frame markers
+        snprintf(buffer->threadName, sizeof(buffer->threadName), "Thread %u", buffer->threadIndex);
+        buffers.push_back(buffer);
+
+        return buffer;
+    }
+
+    bool Profiler::ExportChromeTrace(const std::string& path)
+    {
+        FILE* file = fopen(path.c_str(), "wb");
+        if (file == nullptr)
+        {
+            return false;
+        }
+
+        fputs("{\"traceEvents\":[\n", file);
+        fputs("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":0,\"args\":{\"name\":\"Frames\"}}", file);
+
+        // Frame markers become zones spanning from one marker to the next
+        u64 frameCount = _frameCount.load(std::memory_order_acquire);
+        u64 firstFrame = frameCount > MAX_FRAME_MARKERS ? frameCount - MAX_FRAME_MARKERS : 0;
+        for (u64 frame = firstFrame; frame + 1 < frameCount; frame++)
+        {
+            u64 start = _frameMarkers[frame & (MAX_FRAME_MARKERS - 1)];
+            u64 end = _frameMarkers[(frame + 1) & (MAX_FRAME_MARKERS - 1)];
+
+            fprintf(file, ",\n{\"name\":\"Frame %llu\",\"ph\":\"X\",\"pid\":0,\"tid\":0,\"ts\":%.3f,\"dur\":%.3f}",
+                static_cast<unsigned long long>(frame), static_cast<f64>(start) / 1000.0, static_cast<f64>(end - start) / 1000.0);
+        }
+
+        std::lock_guard<std::mutex> lock(GetRegistryMutex());
+        for (ProfilerThreadBuffer* buffer : GetThreadBuffers())
+        {
+            fprintf(file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":\"", buffer->threadIndex);
+            WriteEscaped(file, buffer->threadName);
+            fputs("\"}}", file);
+
+            u64 writeIndex = buffer->writeIndex.load(std::memory_order_acquire);
+            u64 firstIndex = writeIndex > ProfilerThreadBuffer::CAPACITY ? writeIndex - ProfilerThreadBuffer::CAPACITY : 0;
+
+            for (u64 i = firstIndex; i < writeIndex; i++)
+            {
+                const ProfilerEvent& event = buffer->events[i & (ProfilerThreadBuffer::CAPACITY - 1)];
+
+                fputs(",\n{\"name\":\"", file);
+                WriteEscaped(file, event.name != nullptr ? event.name : "");
+                fprintf(file, "\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"depth\":%u}}",
+                    buffer->threadIndex, static_cast<f64>(event.start) / 1000.0, static_cast<f64>(event.end - event.start) / 1000.0, event.depth);
+            }
+        }
+
+        fputs("\n]}\n", file);
+        fclose(file);
+
+        return true;
+    }
+
+    void Profiler::Clear()
+    {
+        std::lock_guard<std::mutex> lock(GetRegistryMutex());
+        for (ProfilerThreadBuffer* buffer : GetThreadBuffers())
+        {
+            buffer->writeIndex.store(0, std::memory_order_release);
+        }
+
+        _frameCount.store(0, std::memory_order_release);
+    }
+}
\ No newline at end of file
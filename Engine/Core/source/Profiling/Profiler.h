@@ -0,0 +1,152 @@
+#pragma once
+#include "../Core.h"
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <string>
+
+// The profiler is compiled out of Final builds, PROFILE_SCOPE and friends become no-ops there
+#ifndef FINAL
+#define PROFILER_ENABLED 1
+#endif
+
+namespace Profiling
+{
+    class ScopedZone;
+
+    // A finished zone, recorded when the zone goes out of scope
+    struct ProfilerEvent
+    {
+        static const int MAX_COPIED_NAME_LENGTH = 16;
+
+        u64 start = 0; // Nanoseconds since Profiler epoch
+        u64 end = 0;
+        const char* name = nullptr; // Points to either a string with static lifetime or copiedName
+        char copiedName[MAX_COPIED_NAME_LENGTH] = {};
+        u32 depth = 0;
+    };
+
+    // Each thread records into its own ring buffer, only the owning thread ever writes to it so recording needs no locks.
+    // When the buffer is full the oldest events get overwritten.
+    struct ProfilerThreadBuffer
+    {
+        static const u32 CAPACITY = 1 << 16; // Needs to be a power of two
+
+        ProfilerEvent events[CAPACITY];
+        std::atomic<u64> writeIndex = 0;
+        u32 threadIndex = 0;
+        u32 depth = 0;
+        ScopedZone* openZone = nullptr; // The innermost zone that's open on the thread, each one points to the one it's nested in
+        char threadName[32] = {};
+    };
+
+    class Profiler
+    {
+    public:
+        // Timestamps are monotonic nanoseconds
+        static u64 GetTimestamp()
+        {
+            return static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+        }
+
+        static void SetEnabled(bool enabled) { _enabled.store(enabled, std::memory_order_relaxed); }
+        static bool IsEnabled() { return _enabled.load(std::memory_order_relaxed); }
+
+        // Names the calling thread in exported traces
+        static void SetThreadName(const char* name);
+
+        // Call once per frame from the thread driving the main loop
+        static void MarkFrame();
+        static u64 GetFrameCount() { return _frameCount.load(std::memory_order_relaxed); }
+
+        static void RecordEvent(ProfilerThreadBuffer* buffer, const char* name, u64 start, u64 end, bool copyName);
+
+        // Writes all recorded events in the Chrome trace event format (load it in chrome://tracing or Perfetto)
+        // Zones that are recorded while exporting might be torn, export between frames or while workers are idle
+        static bool ExportChromeTrace(const std::string& path);
+
+        // Drops all recorded events and frame markers, only call this while no other thread is recording
+        static void Clear();
+
+        static ProfilerThreadBuffer* GetThreadBuffer();
+
+        // A job parked in JobSystem::WaitForCounter can resume on another thread, so the zones it has open get closed on the thread it leaves
+        // and reopened on the thread it resumes on. Zones that span the wait show up as one event on each thread
+        static ScopedZone* SuspendZones();
+        static void ResumeZones(ScopedZone* zones);
+
+    private:
+        static ProfilerThreadBuffer* RegisterThread();
+
+    private:
+        static std::atomic<bool> _enabled;
+        static std::atomic<u64> _frameCount;
+    };
+
+    class ScopedZone
+    {
+    public:
+        enum NameMode
+        {
+            NAME_MODE_STATIC, // The name has static lifetime, only the pointer gets stored
+            NAME_MODE_COPY // The name gets copied into the event (truncated to 15 chars), use this for names that won't outlive the frame
+        };
+
+        ScopedZone(const char* name, NameMode nameMode = NAME_MODE_STATIC)
+            : _name(name)
+            , _copyName(nameMode == NAME_MODE_COPY)
+            , _active(Profiler::IsEnabled())
+        {
+            if (_active)
+            {
+                _buffer = Profiler::GetThreadBuffer();
+                _buffer->depth++;
+                _parent = _buffer->openZone;
+                _buffer->openZone = this;
+                _start = Profiler::GetTimestamp();
+            }
+        }
+
+        ~ScopedZone()
+        {
+            if (_active)
+            {
+                u64 end = Profiler::GetTimestamp();
+                assert(_buffer->openZone == this); // Zones have to close in the opposite order they were opened in
+                _buffer->openZone = _parent;
+                _buffer->depth--;
+                Profiler::RecordEvent(_buffer, _name, _start, end, _copyName);
+            }
+        }
+
+    private:
+        ScopedZone(const ScopedZone&) = delete;
+        ScopedZone& operator=(const ScopedZone&) = delete;
+
+        friend class Profiler;
+
+    private:
+        ProfilerThreadBuffer* _buffer = nullptr; // Changes when the zone gets resumed on another thread
+        ScopedZone* _parent = nullptr;
+        const char* _name;
+        u64 _start = 0;
+        bool _copyName;
+        bool _active;
+    };
+}
+
+#define _PROFILE1(x, y) x##y
+#define _PROFILE2(x, y) _PROFILE1(x, y)
+#define _PROFILE3(x)    _PROFILE2(x, __COUNTER__)
+
+#ifdef PROFILER_ENABLED
+#define PROFILE_SCOPE(name)         Profiling::ScopedZone _PROFILE3(_profileZone_)(name)
+#define PROFILE_SCOPE_COPY(name)    Profiling::ScopedZone _PROFILE3(_profileZone_)(name, Profiling::ScopedZone::NAME_MODE_COPY)
+#define PROFILE_FUNCTION()          Profiling::ScopedZone _PROFILE3(_profileZone_)(__FUNCTION__)
+#define PROFILE_FRAME()             Profiling::Profiler::MarkFrame()
+#else
+#define PROFILE_SCOPE(name)
+#define PROFILE_SCOPE_COPY(name)
+#define PROFILE_FUNCTION()
+#define PROFILE_FRAME()
+#endif
\ No newline at end of file
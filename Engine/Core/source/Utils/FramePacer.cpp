@@ -0,0 +1,211 @@
+#include "FramePacer.h"
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <thread>
+
+#if defined(_WIN32)
+#include <Windows.h>
+#include <intrin.h>
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+#else
+#include <time.h>
+#include <errno.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+#endif
+
+namespace
+{
+    inline void CPUPause()
+    {
+#if defined(_WIN32) || defined(__x86_64__) || defined(__i386__)
+        _mm_pause();
+#else
+        std::this_thread::yield();
+#endif
+    }
+}
+
+FramePacer::FramePacer(u32 targetRate)
+    : _periodNS(0)
+    , _nextDeadline(0)
+    , _lastFrameStart(0)
+    , _oversleepEstimateNS(0.0)
+    , _spinThresholdNS(500000) // Start out spinning for the last 0.5 ms until we have calibrated
+    , _totalJitterUS(0.0)
+    , _totalSleepUS(0.0)
+    , _totalSpinUS(0.0)
+    , _timer(nullptr)
+{
+#if defined(_WIN32)
+    _timer = CreateWaitableTimerExW(NULL, NULL, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+    if (_timer == NULL)
+    {
+        // High resolution timers need Windows 10 1803, fall back to a regular one
+        _timer = CreateWaitableTimerExW(NULL, NULL, 0, TIMER_ALL_ACCESS);
+    }
+#endif
+
+    SetTargetRate(targetRate);
+    Reset();
+}
+
+FramePacer::~FramePacer()
+{
+#if defined(_WIN32)
+    if (_timer != nullptr)
+    {
+        CloseHandle(_timer);
+    }
+#endif
+}
+
+void FramePacer::SetTargetRate(u32 targetRate)
+{
+    assert(targetRate > 0); // We need a target rate to pace against
+    _periodNS = 1000000000ull / targetRate;
+}
+
+void FramePacer::Reset()
+{
+    _lastFrameStart = GetTimeNS();
+    _nextDeadline = _lastFrameStart + _periodNS;
+}
+
+void FramePacer::ResetStats()
+{
+    _stats = FramePacerStats();
+    _stats.spinThresholdNS = _spinThresholdNS;
+    _totalJitterUS = 0.0;
+    _totalSleepUS = 0.0;
+    _totalSpinUS = 0.0;
+}
+
+u64 FramePacer::WaitForNextFrame()
+{
+    u64 now = GetTimeNS();
+
+    if (now >= _nextDeadline)
+    {
+        _stats.missedDeadlines++;
+    }
+    else
+    {
+        // Sleep until we are within the spin threshold of the deadline
+        if (_nextDeadline - now > _spinThresholdNS)
+        {
+            u64 wakeTarget = _nextDeadline - _spinThresholdNS;
+            SleepUntil(wakeTarget);
+
+            u64 afterSleep = GetTimeNS();
+            _totalSleepUS += static_cast<f64>(afterSleep - now) / 1000.0;
+
+            // Calibrate the spin window from how late the OS woke us up
+            f64 oversleep = afterSleep > wakeTarget ? static_cast<f64>(afterSleep - wakeTarget) : 0.0;
+            const f64 decay = oversleep > _oversleepEstimateNS ? 0.5 : 0.02; // React quickly to worse wakeups, relax slowly
+            _oversleepEstimateNS += (oversleep - _oversleepEstimateNS) * decay;
+
+            u64 threshold = static_cast<u64>(_oversleepEstimateNS * 1.5) + MIN_SPIN_THRESHOLD_NS;
+            _spinThresholdNS = std::min(std::max(threshold, MIN_SPIN_THRESHOLD_NS), MAX_SPIN_THRESHOLD_NS);
+
+            now = afterSleep;
+        }
+
+        // Spin for the last stretch
+        SpinUntil(_nextDeadline);
+        u64 afterSpin = GetTimeNS();
+        _totalSpinUS += static_cast<f64>(afterSpin > now ? afterSpin - now : 0) / 1000.0;
+        now = afterSpin;
+    }
+
+    // Track how far past the deadline we ended up
+    f64 jitterUS = static_cast<f64>(now - std::min(now, _nextDeadline)) / 1000.0;
+    _totalJitterUS += jitterUS;
+    _stats.maxJitterUS = std::max(_stats.maxJitterUS, jitterUS);
+
+    _stats.frames++;
+    _stats.averageJitterUS = _totalJitterUS / static_cast<f64>(_stats.frames);
+    _stats.averageSleepUS = _totalSleepUS / static_cast<f64>(_stats.frames);
+    _stats.averageSpinUS = _totalSpinUS / static_cast<f64>(_stats.frames);
+    _stats.spinThresholdNS = _spinThresholdNS;
+
+    // Advance the deadline, if we fell more than a full period behind we resync instead of trying to catch up
+    _nextDeadline += _periodNS;
+    if (_nextDeadline <= now)
+    {
+        _nextDeadline = now + _periodNS;
+    }
+
+    u64 delta = now - _lastFrameStart;
+    _lastFrameStart = now;
+
+    return delta;
+}
+
+u64 FramePacer::GetTimeNS()
+{
+#if defined(_WIN32)
+    static LARGE_INTEGER frequency = []()
+    {
+        LARGE_INTEGER result;
+        QueryPerformanceFrequency(&result);
+        return result;
+    }();
+
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+
+    // Split the conversion to avoid overflowing
+    u64 ticks = static_cast<u64>(counter.QuadPart);
+    u64 freq = static_cast<u64>(frequency.QuadPart);
+    return (ticks / freq) * 1000000000ull + ((ticks % freq) * 1000000000ull) / freq;
+#else
+    timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return static_cast<u64>(time.tv_sec) * 1000000000ull + static_cast<u64>(time.tv_nsec);
+#endif
+}
+
+void FramePacer::SleepUntil(u64 deadline)
+{
+#if defined(_WIN32)
+    u64 now = GetTimeNS();
+    if (now >= deadline)
+        return;
+
+    if (_timer != nullptr)
+    {
+        // Negative due times are relative, in 100 ns units
+        LARGE_INTEGER dueTime;
+        dueTime.QuadPart = -static_cast<LONGLONG>((deadline - now) / 100);
+
+        if (SetWaitableTimerEx(_timer, &dueTime, 0, NULL, NULL, NULL, 0))
+        {
+            WaitForSingleObject(_timer, INFINITE);
+            return;
+        }
+    }
+    std::this_thread::sleep_for(std::chrono::nanoseconds(deadline - now));
+#else
+    timespec time;
+    time.tv_sec = static_cast<time_t>(deadline / 1000000000ull);
+    time.tv_nsec = static_cast<long>(deadline % 1000000000ull);
+
+    // Absolute deadlines mean being interrupted by a signal doesn't make us drift
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &time, nullptr) == EINTR)
+    {
+    }
+#endif
+}
+
+void FramePacer::SpinUntil(u64 deadline)
+{
+    while (GetTimeNS() < deadline)
+    {
+        CPUPause();
+    }
+}
\ No newline at end of file
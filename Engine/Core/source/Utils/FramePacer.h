@@ -0,0 +1,64 @@
+#pragma once
+#include "../Core.h"
+
+struct FramePacerStats
+{
+    u64 frames = 0;
+    u64 missedDeadlines = 0; // Frames where we were already past the deadline before waiting
+
+    // Jitter is how far past the deadline we woke up
+    f64 averageJitterUS = 0.0;
+    f64 maxJitterUS = 0.0;
+
+    // Per-frame averages of how long we slept and how long we spun, spinning is what costs CPU
+    f64 averageSleepUS = 0.0;
+    f64 averageSpinUS = 0.0;
+
+    u64 spinThresholdNS = 0; // Current calibrated spin window
+};
+
+// Paces frames against absolute, monotonic nanosecond deadlines.
+// It sleeps until shortly before the deadline and only spins for the last stretch, the length of which is calibrated from how much the OS oversleeps.
+class FramePacer
+{
+public:
+    FramePacer(u32 targetRate);
+    ~FramePacer();
+
+    void SetTargetRate(u32 targetRate);
+
+    // Blocks until the next frame deadline, returns the time in nanoseconds since the previous frame started
+    u64 WaitForNextFrame();
+
+    // Restarts pacing from now, call this after a hitch you don't want to catch up from (like loading)
+    void Reset();
+
+    const FramePacerStats& GetStats() const { return _stats; }
+    void ResetStats();
+
+    // Monotonic clock in nanoseconds
+    static u64 GetTimeNS();
+
+private:
+    void SleepUntil(u64 deadline);
+    void SpinUntil(u64 deadline);
+
+private:
+    static constexpr u64 MIN_SPIN_THRESHOLD_NS = 50000; // 50 us
+    static constexpr u64 MAX_SPIN_THRESHOLD_NS = 2000000; // 2 ms
+
+    u64 _periodNS;
+    u64 _nextDeadline;
+    u64 _lastFrameStart;
+
+    // Exponentially decaying estimate of how far past the requested time the OS wakes us up
+    f64 _oversleepEstimateNS;
+    u64 _spinThresholdNS;
+
+    FramePacerStats _stats;
+    f64 _totalJitterUS;
+    f64 _totalSleepUS;
+    f64 _totalSpinUS;
+
+    void* _timer; // High resolution waitable timer on Windows, unused elsewhere
+};
\ No newline at end of file
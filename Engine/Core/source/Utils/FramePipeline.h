@@ -0,0 +1,132 @@
+#pragma once
+#include "../Core.h"
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+// Hands frames from one producer thread (the simulation) to one consumer thread (the renderer) through a ring of latency + 1 slots.
+// The producer fills a slot while the consumer reads an older one, and can get up to latency frames ahead before it has to wait.
+// Handoff is two atomic counters, neither side ever takes a lock.
+template <typename T>
+class FramePipeline
+{
+public:
+    static const u32 MAX_LATENCY = 3;
+
+    FramePipeline(u32 latency = 1)
+        : _slots(ClampLatency(latency) + 1)
+        , _written(0)
+        , _read(0)
+        , _stopped(false)
+        , _producerWaitNS(0)
+        , _consumerWaitNS(0)
+    {
+
+    }
+
+    u32 GetLatency() const { return static_cast<u32>(_slots.size()) - 1; }
+
+    // Producer side, returns the slot to fill in once the consumer is done with it
+    T& BeginWrite()
+    {
+        u64 written = _written.load(std::memory_order_relaxed);
+        u64 waitNS = WaitUntil([&]() { return written - _read.load(std::memory_order_acquire) < _slots.size(); });
+        _producerWaitNS.fetch_add(waitNS, std::memory_order_relaxed);
+
+        return _slots[written % _slots.size()];
+    }
+
+    // Producer side, hands the slot from BeginWrite to the consumer
+    void EndWrite()
+    {
+        _written.fetch_add(1, std::memory_order_release);
+    }
+
+    // Consumer side, returns the oldest written slot or nullptr once Stop was called and everything written has been read
+    T* BeginRead()
+    {
+        u64 read = _read.load(std::memory_order_relaxed);
+        u64 waitNS = WaitUntil([&]() { return _written.load(std::memory_order_acquire) > read || _stopped.load(std::memory_order_acquire); });
+        _consumerWaitNS.fetch_add(waitNS, std::memory_order_relaxed);
+
+        if (_written.load(std::memory_order_acquire) <= read)
+            return nullptr; // Stopped and drained
+
+        return &_slots[read % _slots.size()];
+    }
+
+    // Consumer side, gives the slot from BeginRead back to the producer
+    void EndRead()
+    {
+        _read.fetch_add(1, std::memory_order_release);
+    }
+
+    // Lets the consumer drain what's left and then get nullptr from BeginRead
+    void Stop()
+    {
+        _stopped.store(true, std::memory_order_release);
+    }
+
+    u64 GetFramesWritten() const { return _written.load(std::memory_order_relaxed); }
+    u64 GetFramesRead() const { return _read.load(std::memory_order_relaxed); }
+
+    // Total time each side spent waiting on the other, a well balanced pipeline keeps both low
+    u64 GetProducerWaitNS() const { return _producerWaitNS.load(std::memory_order_relaxed); }
+    u64 GetConsumerWaitNS() const { return _consumerWaitNS.load(std::memory_order_relaxed); }
+
+private:
+    FramePipeline(const FramePipeline&) = delete;
+    FramePipeline& operator=(const FramePipeline&) = delete;
+
+    static u32 ClampLatency(u32 latency)
+    {
+        assert(latency >= 1 && latency <= MAX_LATENCY); // Latency is how many frames the producer can run ahead
+        return latency < 1 ? 1 : (latency > MAX_LATENCY ? MAX_LATENCY : latency);
+    }
+
+    // Spins briefly for the common case of the other side being nearly done, then backs off to short sleeps so a waiting thread doesn't burn a core
+    template <typename Condition>
+    static u64 WaitUntil(const Condition& condition)
+    {
+        if (condition())
+            return 0;
+
+        auto start = std::chrono::steady_clock::now();
+        u32 attempts = 0;
+        while (!condition())
+        {
+            if (attempts++ < SPIN_COUNT)
+            {
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+                _mm_pause();
+#endif
+            }
+            else
+            {
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+            }
+        }
+
+        return static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+    }
+
+private:
+    static const u32 SPIN_COUNT = 1024;
+
+    std::vector<T> _slots;
+
+    alignas(64) std::atomic<u64> _written;
+    alignas(64) std::atomic<u64> _read;
+    std::atomic<bool> _stopped;
+
+    std::atomic<u64> _producerWaitNS;
+    std::atomic<u64> _consumerWaitNS;
+};
\ No newline at end of file
@@ -0,0 +1,89 @@
+#include "StringID.h"
+#include <cassert>
+#ifdef _DEBUG
+#include <mutex>
+#include "../Containers/RobinHood.h"
+#endif
+
+#ifdef _DEBUG
+namespace
+{
+    // Function-local statics so registering from static initializers in other translation units is safe
+    std::mutex& GetRegistryMutex()
+    {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    robin_hood::unordered_node_map<u32, std::string>& GetRegistryNames()
+    {
+        static robin_hood::unordered_node_map<u32, std::string> names;
+        return names;
+    }
+}
+#endif
+
+StringID::StringID(const char* str, std::size_t length)
+    : _hash(StringUtils::fnv1a_32(str, length))
+{
+    StringIDRegistry::Register(*this, str, length);
+}
+
+StringID::StringID(const std::string& str)
+    : StringID(str.c_str(), str.length())
+{
+
+}
+
+const char* StringID::GetDebugName() const
+{
+    return StringIDRegistry::GetName(*this);
+}
+
+void StringIDRegistry::Register(StringID id, const char* str, std::size_t length)
+{
+#ifdef _DEBUG
+    std::lock_guard<std::mutex> lock(GetRegistryMutex());
+    robin_hood::unordered_node_map<u32, std::string>& names = GetRegistryNames();
+
+    auto it = names.find(id.GetHash());
+    if (it != names.end())
+    {
+        assert(it->second.compare(0, std::string::npos, str, length) == 0); // Two different strings hashed to the same StringID, rename one of them
+        return;
+    }
+
+    names.emplace(id.GetHash(), std::string(str, length));
+#else
+    (void)id;
+    (void)str;
+    (void)length;
+#endif
+}
+
+const char* StringIDRegistry::GetName(StringID id)
+{
+#ifdef _DEBUG
+    std::lock_guard<std::mutex> lock(GetRegistryMutex());
+    robin_hood::unordered_node_map<u32, std::string>& names = GetRegistryNames();
+
+    auto it = names.find(id.GetHash());
+    if (it != names.end())
+    {
+        return it->second.c_str();
+    }
+#else
+    (void)id;
+#endif
+    return "";
+}
+
+size_t StringIDRegistry::GetNumRegistered()
+{
+#ifdef _DEBUG
+    std::lock_guard<std::mutex> lock(GetRegistryMutex());
+    return GetRegistryNames().size();
+#else
+    return 0;
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,81 @@
+#pragma once
+#include "../Core.h"
+#include "StringUtils.h"
+#include <string>
+#include <functional>
+
+// A StringID is a hashed string which is 4 bytes big and cheap to copy and compare, use it for names that only need to be compared or looked up.
+// IDs created from string literals are hashed at compiletime in release builds and yield the same value as IDs hashed at runtime.
+// In debug builds every ID created from a string gets registered so it can be mapped back to its name, registering two different names with the same hash will assert.
+// Literals get hashed at runtime in debug builds for that, use StringID("name"_h) where a debug build needs the ID at compiletime.
+class StringID
+{
+    using type = u32;
+
+public:
+    constexpr StringID() : _hash(0) {}
+    constexpr explicit StringID(type hash) : _hash(hash) {}
+
+    // Hashing of string literals and char arrays, only the characters before the first null terminator get hashed
+#ifdef _DEBUG
+    template <std::size_t N>
+    StringID(const char(&str)[N]) : StringID(str, Length(str)) {}
+#else
+    template <std::size_t N>
+    constexpr StringID(const char(&str)[N]) : _hash(StringUtils::fnv1a_32(str, Length(str))) {}
+#endif
+
+    // Runtime hashing, str needs to be null terminated at str[length]
+    StringID(const char* str, std::size_t length);
+    explicit StringID(const std::string& str);
+
+    constexpr type GetHash() const { return _hash; }
+    constexpr bool IsValid() const { return _hash != 0; }
+
+    // Returns the registered name in debug builds, an empty string otherwise
+    const char* GetDebugName() const;
+
+    constexpr bool operator==(const StringID& other) const { return _hash == other._hash; }
+    constexpr bool operator!=(const StringID& other) const { return _hash != other._hash; }
+    constexpr bool operator<(const StringID& other) const { return _hash < other._hash; }
+
+    static constexpr StringID Invalid() { return StringID(); }
+
+private:
+    // An array without a null terminator gets its last character hashed in place of one
+    template <std::size_t N>
+    static constexpr std::size_t Length(const char(&str)[N])
+    {
+        std::size_t length = 0;
+        while (length < N - 1 && str[length] != '\0')
+        {
+            length++;
+        }
+
+        return length;
+    }
+
+private:
+    type _hash;
+};
+
+// Registry of the names behind runtime created StringIDs, this only stores anything in debug builds
+class StringIDRegistry
+{
+public:
+    static void Register(StringID id, const char* str, std::size_t length);
+    static const char* GetName(StringID id);
+    static size_t GetNumRegistered();
+};
+
+namespace std
+{
+    template <>
+    struct hash<StringID>
+    {
+        std::size_t operator()(const StringID& id) const noexcept
+        {
+            return static_cast<std::size_t>(id.GetHash());
+        }
+    };
+}
\ No newline at end of file
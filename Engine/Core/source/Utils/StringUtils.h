@@ -5,9 +5,17 @@
 namespace StringUtils
 {
     // FNV-1a 32bit hashing algorithm.
+    // This is iterative so it can be used both at compiletime and at runtime without recursing once per character,
+    // it hashes s[0] through s[count] (inclusive) which means the null terminator is part of the hash.
     constexpr u32 fnv1a_32(char const* s, std::size_t count)
     {
-        return ((count ? fnv1a_32(s, count - 1) : 2166136261u) ^ s[count]) * 16777619u;
+        u32 hash = 2166136261u;
+        for (std::size_t i = 0; i <= count; i++)
+        {
+            hash = (hash ^ static_cast<u32>(s[i])) * 16777619u;
+        }
+
+        return hash;
     }
 
     std::wstring StringToWString(const std::string& as);
@@ -0,0 +1,92 @@
+#pragma once
+#include <Core.h>
+#include <atomic>
+#include <cassert>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Renderer
+{
+    class Renderer;
+
+    // Whatever a backend read and decoded on a worker thread, handed back to it when the load gets finalized
+    struct AsyncLoadData
+    {
+        virtual ~AsyncLoadData() {}
+    };
+
+    // Returned right away by the Load*Async functions, the ID becomes available once the renderer has finalized the load
+    template <typename ID>
+    class AsyncHandle
+    {
+    public:
+        typedef std::function<void(ID)> ReadyFunction;
+
+        AsyncHandle() {}
+
+        bool IsValid() const { return _state != nullptr; }
+        bool IsReady() const { return _state != nullptr && _state->ready.load(std::memory_order_acquire); }
+
+        ID Get() const
+        {
+            assert(IsReady()); // Check IsReady or use OnReady before getting the ID
+            return _state->id;
+        }
+
+        // Runs on the thread finalizing the load once it's ready, or right away on this thread if it already is
+        void OnReady(ReadyFunction onReady) const
+        {
+            assert(IsValid()); // OnReady on a handle that isn't loading anything
+            {
+                std::lock_guard<std::mutex> lock(_state->mutex);
+                if (!_state->ready.load(std::memory_order_relaxed))
+                {
+                    _state->onReady.push_back(std::move(onReady));
+                    return;
+                }
+            }
+
+            onReady(_state->id);
+        }
+
+    private:
+        struct State
+        {
+            std::atomic<bool> ready = false;
+            ID id;
+
+            std::mutex mutex;
+            std::vector<ReadyFunction> onReady;
+        };
+
+        static AsyncHandle Create()
+        {
+            AsyncHandle handle;
+            handle._state = std::make_shared<State>();
+            return handle;
+        }
+
+        void Finish(ID id) const
+        {
+            std::vector<ReadyFunction> onReady;
+            {
+                std::lock_guard<std::mutex> lock(_state->mutex);
+                _state->id = id;
+                _state->ready.store(true, std::memory_order_release);
+                onReady.swap(_state->onReady);
+            }
+
+            for (ReadyFunction& function : onReady)
+            {
+                function(id);
+            }
+        }
+
+    private:
+        std::shared_ptr<State> _state = nullptr; // Shared between every copy of the handle and the load itself
+
+        friend class Renderer;
+    };
+}
\ No newline at end of file
@@ -1,16 +1,33 @@
 #include "BackendDispatch.h"
 #include "Renderer.h"
+#include "CommandBundle.h"
 
+#include "Commands/BeginRenderPass.h"
 #include "Commands/Clear.h"
 #include "Commands/Draw.h"
+#include "Commands/DrawInstanced.h"
+#include "Commands/EndRenderPass.h"
+#include "Commands/ExecuteBundle.h"
 #include "Commands/PopMarker.h"
 #include "Commands/PushMarker.h"
+#include "Commands/ResourceBarriers.h"
 #include "Commands/SetPipeline.h"
 #include "Commands/SetScissorRect.h"
 #include "Commands/SetViewport.h"
 
 namespace Renderer
 {
+    void BackendDispatch::BeginRenderPass(Renderer* renderer, CommandListID commandList, const void* data)
+    {
+        const Commands::BeginRenderPass* actualData = static_cast<const Commands::BeginRenderPass*>(data);
+        renderer->BeginRenderPass(commandList, actualData->attachments, actualData->numAttachments);
+    }
+    void BackendDispatch::EndRenderPass(Renderer* renderer, CommandListID commandList, const void* data)
+    {
+        const Commands::EndRenderPass* actualData = static_cast<const Commands::EndRenderPass*>(data);
+        renderer->EndRenderPass(commandList, actualData->attachments, actualData->numAttachments);
+    }
+
     void BackendDispatch::ClearImage(Renderer* renderer, CommandListID commandList, const void* data)
     {
         const Commands::ClearImage* actualData = static_cast<const Commands::ClearImage*>(data);
@@ -27,6 +44,17 @@ namespace Renderer
         const Commands::Draw* actualData = static_cast<const Commands::Draw*>(data);
         renderer->Draw(commandList, actualData->model);
     }
+    void BackendDispatch::DrawInstanced(Renderer* renderer, CommandListID commandList, const void* data)
+    {
+        const Commands::DrawInstanced* actualData = static_cast<const Commands::DrawInstanced*>(data);
+        renderer->DrawInstanced(commandList, actualData->model, actualData->instances);
+    }
+
+    void BackendDispatch::ExecuteBundle(Renderer* renderer, CommandListID commandList, const void* data)
+    {
+        const Commands::ExecuteBundle* actualData = static_cast<const Commands::ExecuteBundle*>(data);
+        actualData->bundle->Execute(renderer, commandList);
+    }
 
     void BackendDispatch::PopMarker(Renderer* renderer, CommandListID commandList, const void* /*data*/)
     {
@@ -39,6 +67,12 @@ namespace Renderer
         renderer->PushMarker(commandList, actualData->color, actualData->marker);
     }
 
+    void BackendDispatch::ResourceBarriers(Renderer* renderer, CommandListID commandList, const void* data)
+    {
+        const Commands::ResourceBarriers* actualData = static_cast<const Commands::ResourceBarriers*>(data);
+        renderer->ResourceBarriers(commandList, actualData->barriers, actualData->numBarriers);
+    }
+
     void BackendDispatch::SetConstantBuffer(Renderer* renderer, CommandListID commandList, const void* data)
     {
         const Commands::SetConstantBuffer* actualData = static_cast<const Commands::SetConstantBuffer*>(data);
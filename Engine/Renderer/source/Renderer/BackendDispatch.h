@@ -10,14 +10,22 @@ namespace Renderer
     class BackendDispatch
     {
     public:
+        static void BeginRenderPass(Renderer* renderer, CommandListID commandList, const void* data);
+        static void EndRenderPass(Renderer* renderer, CommandListID commandList, const void* data);
+
         static void ClearImage(Renderer* renderer, CommandListID commandList, const void* data);
         static void ClearDepthImage(Renderer* renderer, CommandListID commandList, const void* data);
 
         static void Draw(Renderer* renderer, CommandListID commandList, const void* data);
+        static void DrawInstanced(Renderer* renderer, CommandListID commandList, const void* data);
+
+        static void ExecuteBundle(Renderer* renderer, CommandListID commandList, const void* data);
 
         static void PopMarker(Renderer* renderer, CommandListID commandList, const void* data);
         static void PushMarker(Renderer* renderer, CommandListID commandList, const void* data);
 
+        static void ResourceBarriers(Renderer* renderer, CommandListID commandList, const void* data);
+
         static void SetConstantBuffer(Renderer* renderer, CommandListID commandList, const void* data);
         static void SetGraphicsPipeline(Renderer* renderer, CommandListID commandList, const void* data);
         static void SetMaterialPipeline(Renderer* renderer, CommandListID commandList, const void* data);
@@ -0,0 +1,35 @@
+#include "CommandBundle.h"
+#include <Profiling/Profiler.h>
+#include <Profiling/FrameStats.h>
+
+namespace Renderer
+{
+    CommandBundle::CommandBundle(Renderer* renderer, size_t size)
+        : _renderer(renderer)
+        , _allocator(size, "CommandBundle")
+        , _commandList(renderer, &_allocator)
+    {
+        _allocator.Init();
+    }
+
+    void CommandBundle::Record(u64 inputsHash, const std::function<void(CommandList&)>& record)
+    {
+        PROFILE_SCOPE("CommandBundle::Record");
+
+        _allocator.Reset();
+        _commandList = CommandList(_renderer, &_allocator);
+
+        record(_commandList);
+        assert(_commandList._markerScope == 0); // We need to pop all markers that we push
+
+        _isRecorded = true;
+        _inputsHash = inputsHash;
+
+        Profiling::FrameStats::AddCounter(Profiling::FRAME_COUNTER_BUNDLES_RECORDED, 1);
+    }
+
+    void CommandBundle::Execute(Renderer* renderer, CommandListID commandList) const
+    {
+        _commandList.Dispatch(renderer, commandList);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,49 @@
+#pragma once
+#include <Core.h>
+#include <functional>
+#include <Memory/StackAllocator.h>
+#include "CommandList.h"
+
+namespace Renderer
+{
+    // Commands that get recorded once and executed from any CommandList with ExecuteBundle, for draws that stay the same frame after frame like static geometry.
+    // Executing a bundle records a single command no matter how many it holds. Pass a hash of whatever the commands were recorded from, like the pipeline,
+    // model and instance transform, and NeedsRecording tells when that changed and the bundle has to be recorded again
+    class CommandBundle
+    {
+    public:
+        static const size_t DEFAULT_SIZE = 16 * 1024;
+
+        CommandBundle(Renderer* renderer, size_t size = DEFAULT_SIZE);
+
+        bool NeedsRecording(u64 inputsHash) const { return !_isRecorded || _inputsHash != inputsHash; }
+
+        // Throws away what was recorded before and records again, record gets a CommandList that starts out knowing nothing is bound and has to pop every marker it pushes.
+        // Lists that execute the bundle read it when they get executed, so don't record it again until they have been
+        void Record(u64 inputsHash, const std::function<void(CommandList&)>& record);
+
+        // Makes NeedsRecording return true until the bundle is recorded again, for when an input can't be hashed
+        void Invalidate() { _isRecorded = false; }
+
+        bool IsRecorded() const { return _isRecorded; }
+        u32 GetNumCommands() const { return _commandList._numCommands; }
+
+    private:
+        CommandBundle(const CommandBundle& other); // The commands live in our allocator
+
+        // BackendDispatch calls this when a list executing the bundle gets executed
+        void Execute(Renderer* renderer, CommandListID commandList) const;
+
+        friend class BackendDispatch;
+        friend class CommandList;
+        friend class CommandCapture;
+
+    private:
+        Renderer* _renderer;
+        Memory::StackAllocator _allocator; // Reset on every Record, the commands are all thrown away together
+        CommandList _commandList;
+
+        bool _isRecorded = false;
+        u64 _inputsHash = 0;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,483 @@
+#include "CommandCapture.h"
+#include "CommandList.h"
+#include "CommandBundle.h"
+#include "Renderer.h"
+#include <Profiling/Profiler.h>
+#include <Logging/Logger.h>
+#include <cstdio>
+
+namespace Renderer
+{
+    namespace
+    {
+        const size_t CONSTANT_BUFFER_SIZE = 64 * 1024; // The most a constant buffer binding can read
+
+        void WriteString(FILE* file, const std::string& string)
+        {
+            u32 length = static_cast<u32>(string.length());
+            fwrite(&length, sizeof(u32), 1, file);
+            fwrite(string.c_str(), 1, length, file);
+        }
+    }
+
+    void CommandCapture::Begin(const std::string& path)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        assert(!_isCapturing); // End the last capture first
+
+        _path = path;
+        _commands.clear();
+        _numCommandLists = 0;
+        _numCommands = 0;
+        _images.clear();
+        _depthImages.clear();
+        _vertexShaders.clear();
+        _pixelShaders.clear();
+        _computeShaders.clear();
+        _materials.clear();
+        _models.clear();
+        _graphicsPipelines.clear();
+        _materialPipelines.clear();
+        _computePipelines.clear();
+        _bufferLookup.clear();
+        _bufferSizes.clear();
+
+        _isCapturing = true;
+    }
+
+    bool CommandCapture::End()
+    {
+        PROFILE_SCOPE("CommandCapture::End");
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        assert(_isCapturing); // Begin a capture first
+
+        _isCapturing = false;
+
+        FILE* file = fopen(_path.c_str(), "wb");
+        if (file == nullptr)
+        {
+            LOG_ERROR(LOG_CATEGORY_RENDERER, "CommandCapture: Could not open %s for writing", _path.c_str());
+            return false;
+        }
+
+        CommandCaptureHeader header;
+        header.numImages = static_cast<u32>(_images.size());
+        header.numDepthImages = static_cast<u32>(_depthImages.size());
+        header.numBuffers = static_cast<u32>(_bufferSizes.size());
+        header.numVertexShaders = static_cast<u32>(_vertexShaders.size());
+        header.numPixelShaders = static_cast<u32>(_pixelShaders.size());
+        header.numComputeShaders = static_cast<u32>(_computeShaders.size());
+        header.numMaterials = static_cast<u32>(_materials.size());
+        header.numModels = static_cast<u32>(_models.size());
+        header.numGraphicsPipelines = static_cast<u32>(_graphicsPipelines.size());
+        header.numMaterialPipelines = static_cast<u32>(_materialPipelines.size());
+        header.numComputePipelines = static_cast<u32>(_computePipelines.size());
+        header.numCommandLists = _numCommandLists;
+        header.numCommands = _numCommands;
+        fwrite(&header, sizeof(CommandCaptureHeader), 1, file);
+
+        for (auto const& image : _images)
+        {
+            const ImageDesc& desc = image.second;
+            fwrite(&image.first, sizeof(u16), 1, file);
+            WriteString(file, desc.debugName);
+            fwrite(&desc.dimensions, sizeof(Vector2i), 1, file);
+            fwrite(&desc.depth, sizeof(u32), 1, file);
+            fwrite(&desc.format, sizeof(ImageFormat), 1, file);
+            fwrite(&desc.sampleCount, sizeof(SampleCount), 1, file);
+            fwrite(&desc.clearColor, sizeof(Vector4), 1, file);
+        }
+
+        for (auto const& image : _depthImages)
+        {
+            const DepthImageDesc& desc = image.second;
+            fwrite(&image.first, sizeof(u16), 1, file);
+            WriteString(file, desc.debugName);
+            fwrite(&desc.dimensions, sizeof(Vector2i), 1, file);
+            fwrite(&desc.format, sizeof(DepthImageFormat), 1, file);
+            fwrite(&desc.sampleCount, sizeof(SampleCount), 1, file);
+            fwrite(&desc.depthClearValue, sizeof(f32), 1, file);
+            fwrite(&desc.stencilClearValue, sizeof(u8), 1, file);
+        }
+
+        for (size_t size : _bufferSizes)
+        {
+            u64 bufferSize = static_cast<u64>(size);
+            fwrite(&bufferSize, sizeof(u64), 1, file);
+        }
+
+        // Shaders and materials only get captured as their paths, the files have to be there when the capture gets replayed
+        for (auto* paths : { &_vertexShaders, &_pixelShaders, &_computeShaders, &_materials })
+        {
+            for (auto const& path : *paths)
+            {
+                fwrite(&path.first, sizeof(u16), 1, file);
+                WriteString(file, path.second);
+            }
+        }
+
+        for (auto const& model : _models)
+        {
+            fwrite(&model.first, sizeof(u16), 1, file);
+            WriteString(file, model.second.desc.path);
+            fwrite(&model.second.primitiveDesc, sizeof(PrimitivePlaneDesc), 1, file);
+        }
+
+        for (auto const& pipeline : _graphicsPipelines)
+        {
+            fwrite(&pipeline.first, sizeof(u16), 1, file);
+            fwrite(&pipeline.second, sizeof(CapturedGraphicsPipeline), 1, file);
+        }
+
+        for (auto const& pipeline : _materialPipelines)
+        {
+            fwrite(&pipeline.first, sizeof(u16), 1, file);
+            fwrite(&pipeline.second, sizeof(CapturedMaterialPipeline), 1, file);
+        }
+
+        for (auto const& pipeline : _computePipelines)
+        {
+            fwrite(&pipeline.first, sizeof(u16), 1, file);
+            fwrite(&pipeline.second, sizeof(ComputePipelineDesc), 1, file);
+        }
+
+        fwrite(_commands.data(), 1, _commands.size(), file);
+
+        bool succeeded = ferror(file) == 0;
+        fclose(file);
+
+        LOG_INFO(LOG_CATEGORY_RENDERER, "CommandCapture: Wrote %u commands in %u command lists to %s", _numCommands, _numCommandLists, _path.c_str());
+        return succeeded;
+    }
+
+    void CommandCapture::CaptureCommandList(const CommandList& commandList)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_isCapturing)
+            return;
+
+        // Bundles get written inline, so the count is only known once every command has been
+        size_t numCommandsOffset = _commands.size();
+        Write(static_cast<u32>(0));
+
+        u32 numCommands = CaptureCommands(commandList);
+        memcpy(&_commands[numCommandsOffset], &numCommands, sizeof(u32));
+
+        _numCommandLists++;
+        _numCommands += numCommands;
+    }
+
+    u32 CommandCapture::CaptureCommands(const CommandList& commandList)
+    {
+        u32 numCommands = 0;
+
+        for (const CommandList::Chunk* chunk = commandList._firstChunk; chunk != nullptr; chunk = chunk->next)
+        {
+            const u8* command = reinterpret_cast<const u8*>(chunk + 1);
+            const u8* end = command + chunk->used;
+
+            while (command < end)
+            {
+                const CommandList::CommandHeader* header = reinterpret_cast<const CommandList::CommandHeader*>(command);
+                const void* data = command + CommandList::COMMAND_OFFSET;
+
+                // Replays don't have the bundle, so it gets captured as the commands it executes
+                if (header->type == COMMAND_TYPE_EXECUTE_BUNDLE)
+                {
+                    const Commands::ExecuteBundle* executeBundle = static_cast<const Commands::ExecuteBundle*>(data);
+                    numCommands += CaptureCommands(executeBundle->bundle->_commandList);
+                }
+                else
+                {
+                    CaptureCommand(header->type, data);
+                    numCommands++;
+                }
+
+                command += header->size;
+            }
+        }
+
+        return numCommands;
+    }
+
+    void CommandCapture::CaptureCommand(CommandType type, const void* data)
+    {
+        // Every command is its type and the size of what follows, so a reader can skip commands it doesn't know
+        u32 commandType = static_cast<u32>(type);
+        Write(commandType);
+
+        size_t sizeOffset = _commands.size();
+        Write(static_cast<u32>(0));
+
+        switch (type)
+        {
+            case COMMAND_TYPE_BEGIN_RENDER_PASS:
+            case COMMAND_TYPE_END_RENDER_PASS:
+            {
+                // Both render pass commands are laid out the same
+                const Commands::BeginRenderPass* command = static_cast<const Commands::BeginRenderPass*>(data);
+                Write(command->numAttachments);
+                Write(command->attachments, sizeof(RenderPassAttachment) * command->numAttachments);
+
+                for (u32 i = 0; i < command->numAttachments; i++)
+                {
+                    CaptureImage(command->attachments[i].image);
+                    CaptureImage(command->attachments[i].depthImage);
+                }
+                break;
+            }
+            case COMMAND_TYPE_RESOURCE_BARRIERS:
+            {
+                const Commands::ResourceBarriers* command = static_cast<const Commands::ResourceBarriers*>(data);
+                Write(command->numBarriers);
+                Write(command->barriers, sizeof(ResourceBarrier) * command->numBarriers);
+
+                for (u32 i = 0; i < command->numBarriers; i++)
+                {
+                    CaptureImage(command->barriers[i].image);
+                    CaptureImage(command->barriers[i].depthImage);
+                }
+                break;
+            }
+            case COMMAND_TYPE_SET_CONSTANT_BUFFER:
+            {
+                const Commands::SetConstantBuffer* command = static_cast<const Commands::SetConstantBuffer*>(data);
+                Write(command->slot);
+                Write(CaptureBuffer(command->gpuResource, CONSTANT_BUFFER_SIZE));
+                break;
+            }
+            case COMMAND_TYPE_DRAW_INSTANCED:
+            {
+                const Commands::DrawInstanced* command = static_cast<const Commands::DrawInstanced*>(data);
+                size_t size = static_cast<size_t>(command->instances.first + command->instances.count) * InstanceBuffer::STRIDE;
+                Write(command->model);
+                Write(CaptureBuffer(command->instances.gpuResource, size));
+                Write(command->instances.first);
+                Write(command->instances.count);
+                CaptureModel(command->model);
+                break;
+            }
+            case COMMAND_TYPE_CLEAR_IMAGE:
+            {
+                const Commands::ClearImage* command = static_cast<const Commands::ClearImage*>(data);
+                Write(*command);
+                CaptureImage(command->image);
+                break;
+            }
+            case COMMAND_TYPE_CLEAR_DEPTH_IMAGE:
+            {
+                const Commands::ClearDepthImage* command = static_cast<const Commands::ClearDepthImage*>(data);
+                Write(*command);
+                CaptureImage(command->image);
+                break;
+            }
+            case COMMAND_TYPE_DRAW:
+            {
+                const Commands::Draw* command = static_cast<const Commands::Draw*>(data);
+                Write(*command);
+                CaptureModel(command->model);
+                break;
+            }
+            case COMMAND_TYPE_SET_GRAPHICS_PIPELINE:
+            {
+                const Commands::SetGraphicsPipeline* command = static_cast<const Commands::SetGraphicsPipeline*>(data);
+                Write(*command);
+                CapturePipeline(command->pipeline);
+                break;
+            }
+            case COMMAND_TYPE_SET_MATERIAL_PIPELINE:
+            {
+                const Commands::SetMaterialPipeline* command = static_cast<const Commands::SetMaterialPipeline*>(data);
+                Write(*command);
+                CapturePipeline(command->pipeline);
+                break;
+            }
+            case COMMAND_TYPE_SET_COMPUTE_PIPELINE:
+            {
+                const Commands::SetComputePipeline* command = static_cast<const Commands::SetComputePipeline*>(data);
+                Write(*command);
+                CapturePipeline(command->pipeline);
+                break;
+            }
+            case COMMAND_TYPE_POP_MARKER: break;
+            case COMMAND_TYPE_PUSH_MARKER: Write(*static_cast<const Commands::PushMarker*>(data)); break;
+            case COMMAND_TYPE_SET_SCISSOR_RECT: Write(*static_cast<const Commands::SetScissorRect*>(data)); break;
+            case COMMAND_TYPE_SET_VIEWPORT: Write(*static_cast<const Commands::SetViewport*>(data)); break;
+            case COMMAND_TYPE_EXECUTE_BUNDLE: // CaptureCommands writes the bundle's commands instead
+            default:
+                assert(false); // Invalid command type, did we just add to the enum?
+        }
+
+        u32 size = static_cast<u32>(_commands.size() - sizeOffset - sizeof(u32));
+        memcpy(&_commands[sizeOffset], &size, sizeof(u32));
+    }
+
+    void CommandCapture::CaptureImage(ImageID image)
+    {
+        using type = type_safe::underlying_type<ImageID>;
+        if (image == ImageID::Invalid() || _images.find(static_cast<type>(image)) != _images.end())
+            return;
+
+        _images.emplace(static_cast<type>(image), _renderer->GetDescriptor(image));
+    }
+
+    void CommandCapture::CaptureImage(DepthImageID image)
+    {
+        using type = type_safe::underlying_type<DepthImageID>;
+        if (image == DepthImageID::Invalid() || _depthImages.find(static_cast<type>(image)) != _depthImages.end())
+            return;
+
+        _depthImages.emplace(static_cast<type>(image), _renderer->GetDescriptor(image));
+    }
+
+    void CommandCapture::CapturePipeline(GraphicsPipelineID pipeline)
+    {
+        using type = type_safe::underlying_type<GraphicsPipelineID>;
+        if (pipeline == GraphicsPipelineID::Invalid() || _graphicsPipelines.find(static_cast<type>(pipeline)) != _graphicsPipelines.end())
+            return;
+
+        // The resources get looked up the same way backends look them up when the pipeline gets set
+        const GraphicsPipelineDesc& desc = _renderer->GetDescriptor(pipeline);
+
+        CapturedGraphicsPipeline captured;
+        captured.states = desc.states;
+        std::fill_n(captured.textures, MAX_BOUND_TEXTURES, ImageID::Invalid());
+        std::fill_n(captured.renderTargets, MAX_RENDER_TARGETS, ImageID::Invalid());
+
+        for (int i = 0; i < MAX_BOUND_TEXTURES; i++)
+        {
+            if (desc.textures[i] != RenderPassResource::Invalid() && desc.ResourceToImageID != nullptr)
+            {
+                captured.textures[i] = desc.ResourceToImageID(desc.textures[i]);
+            }
+        }
+
+        for (int i = 0; i < MAX_RENDER_TARGETS; i++)
+        {
+            if (desc.renderTargets[i] == RenderPassMutableResource::Invalid())
+                break;
+
+            captured.renderTargets[i] = desc.MutableResourceToImageID(desc.renderTargets[i]);
+        }
+
+        if (desc.depthStencil != RenderPassMutableResource::Invalid())
+        {
+            captured.depthStencil = desc.MutableResourceToDepthImageID(desc.depthStencil);
+        }
+
+        _graphicsPipelines.emplace(static_cast<type>(pipeline), captured);
+
+        for (ImageID image : captured.textures)
+        {
+            CaptureImage(image);
+        }
+        for (ImageID image : captured.renderTargets)
+        {
+            CaptureImage(image);
+        }
+        CaptureImage(captured.depthStencil);
+        CaptureShader(captured.states.vertexShader, _vertexShaders);
+        CaptureShader(captured.states.pixelShader, _pixelShaders);
+    }
+
+    void CommandCapture::CapturePipeline(MaterialPipelineID pipeline)
+    {
+        using type = type_safe::underlying_type<MaterialPipelineID>;
+        if (pipeline == MaterialPipelineID::Invalid() || _materialPipelines.find(static_cast<type>(pipeline)) != _materialPipelines.end())
+            return;
+
+        const MaterialPipelineDesc& desc = _renderer->GetDescriptor(pipeline);
+
+        CapturedMaterialPipeline captured;
+        captured.material = desc.material;
+        captured.states = desc.states;
+        std::fill_n(captured.renderTargets, MAX_RENDER_TARGETS, ImageID::Invalid());
+
+        for (int i = 0; i < MAX_RENDER_TARGETS; i++)
+        {
+            if (desc.renderTargets[i] == RenderPassMutableResource::Invalid())
+                break;
+
+            captured.renderTargets[i] = desc.MutableResourceToImageID(desc.renderTargets[i]);
+        }
+
+        if (desc.depthStencil != RenderPassMutableResource::Invalid())
+        {
+            captured.depthStencil = desc.MutableResourceToDepthImageID(desc.depthStencil);
+        }
+
+        _materialPipelines.emplace(static_cast<type>(pipeline), captured);
+
+        for (ImageID image : captured.renderTargets)
+        {
+            CaptureImage(image);
+        }
+        CaptureImage(captured.depthStencil);
+        CaptureMaterial(captured.material);
+    }
+
+    void CommandCapture::CapturePipeline(ComputePipelineID pipeline)
+    {
+        using type = type_safe::underlying_type<ComputePipelineID>;
+        if (pipeline == ComputePipelineID::Invalid() || _computePipelines.find(static_cast<type>(pipeline)) != _computePipelines.end())
+            return;
+
+        ComputePipelineDesc desc = _renderer->GetDescriptor(pipeline);
+        _computePipelines.emplace(static_cast<type>(pipeline), desc);
+
+        CaptureShader(desc.computeShader, _computeShaders);
+    }
+
+    void CommandCapture::CaptureMaterial(MaterialID material)
+    {
+        using type = type_safe::underlying_type<MaterialID>;
+        if (material == MaterialID::Invalid() || _materials.find(static_cast<type>(material)) != _materials.end())
+            return;
+
+        _materials.emplace(static_cast<type>(material), _renderer->GetDescriptor(material).path);
+    }
+
+    void CommandCapture::CaptureModel(ModelID model)
+    {
+        using type = type_safe::underlying_type<ModelID>;
+        if (model == ModelID::Invalid() || _models.find(static_cast<type>(model)) != _models.end())
+            return;
+
+        CapturedModel captured;
+        captured.desc = _renderer->GetDescriptor(model);
+        captured.primitiveDesc = _renderer->GetPrimitiveDescriptor(model);
+        _models.emplace(static_cast<type>(model), captured);
+    }
+
+    template <typename ID>
+    void CommandCapture::CaptureShader(ID shader, robin_hood::unordered_map<u16, std::string>& shaders)
+    {
+        using type = type_safe::underlying_type<ID>;
+        if (shader == ID::Invalid() || shaders.find(static_cast<type>(shader)) != shaders.end())
+            return;
+
+        shaders.emplace(static_cast<type>(shader), _renderer->GetDescriptor(shader).path);
+    }
+
+    u32 CommandCapture::CaptureBuffer(void* gpuResource, size_t size)
+    {
+        auto it = _bufferLookup.find(gpuResource);
+        if (it != _bufferLookup.end())
+        {
+            _bufferSizes[it->second] = size > _bufferSizes[it->second] ? size : _bufferSizes[it->second];
+            return it->second;
+        }
+
+        u32 index = static_cast<u32>(_bufferSizes.size());
+        _bufferSizes.push_back(size);
+        _bufferLookup.emplace(gpuResource, index);
+        return index;
+    }
+
+    void CommandCapture::Write(const void* data, size_t size)
+    {
+        const u8* bytes = static_cast<const u8*>(data);
+        _commands.insert(_commands.end(), bytes, bytes + size);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,137 @@
+#pragma once
+#include <Core.h>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <Containers/RobinHood.h>
+#include "Commands/CommandType.h"
+#include "Descriptors/ImageDesc.h"
+#include "Descriptors/DepthImageDesc.h"
+#include "Descriptors/GraphicsPipelineDesc.h"
+#include "Descriptors/ComputePipelineDesc.h"
+#include "Descriptors/MaterialDesc.h"
+#include "Descriptors/ModelDesc.h"
+#include "Descriptors/PrimitiveModelDesc.h"
+
+namespace Renderer
+{
+    class Renderer;
+    class CommandList;
+
+    // Capture files start with this, followed by the images, depth images, buffers, shaders, materials, models and pipelines the commands use and then every command list in the order they were executed.
+    // Commands are stored as they were recorded except for what they point to, arrays get stored inline and buffers as an index into the buffers
+    struct CommandCaptureHeader
+    {
+        static const u32 MAGIC = 0x5041434E; // "NCAP"
+        static const u32 VERSION = 2;
+
+        u32 magic = MAGIC;
+        u32 version = VERSION;
+        u32 numCommandTypes = COMMAND_TYPE_COUNT; // Commands get stored as their structs, so captures only load in builds with the same commands
+        u32 numImages = 0;
+        u32 numDepthImages = 0;
+        u32 numBuffers = 0;
+        u32 numVertexShaders = 0;
+        u32 numPixelShaders = 0;
+        u32 numComputeShaders = 0;
+        u32 numMaterials = 0;
+        u32 numModels = 0;
+        u32 numGraphicsPipelines = 0;
+        u32 numMaterialPipelines = 0;
+        u32 numComputePipelines = 0;
+        u32 numCommandLists = 0;
+        u32 numCommands = 0;
+    };
+
+    // Pipelines get captured with the images they bind instead of RenderGraph resources, the RenderGraph they were created with is gone by the time they get replayed
+    struct CapturedGraphicsPipeline
+    {
+        GraphicsPipelineDesc::States states;
+        ImageID textures[MAX_BOUND_TEXTURES];
+        ImageID renderTargets[MAX_RENDER_TARGETS];
+        DepthImageID depthStencil = DepthImageID::Invalid();
+    };
+
+    struct CapturedMaterialPipeline
+    {
+        MaterialID material = MaterialID::Invalid();
+        MaterialPipelineDesc::States states;
+        ImageID renderTargets[MAX_RENDER_TARGETS];
+        DepthImageID depthStencil = DepthImageID::Invalid();
+    };
+
+    struct CapturedModel
+    {
+        ModelDesc desc; // The path is empty for primitive models
+        PrimitivePlaneDesc primitiveDesc;
+    };
+
+    // Writes every command list executed between Begin and End to a file that CommandReplay can dispatch again, so real frames can be replayed offline.
+    // Only the size of constant and instance buffers gets captured, not what they hold
+    class CommandCapture
+    {
+    public:
+        CommandCapture(Renderer* renderer)
+            : _renderer(renderer)
+        {
+
+        }
+
+        void Begin(const std::string& path);
+        bool End(); // Writes the file, returns false if that failed
+
+        bool IsCapturing() const { return _isCapturing.load(std::memory_order_relaxed); }
+
+    private:
+        // CommandList::Execute calls this with every list while capturing
+        void CaptureCommandList(const CommandList& commandList);
+        u32 CaptureCommands(const CommandList& commandList); // Returns how many commands got written
+        void CaptureCommand(CommandType type, const void* data);
+
+        void CaptureImage(ImageID image);
+        void CaptureImage(DepthImageID image);
+        void CapturePipeline(GraphicsPipelineID pipeline);
+        void CapturePipeline(MaterialPipelineID pipeline);
+        void CapturePipeline(ComputePipelineID pipeline);
+        void CaptureMaterial(MaterialID material);
+        void CaptureModel(ModelID model);
+
+        template <typename ID>
+        void CaptureShader(ID shader, robin_hood::unordered_map<u16, std::string>& shaders);
+        u32 CaptureBuffer(void* gpuResource, size_t size);
+
+        void Write(const void* data, size_t size);
+
+        template <typename T>
+        void Write(const T& value)
+        {
+            Write(&value, sizeof(T));
+        }
+
+        friend class CommandList;
+
+    private:
+        Renderer* _renderer;
+        std::mutex _mutex;
+        std::atomic<bool> _isCapturing = false;
+        std::string _path;
+
+        std::vector<u8> _commands;
+        u32 _numCommandLists = 0;
+        u32 _numCommands = 0;
+
+        robin_hood::unordered_map<u16, ImageDesc> _images; // Descs of the images by ID, looked up when first used since transients might not outlive the capture
+        robin_hood::unordered_map<u16, DepthImageDesc> _depthImages;
+        robin_hood::unordered_map<u16, std::string> _vertexShaders; // Paths of the shaders by ID
+        robin_hood::unordered_map<u16, std::string> _pixelShaders;
+        robin_hood::unordered_map<u16, std::string> _computeShaders;
+        robin_hood::unordered_map<u16, std::string> _materials; // Paths of the materials by ID
+        robin_hood::unordered_map<u16, CapturedModel> _models;
+        robin_hood::unordered_map<u16, CapturedGraphicsPipeline> _graphicsPipelines;
+        robin_hood::unordered_map<u16, CapturedMaterialPipeline> _materialPipelines;
+        robin_hood::unordered_map<u16, ComputePipelineDesc> _computePipelines;
+        robin_hood::unordered_map<void*, u32> _bufferLookup; // GPU resource to index into _bufferSizes
+        std::vector<size_t> _bufferSizes; // The most any command read from each buffer
+    };
+}
\ No newline at end of file
@@ -1,22 +1,160 @@
 #pragma once
 #include "CommandList.h"
 #include "Renderer.h"
+#include "CommandBundle.h"
+#include <Profiling/Profiler.h>
+#include <Profiling/FrameStats.h>
 
 namespace Renderer
 {
     void CommandList::Execute()
     {
+        PROFILE_SCOPE("CommandList::Execute");
+
         assert(_markerScope == 0); // We need to pop all markers that we push
 
+        CommandCapture& capture = _renderer->GetCommandCapture();
+        if (capture.IsCapturing())
+        {
+            capture.CaptureCommandList(*this);
+        }
+
         CommandListID commandList = _renderer->BeginCommandList();
+        Dispatch(_renderer, commandList);
+        _renderer->EndCommandList(commandList);
+
+        Profiling::FrameStats::AddCounter(Profiling::FRAME_COUNTER_COMMANDS_RECORDED, _numCommands);
+        Profiling::FrameStats::AddCounter(Profiling::FRAME_COUNTER_COMMANDS_FILTERED, _numFilteredCommands);
+        Profiling::FrameStats::AddCounter(Profiling::FRAME_COUNTER_DRAWS, _numDraws);
+        Profiling::FrameStats::AddCounter(Profiling::FRAME_COUNTER_DRAWS_BATCHED, _numBatchedDraws);
+        Profiling::FrameStats::AddCounter(Profiling::FRAME_COUNTER_PIPELINE_BINDS, _numPipelineBinds);
+        Profiling::FrameStats::AddCounter(Profiling::FRAME_COUNTER_CONSTANT_BUFFER_BINDS, _numConstantBufferBinds);
+        Profiling::FrameStats::AddCounter(Profiling::FRAME_COUNTER_RESOURCE_BARRIERS, _numBarriers);
+        Profiling::FrameStats::AddCounter(Profiling::FRAME_COUNTER_RENDER_PASSES, _numRenderPasses);
+        Profiling::FrameStats::AddCounter(Profiling::FRAME_COUNTER_BUNDLES_EXECUTED, _numBundles);
+    }
 
+    void CommandList::Dispatch(Renderer* renderer, CommandListID commandList) const
+    {
         // Execute each command
-        for (int i = 0; i < _functions.Count(); i++)
+        for (const Chunk* chunk = _firstChunk; chunk != nullptr; chunk = chunk->next)
         {
-            _functions[i](_renderer, commandList, _data[i]);
+            const u8* command = reinterpret_cast<const u8*>(chunk + 1);
+            const u8* end = command + chunk->used;
+
+            while (command < end)
+            {
+                const CommandHeader* header = reinterpret_cast<const CommandHeader*>(command);
+                Commands::DISPATCH_FUNCTIONS[header->type](renderer, commandList, command + COMMAND_OFFSET);
+
+                command += header->size;
+            }
         }
+    }
 
-        _renderer->EndCommandList(commandList);
+    void CommandList::Append(CommandList& other)
+    {
+        assert(other._markerScope == 0); // Lists get recorded separately, so each of them has to pop every marker it pushes
+
+        // Other's chunks get linked in rather than copied, so other's allocator needs to outlive us and other is left empty
+        if (other._firstChunk != nullptr)
+        {
+            if (_lastChunk != nullptr)
+            {
+                _lastChunk->next = other._firstChunk;
+            }
+            else
+            {
+                _firstChunk = other._firstChunk;
+            }
+
+            _lastChunk = other._lastChunk;
+            _lastDrawInstanced = other._lastDrawInstanced;
+        }
+
+        _numCommands += other._numCommands;
+        _numFilteredCommands += other._numFilteredCommands;
+        _numDraws += other._numDraws;
+        _numBatchedDraws += other._numBatchedDraws;
+        _numPipelineBinds += other._numPipelineBinds;
+        _numConstantBufferBinds += other._numConstantBufferBinds;
+        _numBarriers += other._numBarriers;
+        _numRenderPasses += other._numRenderPasses;
+        _numBundles += other._numBundles;
+
+        // Other started out knowing nothing, so whatever it knows at the end is what's bound after it and everything else stays as we left it
+        _boundState.Append(other._boundState);
+
+        other._firstChunk = nullptr;
+        other._lastChunk = nullptr;
+        other._lastDrawInstanced = nullptr;
+        other._numCommands = 0;
+        other._boundState = BoundState();
+    }
+
+    u8* CommandList::AllocateCommand(size_t size)
+    {
+        assert(_allocator != nullptr);
+
+        // Whatever gets recorded now comes between the last instanced draw and the next one
+        _lastDrawInstanced = nullptr;
+
+        if (_lastChunk == nullptr || _lastChunk->used + size > _lastChunk->capacity)
+        {
+            size_t capacity = _lastChunk != nullptr ? _lastChunk->capacity * 2 : MIN_CHUNK_SIZE;
+            capacity = capacity > MAX_CHUNK_SIZE ? MAX_CHUNK_SIZE : capacity;
+            capacity = capacity < size ? size : capacity;
+
+            Chunk* chunk = static_cast<Chunk*>(_allocator->Allocate(sizeof(Chunk) + capacity, COMMAND_ALIGNMENT));
+            chunk->next = nullptr;
+            chunk->used = 0;
+            chunk->capacity = capacity;
+
+            if (_lastChunk != nullptr)
+            {
+                _lastChunk->next = chunk;
+            }
+            else
+            {
+                _firstChunk = chunk;
+            }
+
+            _lastChunk = chunk;
+        }
+
+        u8* memory = reinterpret_cast<u8*>(_lastChunk + 1) + _lastChunk->used;
+        _lastChunk->used += size;
+
+        return memory;
+    }
+
+    void CommandList::ResourceBarriers(const ResourceBarrier* barriers, u32 numBarriers)
+    {
+        Commands::ResourceBarriers* command = AddCommand<Commands::ResourceBarriers>();
+        command->barriers = barriers;
+        command->numBarriers = numBarriers;
+
+        _numBarriers += numBarriers;
+    }
+
+    void CommandList::BeginRenderPass(const RenderPassAttachment* attachments, u32 numAttachments)
+    {
+        Commands::BeginRenderPass* command = AddCommand<Commands::BeginRenderPass>();
+        command->attachments = attachments;
+        command->numAttachments = numAttachments;
+
+        // Backends may bind the attachments like a pipeline binds its render targets, so the next pipeline has to be set again
+        _boundState.ForgetPipeline();
+        _numRenderPasses++;
+    }
+
+    void CommandList::EndRenderPass(const RenderPassAttachment* attachments, u32 numAttachments)
+    {
+        Commands::EndRenderPass* command = AddCommand<Commands::EndRenderPass>();
+        command->attachments = attachments;
+        command->numAttachments = numAttachments;
+
+        _boundState.ForgetPipeline();
     }
 
     void CommandList::PushMarker(std::string marker, Vector3 color)
@@ -39,41 +177,111 @@ namespace Renderer
 
     void CommandList::SetPipeline(GraphicsPipelineID pipelineID)
     {
+        assert(pipelineID != GraphicsPipelineID::Invalid()); // Invalid means unknown to the bound state, and there's nothing to bind anyway
+        if (_boundState.graphicsPipeline == pipelineID)
+        {
+            _numFilteredCommands++;
+            return;
+        }
+
         Commands::SetGraphicsPipeline* command = AddCommand<Commands::SetGraphicsPipeline>();
         command->pipeline = pipelineID;
+
+        _boundState.SetPipeline();
+        _boundState.graphicsPipeline = pipelineID;
+        _numPipelineBinds++;
     }
 
     void CommandList::SetPipeline(MaterialPipelineID pipelineID)
     {
+        assert(pipelineID != MaterialPipelineID::Invalid()); // Invalid means unknown to the bound state, and there's nothing to bind anyway
+        if (_boundState.materialPipeline == pipelineID)
+        {
+            _numFilteredCommands++;
+            return;
+        }
+
         Commands::SetMaterialPipeline* command = AddCommand<Commands::SetMaterialPipeline>();
         command->pipeline = pipelineID;
+
+        _boundState.SetPipeline();
+        _boundState.materialPipeline = pipelineID;
+        _numPipelineBinds++;
     }
 
     void CommandList::SetScissorRect(u32 left, u32 right, u32 top, u32 bottom)
     {
-        Commands::SetScissorRect* command = AddCommand<Commands::SetScissorRect>();
-        command->scissorRect.left = left;
-        command->scissorRect.right = right;
-        command->scissorRect.top = top;
-        command->scissorRect.bottom = bottom;
+        ScissorRect scissorRect;
+        scissorRect.left = left;
+        scissorRect.right = right;
+        scissorRect.top = top;
+        scissorRect.bottom = bottom;
+
+        SetScissorRect(scissorRect);
     }
 
     void CommandList::SetViewport(f32 topLeftX, f32 topLeftY, f32 width, f32 height, f32 minDepth, f32 maxDepth)
     {
+        Viewport viewport;
+        viewport.topLeftX = topLeftX;
+        viewport.topLeftY = topLeftY;
+        viewport.width = width;
+        viewport.height = height;
+        viewport.minDepth = minDepth;
+        viewport.maxDepth = maxDepth;
+
+        SetViewport(viewport);
+    }
+
+    void CommandList::SetScissorRect(const ScissorRect& scissorRect)
+    {
+        if (_boundState.hasScissorRect && memcmp(&_boundState.scissorRect, &scissorRect, sizeof(ScissorRect)) == 0)
+        {
+            _numFilteredCommands++;
+            return;
+        }
+
+        Commands::SetScissorRect* command = AddCommand<Commands::SetScissorRect>();
+        command->scissorRect = scissorRect;
+
+        _boundState.hasScissorRect = true;
+        _boundState.scissorRect = scissorRect;
+    }
+
+    void CommandList::SetViewport(const Viewport& viewport)
+    {
+        if (_boundState.hasViewport && memcmp(&_boundState.viewport, &viewport, sizeof(Viewport)) == 0)
+        {
+            _numFilteredCommands++;
+            return;
+        }
+
         Commands::SetViewport* command = AddCommand<Commands::SetViewport>();
-        command->viewport.topLeftX = topLeftX;
-        command->viewport.topLeftY = topLeftY;
-        command->viewport.width = width;
-        command->viewport.height = height;
-        command->viewport.minDepth = minDepth;
-        command->viewport.maxDepth = maxDepth;
+        command->viewport = viewport;
+
+        _boundState.hasViewport = true;
+        _boundState.viewport = viewport;
     }
 
     void CommandList::SetConstantBuffer(u32 slot, void* gpuResource)
     {
+        assert(gpuResource != nullptr); // nullptr means unknown to the bound state
+        bool isTracked = slot < static_cast<u32>(MAX_CONSTANT_BUFFERS);
+        if (isTracked && _boundState.constantBuffers[slot] == gpuResource)
+        {
+            _numFilteredCommands++;
+            return;
+        }
+
         Commands::SetConstantBuffer* command = AddCommand<Commands::SetConstantBuffer>();
         command->slot = slot;
         command->gpuResource = gpuResource;
+
+        if (isTracked)
+        {
+            _boundState.constantBuffers[slot] = gpuResource;
+        }
+        _numConstantBufferBinds++;
     }
 
     void CommandList::Clear(ImageID imageID, Vector4 color)
@@ -96,5 +304,46 @@ namespace Renderer
     {
         Commands::Draw* command = AddCommand<Commands::Draw>();
         command->model = modelID;
+
+        _numDraws++;
+    }
+    void CommandList::DrawInstanced(ModelID modelID, const InstanceRange& instances)
+    {
+        assert(instances.gpuResource != nullptr); // Allocate the instances from an InstanceBuffer
+
+        // Filtered state changes record nothing, so if the last draw is still the last command the same pipeline and bindings are bound
+        Commands::DrawInstanced* last = _lastDrawInstanced;
+        if (last != nullptr && last->model == modelID && last->instances.gpuResource == instances.gpuResource && last->instances.first + last->instances.count == instances.first)
+        {
+            last->instances.count += instances.count;
+            _numBatchedDraws++;
+            return;
+        }
+
+        Commands::DrawInstanced* command = AddCommand<Commands::DrawInstanced>();
+        command->model = modelID;
+        command->instances = instances;
+
+        _lastDrawInstanced = command;
+        _numDraws++;
+    }
+
+    void CommandList::ExecuteBundle(const CommandBundle& bundle)
+    {
+        assert(bundle.IsRecorded()); // Record the bundle before executing it
+
+        Commands::ExecuteBundle* command = AddCommand<Commands::ExecuteBundle>();
+        command->bundle = &bundle;
+
+        // What the bundle binds and draws counts as ours, but its commands were recorded when the bundle was so they don't
+        const CommandList& bundleList = bundle._commandList;
+        _numDraws += bundleList._numDraws;
+        _numBatchedDraws += bundleList._numBatchedDraws;
+        _numPipelineBinds += bundleList._numPipelineBinds;
+        _numConstantBufferBinds += bundleList._numConstantBufferBinds;
+        _numBundles += bundleList._numBundles + 1;
+
+        // The bundle started out knowing nothing, so whatever it knows at the end is what's bound after it like with Append
+        _boundState.Append(bundleList._boundState);
     }
 }
\ No newline at end of file
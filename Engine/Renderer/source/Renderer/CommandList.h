@@ -4,13 +4,18 @@
 #include "Descriptors/CommandListDesc.h"
 #include <vector>
 #include <Memory/StackAllocator.h>
-#include <Containers/DynamicArray.h>
+#include <type_traits>
 
 // Commands
+#include "Commands/BeginRenderPass.h"
 #include "Commands/Clear.h"
 #include "Commands/Draw.h"
+#include "Commands/DrawInstanced.h"
+#include "Commands/EndRenderPass.h"
+#include "Commands/ExecuteBundle.h"
 #include "Commands/PopMarker.h"
 #include "Commands/PushMarker.h"
+#include "Commands/ResourceBarriers.h"
 #include "Commands/SetConstantBuffer.h"
 #include "Commands/SetPipeline.h"
 #include "Commands/SetScissorRect.h"
@@ -18,6 +23,8 @@
 
 namespace Renderer
 {
+    class CommandBundle;
+
     class CommandList
     {
     public:
@@ -25,8 +32,18 @@ namespace Renderer
             : _renderer(renderer)
             , _allocator(allocator)
             , _markerScope(0)
-            , _functions(allocator, 32)
-            , _data(allocator, 32)
+            , _numDraws(0)
+            , _numBatchedDraws(0)
+            , _numPipelineBinds(0)
+            , _numConstantBufferBinds(0)
+            , _numBarriers(0)
+            , _numRenderPasses(0)
+            , _numBundles(0)
+            , _numCommands(0)
+            , _numFilteredCommands(0)
+            , _firstChunk(nullptr)
+            , _lastChunk(nullptr)
+            , _lastDrawInstanced(nullptr)
         {
 
         }
@@ -38,55 +55,167 @@ namespace Renderer
         void SetPipeline(MaterialPipelineID pipelineID);
         void SetScissorRect(u32 left, u32 right, u32 top, u32 bottom);
         void SetViewport(f32 topLeftX, f32 topLeftY, f32 width, f32 height, f32 minDepth, f32 maxDepth);
+        void SetScissorRect(const ScissorRect& scissorRect);
+        void SetViewport(const Viewport& viewport);
         void SetConstantBuffer(u32 slot, void* gpuResource);
 
         void Clear(ImageID imageID, Vector4 color);
         void Clear(DepthImageID imageID, f32 depth, DepthClearFlags flags = DepthClearFlags::DEPTH_CLEAR_DEPTH, u8 stencil = 0);
 
+        // Never merged with other draws, only DrawInstanced is
         void Draw(ModelID modelID);
 
+        // Draws the instances with the bound pipeline, which needs InstanceBufferState enabled. When the last command recorded drew the same model
+        // from right before these instances they get added to it instead, so consecutive draws of a model turn into one instanced draw
+        void DrawInstanced(ModelID modelID, const InstanceRange& instances);
+
+        // Executes the commands recorded into bundle as if they were recorded here, bundle has to stay alive and can't be recorded again until this list has been executed.
+        // The bundle starts out knowing nothing is bound, so it doesn't depend on what was recorded before it and whatever it binds is known after it
+        void ExecuteBundle(const CommandBundle& bundle);
+
     private:
         // Execute gets friend-called from RenderGraph
         void Execute();
 
-        template<typename Command>
-        Command* AddCommand()
+        // Dispatches every command recorded so far to the backend, Execute and executing a bundle share this
+        void Dispatch(Renderer* renderer, CommandListID commandList) const;
+
+        // Appends every command recorded into other after ours, RenderGraph uses this to merge lists recorded in parallel back into graph order
+        void Append(CommandList& other);
+
+        // RenderGraph plans every transition between passes, barriers has to stay alive until Execute
+        void ResourceBarriers(const ResourceBarrier* barriers, u32 numBarriers);
+
+        // RenderGraph wraps passes drawing to attachments in render passes, attachments has to stay alive until Execute
+        void BeginRenderPass(const RenderPassAttachment* attachments, u32 numAttachments);
+        void EndRenderPass(const RenderPassAttachment* attachments, u32 numAttachments);
+
+        // What the commands recorded so far leave bound, so commands that wouldn't change anything get dropped instead of recorded.
+        // Lists start out knowing nothing since they can get appended after or executed on anything
+        struct BoundState
         {
-            Command* command = AllocateCommand<Command>();
+            // At most one of these is known, Invalid means we don't know what's bound
+            GraphicsPipelineID graphicsPipeline = GraphicsPipelineID::Invalid();
+            MaterialPipelineID materialPipeline = MaterialPipelineID::Invalid();
+            bool pipelineChanged = false; // Whether this list changed or forgot the pipeline, which decides what Append keeps
+
+            bool hasViewport = false;
+            Viewport viewport;
+            bool hasScissorRect = false;
+            ScissorRect scissorRect;
+
+            void* constantBuffers[MAX_CONSTANT_BUFFERS] = {}; // nullptr until known
+
+            void ForgetPipeline()
+            {
+                graphicsPipeline = GraphicsPipelineID::Invalid();
+                materialPipeline = MaterialPipelineID::Invalid();
+                pipelineChanged = true;
+            }
+
+            // Changing the pipeline resets its bindings, setting the one that is already bound gets filtered and keeps them
+            void SetPipeline()
+            {
+                ForgetPipeline();
+                memset(constantBuffers, 0, sizeof(constantBuffers));
+            }
+
+            void Append(const BoundState& other)
+            {
+                if (other.pipelineChanged)
+                {
+                    graphicsPipeline = other.graphicsPipeline;
+                    materialPipeline = other.materialPipeline;
+                    pipelineChanged = true;
+                    memcpy(constantBuffers, other.constantBuffers, sizeof(constantBuffers));
+                }
+                else
+                {
+                    for (int i = 0; i < MAX_CONSTANT_BUFFERS; i++)
+                    {
+                        constantBuffers[i] = other.constantBuffers[i] != nullptr ? other.constantBuffers[i] : constantBuffers[i];
+                    }
+                }
+
+                if (other.hasViewport)
+                {
+                    hasViewport = true;
+                    viewport = other.viewport;
+                }
+                if (other.hasScissorRect)
+                {
+                    hasScissorRect = true;
+                    scissorRect = other.scissorRect;
+                }
+            }
+        };
+
+        // Commands get recorded into one stream of chunks from the allocator, each command is a CommandHeader followed by the command itself.
+        // Execute walks the stream front to back, so replaying touches memory in the order it was written.
+        struct CommandHeader
+        {
+            CommandType type;
+            u16 size; // Bytes from this header to the next one
+        };
 
-            AddFunction(Command::DISPATCH_FUNCTION);
-            AddData(command);
+        struct Chunk
+        {
+            Chunk* next;
+            size_t used;
+            size_t capacity; // Bytes of commands following the Chunk
+        };
 
-            return command;
-        }
+        static constexpr size_t COMMAND_ALIGNMENT = 8;
+        static constexpr size_t COMMAND_OFFSET = (sizeof(CommandHeader) + COMMAND_ALIGNMENT - 1) / COMMAND_ALIGNMENT * COMMAND_ALIGNMENT;
+        static constexpr size_t MIN_CHUNK_SIZE = 1024; // Lists start small since most of them only record a pass or two
+        static constexpr size_t MAX_CHUNK_SIZE = 64 * 1024; // Every chunk doubles the last one up to this
 
         template<typename Command>
-        Command* AllocateCommand()
+        Command* AddCommand()
         {
-            assert(_allocator != nullptr);
+            static_assert(alignof(Command) <= COMMAND_ALIGNMENT, "The command stream doesn't align commands this strictly");
+            static_assert(std::is_trivially_destructible<Command>::value, "Nothing destroys commands, they get thrown away with the allocator");
 
-            return Memory::Allocator::New<Command>(_allocator);
-        }
+            constexpr size_t size = (COMMAND_OFFSET + sizeof(Command) + COMMAND_ALIGNMENT - 1) / COMMAND_ALIGNMENT * COMMAND_ALIGNMENT;
+            static_assert(size <= 0xFFFF, "Commands have to fit the size in CommandHeader");
 
-        void AddFunction(const BackendDispatchFunction& function)
-        {
-            _functions.Insert(function);
-        }
+            u8* memory = AllocateCommand(size);
 
-        void AddData(void* data)
-        {
-            _data.Insert(data);
+            CommandHeader* header = reinterpret_cast<CommandHeader*>(memory);
+            header->type = Command::TYPE;
+            header->size = static_cast<u16>(size);
+            _numCommands++;
+
+            return new(memory + COMMAND_OFFSET) Command();
         }
 
+        u8* AllocateCommand(size_t size);
+
     private:
         Memory::Allocator* _allocator;
         Renderer* _renderer;
         u32 _markerScope;
 
-        DynamicArray<BackendDispatchFunction> _functions;
-        DynamicArray<void*> _data;
+        // Stats get accumulated locally and handed to FrameStats on Execute
+        u32 _numDraws;
+        u32 _numBatchedDraws; // Instanced draws merged into the one before them
+        u32 _numPipelineBinds;
+        u32 _numConstantBufferBinds;
+        u32 _numBarriers;
+        u32 _numRenderPasses;
+        u32 _numBundles; // Bundles executed, including the ones executed from inside them
+
+        u32 _numCommands;
+        u32 _numFilteredCommands; // Commands dropped because they wouldn't have changed anything
+        BoundState _boundState;
+
+        Chunk* _firstChunk;
+        Chunk* _lastChunk;
+        Commands::DrawInstanced* _lastDrawInstanced; // Only set while it's the last command in the stream
 
         friend class RenderGraph;
+        friend class CommandCapture;
+        friend class CommandBundle;
     };
 
     class ScopedMarker
@@ -0,0 +1,611 @@
+#include "CommandReplay.h"
+#include "CommandCapture.h"
+#include "CommandList.h"
+#include "Renderer.h"
+#include <Profiling/Profiler.h>
+#include <Logging/Logger.h>
+#include <Containers/RobinHood.h>
+#include <cstddef>
+#include <cstdio>
+
+namespace Renderer
+{
+    namespace
+    {
+        using IDRemap = robin_hood::unordered_map<u16, u16>;
+
+        // IDs that didn't get captured, like invalid ones, aren't in the remap and stay as they are
+        u16 RemapID(const IDRemap& remap, u16 id)
+        {
+            auto it = remap.find(id);
+            return it != remap.end() ? it->second : id;
+        }
+
+        template <typename Desc>
+        void LoadShaders(Renderer* renderer, const std::vector<std::pair<u16, std::string>>& shaders, IDRemap& remap)
+        {
+            for (auto& shader : shaders)
+            {
+                Desc desc;
+                desc.path = shader.second;
+                remap.emplace(shader.first, static_cast<u16>(renderer->LoadShader(desc)));
+            }
+        }
+    }
+
+    // Reads a capture front to back, every read fails once it runs past the end instead of reading garbage
+    class CommandReplay::CaptureReader
+    {
+    public:
+        CaptureReader(const u8* data, size_t size)
+            : _cursor(data)
+            , _end(data + size)
+        {
+
+        }
+
+        bool Read(void* data, size_t size)
+        {
+            if (static_cast<size_t>(_end - _cursor) < size)
+                return false;
+
+            memcpy(data, _cursor, size);
+            _cursor += size;
+            return true;
+        }
+
+        template <typename T>
+        bool Read(T& value)
+        {
+            return Read(&value, sizeof(T));
+        }
+
+        bool Read(std::string& string)
+        {
+            u32 length = 0;
+            if (!Read(length) || static_cast<size_t>(_end - _cursor) < length)
+                return false;
+
+            string.assign(reinterpret_cast<const char*>(_cursor), length);
+            _cursor += length;
+            return true;
+        }
+
+        // The next size bytes as a reader of their own
+        bool Split(size_t size, CaptureReader& reader)
+        {
+            if (static_cast<size_t>(_end - _cursor) < size)
+                return false;
+
+            reader = CaptureReader(_cursor, size);
+            _cursor += size;
+            return true;
+        }
+
+        bool IsAtEnd() const { return _cursor == _end; }
+
+    private:
+        const u8* _cursor;
+        const u8* _end;
+    };
+
+    bool CommandReplay::Load(const std::string& path)
+    {
+        PROFILE_SCOPE("CommandReplay::Load");
+
+        FILE* file = fopen(path.c_str(), "rb");
+        if (file == nullptr)
+        {
+            LOG_ERROR(LOG_CATEGORY_RENDERER, "CommandReplay: Could not open %s", path.c_str());
+            return false;
+        }
+
+        fseek(file, 0, SEEK_END);
+        long fileSize = ftell(file);
+        fseek(file, 0, SEEK_SET);
+
+        std::vector<u8> fileData(fileSize > 0 ? static_cast<size_t>(fileSize) : 0);
+        size_t numRead = fread(fileData.data(), 1, fileData.size(), file);
+        fclose(file);
+
+        _data.clear();
+        _commands.clear();
+        _commandLists.clear();
+        _images.clear();
+        _depthImages.clear();
+        _bufferSizes.clear();
+        _vertexShaders.clear();
+        _pixelShaders.clear();
+        _computeShaders.clear();
+        _materials.clear();
+        _models.clear();
+        _graphicsPipelines.clear();
+        _materialPipelines.clear();
+        _computePipelines.clear();
+        _arrayFixups.clear();
+        _resourceFixups.clear();
+        _bufferFixups.clear();
+        _resourcesCreated = false;
+        _bufferRenderer = nullptr;
+
+        CaptureReader reader(fileData.data(), numRead);
+
+        CommandCaptureHeader header;
+        if (!reader.Read(header) || header.magic != CommandCaptureHeader::MAGIC)
+        {
+            LOG_ERROR(LOG_CATEGORY_RENDERER, "CommandReplay: %s is not a command capture", path.c_str());
+            return false;
+        }
+        if (header.version != CommandCaptureHeader::VERSION || header.numCommandTypes != COMMAND_TYPE_COUNT)
+        {
+            LOG_ERROR(LOG_CATEGORY_RENDERER, "CommandReplay: %s was captured by a build with different commands", path.c_str());
+            return false;
+        }
+
+        bool succeeded = true;
+
+        for (u32 i = 0; succeeded && i < header.numImages; i++)
+        {
+            std::pair<u16, ImageDesc> image;
+            ImageDesc& desc = image.second;
+            succeeded = reader.Read(image.first) && reader.Read(desc.debugName) && reader.Read(desc.dimensions) && reader.Read(desc.depth)
+                && reader.Read(desc.format) && reader.Read(desc.sampleCount) && reader.Read(desc.clearColor);
+            _images.push_back(image);
+        }
+
+        for (u32 i = 0; succeeded && i < header.numDepthImages; i++)
+        {
+            std::pair<u16, DepthImageDesc> image;
+            DepthImageDesc& desc = image.second;
+            succeeded = reader.Read(image.first) && reader.Read(desc.debugName) && reader.Read(desc.dimensions) && reader.Read(desc.format)
+                && reader.Read(desc.sampleCount) && reader.Read(desc.depthClearValue) && reader.Read(desc.stencilClearValue);
+            _depthImages.push_back(image);
+        }
+
+        for (u32 i = 0; succeeded && i < header.numBuffers; i++)
+        {
+            u64 size = 0;
+            succeeded = reader.Read(size);
+            _bufferSizes.push_back(static_cast<size_t>(size));
+        }
+
+        std::pair<u32, std::vector<std::pair<u16, std::string>>*> paths[] = { { header.numVertexShaders, &_vertexShaders }, { header.numPixelShaders, &_pixelShaders },
+            { header.numComputeShaders, &_computeShaders }, { header.numMaterials, &_materials } };
+        for (auto& path : paths)
+        {
+            for (u32 i = 0; succeeded && i < path.first; i++)
+            {
+                std::pair<u16, std::string> entry;
+                succeeded = reader.Read(entry.first) && reader.Read(entry.second);
+                path.second->push_back(entry);
+            }
+        }
+
+        for (u32 i = 0; succeeded && i < header.numModels; i++)
+        {
+            std::pair<u16, CapturedModel> model;
+            succeeded = reader.Read(model.first) && reader.Read(model.second.desc.path) && reader.Read(model.second.primitiveDesc);
+            _models.push_back(model);
+        }
+
+        for (u32 i = 0; succeeded && i < header.numGraphicsPipelines; i++)
+        {
+            std::pair<u16, CapturedGraphicsPipeline> pipeline;
+            succeeded = reader.Read(pipeline.first) && reader.Read(pipeline.second);
+            _graphicsPipelines.push_back(pipeline);
+        }
+
+        for (u32 i = 0; succeeded && i < header.numMaterialPipelines; i++)
+        {
+            std::pair<u16, CapturedMaterialPipeline> pipeline;
+            succeeded = reader.Read(pipeline.first) && reader.Read(pipeline.second);
+            _materialPipelines.push_back(pipeline);
+        }
+
+        for (u32 i = 0; succeeded && i < header.numComputePipelines; i++)
+        {
+            std::pair<u16, ComputePipelineDesc> pipeline;
+            succeeded = reader.Read(pipeline.first) && reader.Read(pipeline.second);
+            _computePipelines.push_back(pipeline);
+        }
+
+        for (u32 i = 0; succeeded && i < header.numCommandLists; i++)
+        {
+            ReplayCommandList commandList;
+            commandList.firstCommand = static_cast<u32>(_commands.size());
+            commandList.numCommands = 0;
+            succeeded = reader.Read(commandList.numCommands);
+
+            for (u32 j = 0; succeeded && j < commandList.numCommands; j++)
+            {
+                u32 type = 0;
+                u32 size = 0;
+                CaptureReader commandReader(nullptr, 0);
+                succeeded = reader.Read(type) && reader.Read(size) && reader.Split(size, commandReader) && type < COMMAND_TYPE_COUNT;
+                succeeded = succeeded && LoadCommand(static_cast<CommandType>(type), commandReader) && commandReader.IsAtEnd();
+            }
+
+            _commandLists.push_back(commandList);
+        }
+
+        if (!succeeded || !reader.IsAtEnd() || _commands.size() != header.numCommands)
+        {
+            LOG_ERROR(LOG_CATEGORY_RENDERER, "CommandReplay: %s is truncated or corrupt", path.c_str());
+            _commands.clear();
+            _commandLists.clear();
+            return false;
+        }
+
+        // _data kept growing while loading, so the arrays only get pointed at now that it's done
+        for (const Fixup& fixup : _arrayFixups)
+        {
+            const u8* array = _data.data() + fixup.value;
+            memcpy(&_data[fixup.offset], &array, sizeof(const u8*));
+        }
+        _arrayFixups.clear();
+
+        LOG_INFO(LOG_CATEGORY_RENDERER, "CommandReplay: Loaded %u commands in %u command lists from %s", GetNumCommands(), GetNumCommandLists(), path.c_str());
+        return true;
+    }
+
+    template <typename Command>
+    size_t CommandReplay::AddCommand(const Command& command)
+    {
+        static_assert(alignof(Command) <= 8, "Commands in _data are only 8 byte aligned");
+
+        size_t offset = (_data.size() + 7) / 8 * 8;
+        _data.resize(offset + sizeof(Command));
+        memcpy(&_data[offset], &command, sizeof(Command));
+
+        ReplayCommand replayCommand;
+        replayCommand.type = Command::TYPE;
+        replayCommand.offset = offset;
+        _commands.push_back(replayCommand);
+
+        return offset;
+    }
+
+    size_t CommandReplay::AddArray(const void* data, size_t size)
+    {
+        size_t offset = (_data.size() + 7) / 8 * 8;
+        _data.resize(offset + size);
+        memcpy(_data.data() + offset, data, size);
+
+        return offset;
+    }
+
+    template <typename Command>
+    bool CommandReplay::LoadCommandAsIs(CaptureReader& reader)
+    {
+        Command command;
+        if (!reader.Read(command))
+            return false;
+
+        AddCommand(command);
+        return true;
+    }
+
+    template <typename Command>
+    bool CommandReplay::LoadCommandWithResource(CaptureReader& reader, size_t resourceOffset, ResourceType resourceType)
+    {
+        Command command;
+        if (!reader.Read(command))
+            return false;
+
+        _resourceFixups.push_back({ AddCommand(command) + resourceOffset, resourceType });
+        return true;
+    }
+
+    template <typename Command>
+    bool CommandReplay::LoadRenderPass(CaptureReader& reader)
+    {
+        Command command;
+        if (!reader.Read(command.numAttachments))
+            return false;
+
+        std::vector<RenderPassAttachment> attachments(command.numAttachments);
+        if (!reader.Read(attachments.data(), sizeof(RenderPassAttachment) * command.numAttachments))
+            return false;
+
+        size_t commandOffset = AddCommand(command);
+        size_t arrayOffset = AddArray(attachments.data(), sizeof(RenderPassAttachment) * command.numAttachments);
+        _arrayFixups.push_back({ commandOffset + offsetof(Command, attachments), arrayOffset });
+
+        for (u32 i = 0; i < command.numAttachments; i++)
+        {
+            size_t attachmentOffset = arrayOffset + sizeof(RenderPassAttachment) * i;
+            _resourceFixups.push_back({ attachmentOffset + offsetof(RenderPassAttachment, image), RESOURCE_TYPE_IMAGE });
+            _resourceFixups.push_back({ attachmentOffset + offsetof(RenderPassAttachment, depthImage), RESOURCE_TYPE_DEPTH_IMAGE });
+        }
+        return true;
+    }
+
+    bool CommandReplay::LoadCommand(CommandType type, CaptureReader& reader)
+    {
+        switch (type)
+        {
+            case COMMAND_TYPE_BEGIN_RENDER_PASS: return LoadRenderPass<Commands::BeginRenderPass>(reader);
+            case COMMAND_TYPE_END_RENDER_PASS: return LoadRenderPass<Commands::EndRenderPass>(reader);
+            case COMMAND_TYPE_RESOURCE_BARRIERS:
+            {
+                Commands::ResourceBarriers command;
+                if (!reader.Read(command.numBarriers))
+                    return false;
+
+                std::vector<ResourceBarrier> barriers(command.numBarriers);
+                if (!reader.Read(barriers.data(), sizeof(ResourceBarrier) * command.numBarriers))
+                    return false;
+
+                size_t commandOffset = AddCommand(command);
+                size_t arrayOffset = AddArray(barriers.data(), sizeof(ResourceBarrier) * command.numBarriers);
+                _arrayFixups.push_back({ commandOffset + offsetof(Commands::ResourceBarriers, barriers), arrayOffset });
+
+                for (u32 i = 0; i < command.numBarriers; i++)
+                {
+                    size_t barrierOffset = arrayOffset + sizeof(ResourceBarrier) * i;
+                    _resourceFixups.push_back({ barrierOffset + offsetof(ResourceBarrier, image), RESOURCE_TYPE_IMAGE });
+                    _resourceFixups.push_back({ barrierOffset + offsetof(ResourceBarrier, depthImage), RESOURCE_TYPE_DEPTH_IMAGE });
+                }
+                return true;
+            }
+            case COMMAND_TYPE_SET_CONSTANT_BUFFER:
+            {
+                Commands::SetConstantBuffer command;
+                u32 buffer = 0;
+                if (!reader.Read(command.slot) || !reader.Read(buffer) || buffer >= _bufferSizes.size())
+                    return false;
+
+                size_t commandOffset = AddCommand(command);
+                _bufferFixups.push_back({ commandOffset + offsetof(Commands::SetConstantBuffer, gpuResource), buffer });
+                return true;
+            }
+            case COMMAND_TYPE_DRAW_INSTANCED:
+            {
+                Commands::DrawInstanced command;
+                u32 buffer = 0;
+                if (!reader.Read(command.model) || !reader.Read(buffer) || !reader.Read(command.instances.first) || !reader.Read(command.instances.count) || buffer >= _bufferSizes.size())
+                    return false;
+
+                size_t commandOffset = AddCommand(command);
+                _bufferFixups.push_back({ commandOffset + offsetof(Commands::DrawInstanced, instances) + offsetof(InstanceRange, gpuResource), buffer });
+                _resourceFixups.push_back({ commandOffset + offsetof(Commands::DrawInstanced, model), RESOURCE_TYPE_MODEL });
+                return true;
+            }
+            case COMMAND_TYPE_CLEAR_IMAGE: return LoadCommandWithResource<Commands::ClearImage>(reader, offsetof(Commands::ClearImage, image), RESOURCE_TYPE_IMAGE);
+            case COMMAND_TYPE_CLEAR_DEPTH_IMAGE: return LoadCommandWithResource<Commands::ClearDepthImage>(reader, offsetof(Commands::ClearDepthImage, image), RESOURCE_TYPE_DEPTH_IMAGE);
+            case COMMAND_TYPE_DRAW: return LoadCommandWithResource<Commands::Draw>(reader, offsetof(Commands::Draw, model), RESOURCE_TYPE_MODEL);
+            case COMMAND_TYPE_SET_GRAPHICS_PIPELINE: return LoadCommandWithResource<Commands::SetGraphicsPipeline>(reader, offsetof(Commands::SetGraphicsPipeline, pipeline), RESOURCE_TYPE_GRAPHICS_PIPELINE);
+            case COMMAND_TYPE_SET_MATERIAL_PIPELINE: return LoadCommandWithResource<Commands::SetMaterialPipeline>(reader, offsetof(Commands::SetMaterialPipeline, pipeline), RESOURCE_TYPE_MATERIAL_PIPELINE);
+            case COMMAND_TYPE_SET_COMPUTE_PIPELINE: return LoadCommandWithResource<Commands::SetComputePipeline>(reader, offsetof(Commands::SetComputePipeline, pipeline), RESOURCE_TYPE_COMPUTE_PIPELINE);
+            case COMMAND_TYPE_POP_MARKER:
+            {
+                AddCommand(Commands::PopMarker());
+                return true;
+            }
+            case COMMAND_TYPE_PUSH_MARKER: return LoadCommandAsIs<Commands::PushMarker>(reader);
+            case COMMAND_TYPE_SET_SCISSOR_RECT: return LoadCommandAsIs<Commands::SetScissorRect>(reader);
+            case COMMAND_TYPE_SET_VIEWPORT: return LoadCommandAsIs<Commands::SetViewport>(reader);
+            default:
+                return false;
+        }
+    }
+    void CommandReplay::CreateResources(Renderer* renderer)
+    {
+        PROFILE_SCOPE("CommandReplay::CreateResources");
+        assert(!_resourcesCreated); // The captured IDs are gone once the resources have been created
+
+        IDRemap remaps[RESOURCE_TYPE_COUNT];
+        IDRemap& imageRemap = remaps[RESOURCE_TYPE_IMAGE];
+        IDRemap& depthImageRemap = remaps[RESOURCE_TYPE_DEPTH_IMAGE];
+
+        for (auto& image : _images)
+        {
+            ImageDesc desc = image.second;
+            imageRemap.emplace(image.first, static_cast<u16>(renderer->CreateImage(desc)));
+        }
+
+        for (auto& image : _depthImages)
+        {
+            DepthImageDesc desc = image.second;
+            depthImageRemap.emplace(image.first, static_cast<u16>(renderer->CreateDepthImage(desc)));
+        }
+
+        for (auto& model : _models)
+        {
+            CapturedModel captured = model.second;
+            ModelID id = captured.desc.path.empty() ? renderer->CreatePrimitiveModel(captured.primitiveDesc) : renderer->LoadModel(captured.desc);
+            remaps[RESOURCE_TYPE_MODEL].emplace(model.first, static_cast<u16>(id));
+        }
+
+        // Commands don't name shaders and materials, only pipelines do
+        IDRemap vertexShaderRemap;
+        IDRemap pixelShaderRemap;
+        IDRemap computeShaderRemap;
+        LoadShaders<VertexShaderDesc>(renderer, _vertexShaders, vertexShaderRemap);
+        LoadShaders<PixelShaderDesc>(renderer, _pixelShaders, pixelShaderRemap);
+        LoadShaders<ComputeShaderDesc>(renderer, _computeShaders, computeShaderRemap);
+
+        IDRemap materialRemap;
+        for (auto& material : _materials)
+        {
+            MaterialDesc desc;
+            desc.path = material.second;
+            materialRemap.emplace(material.first, static_cast<u16>(renderer->LoadMaterial(desc)));
+        }
+
+        // The pipelines bind the images they were captured with, resource i of the desc is the i-th of them
+        for (auto& pipeline : _graphicsPipelines)
+        {
+            const CapturedGraphicsPipeline& captured = pipeline.second;
+            ImageID textures[MAX_BOUND_TEXTURES];
+            ImageID renderTargets[MAX_RENDER_TARGETS];
+            DepthImageID depthStencil = DepthImageID(RemapID(depthImageRemap, static_cast<u16>(captured.depthStencil)));
+
+            GraphicsPipelineDesc desc;
+            desc.states = captured.states;
+            desc.states.vertexShader = VertexShaderID(RemapID(vertexShaderRemap, static_cast<u16>(captured.states.vertexShader)));
+            desc.states.pixelShader = PixelShaderID(RemapID(pixelShaderRemap, static_cast<u16>(captured.states.pixelShader)));
+
+            for (int i = 0; i < MAX_BOUND_TEXTURES; i++)
+            {
+                textures[i] = ImageID(RemapID(imageRemap, static_cast<u16>(captured.textures[i])));
+                if (captured.textures[i] != ImageID::Invalid())
+                {
+                    desc.textures[i] = RenderPassResource(static_cast<u16>(i));
+                }
+            }
+
+            for (int i = 0; i < MAX_RENDER_TARGETS; i++)
+            {
+                renderTargets[i] = ImageID(RemapID(imageRemap, static_cast<u16>(captured.renderTargets[i])));
+                if (captured.renderTargets[i] != ImageID::Invalid())
+                {
+                    desc.renderTargets[i] = RenderPassMutableResource(static_cast<u16>(i));
+                }
+            }
+
+            if (captured.depthStencil != DepthImageID::Invalid())
+            {
+                desc.depthStencil = RenderPassMutableResource(0);
+            }
+
+            // Backends keep the desc and look resources up again when the pipeline gets set, so these hold copies of what they return
+            desc.ResourceToImageID = [textures](RenderPassResource resource) { return textures[static_cast<u16>(resource)]; };
+            desc.ResourceToDepthImageID = [](RenderPassResource /*resource*/) { return DepthImageID::Invalid(); };
+            desc.MutableResourceToImageID = [renderTargets](RenderPassMutableResource resource) { return renderTargets[static_cast<u16>(resource)]; };
+            desc.MutableResourceToDepthImageID = [depthStencil](RenderPassMutableResource /*resource*/) { return depthStencil; };
+
+            remaps[RESOURCE_TYPE_GRAPHICS_PIPELINE].emplace(pipeline.first, static_cast<u16>(renderer->CreatePipeline(desc)));
+        }
+
+        for (auto& pipeline : _materialPipelines)
+        {
+            const CapturedMaterialPipeline& captured = pipeline.second;
+            ImageID renderTargets[MAX_RENDER_TARGETS];
+            DepthImageID depthStencil = DepthImageID(RemapID(depthImageRemap, static_cast<u16>(captured.depthStencil)));
+
+            MaterialPipelineDesc desc;
+            desc.material = MaterialID(RemapID(materialRemap, static_cast<u16>(captured.material)));
+            desc.states = captured.states;
+
+            for (int i = 0; i < MAX_RENDER_TARGETS; i++)
+            {
+                renderTargets[i] = ImageID(RemapID(imageRemap, static_cast<u16>(captured.renderTargets[i])));
+                if (captured.renderTargets[i] != ImageID::Invalid())
+                {
+                    desc.renderTargets[i] = RenderPassMutableResource(static_cast<u16>(i));
+                }
+            }
+
+            if (captured.depthStencil != DepthImageID::Invalid())
+            {
+                desc.depthStencil = RenderPassMutableResource(0);
+            }
+
+            desc.ResourceToDepthImageID = [](RenderPassResource /*resource*/) { return DepthImageID::Invalid(); };
+            desc.MutableResourceToImageID = [renderTargets](RenderPassMutableResource resource) { return renderTargets[static_cast<u16>(resource)]; };
+            desc.MutableResourceToDepthImageID = [depthStencil](RenderPassMutableResource /*resource*/) { return depthStencil; };
+
+            remaps[RESOURCE_TYPE_MATERIAL_PIPELINE].emplace(pipeline.first, static_cast<u16>(renderer->CreatePipeline(desc)));
+        }
+
+        for (auto& pipeline : _computePipelines)
+        {
+            ComputePipelineDesc desc = pipeline.second;
+            desc.computeShader = ComputeShaderID(RemapID(computeShaderRemap, static_cast<u16>(desc.computeShader)));
+            remaps[RESOURCE_TYPE_COMPUTE_PIPELINE].emplace(pipeline.first, static_cast<u16>(renderer->CreatePipeline(desc)));
+        }
+
+        for (const Fixup& fixup : _resourceFixups)
+        {
+            u16 id = 0;
+            memcpy(&id, &_data[fixup.offset], sizeof(u16));
+
+            id = RemapID(remaps[fixup.value], id);
+            memcpy(&_data[fixup.offset], &id, sizeof(u16));
+        }
+
+        _resourcesCreated = true;
+    }
+
+    void CommandReplay::CreateBuffers(Renderer* renderer)
+    {
+        std::vector<void*> gpuResources(_bufferSizes.size());
+        for (size_t i = 0; i < _bufferSizes.size(); i++)
+        {
+            Backend::ConstantBufferBackend* backend = renderer->CreateConstantBufferBackend(_bufferSizes[i]);
+            gpuResources[i] = backend->GetGPUResource(0);
+        }
+
+        for (const Fixup& fixup : _bufferFixups)
+        {
+            memcpy(&_data[fixup.offset], &gpuResources[fixup.value], sizeof(void*));
+        }
+
+        _bufferRenderer = renderer;
+    }
+
+    void CommandReplay::Replay(Renderer* renderer, u32 iterations)
+    {
+        PROFILE_SCOPE("CommandReplay::Replay");
+
+        if (_bufferRenderer != renderer)
+        {
+            CreateBuffers(renderer);
+        }
+
+        for (u32 i = 0; i < iterations; i++)
+        {
+            u64 iterationStart = Profiling::Profiler::GetTimestamp();
+
+            for (const ReplayCommandList& replayCommandList : _commandLists)
+            {
+                CommandListID commandList = renderer->BeginCommandList();
+
+                // Each command gets timed from the end of the one before, so timing costs one timestamp per command
+                u64 lastTimestamp = Profiling::Profiler::GetTimestamp();
+                for (u32 j = 0; j < replayCommandList.numCommands; j++)
+                {
+                    const ReplayCommand& command = _commands[replayCommandList.firstCommand + j];
+                    Commands::DISPATCH_FUNCTIONS[command.type](renderer, commandList, &_data[command.offset]);
+
+                    u64 timestamp = Profiling::Profiler::GetTimestamp();
+                    u64 duration = timestamp - lastTimestamp;
+                    lastTimestamp = timestamp;
+
+                    CommandReplayStats& stats = _stats[command.type];
+                    stats.numCommands++;
+                    stats.totalNS += duration;
+                    stats.maxNS = duration > stats.maxNS ? duration : stats.maxNS;
+                }
+
+                renderer->EndCommandList(commandList);
+            }
+
+            _totalNS += Profiling::Profiler::GetTimestamp() - iterationStart;
+        }
+
+        _numIterations += iterations;
+    }
+
+    void CommandReplay::LogStats() const
+    {
+        if (_numIterations == 0)
+            return;
+
+        f64 iterations = static_cast<f64>(_numIterations);
+        LOG_INFO(LOG_CATEGORY_RENDERER, "CommandReplay: %u commands in %u command lists, %.3f ms per iteration over %llu iterations",
+            GetNumCommands(), GetNumCommandLists(), static_cast<f64>(_totalNS) / iterations / 1000000.0, static_cast<unsigned long long>(_numIterations));
+
+        for (u32 i = 0; i < COMMAND_TYPE_COUNT; i++)
+        {
+            const CommandReplayStats& stats = _stats[i];
+            if (stats.numCommands == 0)
+                continue;
+
+            LOG_INFO(LOG_CATEGORY_RENDERER, "  %-20s %6llu per iteration, %9.3f us per iteration, %8.1f ns avg, %8.1f us max",
+                CommandTypeToString(static_cast<CommandType>(i)), static_cast<unsigned long long>(stats.numCommands / _numIterations),
+                static_cast<f64>(stats.totalNS) / iterations / 1000.0, static_cast<f64>(stats.totalNS) / static_cast<f64>(stats.numCommands), static_cast<f64>(stats.maxNS) / 1000.0);
+        }
+    }
+}
\ No newline at end of file
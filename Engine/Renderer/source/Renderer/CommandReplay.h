@@ -0,0 +1,119 @@
+#pragma once
+#include <Core.h>
+#include <string>
+#include <vector>
+#include "Commands/CommandType.h"
+#include "Descriptors/ImageDesc.h"
+#include "Descriptors/DepthImageDesc.h"
+#include "CommandCapture.h"
+
+namespace Renderer
+{
+    class Renderer;
+
+    struct CommandReplayStats
+    {
+        u64 numCommands = 0; // Summed over every iteration
+        u64 totalNS = 0;
+        u64 maxNS = 0;
+    };
+
+    // Loads a file written by CommandCapture and dispatches it against any Renderer as many times as asked, timing every command by type.
+    // Resource IDs get replayed as captured unless CreateResources creates them in the renderer first, which the renderer that captured them doesn't need.
+    // Buffers get created with the captured sizes and hold zeroes
+    class CommandReplay
+    {
+    public:
+        bool Load(const std::string& path);
+
+        // Creates every image, model and pipeline the capture used in renderer and replays with those, for renderers that don't have them already.
+        // Shaders, materials and models get loaded from the paths they were captured with
+        void CreateResources(Renderer* renderer);
+
+        void Replay(Renderer* renderer, u32 iterations);
+
+        const CommandReplayStats& GetStats(CommandType type) const { return _stats[type]; }
+        u64 GetNumIterations() const { return _numIterations; }
+        u64 GetTotalNS() const { return _totalNS; }
+        u32 GetNumCommands() const { return static_cast<u32>(_commands.size()); }
+        u32 GetNumCommandLists() const { return static_cast<u32>(_commandLists.size()); }
+
+        // Logs the time spent per iteration and in every command type that was replayed
+        void LogStats() const;
+
+    private:
+        struct ReplayCommand
+        {
+            CommandType type;
+            size_t offset; // Into _data
+        };
+
+        struct ReplayCommandList
+        {
+            u32 firstCommand;
+            u32 numCommands;
+        };
+
+        // What a resource fixup names, the IDs of all of them are u16s
+        enum ResourceType
+        {
+            RESOURCE_TYPE_IMAGE,
+            RESOURCE_TYPE_DEPTH_IMAGE,
+            RESOURCE_TYPE_MODEL,
+            RESOURCE_TYPE_GRAPHICS_PIPELINE,
+            RESOURCE_TYPE_MATERIAL_PIPELINE,
+            RESOURCE_TYPE_COMPUTE_PIPELINE,
+            RESOURCE_TYPE_COUNT
+        };
+
+        // Something in _data that can't be known until the file is loaded or the resources it names are created
+        struct Fixup
+        {
+            size_t offset; // Of the field in _data
+            size_t value; // An offset into _data for arrays, the buffer index for buffers and the ResourceType for resources
+        };
+
+        class CaptureReader;
+
+        template <typename Command>
+        size_t AddCommand(const Command& command);
+        size_t AddArray(const void* data, size_t size);
+
+        template <typename Command>
+        bool LoadCommandAsIs(CaptureReader& reader); // For commands that get captured as they are
+        template <typename Command>
+        bool LoadCommandWithResource(CaptureReader& reader, size_t resourceOffset, ResourceType resourceType); // For commands that get captured as they are and name a resource
+        template <typename Command>
+        bool LoadRenderPass(CaptureReader& reader);
+        bool LoadCommand(CommandType type, CaptureReader& reader);
+
+        void CreateBuffers(Renderer* renderer);
+
+    private:
+        std::vector<u8> _data; // The commands rebuilt the way CommandList records them, with whatever they point to right after
+        std::vector<ReplayCommand> _commands;
+        std::vector<ReplayCommandList> _commandLists;
+
+        std::vector<std::pair<u16, ImageDesc>> _images;
+        std::vector<std::pair<u16, DepthImageDesc>> _depthImages;
+        std::vector<size_t> _bufferSizes;
+        std::vector<std::pair<u16, std::string>> _vertexShaders;
+        std::vector<std::pair<u16, std::string>> _pixelShaders;
+        std::vector<std::pair<u16, std::string>> _computeShaders;
+        std::vector<std::pair<u16, std::string>> _materials;
+        std::vector<std::pair<u16, CapturedModel>> _models;
+        std::vector<std::pair<u16, CapturedGraphicsPipeline>> _graphicsPipelines;
+        std::vector<std::pair<u16, CapturedMaterialPipeline>> _materialPipelines;
+        std::vector<std::pair<u16, ComputePipelineDesc>> _computePipelines;
+
+        std::vector<Fixup> _arrayFixups; // Only used while loading
+        std::vector<Fixup> _resourceFixups;
+        std::vector<Fixup> _bufferFixups;
+        bool _resourcesCreated = false;
+        Renderer* _bufferRenderer = nullptr; // The buffers in _data belong to this renderer
+
+        CommandReplayStats _stats[COMMAND_TYPE_COUNT];
+        u64 _numIterations = 0;
+        u64 _totalNS = 0;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,42 @@
+#pragma once
+#include <Core.h>
+#include "CommandType.h"
+#include "../Descriptors/ImageDesc.h"
+#include "../Descriptors/DepthImageDesc.h"
+
+namespace Renderer
+{
+    enum RenderPassLoadAction
+    {
+        RENDER_PASS_LOAD_ACTION_LOAD, // Keep what the attachment already holds
+        RENDER_PASS_LOAD_ACTION_CLEAR, // Clear to the clear value the image was created with
+        RENDER_PASS_LOAD_ACTION_DISCARD // Whatever it holds is undefined, the pass overwrites all of it
+    };
+
+    enum RenderPassStoreAction
+    {
+        RENDER_PASS_STORE_ACTION_STORE, // Something reads it after the render pass
+        RENDER_PASS_STORE_ACTION_DISCARD // Nothing reads it after the render pass, the backend doesn't have to keep it
+    };
+
+    struct RenderPassAttachment
+    {
+        // Only one of these is valid
+        ImageID image = ImageID::Invalid();
+        DepthImageID depthImage = DepthImageID::Invalid();
+
+        RenderPassLoadAction loadAction = RENDER_PASS_LOAD_ACTION_LOAD;
+        RenderPassStoreAction storeAction = RENDER_PASS_STORE_ACTION_STORE;
+    };
+
+    namespace Commands
+    {
+        struct BeginRenderPass
+        {
+            static const CommandType TYPE = COMMAND_TYPE_BEGIN_RENDER_PASS;
+
+            const RenderPassAttachment* attachments = nullptr; // Points into memory owned by whoever recorded the command
+            u32 numAttachments = 0;
+        };
+    }
+}
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 #include <Core.h>
+#include "CommandType.h"
 #include "../Descriptors/ImageDesc.h"
 #include "../Descriptors/DepthImageDesc.h"
 
@@ -9,7 +10,7 @@ namespace Renderer
     {
         struct ClearImage
         {
-            static const BackendDispatchFunction DISPATCH_FUNCTION;
+            static const CommandType TYPE = COMMAND_TYPE_CLEAR_IMAGE;
 
             ImageID image = ImageID::Invalid();
             Vector4 color = Vector4(0, 0, 0, 1);
@@ -17,7 +18,7 @@ namespace Renderer
         
         struct ClearDepthImage
         {
-            static const BackendDispatchFunction DISPATCH_FUNCTION;
+            static const CommandType TYPE = COMMAND_TYPE_CLEAR_DEPTH_IMAGE;
 
             DepthImageID image = DepthImageID::Invalid();
             DepthClearFlags flags = DepthClearFlags::DEPTH_CLEAR_BOTH;
@@ -0,0 +1,37 @@
+#pragma once
+#include <Core.h>
+#include "../BackendDispatch.h"
+
+namespace Renderer
+{
+    // Every command a CommandList can record, the command stream stores this instead of a function pointer to keep its headers small
+    enum CommandType : u16
+    {
+        COMMAND_TYPE_BEGIN_RENDER_PASS,
+        COMMAND_TYPE_CLEAR_IMAGE,
+        COMMAND_TYPE_CLEAR_DEPTH_IMAGE,
+        COMMAND_TYPE_DRAW,
+        COMMAND_TYPE_DRAW_INSTANCED,
+        COMMAND_TYPE_END_RENDER_PASS,
+        COMMAND_TYPE_EXECUTE_BUNDLE,
+        COMMAND_TYPE_POP_MARKER,
+        COMMAND_TYPE_PUSH_MARKER,
+        COMMAND_TYPE_RESOURCE_BARRIERS,
+        COMMAND_TYPE_SET_CONSTANT_BUFFER,
+        COMMAND_TYPE_SET_GRAPHICS_PIPELINE,
+        COMMAND_TYPE_SET_MATERIAL_PIPELINE,
+        COMMAND_TYPE_SET_COMPUTE_PIPELINE,
+        COMMAND_TYPE_SET_SCISSOR_RECT,
+        COMMAND_TYPE_SET_VIEWPORT,
+
+        COMMAND_TYPE_COUNT
+    };
+
+    namespace Commands
+    {
+        // The BackendDispatch function replaying each CommandType, indexed by it
+        extern const BackendDispatchFunction DISPATCH_FUNCTIONS[COMMAND_TYPE_COUNT];
+    }
+
+    const char* CommandTypeToString(CommandType type);
+}
\ No newline at end of file
@@ -1,8 +1,14 @@
 #include "../BackendDispatch.h"
+#include "CommandType.h"
+#include "BeginRenderPass.h"
 #include "Clear.h"
 #include "Draw.h"
+#include "DrawInstanced.h"
+#include "EndRenderPass.h"
+#include "ExecuteBundle.h"
 #include "PopMarker.h"
 #include "PushMarker.h"
+#include "ResourceBarriers.h"
 #include "SetConstantBuffer.h"
 #include "SetPipeline.h"
 #include "SetScissorRect.h"
@@ -12,16 +18,49 @@ namespace Renderer
 {
     namespace Commands
     {
-        const BackendDispatchFunction ClearImage::DISPATCH_FUNCTION = &BackendDispatch::ClearImage;
-        const BackendDispatchFunction ClearDepthImage::DISPATCH_FUNCTION = &BackendDispatch::ClearDepthImage;
-        const BackendDispatchFunction Draw::DISPATCH_FUNCTION = &BackendDispatch::Draw;
-        const BackendDispatchFunction PopMarker::DISPATCH_FUNCTION = &BackendDispatch::PopMarker;
-        const BackendDispatchFunction PushMarker::DISPATCH_FUNCTION = &BackendDispatch::PushMarker;
-        const BackendDispatchFunction SetConstantBuffer::DISPATCH_FUNCTION = &BackendDispatch::SetConstantBuffer;
-        const BackendDispatchFunction SetGraphicsPipeline::DISPATCH_FUNCTION = &BackendDispatch::SetGraphicsPipeline;
-        const BackendDispatchFunction SetMaterialPipeline::DISPATCH_FUNCTION = &BackendDispatch::SetMaterialPipeline;
-        const BackendDispatchFunction SetComputePipeline::DISPATCH_FUNCTION = &BackendDispatch::SetComputePipeline;
-        const BackendDispatchFunction SetScissorRect::DISPATCH_FUNCTION = &BackendDispatch::SetScissorRect;
-        const BackendDispatchFunction SetViewport::DISPATCH_FUNCTION = &BackendDispatch::SetViewport;
+        const BackendDispatchFunction DISPATCH_FUNCTIONS[COMMAND_TYPE_COUNT] =
+        {
+            &BackendDispatch::BeginRenderPass, // COMMAND_TYPE_BEGIN_RENDER_PASS
+            &BackendDispatch::ClearImage, // COMMAND_TYPE_CLEAR_IMAGE
+            &BackendDispatch::ClearDepthImage, // COMMAND_TYPE_CLEAR_DEPTH_IMAGE
+            &BackendDispatch::Draw, // COMMAND_TYPE_DRAW
+            &BackendDispatch::DrawInstanced, // COMMAND_TYPE_DRAW_INSTANCED
+            &BackendDispatch::EndRenderPass, // COMMAND_TYPE_END_RENDER_PASS
+            &BackendDispatch::ExecuteBundle, // COMMAND_TYPE_EXECUTE_BUNDLE
+            &BackendDispatch::PopMarker, // COMMAND_TYPE_POP_MARKER
+            &BackendDispatch::PushMarker, // COMMAND_TYPE_PUSH_MARKER
+            &BackendDispatch::ResourceBarriers, // COMMAND_TYPE_RESOURCE_BARRIERS
+            &BackendDispatch::SetConstantBuffer, // COMMAND_TYPE_SET_CONSTANT_BUFFER
+            &BackendDispatch::SetGraphicsPipeline, // COMMAND_TYPE_SET_GRAPHICS_PIPELINE
+            &BackendDispatch::SetMaterialPipeline, // COMMAND_TYPE_SET_MATERIAL_PIPELINE
+            &BackendDispatch::SetComputePipeline, // COMMAND_TYPE_SET_COMPUTE_PIPELINE
+            &BackendDispatch::SetScissorRect, // COMMAND_TYPE_SET_SCISSOR_RECT
+            &BackendDispatch::SetViewport // COMMAND_TYPE_SET_VIEWPORT
+        };
     }
-}
+    const char* CommandTypeToString(CommandType type)
+    {
+        switch (type)
+        {
+            case COMMAND_TYPE_BEGIN_RENDER_PASS: return "BeginRenderPass";
+            case COMMAND_TYPE_CLEAR_IMAGE: return "ClearImage";
+            case COMMAND_TYPE_CLEAR_DEPTH_IMAGE: return "ClearDepthImage";
+            case COMMAND_TYPE_DRAW: return "Draw";
+            case COMMAND_TYPE_DRAW_INSTANCED: return "DrawInstanced";
+            case COMMAND_TYPE_END_RENDER_PASS: return "EndRenderPass";
+            case COMMAND_TYPE_EXECUTE_BUNDLE: return "ExecuteBundle";
+            case COMMAND_TYPE_POP_MARKER: return "PopMarker";
+            case COMMAND_TYPE_PUSH_MARKER: return "PushMarker";
+            case COMMAND_TYPE_RESOURCE_BARRIERS: return "ResourceBarriers";
+            case COMMAND_TYPE_SET_CONSTANT_BUFFER: return "SetConstantBuffer";
+            case COMMAND_TYPE_SET_GRAPHICS_PIPELINE: return "SetGraphicsPipeline";
+            case COMMAND_TYPE_SET_MATERIAL_PIPELINE: return "SetMaterialPipeline";
+            case COMMAND_TYPE_SET_COMPUTE_PIPELINE: return "SetComputePipeline";
+            case COMMAND_TYPE_SET_SCISSOR_RECT: return "SetScissorRect";
+            case COMMAND_TYPE_SET_VIEWPORT: return "SetViewport";
+            default:
+                assert(false); // Invalid command type, did we just add to the enum?
+        }
+        return "";
+    }
+}
\ No newline at end of file
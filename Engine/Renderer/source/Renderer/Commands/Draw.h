@@ -1,5 +1,6 @@
 #pragma once
 #include <Core.h>
+#include "CommandType.h"
 #include "../Descriptors/ModelDesc.h"
 #include "../InstanceData.h"
 
@@ -9,7 +10,7 @@ namespace Renderer
     {
         struct Draw
         {
-            static const BackendDispatchFunction DISPATCH_FUNCTION;
+            static const CommandType TYPE = COMMAND_TYPE_DRAW;
 
             ModelID model = ModelID::Invalid();
         };
@@ -0,0 +1,19 @@
+#pragma once
+#include <Core.h>
+#include "CommandType.h"
+#include "../Descriptors/ModelDesc.h"
+#include "../InstanceBuffer.h"
+
+namespace Renderer
+{
+    namespace Commands
+    {
+        struct DrawInstanced
+        {
+            static const CommandType TYPE = COMMAND_TYPE_DRAW_INSTANCED;
+
+            ModelID model = ModelID::Invalid();
+            InstanceRange instances;
+        };
+    }
+}
\ No newline at end of file
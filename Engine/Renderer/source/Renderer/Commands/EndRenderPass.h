@@ -0,0 +1,18 @@
+#pragma once
+#include <Core.h>
+#include "CommandType.h"
+#include "BeginRenderPass.h"
+
+namespace Renderer
+{
+    namespace Commands
+    {
+        struct EndRenderPass
+        {
+            static const CommandType TYPE = COMMAND_TYPE_END_RENDER_PASS;
+
+            const RenderPassAttachment* attachments = nullptr; // The same attachments as the BeginRenderPass, for their store actions
+            u32 numAttachments = 0;
+        };
+    }
+}
\ No newline at end of file
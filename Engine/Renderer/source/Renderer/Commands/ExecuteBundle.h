@@ -0,0 +1,18 @@
+#pragma once
+#include <Core.h>
+#include "CommandType.h"
+
+namespace Renderer
+{
+    class CommandBundle;
+
+    namespace Commands
+    {
+        struct ExecuteBundle
+        {
+            static const CommandType TYPE = COMMAND_TYPE_EXECUTE_BUNDLE;
+
+            const CommandBundle* bundle = nullptr; // Has to stay alive and not be recorded again until the list executing it has been executed
+        };
+    }
+}
\ No newline at end of file
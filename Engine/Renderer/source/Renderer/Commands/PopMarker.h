@@ -1,5 +1,6 @@
 #pragma once
 #include <Core.h>
+#include "CommandType.h"
 
 namespace Renderer
 {
@@ -7,7 +8,7 @@ namespace Renderer
     {
         struct PopMarker
         {
-            static const BackendDispatchFunction DISPATCH_FUNCTION;
+            static const CommandType TYPE = COMMAND_TYPE_POP_MARKER;
         };
     }
 }
\ No newline at end of file
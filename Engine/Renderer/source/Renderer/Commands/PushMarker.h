@@ -1,5 +1,6 @@
 #pragma once
 #include <Core.h>
+#include "CommandType.h"
 
 namespace Renderer
 {
@@ -7,7 +8,7 @@ namespace Renderer
     {
         struct PushMarker
         {
-            static const BackendDispatchFunction DISPATCH_FUNCTION;
+            static const CommandType TYPE = COMMAND_TYPE_PUSH_MARKER;
 
             Vector3 color = Vector3(1, 1, 1);
             char marker[16];
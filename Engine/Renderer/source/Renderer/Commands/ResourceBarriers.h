@@ -0,0 +1,51 @@
+#pragma once
+#include <Core.h>
+#include "CommandType.h"
+#include "../Descriptors/ImageDesc.h"
+#include "../Descriptors/DepthImageDesc.h"
+
+namespace Renderer
+{
+    // Backend agnostic resource states, read states can be combined
+    enum ResourceState
+    {
+        RESOURCE_STATE_COMMON = 0,
+        RESOURCE_STATE_RENDER_TARGET = 1 << 0,
+        RESOURCE_STATE_UNORDERED_ACCESS = 1 << 1,
+        RESOURCE_STATE_DEPTH_WRITE = 1 << 2,
+        RESOURCE_STATE_DEPTH_READ = 1 << 3,
+        RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE = 1 << 4,
+        RESOURCE_STATE_PIXEL_SHADER_RESOURCE = 1 << 5
+    };
+
+    enum ResourceBarrierType
+    {
+        RESOURCE_BARRIER_TYPE_TRANSITION,
+        RESOURCE_BARRIER_TYPE_UAV, // Waits for earlier unordered access writes to the resource
+        RESOURCE_BARRIER_TYPE_ALIASING // The resource takes over memory it shares with other resources
+    };
+
+    struct ResourceBarrier
+    {
+        ResourceBarrierType type = RESOURCE_BARRIER_TYPE_TRANSITION;
+
+        // Only one of these is valid
+        ImageID image = ImageID::Invalid();
+        DepthImageID depthImage = DepthImageID::Invalid();
+
+        // Only used by transitions
+        ResourceState before = RESOURCE_STATE_COMMON;
+        ResourceState after = RESOURCE_STATE_COMMON;
+    };
+
+    namespace Commands
+    {
+        struct ResourceBarriers
+        {
+            static const CommandType TYPE = COMMAND_TYPE_RESOURCE_BARRIERS;
+
+            const ResourceBarrier* barriers = nullptr; // Points into memory owned by whoever recorded the command
+            u32 numBarriers = 0;
+        };
+    }
+}
\ No newline at end of file
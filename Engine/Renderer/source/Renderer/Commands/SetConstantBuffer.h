@@ -1,5 +1,6 @@
 #pragma once
 #include <Core.h>
+#include "CommandType.h"
 #include "../ConstantBuffer.h"
 
 namespace Renderer
@@ -8,7 +9,7 @@ namespace Renderer
     {
         struct SetConstantBuffer
         {
-            static const BackendDispatchFunction DISPATCH_FUNCTION;
+            static const CommandType TYPE = COMMAND_TYPE_SET_CONSTANT_BUFFER;
 
             u32 slot = 0;
             void* gpuResource = nullptr;
@@ -1,5 +1,6 @@
 #pragma once
 #include <Core.h>
+#include "CommandType.h"
 #include "../Descriptors/GraphicsPipelineDesc.h"
 #include "../Descriptors/ComputePipelineDesc.h"
 #include "../Descriptors/MaterialDesc.h"
@@ -10,21 +11,21 @@ namespace Renderer
     {
         struct SetGraphicsPipeline
         {
-            static const BackendDispatchFunction DISPATCH_FUNCTION;
+            static const CommandType TYPE = COMMAND_TYPE_SET_GRAPHICS_PIPELINE;
 
             GraphicsPipelineID pipeline = GraphicsPipelineID::Invalid();
         };
 
         struct SetMaterialPipeline
         {
-            static const BackendDispatchFunction DISPATCH_FUNCTION;
+            static const CommandType TYPE = COMMAND_TYPE_SET_MATERIAL_PIPELINE;
 
             MaterialPipelineID pipeline = MaterialPipelineID::Invalid();
         };
         
         struct SetComputePipeline
         {
-            static const BackendDispatchFunction DISPATCH_FUNCTION;
+            static const CommandType TYPE = COMMAND_TYPE_SET_COMPUTE_PIPELINE;
 
             ComputePipelineID pipeline = ComputePipelineID::Invalid();
         };
@@ -1,5 +1,6 @@
 #pragma once
 #include <Core.h>
+#include "CommandType.h"
 #include "../RenderStates.h"
 
 namespace Renderer
@@ -8,7 +9,7 @@ namespace Renderer
     {
         struct SetScissorRect
         {
-            static const BackendDispatchFunction DISPATCH_FUNCTION;
+            static const CommandType TYPE = COMMAND_TYPE_SET_SCISSOR_RECT;
 
             ScissorRect scissorRect;
         };
@@ -1,4 +1,5 @@
 #pragma once
+#include <Profiling/FrameStats.h>
 
 namespace Renderer
 {
@@ -8,6 +9,7 @@ namespace Renderer
         {
             virtual ~ConstantBufferBackend() {}
             virtual void Apply(u32 frameIndex, void* data, size_t size) = 0;
+            virtual void Write(u32 frameIndex, size_t offset, const void* data, size_t size) = 0; // Writes part of the buffer, Apply writes from the start
             virtual void* GetGPUResource(u32 frameIndex) = 0;
         };
     }
@@ -25,6 +27,7 @@ namespace Renderer
         void Apply(u32 frameIndex)
         {
             backend->Apply(frameIndex, &resource, GetSize());
+            Profiling::FrameStats::AddCounter(Profiling::FRAME_COUNTER_BYTES_UPLOADED, GetSize());
         }
 
         void* GetGPUResource(u32 frameIndex)
@@ -35,7 +38,7 @@ namespace Renderer
         Backend::ConstantBufferBackend* backend = nullptr;
 
 
-        ConstantBuffer(ConstantBuffer<T>& copy)
+        ConstantBuffer(const ConstantBuffer<T>& copy)
         {
             backend = copy.backend;
             resource = copy.resource;
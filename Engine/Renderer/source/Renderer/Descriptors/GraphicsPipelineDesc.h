@@ -34,6 +34,7 @@ namespace Renderer
             DepthStencilState depthStencilState;
             BlendState blendState;
             ConstantBufferState constantBufferStates[MAX_CONSTANT_BUFFERS];
+            InstanceBufferState instanceBufferState;
             InputLayout inputLayouts[MAX_INPUT_LAYOUTS];
             Sampler samplers[MAX_BOUND_TEXTURES];
 
@@ -5,6 +5,7 @@
 namespace Memory
 {
     class Allocator;
+    class PerThreadStackAllocator;
 }
 
 namespace Renderer
@@ -13,6 +14,16 @@ namespace Renderer
 
     struct RenderGraphDesc
     {
-        Memory::Allocator* allocator;
+        Memory::Allocator* allocator; // The passes and the compiled graph live here
+
+        // Optional, set this to keep the graph across frames. Whatever only lasts a frame, like compiling and recording, comes from here instead of allocator,
+        // so reset it every frame and keep allocator around as long as the graph
+        Memory::Allocator* frameAllocator = nullptr;
+
+        // Optional, when this is set and the JobSystem is running, passes get recorded in parallel with their commands allocated from here
+        Memory::PerThreadStackAllocator* threadAllocator = nullptr;
+
+        // The constant buffer slot the constant buffers of RenderViews get bound to
+        u32 viewConstantBufferSlot = 0;
     };
 }
\ No newline at end of file
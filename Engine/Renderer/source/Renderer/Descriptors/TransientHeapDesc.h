@@ -0,0 +1,16 @@
+#pragma once
+#include <Core.h>
+#include <Utils/StrongTypedef.h>
+
+namespace Renderer
+{
+    // Memory that RenderGraph transient images get placed in
+    struct TransientHeapDesc
+    {
+        size_t size = 0;
+        size_t alignment = 0;
+    };
+
+    // Lets strong-typedef an ID type with the underlying type of u16
+    STRONG_TYPEDEF(TransientHeapID, u16);
+}
\ No newline at end of file
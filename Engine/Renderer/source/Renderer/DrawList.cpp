@@ -0,0 +1,253 @@
+#include "DrawList.h"
+#include "CommandList.h"
+#include "InstanceBuffer.h"
+#include "InstanceData.h"
+#include <Profiling/Profiler.h>
+
+namespace Renderer
+{
+    namespace
+    {
+        const u32 RADIX_BITS = 8;
+        const u32 RADIX_SIZE = 1 << RADIX_BITS;
+        const u32 RADIX_PASSES = 64 / RADIX_BITS;
+
+        u64 GetPipelineBits(const DrawPacket& packet)
+        {
+            const u64 halfRange = 1ull << (DrawList::PIPELINE_BITS - 1);
+
+            if (packet.graphicsPipeline != GraphicsPipelineID::Invalid())
+            {
+                using type = type_safe::underlying_type<GraphicsPipelineID>;
+                u64 pipeline = static_cast<type>(packet.graphicsPipeline);
+                assert(pipeline + 1 < halfRange); // Out of key bits for graphics pipelines
+                return pipeline + 1;
+            }
+
+            if (packet.materialPipeline != MaterialPipelineID::Invalid())
+            {
+                using type = type_safe::underlying_type<MaterialPipelineID>;
+                u64 pipeline = static_cast<type>(packet.materialPipeline);
+                assert(pipeline < halfRange); // Out of key bits for material pipelines
+                return halfRange + pipeline;
+            }
+
+            return 0;
+        }
+
+        u64 GetMaterialBits(const DrawPacket& packet)
+        {
+            if (packet.material == MaterialID::Invalid())
+                return 0;
+
+            using type = type_safe::underlying_type<MaterialID>;
+            u64 material = static_cast<type>(packet.material);
+            assert(material + 1 < (1ull << DrawList::MATERIAL_BITS)); // Out of key bits for materials
+            return material + 1;
+        }
+
+        u64 GetDepthBits(f32 depth)
+        {
+            const f32 maxDepth = static_cast<f32>((1u << DrawList::DEPTH_BITS) - 1);
+
+            depth = depth < 0.0f ? 0.0f : (depth > 1.0f ? 1.0f : depth);
+            return static_cast<u64>(depth * maxDepth);
+        }
+    }
+
+    DrawList::DrawList(Memory::Allocator* allocator, size_t capacity)
+        : _allocator(allocator)
+        , _numPackets(0)
+        , _capacity(capacity)
+    {
+        _packets = Memory::Allocator::NewArray<DrawPacket>(allocator, capacity);
+        _sortKeys = Memory::Allocator::NewArray<SortKey>(allocator, capacity);
+    }
+
+    void DrawList::AddDraw(const DrawPacket& packet)
+    {
+        assert(_numPackets < _capacity); // Create the DrawList with room for every draw, it doesn't grow
+
+        _packets[_numPackets] = packet;
+        _sortKeys[_numPackets].key = CalculateKey(packet);
+        _sortKeys[_numPackets].packet = static_cast<u32>(_numPackets);
+        _numPackets++;
+    }
+
+    u64 DrawList::CalculateKey(const DrawPacket& packet)
+    {
+        assert(packet.view < (1u << VIEW_BITS)); // Out of key bits for views
+        assert(packet.pass < (1u << PASS_BITS)); // Out of key bits for passes
+
+        using type = type_safe::underlying_type<ModelID>;
+        u64 model = static_cast<type>(packet.model);
+        assert(model < (1ull << MODEL_BITS)); // Out of key bits for models
+
+        u64 pipeline = GetPipelineBits(packet);
+        u64 material = GetMaterialBits(packet);
+        u64 depth = GetDepthBits(packet.depth);
+
+        u64 key = static_cast<u64>(packet.view);
+        key = (key << PASS_BITS) | packet.pass;
+        key = (key << 1) | (packet.translucent ? 1 : 0);
+
+        if (packet.translucent)
+        {
+            // Back to front is what makes blending right, so depth goes first and inverted
+            key = (key << DEPTH_BITS) | (((1ull << DEPTH_BITS) - 1) - depth);
+            key = (key << PIPELINE_BITS) | pipeline;
+            key = (key << MATERIAL_BITS) | material;
+            key = (key << MODEL_BITS) | model;
+        }
+        else
+        {
+            // Depth only orders draws sharing state, front to back so early depth rejects as much as it can
+            key = (key << PIPELINE_BITS) | pipeline;
+            key = (key << MATERIAL_BITS) | material;
+            key = (key << MODEL_BITS) | model;
+            key = (key << DEPTH_BITS) | depth;
+        }
+
+        return key;
+    }
+
+    void DrawList::Sort()
+    {
+        PROFILE_SCOPE("DrawList::Sort");
+
+        if (_numPackets < 2)
+            return;
+
+        // Least significant digit first, one histogram pass over the keys counts every digit up front
+        u32* histograms = Memory::Allocator::NewArray<u32>(_allocator, RADIX_PASSES * RADIX_SIZE);
+        memset(histograms, 0, sizeof(u32) * RADIX_PASSES * RADIX_SIZE);
+
+        for (size_t i = 0; i < _numPackets; i++)
+        {
+            u64 key = _sortKeys[i].key;
+            for (u32 pass = 0; pass < RADIX_PASSES; pass++)
+            {
+                histograms[pass * RADIX_SIZE + ((key >> (pass * RADIX_BITS)) & (RADIX_SIZE - 1))]++;
+            }
+        }
+
+        SortKey* source = _sortKeys;
+        SortKey* destination = Memory::Allocator::NewArray<SortKey>(_allocator, _numPackets);
+
+        for (u32 pass = 0; pass < RADIX_PASSES; pass++)
+        {
+            u32* histogram = &histograms[pass * RADIX_SIZE];
+            u32 shift = pass * RADIX_BITS;
+
+            // Most of the key is the same for every draw, a digit they all share can't reorder anything
+            if (histogram[(source[0].key >> shift) & (RADIX_SIZE - 1)] == _numPackets)
+                continue;
+
+            u32 offset = 0;
+            for (u32 digit = 0; digit < RADIX_SIZE; digit++)
+            {
+                u32 count = histogram[digit];
+                histogram[digit] = offset;
+                offset += count;
+            }
+
+            for (size_t i = 0; i < _numPackets; i++)
+            {
+                u32 digit = static_cast<u32>((source[i].key >> shift) & (RADIX_SIZE - 1));
+                destination[histogram[digit]++] = source[i];
+            }
+
+            SortKey* sorted = destination;
+            destination = source;
+            source = sorted;
+        }
+
+        if (source != _sortKeys)
+        {
+            memcpy(_sortKeys, source, sizeof(SortKey) * _numPackets);
+        }
+    }
+
+    void DrawList::Submit(CommandList& commandList, u32 instanceConstantBufferSlot, const PipelineChangedFunction& onPipelineChanged)
+    {
+        PROFILE_SCOPE("DrawList::Submit");
+
+        GraphicsPipelineID graphicsPipeline = GraphicsPipelineID::Invalid();
+        MaterialPipelineID materialPipeline = MaterialPipelineID::Invalid();
+        void* constantBuffer = nullptr;
+
+        for (size_t i = 0; i < _numPackets; i++)
+        {
+            const DrawPacket& packet = _packets[_sortKeys[i].packet];
+
+            if (SetPipeline(commandList, packet, graphicsPipeline, materialPipeline, onPipelineChanged))
+            {
+                constantBuffer = nullptr;
+            }
+
+            if (packet.constantBuffer != nullptr && packet.constantBuffer != constantBuffer)
+            {
+                commandList.SetConstantBuffer(instanceConstantBufferSlot, packet.constantBuffer);
+                constantBuffer = packet.constantBuffer;
+            }
+
+            commandList.Draw(packet.model);
+        }
+    }
+
+    void DrawList::Submit(CommandList& commandList, InstanceBuffer& instanceBuffer, const PipelineChangedFunction& onPipelineChanged)
+    {
+        PROFILE_SCOPE("DrawList::Submit");
+
+        if (_numPackets == 0)
+            return;
+
+        GraphicsPipelineID graphicsPipeline = GraphicsPipelineID::Invalid();
+        MaterialPipelineID materialPipeline = MaterialPipelineID::Invalid();
+
+        // One range for the whole list, so neighbouring packets always get neighbouring instances
+        InstanceRange range = instanceBuffer.Allocate(static_cast<u32>(_numPackets));
+
+        for (u32 i = 0; i < range.count; i++)
+        {
+            const DrawPacket& packet = _packets[_sortKeys[i].packet];
+            assert(packet.instance != nullptr); // Instanced submits need the instance of every packet
+
+            SetPipeline(commandList, packet, graphicsPipeline, materialPipeline, onPipelineChanged);
+
+            instanceBuffer.Write(range, i, packet.instance->GetInstanceConstants());
+
+            InstanceRange instance;
+            instance.gpuResource = range.gpuResource;
+            instance.first = range.first + i;
+            instance.count = 1;
+            commandList.DrawInstanced(packet.model, instance);
+        }
+    }
+
+    bool DrawList::SetPipeline(CommandList& commandList, const DrawPacket& packet, GraphicsPipelineID& graphicsPipeline, MaterialPipelineID& materialPipeline, const PipelineChangedFunction& onPipelineChanged)
+    {
+        if (packet.graphicsPipeline != GraphicsPipelineID::Invalid() && packet.graphicsPipeline != graphicsPipeline)
+        {
+            commandList.SetPipeline(packet.graphicsPipeline);
+            graphicsPipeline = packet.graphicsPipeline;
+            materialPipeline = MaterialPipelineID::Invalid();
+        }
+        else if (packet.materialPipeline != MaterialPipelineID::Invalid() && packet.materialPipeline != materialPipeline)
+        {
+            commandList.SetPipeline(packet.materialPipeline);
+            materialPipeline = packet.materialPipeline;
+            graphicsPipeline = GraphicsPipelineID::Invalid();
+        }
+        else
+        {
+            return false;
+        }
+
+        if (onPipelineChanged)
+        {
+            onPipelineChanged(commandList);
+        }
+        return true;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,86 @@
+#pragma once
+#include <Core.h>
+#include <functional>
+#include <Memory/Allocator.h>
+#include "Descriptors/GraphicsPipelineDesc.h"
+#include "Descriptors/MaterialDesc.h"
+#include "Descriptors/ModelDesc.h"
+
+namespace Renderer
+{
+    class CommandList;
+    class InstanceBuffer;
+    struct InstanceData;
+
+    struct DrawPacket
+    {
+        u8 view = 0; // Lets several views share one list, draws stay grouped per view
+        u8 pass = 0;
+        bool translucent = false;
+
+        // Only one of these is valid, or neither if the pass sets its own pipeline
+        GraphicsPipelineID graphicsPipeline = GraphicsPipelineID::Invalid();
+        MaterialPipelineID materialPipeline = MaterialPipelineID::Invalid();
+
+        MaterialID material = MaterialID::Invalid(); // Only used for sorting
+        ModelID model = ModelID::Invalid();
+        f32 depth = 0.0f; // Distance from the view, 0 at the camera and 1 at the furthest anything gets sorted
+        void* constantBuffer = nullptr; // Bound to the instance slot right before the draw
+        const InstanceData* instance = nullptr; // Written to the InstanceBuffer when submitting instanced
+    };
+
+    // Collects draws and sorts them by a 64 bit key before expanding them into commands, instead of drawing in whatever order they were found in.
+    // Keys sort by view, pass and opaque before translucent. Opaque draws group by pipeline, material and model and go front to back inside those,
+    // translucent draws go back to front and only group by pipeline where depths tie.
+    class DrawList
+    {
+    public:
+        static const u32 VIEW_BITS = 6;
+        static const u32 PASS_BITS = 6;
+        static const u32 PIPELINE_BITS = 12; // Graphics pipelines in the lower half, material pipelines in the upper half and 0 for none
+        static const u32 MATERIAL_BITS = 11;
+        static const u32 MODEL_BITS = 12;
+        static const u32 DEPTH_BITS = 16;
+
+        typedef std::function<void(CommandList&)> PipelineChangedFunction;
+
+        DrawList(Memory::Allocator* allocator, size_t capacity);
+
+        void AddDraw(const DrawPacket& packet);
+        void Clear() { _numPackets = 0; }
+
+        // Radix sorts the packets by key, call it once after adding every draw
+        void Sort();
+
+        // Records the packets in sorted order, pipelines and constant buffers only get set when they change.
+        // Setting a pipeline resets its bindings, so onPipelineChanged gets called after every pipeline change to bind anything else the draws need.
+        // Every packet stays its own Draw since its instance is bound as a constant buffer, material pipelines read instances that way so their draws never merge
+        void Submit(CommandList& commandList, u32 instanceConstantBufferSlot, const PipelineChangedFunction& onPipelineChanged = nullptr);
+
+        // Same as above but every packet's instance gets written to the InstanceBuffer in sorted order and drawn with DrawInstanced,
+        // so the CommandList merges consecutive packets of the same model into one draw. The pipelines need InstanceBufferState enabled
+        void Submit(CommandList& commandList, InstanceBuffer& instanceBuffer, const PipelineChangedFunction& onPipelineChanged = nullptr);
+
+        size_t Count() const { return _numPackets; }
+
+        static u64 CalculateKey(const DrawPacket& packet);
+
+    private:
+        struct SortKey
+        {
+            u64 key;
+            u32 packet; // Index into _packets, the packets themselves never move
+        };
+
+        // Sets the packet's pipeline if it differs from the bound one, returns whether it did
+        static bool SetPipeline(CommandList& commandList, const DrawPacket& packet, GraphicsPipelineID& graphicsPipeline, MaterialPipelineID& materialPipeline, const PipelineChangedFunction& onPipelineChanged);
+
+    private:
+        Memory::Allocator* _allocator;
+
+        DrawPacket* _packets;
+        SortKey* _sortKeys;
+        size_t _numPackets;
+        size_t _capacity;
+    };
+}
\ No newline at end of file
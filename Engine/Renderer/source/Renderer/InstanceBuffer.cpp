@@ -0,0 +1,30 @@
+#include "InstanceBuffer.h"
+#include <cassert>
+
+namespace Renderer
+{
+    void InstanceBuffer::Reset(u32 frameIndex)
+    {
+        _frameIndex = frameIndex;
+        _numAllocated = 0;
+    }
+
+    InstanceRange InstanceBuffer::Allocate(u32 count)
+    {
+        InstanceRange range;
+        range.gpuResource = _backend->GetGPUResource(_frameIndex);
+        range.first = _numAllocated.fetch_add(count);
+        range.count = count;
+
+        assert(range.first + count <= _capacity); // Create the InstanceBuffer with room for every instance drawn in a frame
+        return range;
+    }
+
+    void InstanceBuffer::Write(const InstanceRange& range, u32 index, const InstanceConstants& constants)
+    {
+        assert(index < range.count); // Writing outside of the range
+
+        _backend->Write(_frameIndex, static_cast<size_t>(range.first + index) * STRIDE, &constants, STRIDE);
+        Profiling::FrameStats::AddCounter(Profiling::FRAME_COUNTER_BYTES_UPLOADED, STRIDE);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,65 @@
+#pragma once
+#include <Core.h>
+#include <atomic>
+#include "ConstantBuffer.h"
+
+namespace Renderer
+{
+    // What instanced draws read per instance, laid out like the start of ModelConstantBuffer so shaders see the same data either way
+    struct InstanceConstants
+    {
+        Vector4 colorMultiplier; // 16 bytes
+        Matrix modelMatrix; // 64 bytes
+    };
+
+    // Instances in an InstanceBuffer, instanced draws bind the buffer at the first one so shaders index it with SV_InstanceID
+    struct InstanceRange
+    {
+        void* gpuResource = nullptr;
+        u32 first = 0;
+        u32 count = 0;
+    };
+
+    // Per frame upload memory for the instances of instanced draws. Reset it once a frame before recording, after that Allocate and Write can be called from any thread
+    class InstanceBuffer
+    {
+    public:
+        static const u32 STRIDE = sizeof(InstanceConstants);
+
+        InstanceBuffer(const InstanceBuffer& copy)
+            : _backend(copy._backend)
+            , _capacity(copy._capacity)
+            , _frameIndex(copy._frameIndex)
+            , _numAllocated(0)
+        {
+
+        }
+
+        void Reset(u32 frameIndex);
+
+        // Instances get handed out front to back, so ranges allocated one after another on the same thread are usually contiguous
+        InstanceRange Allocate(u32 count);
+        void Write(const InstanceRange& range, u32 index, const InstanceConstants& constants);
+
+        u32 GetNumAllocated() const { return _numAllocated.load(); }
+        u32 GetCapacity() const { return _capacity; }
+
+    protected:
+        InstanceBuffer(Backend::ConstantBufferBackend* backend, u32 capacity) // This has to be created through Renderer::CreateInstanceBuffer
+            : _backend(backend)
+            , _capacity(capacity)
+            , _frameIndex(0)
+            , _numAllocated(0)
+        {
+
+        }
+
+        friend class Renderer;
+
+    private:
+        Backend::ConstantBufferBackend* _backend;
+        u32 _capacity;
+        u32 _frameIndex;
+        std::atomic<u32> _numAllocated;
+    };
+}
\ No newline at end of file
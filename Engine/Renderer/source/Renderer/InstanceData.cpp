@@ -1,5 +1,6 @@
 #include "InstanceData.h"
 #include "Renderer.h"
+#include <Utils/XXHash64.h>
 
 namespace Renderer
 {
@@ -27,4 +28,22 @@ namespace Renderer
     {
         return modelCB.GetGPUResource(frameIndex);
     }
+
+    InstanceConstants InstanceData::GetInstanceConstants() const
+    {
+        InstanceConstants constants;
+        constants.colorMultiplier = modelCB.resource.colorMultiplier;
+        constants.modelMatrix = modelCB.resource.modelMatrix;
+        return constants;
+    }
+
+    u64 InstanceData::GetTransformHash() const
+    {
+        XXHash64 hash(0);
+        hash.add(&colorMultiplier, sizeof(Vector4));
+        hash.add(&position, sizeof(Vector3));
+        hash.add(&rotation, sizeof(Vector3));
+        hash.add(&scale, sizeof(Vector3));
+        return hash.hash();
+    }
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 #include <Core.h>
 #include "ConstantBuffer.h"
+#include "InstanceBuffer.h"
 
 namespace Renderer
 {
@@ -26,6 +27,11 @@ namespace Renderer
 
         void Apply(u32 frameIndex);
         void* GetGPUResource(u32 frameIndex);
+        InstanceConstants GetInstanceConstants() const; // What the last Apply wrote, for instanced draws
+
+        // Changes whenever colorMultiplier, position, rotation or scale does. They get set directly, so this hashes them instead of counting changes.
+        // Lets whatever got built from the instance, like a CommandBundle, tell when it has to Apply and build it again
+        u64 GetTransformHash() const;
 
     private:
         ConstantBuffer<ModelConstantBuffer> modelCB;
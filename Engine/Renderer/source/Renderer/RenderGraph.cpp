@@ -1,10 +1,51 @@
 #include "RenderGraph.h"
 #include "RenderGraphBuilder.h"
+#include <Profiling/Profiler.h>
+#include <Profiling/FrameStats.h>
+#include <Memory/PerThreadStackAllocator.h>
+#include <Jobs/JobSystem.h>
+#include <Logging/Logger.h>
+#include <algorithm>
+#include <cstdio>
+#include <functional>
 
 #include "Renderer.h"
 
 namespace Renderer
 {
+    namespace
+    {
+        const u16 INVALID_PASS = 0xFFFF;
+        const u32 INVALID_INDEX = 0xFFFFFFFF;
+        const u32 INVALID_RENDER_PASS = 0xFFFFFFFF;
+        const u32 FNV1A_32_OFFSET_BASIS = 2166136261u;
+        const u32 FNV1A_32_PRIME = 16777619u;
+
+        struct CompileEdge
+        {
+            u16 from;
+            u16 to;
+            bool carriesData; // The later pass reads what the earlier one wrote, otherwise the edge only keeps their order
+        };
+
+        struct ReaderNode
+        {
+            u16 pass;
+            u32 next;
+        };
+
+        // Continues an fnv1a_32 hash with the bytes of value
+        u32 HashValue(u32 hash, u32 value)
+        {
+            for (u32 i = 0; i < 4; i++)
+            {
+                hash = (hash ^ ((value >> (i * 8)) & 0xFF)) * FNV1A_32_PRIME;
+            }
+
+            return hash;
+        }
+    }
+
     bool RenderGraph::Init(RenderGraphDesc& desc)
     {
         _desc = desc;
@@ -30,26 +71,1225 @@ namespace Renderer
 
     void RenderGraph::Setup()
     {
-        for (IRenderPass* pass : _passes)
+        PROFILE_SCOPE("RenderGraph::Setup");
+
+        u32 numPasses = static_cast<u32>(_passes.Count());
+        assert(numPasses < INVALID_PASS); // Pass indices are stored as u16 while compiling
+
+        _renderGraphBuilder->Reset();
+
+        bool* passEnabled = Memory::Allocator::NewArray<bool>(GetFrameAllocator(), numPasses + 1);
+        for (u32 i = 0; i < numPasses; i++)
+        {
+            _renderGraphBuilder->SetCurrentPass(static_cast<u16>(i));
+            passEnabled[i] = _passes[i]->Setup(_renderGraphBuilder);
+        }
+
+        // Setups declare the same passes and resources every frame almost always, transients included since their placeholder IDs only depend on the order they're created in
+        u32 topologyHash = GetTopologyHash(passEnabled);
+        bool isHashMatch = _isCompiled && topologyHash == _topologyHash;
+        bool isSameTopology = isHashMatch && _topology == _compiledTopology;
+        if (isHashMatch && !isSameTopology)
+        {
+            LOG_WARNING(LOG_CATEGORY_RENDERER, "RenderGraph: Two topologies share the hash %08x, recompiling", topologyHash);
+        }
+
+        if (isSameTopology)
+        {
+            // The compiled graph still holds, only the IDs of this frame's transients need filling in
+            PlaceTransients();
+            ResolveBarriers();
+            ResolveRenderPasses();
+        }
+        else
+        {
+            _topologyHash = topologyHash;
+            _compiledTopology.swap(_topology);
+            if (!Compile(passEnabled))
+            {
+                assert(false); // The RenderGraph has a hazard or a cycle, the log says which passes
+            }
+        }
+
+        Profiling::FrameStats::AddCounter(Profiling::FRAME_COUNTER_RENDERGRAPH_PASSES_CULLED, _numCulledPasses);
+        Profiling::FrameStats::AddCounter(Profiling::FRAME_COUNTER_RENDERGRAPH_PASSES_MERGED, _numMergedPasses);
+        Profiling::FrameStats::AddCounter(Profiling::FRAME_COUNTER_TRANSIENT_BYTES_SAVED, _transientBytesRequested - _transientBytesAllocated);
+    }
+
+    u32 RenderGraph::GetTopologyHash(const bool* passEnabled)
+    {
+        PROFILE_SCOPE("RenderGraph::GetTopologyHash");
+
+        using Access = RenderGraphBuilder::ResourceAccess;
+        using ImageType = type_safe::underlying_type<ImageID>;
+        using DepthImageType = type_safe::underlying_type<DepthImageID>;
+
+        // The topology is kept word for word next to its hash, so a hash that matches by accident can't hand this frame another graph's barriers
+        _topology.clear();
+
+        u32 numPasses = static_cast<u32>(_passes.Count());
+        _topology.push_back(numPasses);
+        for (u32 i = 0; i < numPasses; i++)
+        {
+            _topology.push_back((passEnabled[i] ? 1u : 0u) | (static_cast<u32>(_renderGraphBuilder->_passDeclarations[i].queue) << 1));
+        }
+
+        _topology.push_back(static_cast<u32>(_renderGraphBuilder->_trackedImages.Count()));
+        for (ImageID& image : _renderGraphBuilder->_trackedImages)
+        {
+            _topology.push_back(static_cast<ImageType>(image));
+        }
+        _topology.push_back(static_cast<u32>(_renderGraphBuilder->_trackedDepthImages.Count()));
+        for (DepthImageID& image : _renderGraphBuilder->_trackedDepthImages)
+        {
+            _topology.push_back(static_cast<DepthImageType>(image));
+        }
+
+        // The desc index changes whenever a transient's desc does, so resizing one recompiles the graph
+        _topology.push_back(static_cast<u32>(_renderGraphBuilder->_transientImages.Count()));
+        for (u32& desc : _renderGraphBuilder->_transientImages)
+        {
+            _topology.push_back(desc);
+        }
+        _topology.push_back(static_cast<u32>(_renderGraphBuilder->_transientDepthImages.Count()));
+        for (u32& desc : _renderGraphBuilder->_transientDepthImages)
+        {
+            _topology.push_back(desc);
+        }
+
+        _topology.push_back(static_cast<u32>(_renderGraphBuilder->_accesses.Count()));
+        for (Access& access : _renderGraphBuilder->_accesses)
+        {
+            _topology.push_back((static_cast<u32>(access.pass) << 16) | access.resource);
+            _topology.push_back((access.isDepth ? 1u : 0u) | (access.isWrite ? 2u : 0u) | (static_cast<u32>(access.shaderStage) << 2) | (static_cast<u32>(access.writeMode) << 8) | (static_cast<u32>(access.loadMode) << 16));
+        }
+
+        u32 hash = FNV1A_32_OFFSET_BASIS;
+        for (u32 value : _topology)
+        {
+            hash = HashValue(hash, value);
+        }
+
+        return hash;
+    }
+
+    bool RenderGraph::Compile(const bool* passEnabled)
+    {
+        PROFILE_SCOPE("RenderGraph::Compile");
+
+        using Access = RenderGraphBuilder::ResourceAccess;
+        DynamicArray<Access>& accesses = _renderGraphBuilder->_accesses;
+        Memory::Allocator* allocator = GetFrameAllocator();
+
+        u32 numPasses = static_cast<u32>(_passes.Count());
+        u32 numAccesses = static_cast<u32>(accesses.Count());
+        u32 numImages = static_cast<u32>(_renderGraphBuilder->_trackedImages.Count());
+        u32 numResources = numImages + static_cast<u32>(_renderGraphBuilder->_trackedDepthImages.Count());
+        bool isValid = true;
+
+        _numCompiles++;
+        _isCompiled = true;
+        Profiling::FrameStats::AddCounter(Profiling::FRAME_COUNTER_RENDERGRAPH_COMPILES, 1);
+        _executingPasses.Clear();
+
+        // Everything compiling needs comes from the frame allocator and is thrown away with the frame, only the results are kept
+        _transientIndices.resize(numResources);
+        for (u32 i = 0; i < numResources; i++)
+        {
+            _transientIndices[i] = i < numImages ? _renderGraphBuilder->GetTransientIndex(_renderGraphBuilder->_trackedImages[i]) : _renderGraphBuilder->GetTransientIndex(_renderGraphBuilder->_trackedDepthImages[i - numImages]);
+        }
+
+        u16* lastWriter = Memory::Allocator::NewArray<u16>(allocator, numResources);
+        u32* firstReader = Memory::Allocator::NewArray<u32>(allocator, numResources); // Passes that read the resource since it was last written, as a list through readers
+        u16* lastReadBy = Memory::Allocator::NewArray<u16>(allocator, numResources);
+        u16* lastWrittenBy = Memory::Allocator::NewArray<u16>(allocator, numResources);
+        for (u32 i = 0; i < numResources; i++)
+        {
+            lastWriter[i] = INVALID_PASS;
+            firstReader[i] = INVALID_INDEX;
+            lastReadBy[i] = INVALID_PASS;
+            lastWrittenBy[i] = INVALID_PASS;
+        }
+
+        ReaderNode* readers = Memory::Allocator::NewArray<ReaderNode>(allocator, numAccesses + 1);
+        u32 numReaders = 0;
+
+        u32* firstAccess = Memory::Allocator::NewArray<u32>(allocator, numPasses + 1); // Accesses declared by pass i are [firstAccess[i], firstAccess[i + 1])
+        u32* firstEdge = Memory::Allocator::NewArray<u32>(allocator, numPasses + 1); // Edges into pass i are [firstEdge[i], firstEdge[i + 1])
+        u32* newestEdgeFrom = Memory::Allocator::NewArray<u32>(allocator, numPasses); // So a pass that depends on another through several resources only gets one edge
+        for (u32 i = 0; i < numPasses; i++)
+        {
+            newestEdgeFrom[i] = INVALID_INDEX;
+        }
+        DynamicArray<CompileEdge> edges(allocator, numAccesses + 1);
+
+        auto addEdge = [&](u16 from, u16 to, bool carriesData)
+        {
+            u32 newest = newestEdgeFrom[from];
+            if (newest != INVALID_INDEX && edges[newest].to == to)
+            {
+                edges[newest].carriesData |= carriesData;
+                return;
+            }
+
+            CompileEdge edge;
+            edge.from = from;
+            edge.to = to;
+            edge.carriesData = carriesData;
+
+            newestEdgeFrom[from] = static_cast<u32>(edges.Count());
+            edges.Insert(edge);
+        };
+
+        // Derive the edges from the reads and writes in declaration order, Setup ran the passes in order so each pass's accesses are contiguous
+        u32 accessIndex = 0;
+        for (u32 pass = 0; pass < numPasses; pass++)
+        {
+            firstAccess[pass] = accessIndex;
+            firstEdge[pass] = static_cast<u32>(edges.Count());
+            u16 passIndex = static_cast<u16>(pass);
+
+            for (; accessIndex < numAccesses && accesses[accessIndex].pass == passIndex; accessIndex++)
+            {
+                if (!passEnabled[pass])
+                    continue; // Passes that returned false from setup don't take part, even if they declared resources before deciding that
+
+                const Access& access = accesses[accessIndex];
+                u32 resource = access.isDepth ? numImages + access.resource : access.resource;
+
+                if (access.isWrite)
+                {
+                    if (lastReadBy[resource] == passIndex || lastWrittenBy[resource] == passIndex)
+                    {
+                        char resourceName[64];
+                        GetResourceName(resource, resourceName, sizeof(resourceName));
+                        LOG_ERROR(LOG_CATEGORY_RENDERER, "RenderGraph: Pass \"%s\" %s %s, a pass can only read or write a resource once", _passes[pass]->GetName(), lastReadBy[resource] == passIndex ? "reads and writes" : "writes twice to", resourceName);
+                        isValid = false;
+                        continue;
+                    }
+
+                    // Loading needs what the previous writer left behind, clearing or discarding only has to happen after it
+                    if (lastWriter[resource] != INVALID_PASS)
+                    {
+                        addEdge(lastWriter[resource], passIndex, access.loadMode == RenderGraphBuilder::LOAD_MODE_LOAD);
+                    }
+
+                    // Write after read, everyone reading the old contents has to be done first
+                    for (u32 reader = firstReader[resource]; reader != INVALID_INDEX; reader = readers[reader].next)
+                    {
+                        addEdge(readers[reader].pass, passIndex, false);
+                    }
+
+                    firstReader[resource] = INVALID_INDEX;
+                    lastWriter[resource] = passIndex;
+                    lastWrittenBy[resource] = passIndex;
+                }
+                else
+                {
+                    if (lastWrittenBy[resource] == passIndex)
+                    {
+                        char resourceName[64];
+                        GetResourceName(resource, resourceName, sizeof(resourceName));
+                        LOG_ERROR(LOG_CATEGORY_RENDERER, "RenderGraph: Pass \"%s\" reads and writes %s, a pass can only read or write a resource once", _passes[pass]->GetName(), resourceName);
+                        isValid = false;
+                        continue;
+                    }
+
+                    if (lastReadBy[resource] == passIndex)
+                        continue; // Reading it twice changes nothing
+
+                    if (lastWriter[resource] != INVALID_PASS)
+                    {
+                        addEdge(lastWriter[resource], passIndex, true);
+                    }
+
+                    readers[numReaders].pass = passIndex;
+                    readers[numReaders].next = firstReader[resource];
+                    firstReader[resource] = numReaders++;
+                    lastReadBy[resource] = passIndex;
+                }
+            }
+        }
+        firstAccess[numPasses] = numAccesses;
+        firstEdge[numPasses] = static_cast<u32>(edges.Count());
+
+        // Cull, the final contents of every imported resource are what the graph outputs so their last writers are needed, and so is every pass feeding data into a needed pass.
+        // Transients die with the graph so writing them alone doesn't keep a pass alive.
+        // Edges always point from an earlier pass to a later one so a single backwards sweep finds all of them
+        bool* isNeeded = Memory::Allocator::NewArray<bool>(allocator, numPasses);
+        for (u32 i = 0; i < numPasses; i++)
+        {
+            isNeeded[i] = false;
+        }
+        for (u32 i = 0; i < numResources; i++)
+        {
+            if (lastWriter[i] != INVALID_PASS && _transientIndices[i] == RenderGraphBuilder::INVALID_TRANSIENT)
+            {
+                isNeeded[lastWriter[i]] = true;
+            }
+        }
+        for (u32 pass = numPasses; pass-- > 0;)
+        {
+            if (!isNeeded[pass])
+                continue;
+
+            for (u32 edge = firstEdge[pass]; edge < firstEdge[pass + 1]; edge++)
+            {
+                if (edges[edge].carriesData)
+                {
+                    isNeeded[edges[edge].from] = true;
+                }
+            }
+        }
+
+        // Topologically sort the needed passes, picking the earliest declared pass whenever several are ready so independent passes keep the order they were added in
+        u32* numDependencies = Memory::Allocator::NewArray<u32>(allocator, numPasses);
+        u32* firstDependent = Memory::Allocator::NewArray<u32>(allocator, numPasses + 1); // Passes depending on pass i are dependents[firstDependent[i]] onwards
+        for (u32 i = 0; i <= numPasses; i++)
+        {
+            firstDependent[i] = 0;
+        }
+        for (u32 i = 0; i < numPasses; i++)
+        {
+            numDependencies[i] = 0;
+        }
+
+        u32 numEdges = static_cast<u32>(edges.Count());
+        for (u32 i = 0; i < numEdges; i++)
+        {
+            const CompileEdge& edge = edges[i];
+            if (isNeeded[edge.from] && isNeeded[edge.to])
+            {
+                numDependencies[edge.to]++;
+                firstDependent[edge.from + 1]++;
+            }
+        }
+        for (u32 i = 0; i < numPasses; i++)
+        {
+            firstDependent[i + 1] += firstDependent[i];
+        }
+
+        u16* dependents = Memory::Allocator::NewArray<u16>(allocator, numEdges + 1);
+        u32* dependentsFilled = Memory::Allocator::NewArray<u32>(allocator, numPasses);
+        for (u32 i = 0; i < numPasses; i++)
+        {
+            dependentsFilled[i] = firstDependent[i];
+        }
+        for (u32 i = 0; i < numEdges; i++)
+        {
+            const CompileEdge& edge = edges[i];
+            if (isNeeded[edge.from] && isNeeded[edge.to])
+            {
+                dependents[dependentsFilled[edge.from]++] = edge.to;
+            }
+        }
+
+        u16* ready = Memory::Allocator::NewArray<u16>(allocator, numPasses + 1); // A min-heap of pass indices
+        u32 numReady = 0;
+        u32 numNeeded = 0;
+        u32 numEnabled = 0;
+        for (u32 i = 0; i < numPasses; i++)
+        {
+            numEnabled += passEnabled[i] ? 1 : 0;
+            if (!isNeeded[i])
+                continue;
+
+            numNeeded++;
+            if (numDependencies[i] == 0)
+            {
+                ready[numReady++] = static_cast<u16>(i);
+                std::push_heap(ready, ready + numReady, std::greater<u16>());
+            }
+        }
+
+        u16* executionOrder = Memory::Allocator::NewArray<u16>(allocator, numPasses + 1);
+        u32 numSorted = 0;
+        while (numReady > 0)
+        {
+            std::pop_heap(ready, ready + numReady, std::greater<u16>());
+            u16 pass = ready[--numReady];
+
+            _executingPasses.Insert(_passes[pass]);
+            executionOrder[numSorted++] = pass;
+
+            for (u32 i = firstDependent[pass]; i < firstDependent[pass + 1]; i++)
+            {
+                u16 dependent = dependents[i];
+                if (--numDependencies[dependent] == 0)
+                {
+                    ready[numReady++] = dependent;
+                    std::push_heap(ready, ready + numReady, std::greater<u16>());
+                }
+            }
+        }
+
+        // Edges only come from accesses in declaration order so this can't happen today, but keep the check so anything adding edges later can't silently drop passes
+        if (numSorted != numNeeded)
+        {
+            for (u32 i = 0; i < numPasses; i++)
+            {
+                if (isNeeded[i] && numDependencies[i] > 0)
+                {
+                    LOG_ERROR(LOG_CATEGORY_RENDERER, "RenderGraph: Pass \"%s\" is part of a dependency cycle", _passes[i]->GetName());
+                    _executingPasses.Insert(_passes[i]); // Still run it, in declaration order
+                    executionOrder[numSorted++] = static_cast<u16>(i);
+                }
+            }
+            isValid = false;
+        }
+
+        _numCulledPasses = numEnabled - numNeeded;
+        _executionOrder.assign(executionOrder, executionOrder + numSorted);
+
+        ScheduleQueues(executionOrder, numSorted, firstAccess, firstDependent, dependents);
+        AllocateTransients(executionOrder, numSorted, firstAccess);
+        PlanBarriers(executionOrder, numSorted, firstAccess);
+        PlanRenderPasses(executionOrder, numSorted, firstAccess);
+
+        return isValid;
+    }
+
+    void RenderGraph::ScheduleQueues(const u16* executionOrder, u32 numExecuting, const u32* firstAccess, const u32* firstDependent, const u16* dependents)
+    {
+        PROFILE_SCOPE("RenderGraph::ScheduleQueues");
+
+        using Access = RenderGraphBuilder::ResourceAccess;
+        using Queue = RenderGraphBuilder::Queue;
+        DynamicArray<Access>& accesses = _renderGraphBuilder->_accesses;
+        Memory::Allocator* allocator = GetFrameAllocator();
+
+        u32 numPasses = static_cast<u32>(_passes.Count());
+        u32 numImages = static_cast<u32>(_renderGraphBuilder->_trackedImages.Count());
+
+        u32* executingIndex = Memory::Allocator::NewArray<u32>(allocator, numPasses + 1);
+        for (u32 i = 0; i < numPasses; i++)
+        {
+            executingIndex[i] = INVALID_INDEX;
+        }
+
+        _passQueues.resize(numExecuting);
+        for (u32 i = 0; i < numExecuting; i++)
+        {
+            u16 pass = executionOrder[i];
+            executingIndex[pass] = i;
+
+            // Compute queues can't rasterize or move resources in or out of the states rasterizing uses, passes needing that stay on the graphics queue
+            Queue queue = _renderGraphBuilder->_passDeclarations[pass].queue;
+            for (u32 accessIndex = firstAccess[pass]; accessIndex < firstAccess[pass + 1] && queue == RenderGraphBuilder::QUEUE_ASYNC_COMPUTE; accessIndex++)
+            {
+                const Access& access = accesses[accessIndex];
+                bool isRenderTarget = access.isWrite && access.writeMode == RenderGraphBuilder::WRITE_MODE_RENDERTARGET;
+                bool isRasterRead = !access.isWrite && ((access.shaderStage & RenderGraphBuilder::SHADER_STAGE_PIXEL) || (access.isDepth && access.shaderStage == RenderGraphBuilder::SHADER_STAGE_NONE));
+
+                if (isRenderTarget || isRasterRead)
+                {
+                    char resourceName[64];
+                    GetResourceName(access.isDepth ? numImages + access.resource : access.resource, resourceName, sizeof(resourceName));
+                    LOG_WARNING(LOG_CATEGORY_RENDERER, "RenderGraph: Pass \"%s\" is on the async compute queue but %s %s, it runs on the graphics queue instead", _passes[pass]->GetName(), isRenderTarget ? "renders to" : "rasterizes with", resourceName);
+                    queue = RenderGraphBuilder::QUEUE_GRAPHICS;
+                }
+            }
+
+            _passQueues[i] = queue;
+        }
+
+        // The latest pass on every other queue each pass depends on, waiting for that covers everything before it on that queue.
+        // Passes execute in order so going through them in order leaves the latest one
+        u32* latestDependency = Memory::Allocator::NewArray<u32>(allocator, numExecuting * RenderGraphBuilder::QUEUE_COUNT + 1);
+        for (u32 i = 0; i < numExecuting * RenderGraphBuilder::QUEUE_COUNT; i++)
+        {
+            latestDependency[i] = INVALID_INDEX;
+        }
+        for (u32 i = 0; i < numExecuting; i++)
+        {
+            u16 pass = executionOrder[i];
+            for (u32 j = firstDependent[pass]; j < firstDependent[pass + 1]; j++)
+            {
+                u32 dependent = executingIndex[dependents[j]];
+                if (dependent == INVALID_INDEX || dependent < i || _passQueues[dependent] == _passQueues[i])
+                    continue; // Same queue, or a cycle that got executed in declaration order anyway
+
+                latestDependency[dependent * RenderGraphBuilder::QUEUE_COUNT + _passQueues[i]] = i;
+            }
+        }
+
+        // A queue that already waited for a pass at least as late on the other queue doesn't have to wait again
+        u32 lastWaitedFor[RenderGraphBuilder::QUEUE_COUNT * RenderGraphBuilder::QUEUE_COUNT]; // Waiting queue * QUEUE_COUNT + signaling queue
+        for (u32& waitedFor : lastWaitedFor)
+        {
+            waitedFor = INVALID_INDEX;
+        }
+
+        _queueSyncs.clear();
+        for (u32 i = 0; i < numExecuting; i++)
+        {
+            for (u32 queue = 0; queue < RenderGraphBuilder::QUEUE_COUNT; queue++)
+            {
+                u32 latest = latestDependency[i * RenderGraphBuilder::QUEUE_COUNT + queue];
+                u32& waitedFor = lastWaitedFor[_passQueues[i] * RenderGraphBuilder::QUEUE_COUNT + queue];
+                if (latest == INVALID_INDEX || (waitedFor != INVALID_INDEX && waitedFor >= latest))
+                    continue;
+
+                QueueSync sync;
+                sync.signalPass = latest;
+                sync.waitPass = i;
+                _queueSyncs.push_back(sync);
+
+                waitedFor = latest;
+            }
+        }
+    }
+
+    void RenderGraph::LogSchedule()
+    {
+        LOG_INFO(LOG_CATEGORY_RENDERER, "RenderGraph: %u passes, %u queue syncs", static_cast<u32>(_executingPasses.Count()), static_cast<u32>(_queueSyncs.size()));
+        for (u32 i = 0; i < _executingPasses.Count(); i++)
+        {
+            LOG_INFO(LOG_CATEGORY_RENDERER, "    %s \"%s\"", _passQueues[i] == RenderGraphBuilder::QUEUE_ASYNC_COMPUTE ? "async compute" : "graphics", _executingPasses[i]->GetName());
+        }
+        for (QueueSync& sync : _queueSyncs)
+        {
+            LOG_INFO(LOG_CATEGORY_RENDERER, "    \"%s\" waits for \"%s\"", _executingPasses[sync.waitPass]->GetName(), _executingPasses[sync.signalPass]->GetName());
+        }
+    }
+
+    namespace
+    {
+        size_t AlignUp(size_t value, size_t alignment)
+        {
+            return (value + alignment - 1) / alignment * alignment;
+        }
+    }
+
+    void RenderGraph::AllocateTransients(const u16* executionOrder, u32 numExecuting, const u32* firstAccess)
+    {
+        PROFILE_SCOPE("RenderGraph::AllocateTransients");
+
+        using Access = RenderGraphBuilder::ResourceAccess;
+        DynamicArray<Access>& accesses = _renderGraphBuilder->_accesses;
+        Memory::Allocator* allocator = GetFrameAllocator();
+        TransientResourcePool& pool = _renderer->GetTransientResourcePool();
+
+        u32 numImages = static_cast<u32>(_renderGraphBuilder->_trackedImages.Count());
+        u32 numResources = numImages + static_cast<u32>(_renderGraphBuilder->_trackedDepthImages.Count());
+
+        // Lifetimes in executing passes, a transient only needs its memory from the first pass touching it to the last one
+        u16* firstUse = Memory::Allocator::NewArray<u16>(allocator, numResources + 1);
+        u16* lastUse = Memory::Allocator::NewArray<u16>(allocator, numResources + 1);
+        bool* isUsedAsync = Memory::Allocator::NewArray<bool>(allocator, numResources + 1);
+        for (u32 i = 0; i < numResources; i++)
+        {
+            firstUse[i] = INVALID_PASS;
+            lastUse[i] = INVALID_PASS;
+            isUsedAsync[i] = false;
+        }
+
+        for (u32 i = 0; i < numExecuting; i++)
+        {
+            u16 pass = executionOrder[i];
+            for (u32 accessIndex = firstAccess[pass]; accessIndex < firstAccess[pass + 1]; accessIndex++)
+            {
+                const Access& access = accesses[accessIndex];
+                u32 resource = access.isDepth ? numImages + access.resource : access.resource;
+                if (_transientIndices[resource] == RenderGraphBuilder::INVALID_TRANSIENT)
+                    continue;
+
+                isUsedAsync[resource] |= _passQueues[i] != RenderGraphBuilder::QUEUE_GRAPHICS;
+                if (firstUse[resource] == INVALID_PASS)
+                {
+                    firstUse[resource] = static_cast<u16>(i);
+                    if (!access.isWrite || access.loadMode == RenderGraphBuilder::LOAD_MODE_LOAD)
+                    {
+                        char resourceName[64];
+                        GetResourceName(resource, resourceName, sizeof(resourceName));
+                        LOG_WARNING(LOG_CATEGORY_RENDERER, "RenderGraph: Pass \"%s\" is the first to use %s but loads it, its contents are undefined until something clears or writes it", _passes[pass]->GetName(), resourceName);
+                    }
+                }
+                lastUse[resource] = static_cast<u16>(i);
+            }
+        }
+
+        TransientPlacement* placements = Memory::Allocator::NewArray<TransientPlacement>(allocator, numResources + 1);
+        u32 numPlacements = 0;
+        _transientBytesRequested = 0;
+        for (u32 i = 0; i < numResources; i++)
+        {
+            if (firstUse[i] == INVALID_PASS)
+                continue; // Not transient, or only used by culled passes
+
+            bool isDepth = i >= numImages;
+            TransientPlacement& placement = placements[numPlacements++];
+            placement.resource = isDepth ? i - numImages : i;
+            placement.isDepth = isDepth;
+            placement.desc = isDepth ? _renderGraphBuilder->_transientDepthImages[_transientIndices[i]] : _renderGraphBuilder->_transientImages[_transientIndices[i]];
+            placement.block = 0;
+            placement.offset = 0;
+            placement.alignment = pool.GetAlignment(placement.desc, isDepth);
+            placement.size = AlignUp(pool.GetSize(placement.desc, isDepth), placement.alignment);
+            placement.firstPass = firstUse[i];
+            placement.lastPass = lastUse[i];
+
+            // Passes on other queues overlap with whatever isn't ordered against them, so transients they touch keep their memory for the whole graph
+            if (isUsedAsync[i])
+            {
+                placement.firstPass = 0;
+                placement.lastPass = static_cast<u16>(numExecuting - 1);
+            }
+
+            _transientBytesRequested += placement.size;
+        }
+
+        // Place the biggest transients first, each at the lowest offset of the first block of its alignment class where it doesn't overlap anything alive at the same time
+        std::sort(placements, placements + numPlacements, [](const TransientPlacement& a, const TransientPlacement& b)
+        {
+            if (a.size != b.size)
+                return a.size > b.size;
+
+            return a.firstPass < b.firstPass;
+        });
+
+        DynamicArray<TransientHeapDesc> blocks(allocator, 8);
+        for (u32 i = 0; i < numPlacements; i++)
+        {
+            TransientPlacement& placement = placements[i];
+
+            bool isPlaced = false;
+            u32 numBlocks = static_cast<u32>(blocks.Count());
+            for (u32 block = 0; block < numBlocks && !isPlaced; block++)
+            {
+                if (blocks[block].alignment != placement.alignment)
+                    continue;
+
+                // Every move only goes up, so this settles on the lowest offset that fits between the others
+                size_t offset = 0;
+                bool hasMoved = true;
+                while (hasMoved)
+                {
+                    hasMoved = false;
+                    for (u32 j = 0; j < i; j++)
+                    {
+                        const TransientPlacement& other = placements[j];
+                        bool livesTogether = other.firstPass <= placement.lastPass && placement.firstPass <= other.lastPass;
+                        bool overlaps = offset < other.offset + other.size && other.offset < offset + placement.size;
+
+                        if (other.block == block && livesTogether && overlaps)
+                        {
+                            offset = AlignUp(other.offset + other.size, placement.alignment);
+                            hasMoved = true;
+                        }
+                    }
+                }
+
+                if (offset + placement.size > TransientResourcePool::MAX_BLOCK_SIZE)
+                    continue;
+
+                placement.block = block;
+                placement.offset = offset;
+                blocks[block].size = std::max(blocks[block].size, offset + placement.size);
+                isPlaced = true;
+            }
+
+            if (!isPlaced)
+            {
+                TransientHeapDesc block;
+                block.size = placement.size; // Transients bigger than MAX_BLOCK_SIZE end up alone in their own block
+                block.alignment = placement.alignment;
+
+                placement.block = numBlocks;
+                placement.offset = 0;
+                blocks.Insert(block);
+            }
+        }
+
+        u32 numBlocks = static_cast<u32>(blocks.Count());
+        _transientBlocks.resize(numBlocks);
+        _transientBytesAllocated = 0;
+        for (u32 i = 0; i < numBlocks; i++)
+        {
+            _transientBlocks[i] = blocks[i];
+            _transientBytesAllocated += blocks[i].size;
+        }
+
+        _aliasingPlan.Clear();
+        for (u32 i = 0; i < numPlacements; i++)
+        {
+            _aliasingPlan.Insert(placements[i]);
+        }
+
+        PlaceTransients();
+    }
+
+    void RenderGraph::PlaceTransients()
+    {
+        TransientResourcePool& pool = _renderer->GetTransientResourcePool();
+
+        // Every frame, so blocks the graph uses don't look unused to the pool while it keeps reusing its compiled plan
+        pool.ReserveBlocks(_transientBlocks.data(), static_cast<u32>(_transientBlocks.size()));
+
+        // Swap the placeholder IDs for the real images, passes get them through the builder while executing
+        for (TransientPlacement& placement : _aliasingPlan)
+        {
+            if (placement.isDepth)
+            {
+                _renderGraphBuilder->_trackedDepthImages[placement.resource] = pool.GetDepthImage(placement.desc, placement.block, placement.offset);
+            }
+            else
+            {
+                _renderGraphBuilder->_trackedImages[placement.resource] = pool.GetImage(placement.desc, placement.block, placement.offset);
+            }
+        }
+    }
+
+    void RenderGraph::GetResourceName(u32 resource, char* name, size_t nameSize)
+    {
+        u32 numImages = static_cast<u32>(_renderGraphBuilder->_trackedImages.Count());
+        bool isDepth = resource >= numImages;
+        u32 index = isDepth ? resource - numImages : resource;
+
+        u32 transient = _transientIndices[resource];
+        if (transient != RenderGraphBuilder::INVALID_TRANSIENT)
+        {
+            u32 desc = isDepth ? _renderGraphBuilder->_transientDepthImages[transient] : _renderGraphBuilder->_transientImages[transient];
+            snprintf(name, nameSize, "transient %s \"%s\"", isDepth ? "depth image" : "image", GetTransientName(desc, isDepth));
+        }
+        else
+        {
+            snprintf(name, nameSize, "%s %u", isDepth ? "depth image" : "image", index);
+        }
+    }
+
+    const char* RenderGraph::GetTransientName(u32 desc, bool isDepth)
+    {
+        TransientResourcePool& pool = _renderer->GetTransientResourcePool();
+        return isDepth ? pool.GetDepthImageDesc(desc).debugName.c_str() : pool.GetImageDesc(desc).debugName.c_str();
+    }
+
+    void RenderGraph::LogAliasingPlan()
+    {
+        LOG_INFO(LOG_CATEGORY_RENDERER, "RenderGraph: %u transients, %llu bytes requested, %llu bytes allocated", static_cast<u32>(_aliasingPlan.Count()), static_cast<unsigned long long>(_transientBytesRequested), static_cast<unsigned long long>(_transientBytesAllocated));
+        for (u32 i = 0; i < _aliasingPlan.Count(); i++)
+        {
+            LOG_INFO(LOG_CATEGORY_RENDERER, "    \"%s\" block %u offset %llu size %llu, passes \"%s\" to \"%s\"", GetTransientName(_aliasingPlan[i].desc, _aliasingPlan[i].isDepth), _aliasingPlan[i].block,
+                static_cast<unsigned long long>(_aliasingPlan[i].offset), static_cast<unsigned long long>(_aliasingPlan[i].size), _executingPasses[_aliasingPlan[i].firstPass]->GetName(), _executingPasses[_aliasingPlan[i].lastPass]->GetName());
+        }
+    }
+
+    namespace
+    {
+        // The state imported images are in outside of the graph, backends create them like this and Present expects them like this
+        ResourceState GetHomeState(bool isDepth)
+        {
+            return isDepth ? RESOURCE_STATE_DEPTH_WRITE : RESOURCE_STATE_RENDER_TARGET;
+        }
+
+        ResourceState GetRequiredState(bool isDepth, bool isWrite, RenderGraphBuilder::ShaderStage shaderStage, RenderGraphBuilder::WriteMode writeMode)
+        {
+            if (isWrite)
+            {
+                if (writeMode == RenderGraphBuilder::WRITE_MODE_UAV)
+                    return RESOURCE_STATE_UNORDERED_ACCESS;
+
+                return GetHomeState(isDepth);
+            }
+
+            u32 state = RESOURCE_STATE_COMMON;
+            if (shaderStage & RenderGraphBuilder::SHADER_STAGE_PIXEL)
+            {
+                state |= RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+            }
+            if (shaderStage & (RenderGraphBuilder::SHADER_STAGE_VERTEX | RenderGraphBuilder::SHADER_STAGE_COMPUTE))
+            {
+                state |= RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE;
+            }
+
+            if (isDepth)
+            {
+                state |= RESOURCE_STATE_DEPTH_READ; // Without a shader stage it's only depth tested against
+            }
+            else if (state == RESOURCE_STATE_COMMON)
+            {
+                state = RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+            }
+
+            return static_cast<ResourceState>(state);
+        }
+    }
+
+    void RenderGraph::PlanBarriers(const u16* executionOrder, u32 numExecuting, const u32* firstAccess)
+    {
+        PROFILE_SCOPE("RenderGraph::PlanBarriers");
+
+        using Access = RenderGraphBuilder::ResourceAccess;
+        DynamicArray<Access>& accesses = _renderGraphBuilder->_accesses;
+        Memory::Allocator* allocator = GetFrameAllocator();
+
+        u32 numImages = static_cast<u32>(_renderGraphBuilder->_trackedImages.Count());
+        u32 numResources = numImages + static_cast<u32>(_renderGraphBuilder->_trackedDepthImages.Count());
+        u32 numAccesses = static_cast<u32>(accesses.Count());
+
+        ResourceState* states = Memory::Allocator::NewArray<ResourceState>(allocator, numResources);
+        u32* readStates = Memory::Allocator::NewArray<u32>(allocator, numResources);
+        for (u32 i = 0; i < numResources; i++)
+        {
+            states[i] = GetHomeState(i >= numImages);
+            readStates[i] = RESOURCE_STATE_COMMON;
+        }
+
+        // Walk backwards first so every read knows what the following reads need before the next write, that way a resource read by
+        // several passes in a row transitions once into a combined state instead of bouncing between read states
+        u32* mergedReadStates = Memory::Allocator::NewArray<u32>(allocator, numAccesses + 1);
+        for (u32 i = numExecuting; i-- > 0;)
+        {
+            u16 pass = executionOrder[i];
+            for (u32 accessIndex = firstAccess[pass]; accessIndex < firstAccess[pass + 1]; accessIndex++)
+            {
+                const Access& access = accesses[accessIndex];
+                u32 resource = access.isDepth ? numImages + access.resource : access.resource;
+
+                if (access.isWrite)
+                {
+                    readStates[resource] = RESOURCE_STATE_COMMON;
+                }
+                else
+                {
+                    readStates[resource] |= GetRequiredState(access.isDepth, false, access.shaderStage, access.writeMode);
+                    mergedReadStates[accessIndex] = readStates[resource];
+                }
+            }
+        }
+
+        // Then forwards, every pass gets one batch right before it with the transitions it needs, which is the latest point they can happen.
+        // Another batch after the last pass returns everything to its home state
+        u32 numPlacements = static_cast<u32>(_aliasingPlan.Count());
+        _barriers.clear();
+        _barrierResources.clear();
+        _barriers.reserve(numAccesses + numResources + numPlacements + 1);
+        _barrierResources.reserve(numAccesses + numResources + numPlacements + 1);
+        _firstBarrier.resize(numExecuting + 2);
+
+        auto addBarrier = [&](u32 resource, ResourceBarrierType type, ResourceState before, ResourceState after)
+        {
+            ResourceBarrier barrier;
+            barrier.type = type;
+            barrier.before = before;
+            barrier.after = after;
+
+            _barriers.push_back(barrier);
+            _barrierResources.push_back(resource);
+        };
+
+        for (u32 i = 0; i < numExecuting; i++)
+        {
+            _firstBarrier[i] = static_cast<u32>(_barriers.size());
+
+            // Transients share memory, so the ones that died in the last pass go home before something else takes their place, that way the next
+            // transient placed at the same spot starts out in its home state even when it's the same image. The new ones then take over the memory
+            for (u32 j = 0; j < numPlacements; j++)
+            {
+                const TransientPlacement& placement = _aliasingPlan[j];
+                u32 resource = placement.isDepth ? numImages + placement.resource : placement.resource;
+                ResourceState homeState = GetHomeState(placement.isDepth);
+
+                if (placement.lastPass + 1u == i && states[resource] != homeState)
+                {
+                    addBarrier(resource, RESOURCE_BARRIER_TYPE_TRANSITION, states[resource], homeState);
+                    states[resource] = homeState;
+                }
+            }
+            for (u32 j = 0; j < numPlacements; j++)
+            {
+                const TransientPlacement& placement = _aliasingPlan[j];
+                if (static_cast<u32>(placement.firstPass) == i)
+                {
+                    addBarrier(placement.isDepth ? numImages + placement.resource : placement.resource, RESOURCE_BARRIER_TYPE_ALIASING, RESOURCE_STATE_COMMON, RESOURCE_STATE_COMMON);
+                }
+            }
+
+            u16 pass = executionOrder[i];
+            for (u32 accessIndex = firstAccess[pass]; accessIndex < firstAccess[pass + 1]; accessIndex++)
+            {
+                const Access& access = accesses[accessIndex];
+                u32 resource = access.isDepth ? numImages + access.resource : access.resource;
+                ResourceState required = access.isWrite ? GetRequiredState(access.isDepth, true, access.shaderStage, access.writeMode) : static_cast<ResourceState>(mergedReadStates[accessIndex]);
+
+                if (!access.isWrite && (states[resource] & required) == required)
+                    continue; // An earlier read already moved it into a state covering this one
+
+                if (required != states[resource])
+                {
+                    addBarrier(resource, RESOURCE_BARRIER_TYPE_TRANSITION, states[resource], required);
+                    states[resource] = required;
+                }
+                else if (access.isWrite && required == RESOURCE_STATE_UNORDERED_ACCESS)
+                {
+                    addBarrier(resource, RESOURCE_BARRIER_TYPE_UAV, required, required); // Already in the right state, but the previous unordered access writes still need to finish
+                }
+            }
+        }
+
+        _firstBarrier[numExecuting] = static_cast<u32>(_barriers.size());
+        for (u32 i = 0; i < numResources; i++)
+        {
+            ResourceState homeState = GetHomeState(i >= numImages);
+            if (states[i] != homeState)
+            {
+                addBarrier(i, RESOURCE_BARRIER_TYPE_TRANSITION, states[i], homeState);
+            }
+        }
+        _firstBarrier[numExecuting + 1] = static_cast<u32>(_barriers.size());
+
+        ResolveBarriers();
+    }
+
+    void RenderGraph::ResolveBarriers()
+    {
+        u32 numImages = static_cast<u32>(_renderGraphBuilder->_trackedImages.Count());
+        for (size_t i = 0; i < _barriers.size(); i++)
+        {
+            u32 resource = _barrierResources[i];
+            if (resource < numImages)
+            {
+                _barriers[i].image = _renderGraphBuilder->_trackedImages[resource];
+                _barriers[i].depthImage = DepthImageID::Invalid();
+            }
+            else
+            {
+                _barriers[i].image = ImageID::Invalid();
+                _barriers[i].depthImage = _renderGraphBuilder->_trackedDepthImages[resource - numImages];
+            }
+        }
+    }
+
+    namespace
+    {
+        RenderPassLoadAction ToLoadAction(RenderGraphBuilder::LoadMode loadMode)
+        {
+            switch (loadMode)
+            {
+                case RenderGraphBuilder::LOAD_MODE_LOAD: return RENDER_PASS_LOAD_ACTION_LOAD;
+                case RenderGraphBuilder::LOAD_MODE_DISCARD: return RENDER_PASS_LOAD_ACTION_DISCARD;
+                case RenderGraphBuilder::LOAD_MODE_CLEAR: return RENDER_PASS_LOAD_ACTION_CLEAR;
+                default:
+                    assert(false); // Invalid loadMode, did we add to the enum?
+            }
+            return RENDER_PASS_LOAD_ACTION_LOAD;
+        }
+    }
+
+    void RenderGraph::PlanRenderPasses(const u16* executionOrder, u32 numExecuting, const u32* firstAccess)
+    {
+        PROFILE_SCOPE("RenderGraph::PlanRenderPasses");
+
+        using Access = RenderGraphBuilder::ResourceAccess;
+        DynamicArray<Access>& accesses = _renderGraphBuilder->_accesses;
+        Memory::Allocator* allocator = GetFrameAllocator();
+
+        u32 numImages = static_cast<u32>(_renderGraphBuilder->_trackedImages.Count());
+        u32 numResources = numImages + static_cast<u32>(_renderGraphBuilder->_trackedDepthImages.Count());
+        u32 numAccesses = static_cast<u32>(accesses.Count());
+
+        // Walk backwards first so every access knows if anything after it needs what it leaves behind, that decides whether render passes store or discard.
+        // What imported resources end up holding is the graph's output so it's always needed
+        bool* isLoadedLater = Memory::Allocator::NewArray<bool>(allocator, numResources + 1);
+        bool* isNeededAfter = Memory::Allocator::NewArray<bool>(allocator, numAccesses + 1);
+        for (u32 i = 0; i < numResources; i++)
+        {
+            isLoadedLater[i] = _transientIndices[i] == RenderGraphBuilder::INVALID_TRANSIENT;
+        }
+        for (u32 i = numExecuting; i-- > 0;)
         {
-            if (pass->Setup(_renderGraphBuilder))
+            u16 pass = executionOrder[i];
+            for (u32 accessIndex = firstAccess[pass]; accessIndex < firstAccess[pass + 1]; accessIndex++)
+            {
+                const Access& access = accesses[accessIndex];
+                u32 resource = access.isDepth ? numImages + access.resource : access.resource;
+
+                isNeededAfter[accessIndex] = isLoadedLater[resource];
+                isLoadedLater[resource] = !access.isWrite || access.loadMode == RenderGraphBuilder::LOAD_MODE_LOAD;
+            }
+        }
+
+        u32* lastRenderPass = Memory::Allocator::NewArray<u32>(allocator, numResources + 1); // The render pass of the last pass touching each resource
+        for (u32 i = 0; i < numResources; i++)
+        {
+            lastRenderPass[i] = INVALID_RENDER_PASS;
+        }
+
+        _passRenderPasses.resize(numExecuting);
+        _firstAttachment.clear();
+        _attachments.clear();
+        _attachmentResources.clear();
+        _numMergedPasses = 0;
+
+        u32 renderPass = INVALID_RENDER_PASS;
+        auto findAttachment = [&](u32 resource)
+        {
+            for (u32 i = _firstAttachment[renderPass]; i < _attachments.size(); i++)
+            {
+                if (_attachmentResources[i] == resource)
+                    return i;
+            }
+            return INVALID_INDEX;
+        };
+
+        for (u32 i = 0; i < numExecuting; i++)
+        {
+            u16 pass = executionOrder[i];
+
+            // A pass joins the render pass before it if nothing has to happen in between, barriers can't go inside a render pass and neither can clears. Attachments
+            // it adds get loaded when the render pass begins, so the passes already in it can't have touched them
+            bool hasAttachments = false;
+            bool canMerge = renderPass != INVALID_RENDER_PASS && _firstBarrier[i] == _firstBarrier[i + 1];
+            u32 numRenderTargets = 0;
+            bool hasDepth = false;
+            if (canMerge)
+            {
+                for (u32 j = _firstAttachment[renderPass]; j < _attachments.size(); j++)
+                {
+                    hasDepth |= _attachmentResources[j] >= numImages;
+                    numRenderTargets += _attachmentResources[j] >= numImages ? 0 : 1;
+                }
+            }
+
+            for (u32 accessIndex = firstAccess[pass]; accessIndex < firstAccess[pass + 1]; accessIndex++)
+            {
+                const Access& access = accesses[accessIndex];
+                u32 resource = access.isDepth ? numImages + access.resource : access.resource;
+                bool isAttachment = access.isWrite && access.writeMode == RenderGraphBuilder::WRITE_MODE_RENDERTARGET;
+                hasAttachments |= isAttachment;
+
+                if (!canMerge)
+                    continue;
+
+                u32 attachment = findAttachment(resource);
+                if (!isAttachment)
+                {
+                    canMerge = attachment == INVALID_INDEX; // Reading or writing an attachment any other way needs it out of the render pass
+                }
+                else if (attachment != INVALID_INDEX)
+                {
+                    canMerge = access.loadMode != RenderGraphBuilder::LOAD_MODE_CLEAR;
+                }
+                else
+                {
+                    canMerge = lastRenderPass[resource] != renderPass && (access.isDepth ? !hasDepth : numRenderTargets < static_cast<u32>(MAX_RENDER_TARGETS));
+                    hasDepth |= access.isDepth;
+                    numRenderTargets += access.isDepth ? 0 : 1;
+                }
+            }
+
+            if (!hasAttachments)
+            {
+                _passRenderPasses[i] = INVALID_RENDER_PASS;
+                renderPass = INVALID_RENDER_PASS;
+                continue;
+            }
+
+            if (canMerge)
+            {
+                _numMergedPasses++;
+            }
+            else
+            {
+                renderPass = static_cast<u32>(_firstAttachment.size());
+                _firstAttachment.push_back(static_cast<u32>(_attachments.size()));
+            }
+            _passRenderPasses[i] = renderPass;
+
+            for (u32 accessIndex = firstAccess[pass]; accessIndex < firstAccess[pass + 1]; accessIndex++)
+            {
+                const Access& access = accesses[accessIndex];
+                u32 resource = access.isDepth ? numImages + access.resource : access.resource;
+                lastRenderPass[resource] = renderPass;
+
+                if (!access.isWrite || access.writeMode != RenderGraphBuilder::WRITE_MODE_RENDERTARGET)
+                    continue;
+
+                // The last pass in the render pass writing an attachment decides if it gets stored, the first one how it gets loaded
+                RenderPassStoreAction storeAction = isNeededAfter[accessIndex] ? RENDER_PASS_STORE_ACTION_STORE : RENDER_PASS_STORE_ACTION_DISCARD;
+                u32 attachment = findAttachment(resource);
+                if (attachment != INVALID_INDEX)
+                {
+                    _attachments[attachment].storeAction = storeAction;
+                    continue;
+                }
+
+                RenderPassAttachment newAttachment;
+                newAttachment.loadAction = ToLoadAction(access.loadMode);
+                newAttachment.storeAction = storeAction;
+
+                _attachments.push_back(newAttachment);
+                _attachmentResources.push_back(resource);
+            }
+        }
+        _firstAttachment.push_back(static_cast<u32>(_attachments.size()));
+
+        ResolveRenderPasses();
+    }
+
+    void RenderGraph::ResolveRenderPasses()
+    {
+        u32 numImages = static_cast<u32>(_renderGraphBuilder->_trackedImages.Count());
+        for (size_t i = 0; i < _attachments.size(); i++)
+        {
+            u32 resource = _attachmentResources[i];
+            if (resource < numImages)
+            {
+                _attachments[i].image = _renderGraphBuilder->_trackedImages[resource];
+                _attachments[i].depthImage = DepthImageID::Invalid();
+            }
+            else
             {
-                _executingPasses.Insert(pass);
+                _attachments[i].image = ImageID::Invalid();
+                _attachments[i].depthImage = _renderGraphBuilder->_trackedDepthImages[resource - numImages];
             }
         }
     }
 
     void RenderGraph::Execute()
     {
-        // TODO: Parallel_for this
-        CommandList commandList(_renderer, _desc.allocator);
+        PROFILE_SCOPE("RenderGraph::Execute");
+
+        assert(_isCompiled); // Setup needs to compile the graph before it can execute
+
+        CommandList commandList(_renderer, GetFrameAllocator());
         commandList.PushMarker("RenderGraph", Vector3(0.0f, 0.0f, 0.4f));
-        for (IRenderPass* pass : _executingPasses)
+
+        u32 numPasses = static_cast<u32>(_executingPasses.Count());
+        auto recordBarriers = [&](u32 executingIndex)
+        {
+            u32 numBarriers = _firstBarrier[executingIndex + 1] - _firstBarrier[executingIndex];
+            if (numBarriers > 0)
+            {
+                commandList.ResourceBarriers(&_barriers[_firstBarrier[executingIndex]], numBarriers);
+            }
+        };
+        auto beginRenderPass = [&](u32 executingIndex)
+        {
+            u32 renderPass = _passRenderPasses[executingIndex];
+            if (renderPass != INVALID_RENDER_PASS && (executingIndex == 0 || _passRenderPasses[executingIndex - 1] != renderPass))
+            {
+                commandList.BeginRenderPass(&_attachments[_firstAttachment[renderPass]], _firstAttachment[renderPass + 1] - _firstAttachment[renderPass]);
+            }
+        };
+        auto endRenderPass = [&](u32 executingIndex)
+        {
+            u32 renderPass = _passRenderPasses[executingIndex];
+            if (renderPass != INVALID_RENDER_PASS && (executingIndex + 1 == numPasses || _passRenderPasses[executingIndex + 1] != renderPass))
+            {
+                commandList.EndRenderPass(&_attachments[_firstAttachment[renderPass]], _firstAttachment[renderPass + 1] - _firstAttachment[renderPass]);
+            }
+        };
+
+        if (numPasses > 1 && CanRecordInParallel())
+        {
+            // Every pass records into its own CommandList on whichever thread picks it up, then they get appended in graph order
+            CommandList** passCommandLists = Memory::Allocator::NewArray<CommandList*>(GetFrameAllocator(), numPasses);
+
+            Jobs::JobSystem::ParallelFor(numPasses, 1, [&](u32 begin, u32 end)
+            {
+                for (u32 i = begin; i < end; i++)
+                {
+                    Memory::Allocator* allocator = _desc.threadAllocator->Get();
+                    passCommandLists[i] = Memory::Allocator::New<CommandList>(allocator, _renderer, allocator);
+                    ExecutePass(i, *passCommandLists[i]);
+                }
+            });
+
+            for (u32 i = 0; i < numPasses; i++)
+            {
+                recordBarriers(i);
+                beginRenderPass(i);
+                commandList.Append(*passCommandLists[i]);
+                endRenderPass(i);
+            }
+        }
+        else
         {
-            pass->Execute(commandList);
+            for (u32 i = 0; i < numPasses; i++)
+            {
+                recordBarriers(i);
+                beginRenderPass(i);
+                ExecutePass(i, commandList);
+                endRenderPass(i);
+            }
         }
+        recordBarriers(numPasses);
+
         commandList.PopMarker();
         commandList.Execute();
+
+        Profiling::FrameStats::AddCounter(Profiling::FRAME_COUNTER_RENDERGRAPH_PASSES_EXECUTED, _executingPasses.Count());
+    }
+
+    void RenderGraph::ExecutePass(u32 executingIndex, CommandList& commandList)
+    {
+        IRenderPass* pass = _executingPasses[executingIndex];
+        const RenderGraphBuilder::PassDeclaration& declaration = _renderGraphBuilder->_passDeclarations[_executionOrder[executingIndex]];
+
+        commandList.PushMarker(pass->GetName(), Vector3(0.0f, 0.4f, 0.0f));
+        pass->Execute(commandList);
+
+        // Views share everything the pass did once above, each of them only adds its own bindings and draws
+        if (declaration.numViews > 0)
+        {
+            RecordParallel(commandList, declaration.numViews, 1, [&](CommandList& viewCommandList, u32 begin, u32 end)
+            {
+                for (u32 i = begin; i < end; i++)
+                {
+                    const RenderView& view = declaration.views[i];
+                    viewCommandList.SetViewport(view.viewport);
+                    viewCommandList.SetScissorRect(view.scissorRect);
+                    if (view.constantBuffer != nullptr)
+                    {
+                        viewCommandList.SetConstantBuffer(_desc.viewConstantBufferSlot, view.constantBuffer);
+                    }
+
+                    pass->ExecuteView(viewCommandList, view);
+                }
+            });
+
+            Profiling::FrameStats::AddCounter(Profiling::FRAME_COUNTER_RENDERGRAPH_VIEWS, declaration.numViews);
+        }
+
+        commandList.PopMarker();
+    }
+
+    void RenderGraph::RecordParallel(CommandList& commandList, u32 count, u32 grainSize, const std::function<void(CommandList&, u32, u32)>& record)
+    {
+        grainSize = grainSize == 0 ? 1 : grainSize;
+        if (count <= grainSize || !CanRecordInParallel())
+        {
+            record(commandList, 0, count);
+            return;
+        }
+
+        u32 numChunks = (count + grainSize - 1) / grainSize;
+        CommandList** chunkCommandLists = Memory::Allocator::NewArray<CommandList*>(_desc.threadAllocator->Get(), numChunks);
+
+        Jobs::JobSystem::ParallelFor(numChunks, 1, [&](u32 beginChunk, u32 endChunk)
+        {
+            for (u32 chunk = beginChunk; chunk < endChunk; chunk++)
+            {
+                Memory::Allocator* allocator = _desc.threadAllocator->Get();
+                chunkCommandLists[chunk] = Memory::Allocator::New<CommandList>(allocator, _renderer, allocator);
+
+                u32 begin = chunk * grainSize;
+                u32 end = (count - begin) > grainSize ? begin + grainSize : count;
+                record(*chunkCommandLists[chunk], begin, end);
+            }
+        });
+
+        for (u32 chunk = 0; chunk < numChunks; chunk++)
+        {
+            commandList.Append(*chunkCommandLists[chunk]);
+        }
+    }
+
+    bool RenderGraph::CanRecordInParallel()
+    {
+        return _desc.threadAllocator != nullptr && Jobs::JobSystem::IsInitialized() && Jobs::JobSystem::GetNumThreads() > 1
+            && Jobs::JobSystem::GetThreadIndex() != Jobs::JobSystem::INVALID_THREAD_INDEX;
     }
 
     void RenderGraph::InitializePipelineDesc(GraphicsPipelineDesc& desc)
@@ -1,7 +1,10 @@
 #pragma once
 #include <Core.h>
+#include <vector>
 #include "Descriptors/RenderGraphDesc.h"
+#include "Descriptors/TransientHeapDesc.h"
 #include "RenderPass.h"
+#include "RenderGraphBuilder.h"
 #include <Memory/StackAllocator.h>
 #include <Containers/DynamicArray.h>
 
@@ -13,12 +16,34 @@ namespace Memory
 namespace Renderer
 {
     class Renderer;
-    class RenderGraphBuilder;
 
-    // Acyclic Graph for rendering
+    // Acyclic Graph for rendering.
+    // A graph can be built once and set up and executed every frame, passes capture whatever changes per frame by reference. Setup only recompiles
+    // when the topology of the passes, their enable flags and the resources they use changes, otherwise it reuses the compiled graph
     class RenderGraph
     {
     public:
+        // Where a transient resource lives in the memory the TransientResourcePool keeps for it, passes are indices into the execution order
+        struct TransientPlacement
+        {
+            u32 resource; // Index into the builder's _trackedImages, or _trackedDepthImages if isDepth
+            bool isDepth;
+            u32 desc; // Index into the TransientResourcePool's descs
+            u32 block;
+            size_t offset;
+            size_t size;
+            size_t alignment;
+            u16 firstPass;
+            u16 lastPass;
+        };
+
+        // waitPass's queue waits right before it for signalPass's queue to finish signalPass, passes are indices into the execution order
+        struct QueueSync
+        {
+            u32 signalPass;
+            u32 waitPass;
+        };
+
         ~RenderGraph();
 
         template <typename PassData>
@@ -28,11 +53,45 @@ namespace Renderer
             _passes.Insert(pass);
         }
 
+        // A pass running once for every view it declares with RenderGraphBuilder::SetViews. Setup and onExecute run once, so onExecute is where pipelines get resolved and
+        // state every view shares gets set. Then onExecuteView runs for every view with its viewport, scissor rect and constant buffer bound, views can be recorded on
+        // several threads at the same time so onExecuteView should only read PassData
+        template <typename PassData>
+        void AddPass(std::string name, std::function<bool(PassData&, RenderGraphBuilder&)> onSetup, std::function<void(PassData&, CommandList&)> onExecute,
+            std::function<void(PassData&, CommandList&, const RenderView&)> onExecuteView)
+        {
+            IRenderPass* pass = Memory::Allocator::New<RenderPass<PassData>>(_desc.allocator, name, onSetup, onExecute, onExecuteView);
+            _passes.Insert(pass);
+        }
+
+        // Runs every pass's setup and compiles the graph if its topology changed, passes execute in dependency order and passes nothing depends on are culled
         void Setup();
         void Execute();
 
+        // Splits count items into chunks of grainSize, records every chunk into its own CommandList on the JobSystem and appends them to commandList in order.
+        // Call this from a pass's execute to spread a pass with a lot of draws over several threads, state set on commandList before the call carries over into every chunk.
+        void RecordParallel(CommandList& commandList, u32 count, u32 grainSize, const std::function<void(CommandList&, u32, u32)>& record);
+
         RenderGraphBuilder* GetBuilder() { return _renderGraphBuilder; }
 
+        u32 GetNumCulledPasses() const { return _numCulledPasses; }
+        u32 GetNumCompiles() const { return _numCompiles; }
+        u32 GetNumMergedPasses() const { return _numMergedPasses; } // Passes sharing the render pass of the pass before them
+
+        // What the transients created during Setup would take up on their own, and what they take up sharing memory
+        size_t GetTransientBytesRequested() const { return _transientBytesRequested; }
+        size_t GetTransientBytesAllocated() const { return _transientBytesAllocated; }
+        DynamicArray<TransientPlacement>& GetAliasingPlan() { return _aliasingPlan; }
+        void LogAliasingPlan();
+
+        // The queue every executing pass runs on, and the fewest waits between queues that keep every dependency across them. Execute still records every pass into one
+        // command list in execution order, which is always a valid serialization of this schedule
+        u32 GetNumExecutingPasses() { return static_cast<u32>(_executingPasses.Count()); }
+        const char* GetExecutingPassName(u32 executingPass) { return _executingPasses[executingPass]->GetName(); }
+        RenderGraphBuilder::Queue GetPassQueue(u32 executingPass) const { return _passQueues[executingPass]; }
+        const std::vector<QueueSync>& GetQueueSyncs() const { return _queueSyncs; }
+        void LogSchedule();
+
         void InitializePipelineDesc(GraphicsPipelineDesc& desc);
         void InitializePipelineDesc(MaterialPipelineDesc& desc);
 
@@ -42,10 +101,25 @@ namespace Renderer
             , _renderGraphBuilder(nullptr)
             , _passes(allocator, 32)
             , _executingPasses(allocator, 32)
+            , _aliasingPlan(allocator, 16)
         {
         
         } // This gets friend-created by Renderer
         bool Init(RenderGraphDesc& desc);
+        bool Compile(const bool* passEnabled);
+        u32 GetTopologyHash(const bool* passEnabled);
+        void ScheduleQueues(const u16* executionOrder, u32 numExecuting, const u32* firstAccess, const u32* firstDependent, const u16* dependents);
+        void AllocateTransients(const u16* executionOrder, u32 numExecuting, const u32* firstAccess);
+        void PlaceTransients();
+        void PlanBarriers(const u16* executionOrder, u32 numExecuting, const u32* firstAccess);
+        void ResolveBarriers();
+        void PlanRenderPasses(const u16* executionOrder, u32 numExecuting, const u32* firstAccess);
+        void ResolveRenderPasses();
+        Memory::Allocator* GetFrameAllocator() { return _desc.frameAllocator != nullptr ? _desc.frameAllocator : _desc.allocator; }
+        void GetResourceName(u32 resource, char* name, size_t nameSize);
+        const char* GetTransientName(u32 desc, bool isDepth);
+        bool CanRecordInParallel();
+        void ExecutePass(u32 executingIndex, CommandList& commandList);
 
     private:
         RenderGraphDesc _desc;
@@ -59,6 +133,38 @@ namespace Renderer
         Renderer* _renderer;
         RenderGraphBuilder* _renderGraphBuilder;
 
+        u32 _numCulledPasses = 0;
+
+        // Everything below is the compiled graph, it outlives the frame it was compiled in so it can't come from the frame allocator
+        bool _isCompiled = false;
+        u32 _topologyHash = 0;
+        std::vector<u32> _topology; // What GetTopologyHash hashed this frame, compared against _compiledTopology whenever the hashes match
+        std::vector<u32> _compiledTopology;
+        u32 _numCompiles = 0;
+
+        std::vector<u16> _executionOrder; // Per executing pass, the index of the pass
+        std::vector<RenderGraphBuilder::Queue> _passQueues; // Per executing pass
+        std::vector<QueueSync> _queueSyncs;
+
+        std::vector<u32> _transientIndices; // Per tracked resource, images first, the index into the builder's transients or INVALID_TRANSIENT
+        DynamicArray<TransientPlacement> _aliasingPlan;
+        std::vector<TransientHeapDesc> _transientBlocks;
+        size_t _transientBytesRequested = 0;
+        size_t _transientBytesAllocated = 0;
+
+        // Transitions to record before each executing pass are [_firstBarrier[i], _firstBarrier[i + 1]), the ones after the last pass return resources to their home state
+        std::vector<ResourceBarrier> _barriers;
+        std::vector<u32> _barrierResources; // The tracked resource behind every barrier, its ID changes every frame for transients
+        std::vector<u32> _firstBarrier;
+
+        // Executing passes writing render targets run inside render passes, and passes in a row drawing to the same attachments share one. Executing pass i is in render pass
+        // _passRenderPasses[i] or none if it's INVALID_RENDER_PASS, the attachments of render pass j are [_firstAttachment[j], _firstAttachment[j + 1])
+        std::vector<u32> _passRenderPasses;
+        std::vector<u32> _firstAttachment;
+        std::vector<RenderPassAttachment> _attachments;
+        std::vector<u32> _attachmentResources; // The tracked resource behind every attachment, same as _barrierResources
+        u32 _numMergedPasses = 0;
+
         friend class Renderer; // To have access to the constructor
     };
 }
\ No newline at end of file
@@ -5,56 +5,121 @@
 namespace Renderer
 {
     RenderGraphBuilder::RenderGraphBuilder(Memory::Allocator* allocator, Renderer* renderer)
-        : _renderer(renderer)
+        : _allocator(allocator)
+        , _renderer(renderer)
         , _trackedImages(allocator, 32)
         , _trackedDepthImages(allocator, 32)
+        , _transientImages(allocator, 16)
+        , _transientDepthImages(allocator, 16)
+        , _accesses(allocator, 128)
+        , _passDeclarations(allocator, 32)
     {
 
     }
 
-    void RenderGraphBuilder::Compile(CommandList* /*commandList*/)
+    void RenderGraphBuilder::Reset()
     {
+        _trackedImages.Clear();
+        _trackedDepthImages.Clear();
+        _transientImages.Clear();
+        _transientDepthImages.Clear();
+        _accesses.Clear();
+        _passDeclarations.Clear();
+        _currentPass = 0;
+    }
+
+    ImageID RenderGraphBuilder::Create(ImageDesc& desc)
+    {
+        using type = type_safe::underlying_type<ImageID>;
 
+        size_t index = _transientImages.Count();
+        assert(index + 1 < ImageID::MaxValue()); // Out of placeholder IDs
+
+        _transientImages.Insert(_renderer->GetTransientResourcePool().RegisterDesc(desc));
+        return ImageID(static_cast<type>(ImageID::MaxValue() - 1 - index));
     }
 
-    ImageID RenderGraphBuilder::Create(ImageDesc& /*desc*/)
+    DepthImageID RenderGraphBuilder::Create(DepthImageDesc& desc)
     {
-        return ImageID::Invalid();
+        using type = type_safe::underlying_type<DepthImageID>;
+
+        size_t index = _transientDepthImages.Count();
+        assert(index + 1 < DepthImageID::MaxValue()); // Out of placeholder IDs
+
+        _transientDepthImages.Insert(_renderer->GetTransientResourcePool().RegisterDesc(desc));
+        return DepthImageID(static_cast<type>(DepthImageID::MaxValue() - 1 - index));
     }
 
-    DepthImageID RenderGraphBuilder::Create(DepthImageDesc& /*desc*/)
+    u32 RenderGraphBuilder::GetTransientIndex(ImageID id)
     {
-        return DepthImageID::Invalid();
+        using type = type_safe::underlying_type<ImageID>;
+
+        size_t value = static_cast<type>(id);
+        size_t numTransients = _transientImages.Count();
+        if (value >= ImageID::MaxValue() || value + numTransients < ImageID::MaxValue())
+            return INVALID_TRANSIENT;
+
+        return static_cast<u32>(ImageID::MaxValue() - 1 - value);
     }
 
-    RenderPassResource RenderGraphBuilder::Read(ImageID id, ShaderStage /*shaderStage*/)
+    u32 RenderGraphBuilder::GetTransientIndex(DepthImageID id)
+    {
+        using type = type_safe::underlying_type<DepthImageID>;
+
+        size_t value = static_cast<type>(id);
+        size_t numTransients = _transientDepthImages.Count();
+        if (value >= DepthImageID::MaxValue() || value + numTransients < DepthImageID::MaxValue())
+            return INVALID_TRANSIENT;
+
+        return static_cast<u32>(DepthImageID::MaxValue() - 1 - value);
+    }
+
+    RenderPassResource RenderGraphBuilder::Read(ImageID id, ShaderStage shaderStage)
     {
         RenderPassResource resource = GetResource(id);
+        AddAccess(static_cast<u16>(resource), false, false, shaderStage, WRITE_MODE_RENDERTARGET, LOAD_MODE_LOAD);
 
         return resource;
     }
 
-    RenderPassResource RenderGraphBuilder::Read(DepthImageID id, ShaderStage /*shaderStage*/)
+    RenderPassResource RenderGraphBuilder::Read(DepthImageID id, ShaderStage shaderStage)
     {
         RenderPassResource resource = GetResource(id);
+        AddAccess(static_cast<u16>(resource), true, false, shaderStage, WRITE_MODE_RENDERTARGET, LOAD_MODE_LOAD);
 
         return resource;
     }
 
-    RenderPassMutableResource RenderGraphBuilder::Write(ImageID id, WriteMode /*writeMode*/, LoadMode /*loadMode*/)
+    RenderPassMutableResource RenderGraphBuilder::Write(ImageID id, WriteMode writeMode, LoadMode loadMode)
     {
         RenderPassMutableResource resource = GetMutableResource(id);
+        AddAccess(static_cast<u16>(resource), false, true, SHADER_STAGE_NONE, writeMode, loadMode);
 
         return resource;
     }
 
-    RenderPassMutableResource RenderGraphBuilder::Write(DepthImageID id, WriteMode /*writeMode*/, LoadMode /*loadMode*/)
+    RenderPassMutableResource RenderGraphBuilder::Write(DepthImageID id, WriteMode writeMode, LoadMode loadMode)
     {
         RenderPassMutableResource resource = GetMutableResource(id);
+        AddAccess(static_cast<u16>(resource), true, true, SHADER_STAGE_NONE, writeMode, loadMode);
 
         return resource;
     }
 
+    void RenderGraphBuilder::AddAccess(u16 resource, bool isDepth, bool isWrite, ShaderStage shaderStage, WriteMode writeMode, LoadMode loadMode)
+    {
+        ResourceAccess access;
+        access.pass = _currentPass;
+        access.resource = resource;
+        access.isDepth = isDepth;
+        access.isWrite = isWrite;
+        access.shaderStage = shaderStage;
+        access.writeMode = writeMode;
+        access.loadMode = loadMode;
+
+        _accesses.Insert(access);
+    }
+
     ImageID RenderGraphBuilder::GetImage(RenderPassResource resource)
     {
         using type = type_safe::underlying_type<RenderPassResource>;
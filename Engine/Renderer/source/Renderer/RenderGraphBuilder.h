@@ -7,6 +7,7 @@
 
 #include "RenderStates.h"
 #include "RenderPassResources.h"
+#include "RenderView.h"
 
 #include "Descriptors/ImageDesc.h"
 #include "Descriptors/DepthImageDesc.h"
@@ -33,11 +34,20 @@ namespace Renderer
             WRITE_MODE_UAV
         };
 
+        // Render target writes become the load actions of the render pass the graph wraps the pass in
         enum LoadMode
         {
             LOAD_MODE_LOAD, // Load the contents of the resource
-            LOAD_MODE_DISCARD, // Load the contents of the resource, but we don't really care
-            LOAD_MODE_CLEAR // Clear the resource of existing data
+            LOAD_MODE_DISCARD, // The contents of the resource are undefined, the pass overwrites all of it
+            LOAD_MODE_CLEAR // Clear the resource to the clear value it was created with
+        };
+
+        // The queue a pass gets scheduled on, RenderGraph synchronizes queues wherever a pass depends on one from another queue
+        enum Queue
+        {
+            QUEUE_GRAPHICS,
+            QUEUE_ASYNC_COMPUTE, // Overlaps with graphics work, passes on it can't write render targets or depth test
+            QUEUE_COUNT
         };
 
         enum ShaderStage
@@ -48,7 +58,9 @@ namespace Renderer
             SHADER_STAGE_COMPUTE = 4
         };
 
-        // Create transient resources
+        // Create transient resources, these only exist while the graph executes and share memory with other transients whenever their lifetimes don't overlap.
+        // The returned ID is a placeholder until the graph compiles, so don't use it in execute, get the image from the pass's resource with GetImage instead.
+        // The first pass using a transient should write it with LOAD_MODE_CLEAR, its memory holds whatever was placed there before
         ImageID Create(ImageDesc& desc);
         DepthImageID Create(DepthImageDesc& desc);
 
@@ -60,6 +72,16 @@ namespace Renderer
         RenderPassMutableResource Write(ImageID id, WriteMode writeMode, LoadMode loadMode);
         RenderPassMutableResource Write(DepthImageID id, WriteMode writeMode, LoadMode loadMode);
 
+        // Call during Setup to run the pass on another queue than QUEUE_GRAPHICS
+        void SetQueue(Queue queue) { _passDeclarations[_currentPass].queue = queue; }
+
+        // Call during Setup to run the pass once per view, views has to stay alive until the graph has executed
+        void SetViews(const RenderView* views, u32 numViews)
+        {
+            _passDeclarations[_currentPass].views = views;
+            _passDeclarations[_currentPass].numViews = numViews;
+        }
+
         // Render states
         void SetRasterizerState(RasterizerState& rasterizerState) { _rasterizerState = rasterizerState; }
         void SetDepthStencilState(DepthStencilState& depthStencilState) { _depthStencilState = depthStencilState; }
@@ -70,8 +92,40 @@ namespace Renderer
         DepthImageID GetDepthImage(RenderPassMutableResource resource);
 
     private:
-        void Compile(CommandList* commandList);
-        
+        // Every Read and Write a pass declares during Setup, RenderGraph::Compile derives the dependencies between passes from these
+        struct ResourceAccess
+        {
+            u16 pass;
+            u16 resource; // Index into _trackedImages or _trackedDepthImages
+            bool isDepth;
+            bool isWrite;
+            ShaderStage shaderStage;
+            WriteMode writeMode;
+            LoadMode loadMode;
+        };
+
+        // Everything but the resources a pass declares during Setup
+        struct PassDeclaration
+        {
+            Queue queue = QUEUE_GRAPHICS;
+            const RenderView* views = nullptr;
+            u32 numViews = 0;
+        };
+
+        void SetCurrentPass(u16 passIndex)
+        {
+            assert(_passDeclarations.Count() == passIndex); // Passes get set up in order after a Reset
+            _currentPass = passIndex;
+            _passDeclarations.Insert(PassDeclaration());
+        }
+        void Reset(); // Forgets what the last Setup declared, keeping the memory
+
+        // Placeholder IDs count down from just below Invalid, returns the index into _transientImages or _transientDepthImages or INVALID_TRANSIENT
+        static const u32 INVALID_TRANSIENT = 0xFFFFFFFF;
+        u32 GetTransientIndex(ImageID id);
+        u32 GetTransientIndex(DepthImageID id);
+        void AddAccess(u16 resource, bool isDepth, bool isWrite, ShaderStage shaderStage, WriteMode writeMode, LoadMode loadMode);
+
         RenderPassResource GetResource(ImageID id);
         RenderPassResource GetResource(DepthImageID id);
         RenderPassMutableResource GetMutableResource(ImageID id);
@@ -85,5 +139,14 @@ namespace Renderer
 
         DynamicArray<ImageID> _trackedImages;
         DynamicArray<DepthImageID> _trackedDepthImages;
+
+        DynamicArray<u32> _transientImages; // Desc index in the TransientResourcePool for every transient created this frame
+        DynamicArray<u32> _transientDepthImages;
+
+        DynamicArray<ResourceAccess> _accesses;
+        DynamicArray<PassDeclaration> _passDeclarations; // Per pass
+        u16 _currentPass = 0;
+
+        friend class RenderGraph;
     };
 }
\ No newline at end of file
@@ -4,6 +4,8 @@
 #include <functional>
 
 #include "CommandList.h"
+#include "RenderView.h"
+#include <Profiling/Profiler.h>
 #include "Descriptors/GraphicsPipelineDesc.h"
 #include "Descriptors/ComputePipelineDesc.h"
 
@@ -19,7 +21,9 @@ namespace Renderer
     public:
         virtual bool Setup(RenderGraphBuilder* renderGraphBuilder) = 0;
         virtual void Execute(CommandList& commandList) = 0;
+        virtual void ExecuteView(CommandList& commandList, const RenderView& view) = 0;
         virtual void DeInit() = 0;
+        virtual const char* GetName() const = 0;
     };
 
     template <typename PassData>
@@ -28,10 +32,12 @@ namespace Renderer
     public:
         typedef std::function<bool(PassData&, RenderGraphBuilder&)> SetupFunction;
         typedef std::function<void(PassData&, CommandList&)> ExecuteFunction;
+        typedef std::function<void(PassData&, CommandList&, const RenderView&)> ExecuteViewFunction;
     
-        RenderPass(std::string& name, SetupFunction onSetup, ExecuteFunction onExecute)
+        RenderPass(std::string& name, SetupFunction onSetup, ExecuteFunction onExecute, ExecuteViewFunction onExecuteView = nullptr)
             : _onSetup(onSetup)
             , _onExecute(onExecute)
+            , _onExecuteView(onExecuteView)
         {
             assert(name.length() < 16); // Max length of renderpass names is enforced to 15 chars since we have to store the string internally
             strcpy(_name, name.c_str());
@@ -40,22 +46,37 @@ namespace Renderer
     private:
         bool Setup(RenderGraphBuilder* renderGraphBuilder) override
         {
+            PROFILE_SCOPE_COPY(_name); // The pass lives in the frame allocator so the name needs to be copied
             return _onSetup(_data, *renderGraphBuilder);
         }
 
         void Execute(CommandList& commandList) override
         {
-            commandList.PushMarker(_name, Vector3(0.0f, 0.4f, 0.0f));
-            _onExecute(_data, commandList);
-            commandList.PopMarker();
+            PROFILE_SCOPE_COPY(_name);
+            if (_onExecute)
+            {
+                _onExecute(_data, commandList);
+            }
+        }
+
+        void ExecuteView(CommandList& commandList, const RenderView& view) override
+        {
+            PROFILE_SCOPE_COPY(_name);
+            if (_onExecuteView)
+            {
+                _onExecuteView(_data, commandList, view);
+            }
         }
 
         bool ShouldRun() { return _shouldRun; }
 
+        const char* GetName() const override { return _name; }
+
         void DeInit() override
         {
             _onSetup = nullptr;
             _onExecute = nullptr;
+            _onExecuteView = nullptr;
         }
     private:
 
@@ -63,6 +84,7 @@ namespace Renderer
         char _name[16];
         SetupFunction _onSetup;
         ExecuteFunction _onExecute;
+        ExecuteViewFunction _onExecuteView;
 
         PassData _data;
     };
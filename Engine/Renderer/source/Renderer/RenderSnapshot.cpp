@@ -0,0 +1,41 @@
+#include "RenderSnapshot.h"
+#include <Profiling/Profiler.h>
+
+namespace Renderer
+{
+    void RenderSnapshot::RegisterModel(u32 layerHash, MaterialID materialID, ModelID modelID, const InstanceData& instanceData)
+    {
+        InstanceData* instance = nullptr;
+        if (_numInstances < _instances.size())
+        {
+            instance = &_instances[_numInstances];
+            *instance = instanceData;
+        }
+        else
+        {
+            instance = &_instances.emplace_back(instanceData);
+        }
+        _numInstances++;
+
+        _renderLayers[layerHash].RegisterModel(materialID, modelID, instance);
+    }
+
+    void RenderSnapshot::ApplyInstances(u32 frameIndex)
+    {
+        PROFILE_SCOPE("RenderSnapshot::ApplyInstances");
+
+        for (u32 i = 0; i < _numInstances; i++)
+        {
+            _instances[i].Apply(frameIndex);
+        }
+    }
+
+    void RenderSnapshot::Reset()
+    {
+        for (auto& renderLayer : _renderLayers)
+        {
+            renderLayer.second.Reset();
+        }
+        _numInstances = 0;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,40 @@
+#pragma once
+#include <Core.h>
+#include <Containers/RobinHood.h>
+#include <deque>
+#include "RenderLayer.h"
+#include "InstanceData.h"
+
+namespace Renderer
+{
+    // Everything the render side needs to draw a frame, filled in by the simulation side.
+    // Instances get copied in when they are registered, so the simulation can keep changing the originals while another thread renders from the snapshot.
+    class RenderSnapshot
+    {
+    public:
+        RenderSnapshot() {}
+
+        void RegisterModel(u32 layerHash, MaterialID materialID, ModelID modelID, const InstanceData& instanceData);
+
+        // Layers in a snapshot only point at the snapshot's own copies of the instances
+        RenderLayer& GetRenderLayer(u32 layerHash) { return _renderLayers[layerHash]; }
+
+        // Updates the constant buffers of every instance in the snapshot, this is the only part of InstanceData the render side writes
+        void ApplyInstances(u32 frameIndex);
+
+        // Clears the snapshot for the next frame, the instance copies are kept around to be reused
+        void Reset();
+
+        u32 GetNumInstances() const { return _numInstances; }
+
+    private:
+        RenderSnapshot(const RenderSnapshot&) = delete;
+        RenderSnapshot& operator=(const RenderSnapshot&) = delete;
+
+    private:
+        robin_hood::unordered_map<u32, RenderLayer> _renderLayers;
+
+        std::deque<InstanceData> _instances; // A deque so the pointers in _renderLayers stay valid as it grows
+        u32 _numInstances = 0;
+    };
+}
\ No newline at end of file
@@ -203,6 +203,13 @@ namespace Renderer
         ShaderVisibility shaderVisibility = SHADER_VISIBILITY_ALL;
     };
 
+    // A structured buffer of per instance data that instanced draws bind a range of, shaders read it from t0 in space1 indexed by SV_InstanceID
+    struct InstanceBufferState
+    {
+        bool enabled = false;
+        ShaderVisibility shaderVisibility = SHADER_VISIBILITY_VERTEX;
+    };
+
     enum InputFormat
     {
         INPUT_FORMAT_UNKNOWN,
@@ -0,0 +1,18 @@
+#pragma once
+#include <Core.h>
+#include "RenderStates.h"
+
+namespace Renderer
+{
+    class RenderLayer;
+
+    // One of the points of view a per-view pass renders from, like a shadow cascade, a split-screen player or a cubemap face.
+    // RenderGraph binds the viewport, scissor rect and constant buffer before the pass records the view
+    struct RenderView
+    {
+        Viewport viewport;
+        ScissorRect scissorRect;
+        void* constantBuffer = nullptr; // The GPU resource of the view's constant buffer for this frame, bound to RenderGraphDesc::viewConstantBufferSlot
+        RenderLayer* visibleLayer = nullptr; // What the view can see, so every view only walks its own visibility list
+    };
+}
\ No newline at end of file
@@ -1,9 +1,13 @@
 #include "Renderer.h"
+#include <Profiling/Profiler.h>
+#include <chrono>
+#include <limits>
 
 namespace Renderer
 {
     Renderer::~Renderer()
     {
+        assert(_numPendingAsyncLoads == 0); // Backends need to call DiscardAsyncLoads in Deinit
         _renderLayers.clear();
     }
 
@@ -19,4 +23,120 @@ namespace Renderer
     {
         return _renderLayers[layerHash];
     }
+
+    AsyncHandle<TextureID> Renderer::LoadTextureAsync(const TextureDesc& desc)
+    {
+        return QueueAsyncLoad<TextureID>(desc, &Renderer::ReadTextureAsync, &Renderer::FinalizeTextureAsync);
+    }
+
+    AsyncHandle<ModelID> Renderer::LoadModelAsync(const ModelDesc& desc)
+    {
+        return QueueAsyncLoad<ModelID>(desc, &Renderer::ReadModelAsync, &Renderer::FinalizeModelAsync);
+    }
+
+    AsyncHandle<MaterialID> Renderer::LoadMaterialAsync(const MaterialDesc& desc)
+    {
+        return QueueAsyncLoad<MaterialID>(desc, &Renderer::ReadMaterialAsync, &Renderer::FinalizeMaterialAsync);
+    }
+
+    AsyncHandle<VertexShaderID> Renderer::LoadShaderAsync(const VertexShaderDesc& desc)
+    {
+        return QueueAsyncLoad<VertexShaderID>(desc, &Renderer::ReadShaderAsync, &Renderer::FinalizeShaderAsync);
+    }
+
+    AsyncHandle<PixelShaderID> Renderer::LoadShaderAsync(const PixelShaderDesc& desc)
+    {
+        return QueueAsyncLoad<PixelShaderID>(desc, &Renderer::ReadShaderAsync, &Renderer::FinalizeShaderAsync);
+    }
+
+    AsyncHandle<ComputeShaderID> Renderer::LoadShaderAsync(const ComputeShaderDesc& desc)
+    {
+        return QueueAsyncLoad<ComputeShaderID>(desc, &Renderer::ReadShaderAsync, &Renderer::FinalizeShaderAsync);
+    }
+
+    u32 Renderer::FinalizeAsyncLoads(f32 budgetMS)
+    {
+        PROFILE_SCOPE("Renderer::FinalizeAsyncLoads");
+
+        auto start = std::chrono::steady_clock::now();
+        u32 numFinalized = 0;
+        while (true)
+        {
+            if (numFinalized > 0)
+            {
+                std::chrono::duration<f32, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+                if (elapsed.count() >= budgetMS)
+                    break;
+            }
+
+            AsyncLoad* load = nullptr;
+            {
+                std::lock_guard<std::mutex> lock(_asyncLoadMutex);
+                if (_readAsyncLoads.empty())
+                    break;
+
+                load = _readAsyncLoads.front();
+                _readAsyncLoads.pop_front();
+            }
+
+            // This creates the resource and runs the OnReady functions, which are free to queue more loads
+            load->finalize(load->data);
+
+            delete load->data;
+            delete load;
+            _numPendingAsyncLoads.fetch_sub(1, std::memory_order_relaxed);
+            numFinalized++;
+        }
+
+        return numFinalized;
+    }
+
+    void Renderer::WaitForAsyncLoads()
+    {
+        PROFILE_SCOPE("Renderer::WaitForAsyncLoads");
+
+        while (_numPendingAsyncLoads.load(std::memory_order_relaxed) > 0)
+        {
+            Jobs::JobSystem::Wait(&_asyncReadCounter);
+            FinalizeAsyncLoads(std::numeric_limits<f32>::max());
+        }
+    }
+
+    void Renderer::DiscardAsyncLoads()
+    {
+        Jobs::JobSystem::Wait(&_asyncReadCounter);
+
+        std::lock_guard<std::mutex> lock(_asyncLoadMutex);
+        for (AsyncLoad* load : _readAsyncLoads)
+        {
+            delete load->data;
+            delete load;
+        }
+        _readAsyncLoads.clear();
+        _numPendingAsyncLoads = 0;
+    }
+
+    void Renderer::StartAsyncLoad(AsyncLoad* load)
+    {
+        _numPendingAsyncLoads.fetch_add(1, std::memory_order_relaxed);
+
+        if (Jobs::JobSystem::IsInitialized())
+        {
+            Jobs::JobSystem::Schedule([this, load]() { ReadAsyncLoad(load); }, &_asyncReadCounter);
+        }
+        else
+        {
+            ReadAsyncLoad(load); // Nothing to read on in the background, it still gets finalized later like any other load
+        }
+    }
+
+    void Renderer::ReadAsyncLoad(AsyncLoad* load)
+    {
+        PROFILE_SCOPE("Renderer::ReadAsyncLoad");
+
+        load->data = load->read();
+
+        std::lock_guard<std::mutex> lock(_asyncLoadMutex);
+        _readAsyncLoads.push_back(load);
+    }
 }
\ No newline at end of file
@@ -2,12 +2,19 @@
 #include <Core.h>
 #include <Utils/StringUtils.h>
 #include <Containers/RobinHood.h>
+#include <Jobs/JobSystem.h>
+#include <deque>
+#include <mutex>
+#include "AsyncHandle.h"
 #include "RenderGraph.h"
 #include "RenderGraphBuilder.h"
 #include "RenderLayer.h"
 #include "RenderPass.h"
 #include "ConstantBuffer.h"
+#include "InstanceBuffer.h"
 #include "RenderStates.h"
+#include "TransientResourcePool.h"
+#include "CommandCapture.h"
 
 // Descriptors
 #include "Descriptors/CommandListDesc.h"
@@ -20,6 +27,7 @@
 #include "Descriptors/ModelDesc.h"
 #include "Descriptors/PrimitiveModelDesc.h"
 #include "Descriptors/MaterialDesc.h"
+#include "Descriptors/TransientHeapDesc.h"
 
 class Window;
 
@@ -53,8 +61,41 @@ namespace Renderer
             return constantBuffer;
         }
 
+        InstanceBuffer CreateInstanceBuffer(u32 capacity)
+        {
+            return InstanceBuffer(CreateConstantBufferBackend(static_cast<size_t>(capacity) * InstanceBuffer::STRIDE), capacity);
+        }
+
         virtual ModelID CreatePrimitiveModel(PrimitivePlaneDesc& desc) = 0;
 
+        // Transient memory, RenderGraph places transient images whose lifetimes don't overlap in the same heap
+        virtual void GetMemoryRequirements(const ImageDesc& desc, size_t& size, size_t& alignment) = 0;
+        virtual void GetMemoryRequirements(const DepthImageDesc& desc, size_t& size, size_t& alignment) = 0;
+        virtual TransientHeapID CreateTransientHeap(TransientHeapDesc& desc) = 0;
+        virtual void DestroyTransientHeap(TransientHeapID heap) = 0; // Destroys the images placed in it as well, the GPU has to be done with them
+        virtual ImageID CreatePlacedImage(ImageDesc& desc, TransientHeapID heap, size_t offset) = 0;
+        virtual DepthImageID CreatePlacedImage(DepthImageDesc& desc, TransientHeapID heap, size_t offset) = 0;
+
+        virtual const ImageDesc& GetDescriptor(ImageID image) = 0;
+        virtual const DepthImageDesc& GetDescriptor(DepthImageID image) = 0;
+
+        // What everything else was created or loaded from, CommandCapture stores these so a replay can create them again
+        virtual const GraphicsPipelineDesc& GetDescriptor(GraphicsPipelineID pipeline) = 0;
+        virtual const MaterialPipelineDesc& GetDescriptor(MaterialPipelineID pipeline) = 0;
+        virtual const ComputePipelineDesc& GetDescriptor(ComputePipelineID pipeline) = 0;
+        virtual const MaterialDesc& GetDescriptor(MaterialID material) = 0;
+        virtual const ModelDesc& GetDescriptor(ModelID model) = 0; // The path is empty for primitive models
+        virtual const PrimitivePlaneDesc& GetPrimitiveDescriptor(ModelID model) = 0;
+
+        virtual VertexShaderDesc GetDescriptor(VertexShaderID shader) = 0;
+        virtual PixelShaderDesc GetDescriptor(PixelShaderID shader) = 0;
+        virtual ComputeShaderDesc GetDescriptor(ComputeShaderID shader) = 0;
+
+        TransientResourcePool& GetTransientResourcePool() { return _transientResourcePool; }
+
+        // Executed command lists get written to the capture while it's capturing
+        CommandCapture& GetCommandCapture() { return _commandCapture; }
+
         // Loading
         virtual TextureID LoadTexture(TextureDesc& desc) = 0;
         virtual ModelID LoadModel(ModelDesc& desc) = 0;
@@ -64,14 +105,37 @@ namespace Renderer
         virtual PixelShaderID LoadShader(PixelShaderDesc& desc) = 0;
         virtual ComputeShaderID LoadShader(ComputeShaderDesc& desc) = 0;
 
+        // Async loading, these return a handle right away and read and decode on the job system.
+        // The handle becomes ready once FinalizeAsyncLoads has created the resource.
+        AsyncHandle<TextureID> LoadTextureAsync(const TextureDesc& desc);
+        AsyncHandle<ModelID> LoadModelAsync(const ModelDesc& desc);
+        AsyncHandle<MaterialID> LoadMaterialAsync(const MaterialDesc& desc);
+
+        AsyncHandle<VertexShaderID> LoadShaderAsync(const VertexShaderDesc& desc);
+        AsyncHandle<PixelShaderID> LoadShaderAsync(const PixelShaderDesc& desc);
+        AsyncHandle<ComputeShaderID> LoadShaderAsync(const ComputeShaderDesc& desc);
+
+        // Creates resources for loads that are done reading until budgetMS has passed, call this once per frame.
+        // At least one load is finalized per call so loading always makes progress, returns how many were finalized
+        u32 FinalizeAsyncLoads(f32 budgetMS);
+
+        // Blocks until every async load so far has been read and finalized, useful behind a loading screen
+        void WaitForAsyncLoads();
+
+        u32 GetNumPendingAsyncLoads() const { return _numPendingAsyncLoads.load(std::memory_order_relaxed); }
+
         // Command List Functions
         virtual CommandListID BeginCommandList() = 0;
         virtual void EndCommandList(CommandListID commandList) = 0;
+        virtual void BeginRenderPass(CommandListID commandList, const RenderPassAttachment* attachments, u32 numAttachments) = 0;
+        virtual void EndRenderPass(CommandListID commandList, const RenderPassAttachment* attachments, u32 numAttachments) = 0;
         virtual void Clear(CommandListID commandList, ImageID image, Vector4 color) = 0;
         virtual void Clear(CommandListID commandList, DepthImageID image, DepthClearFlags clearFlags, f32 depth, u8 stencil) = 0;
         virtual void Draw(CommandListID commandList, ModelID model) = 0;
+        virtual void DrawInstanced(CommandListID commandList, ModelID model, const InstanceRange& instances) = 0;
         virtual void PopMarker(CommandListID commandList) = 0;
         virtual void PushMarker(CommandListID commandList, Vector3 color, std::string name) = 0;
+        virtual void ResourceBarriers(CommandListID commandList, const ResourceBarrier* barriers, u32 numBarriers) = 0;
         virtual void SetConstantBuffer(CommandListID commandList, u32 slot, void* gpuResource) = 0;
         virtual void SetPipeline(CommandListID commandList, GraphicsPipelineID pipeline) = 0;
         virtual void SetPipeline(CommandListID commandList, MaterialPipelineID pipeline) = 0;
@@ -84,11 +148,67 @@ namespace Renderer
         virtual void Present(Window* window, DepthImageID image) = 0;
 
     protected:
-        Renderer() {}; // Pure virtual class, disallow creation of it
+        Renderer() : _transientResourcePool(this), _commandCapture(this) {}; // Pure virtual class, disallow creation of it
 
         virtual Backend::ConstantBufferBackend* CreateConstantBufferBackend(size_t size) = 0;
+        friend class CommandReplay; // Creates buffers standing in for the captured ones
+
+        // Async loads are split in two. Read*Async runs on worker threads and must not touch anything the backend creates resources in,
+        // Finalize*Async runs from FinalizeAsyncLoads and gets the data back. The defaults read nothing and do the whole synchronous load when finalizing.
+        virtual AsyncLoadData* ReadTextureAsync(const TextureDesc& /*desc*/) { return nullptr; }
+        virtual TextureID FinalizeTextureAsync(TextureDesc& desc, AsyncLoadData* /*data*/) { return LoadTexture(desc); }
+        virtual AsyncLoadData* ReadModelAsync(const ModelDesc& /*desc*/) { return nullptr; }
+        virtual ModelID FinalizeModelAsync(ModelDesc& desc, AsyncLoadData* /*data*/) { return LoadModel(desc); }
+        virtual AsyncLoadData* ReadMaterialAsync(const MaterialDesc& /*desc*/) { return nullptr; }
+        virtual MaterialID FinalizeMaterialAsync(MaterialDesc& desc, AsyncLoadData* /*data*/) { return LoadMaterial(desc); }
+
+        virtual AsyncLoadData* ReadShaderAsync(const VertexShaderDesc& /*desc*/) { return nullptr; }
+        virtual VertexShaderID FinalizeShaderAsync(VertexShaderDesc& desc, AsyncLoadData* /*data*/) { return LoadShader(desc); }
+        virtual AsyncLoadData* ReadShaderAsync(const PixelShaderDesc& /*desc*/) { return nullptr; }
+        virtual PixelShaderID FinalizeShaderAsync(PixelShaderDesc& desc, AsyncLoadData* /*data*/) { return LoadShader(desc); }
+        virtual AsyncLoadData* ReadShaderAsync(const ComputeShaderDesc& /*desc*/) { return nullptr; }
+        virtual ComputeShaderID FinalizeShaderAsync(ComputeShaderDesc& desc, AsyncLoadData* /*data*/) { return LoadShader(desc); }
+
+        // Waits for reads still running on the job system and drops loads that weren't finalized, backends call this before tearing down
+        void DiscardAsyncLoads();
+
+        // Destroys the heaps and images behind RenderGraph transients, backends call this before tearing down
+        void DestroyTransientResources() { _transientResourcePool.Clear(); }
+
+    private:
+        struct AsyncLoad
+        {
+            std::function<AsyncLoadData*()> read;
+            std::function<void(AsyncLoadData*)> finalize;
+            AsyncLoadData* data = nullptr;
+        };
+
+        template <typename ID, typename Desc>
+        AsyncHandle<ID> QueueAsyncLoad(const Desc& desc, AsyncLoadData* (Renderer::*read)(const Desc&), ID (Renderer::*finalize)(Desc&, AsyncLoadData*))
+        {
+            AsyncHandle<ID> handle = AsyncHandle<ID>::Create();
+
+            AsyncLoad* load = new AsyncLoad();
+            load->read = [this, desc, read]() { return (this->*read)(desc); };
+            load->finalize = [this, desc = Desc(desc), finalize, handle](AsyncLoadData* data) mutable { handle.Finish((this->*finalize)(desc, data)); };
+            StartAsyncLoad(load);
+
+            return handle;
+        }
+
+        void StartAsyncLoad(AsyncLoad* load);
+        void ReadAsyncLoad(AsyncLoad* load);
 
     protected:
         robin_hood::unordered_map<u32, RenderLayer> _renderLayers;
+        TransientResourcePool _transientResourcePool;
+        CommandCapture _commandCapture;
+
+    private:
+        Jobs::JobCounter _asyncReadCounter;
+        std::atomic<u32> _numPendingAsyncLoads = 0; // Queued loads that haven't been finalized yet
+
+        std::mutex _asyncLoadMutex;
+        std::deque<AsyncLoad*> _readAsyncLoads; // Done reading, waiting for FinalizeAsyncLoads
     };
 }
\ No newline at end of file
@@ -42,6 +42,9 @@ namespace Renderer
                 assert(SUCCEEDED(result)); // We failed to reset the allocator
                 result = commandList.commandList->Reset(commandList.allocator.Get(), NULL);
                 assert(SUCCEEDED(result)); // We failed to reset the commandlist
+
+                commandList.hasBoundRenderTargets = false;
+                commandList.boundGraphicsPipeline = GraphicsPipelineID::Invalid();
             }
             else
             {
@@ -91,6 +94,51 @@ namespace Renderer
             return commandList.commandList.Get();
         }
 
+        void CommandListHandlerDX12::SetRenderTargets(CommandListID id, u32 numRenderTargets, const D3D12_CPU_DESCRIPTOR_HANDLE* rtvs, const D3D12_CPU_DESCRIPTOR_HANDLE* dsv)
+        {
+            assert(numRenderTargets <= D3D12_SIMULTANEOUS_RENDER_TARGET_COUNT); // More render targets than D3D12 can bind
+
+            using type = type_safe::underlying_type<CommandListID>;
+            CommandList& commandList = _commandLists[static_cast<type>(id)];
+
+            bool isBound = commandList.hasBoundRenderTargets && commandList.numBoundRenderTargets == numRenderTargets && commandList.hasBoundDepthStencil == (dsv != nullptr);
+            isBound = isBound && (dsv == nullptr || commandList.boundDepthStencil.ptr == dsv->ptr);
+            for (u32 i = 0; isBound && i < numRenderTargets; i++)
+            {
+                isBound = commandList.boundRenderTargets[i].ptr == rtvs[i].ptr;
+            }
+
+            if (isBound)
+                return;
+
+            commandList.commandList->OMSetRenderTargets(numRenderTargets, rtvs, false, dsv);
+
+            commandList.hasBoundRenderTargets = true;
+            commandList.numBoundRenderTargets = numRenderTargets;
+            for (u32 i = 0; i < numRenderTargets; i++)
+            {
+                commandList.boundRenderTargets[i] = rtvs[i];
+            }
+            commandList.hasBoundDepthStencil = dsv != nullptr;
+            commandList.boundDepthStencil = dsv != nullptr ? *dsv : D3D12_CPU_DESCRIPTOR_HANDLE();
+        }
+
+        void CommandListHandlerDX12::SetGraphicsPipeline(CommandListID id, GraphicsPipelineID pipeline)
+        {
+            using type = type_safe::underlying_type<CommandListID>;
+            CommandList& commandList = _commandLists[static_cast<type>(id)];
+
+            commandList.boundGraphicsPipeline = pipeline;
+        }
+
+        GraphicsPipelineID CommandListHandlerDX12::GetGraphicsPipeline(CommandListID id)
+        {
+            using type = type_safe::underlying_type<CommandListID>;
+            CommandList& commandList = _commandLists[static_cast<type>(id)];
+
+            return commandList.boundGraphicsPipeline;
+        }
+
         /*ID3D12Fence* CommandListHandlerDX12::GetFence(CommandListID id)
         {
             using type = type_safe::underlying_type<CommandListID>;
@@ -5,6 +5,7 @@
 #include "d3dx12.h"
 
 #include "../../../Descriptors/CommandListDesc.h"
+#include "../../../Descriptors/GraphicsPipelineDesc.h"
 
 namespace Renderer
 {
@@ -22,6 +23,13 @@ namespace Renderer
             void EndCommandList(RenderDeviceDX12* device, CommandListID id);
 
             ID3D12GraphicsCommandList* GetCommandList(CommandListID id);
+
+            // Pipelines and render passes both bind render targets, this skips OMSetRenderTargets when the list already has exactly these bound
+            void SetRenderTargets(CommandListID id, u32 numRenderTargets, const D3D12_CPU_DESCRIPTOR_HANDLE* rtvs, const D3D12_CPU_DESCRIPTOR_HANDLE* dsv);
+
+            // Instanced draws bind the instance buffer at the root index of whatever graphics pipeline is bound
+            void SetGraphicsPipeline(CommandListID id, GraphicsPipelineID pipeline);
+            GraphicsPipelineID GetGraphicsPipeline(CommandListID id);
             /*ID3D12Fence* GetFence(CommandListID id);
             u64 GetFenceValue(CommandListID id);
             void SetFenceValue(CommandListID id, u64 value);*/
@@ -32,6 +40,14 @@ namespace Renderer
                 Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> commandList;
                 Microsoft::WRL::ComPtr<ID3D12CommandAllocator> allocator;
 
+                // What OMSetRenderTargets last bound, forgotten every time the list gets reset
+                bool hasBoundRenderTargets = false;
+                u32 numBoundRenderTargets = 0;
+                D3D12_CPU_DESCRIPTOR_HANDLE boundRenderTargets[D3D12_SIMULTANEOUS_RENDER_TARGET_COUNT] = {};
+                bool hasBoundDepthStencil = false;
+                D3D12_CPU_DESCRIPTOR_HANDLE boundDepthStencil = {};
+                GraphicsPipelineID boundGraphicsPipeline = GraphicsPipelineID::Invalid();
+
                 //ID3D12Fence* fence;
                 //u64 fenceValue;
             };
@@ -29,6 +29,11 @@ namespace Renderer
                 memcpy(gpuAddress[frameIndex], data, size);
             }
 
+            void Write(u32 frameIndex, size_t offset, const void* data, size_t size) override
+            {
+                memcpy(static_cast<u8*>(gpuAddress[frameIndex]) + offset, data, size);
+            }
+
             void* GetGPUResource(u32 frameIndex) override
             {
                 return static_cast<void*>(uploadHeap[frameIndex].Get());
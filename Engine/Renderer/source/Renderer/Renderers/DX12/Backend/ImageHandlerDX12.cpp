@@ -28,11 +28,29 @@ namespace Renderer
                 image.srvDescriptorHeap.Reset();
                 image.resource.Reset();
             }
+            for (auto& heap : _heaps)
+            {
+                heap.Reset();
+            }
             _images.clear();
             _depthImages.clear();
         }
 
         TextureID ImageHandlerDX12::LoadTexture(RenderDeviceDX12* device, CommandListHandlerDX12* commandListHandler, const TextureDesc& desc)
+        {
+            TextureData data;
+            ReadTexture(desc, data);
+
+            return CreateTexture(device, commandListHandler, desc, data);
+        }
+
+        void ImageHandlerDX12::ReadTexture(const TextureDesc& desc, TextureData& data)
+        {
+            std::wstring path = StringUtils::StringToWString(desc.path);
+            LoadImageDataFromFile(&data.imageData, data.resourceDesc, path, data.bytesPerRow);
+        }
+
+        TextureID ImageHandlerDX12::CreateTexture(RenderDeviceDX12* device, CommandListHandlerDX12* commandListHandler, const TextureDesc& desc, TextureData& data)
         {
             size_t nextHandle = _images.size();
 
@@ -47,13 +65,10 @@ namespace Renderer
             CommandListID commandListID = commandListHandler->BeginCommandList(device);
             ID3D12GraphicsCommandList* commandList =  commandListHandler->GetCommandList(commandListID);
 
-            // So lets load the texture
-            D3D12_RESOURCE_DESC textureDesc;
-            int imageBytesPerRow;
-            u8* imageData;
-            std::wstring path = StringUtils::StringToWString(desc.path);
-           
-            LoadImageDataFromFile(&imageData, textureDesc, path, imageBytesPerRow);
+            // The texture was already read by ReadTexture
+            const D3D12_RESOURCE_DESC& textureDesc = data.resourceDesc;
+            int imageBytesPerRow = data.bytesPerRow;
+            u8* imageData = data.imageData;
 
             // Create the texture
             HRESULT result = device->_device->CreateCommittedResource(&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT), // a default heap
@@ -92,6 +107,10 @@ namespace Renderer
             // Now we copy the upload buffer contents to the default heap
             UpdateSubresources(commandList, image.resource.Get(), uploadHeap.Get(), 0, 0, 1, &textureData);
 
+            // UpdateSubresources has copied the image into the upload heap, we're done with it
+            free(data.imageData);
+            data.imageData = nullptr;
+
             // Transition the texture default heap to a pixel shader resource (we will be sampling from this heap in the pixel shader to get the color of pixels)
             commandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(image.resource.Get(), D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE));
 
@@ -117,7 +136,7 @@ namespace Renderer
             return TextureID(static_cast<type>(nextHandle));
         }
 
-        ImageID ImageHandlerDX12::CreateImage(RenderDeviceDX12* device, const ImageDesc& desc)
+        ImageID ImageHandlerDX12::CreateImage(RenderDeviceDX12* device, const ImageDesc& desc, TransientHeapID heap, size_t heapOffset)
         {
             size_t nextHandle = _images.size();
 
@@ -127,35 +146,13 @@ namespace Renderer
 
             Image image;
             image.desc = desc;
+            image.heap = heap;
 
             // Create resource
-            auto heapProperties = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT);
-
-            D3D12_RESOURCE_DESC resourceDesc;
-
-            assert(desc.dimensions.x > 0); // Make sure the width is valid
-            assert(desc.dimensions.y > 0); // Make sure the height is valid
-            assert(desc.depth > 0); // Make sure the depth is valid
-            assert(desc.format != IMAGE_FORMAT_UNKNOWN); // Make sure the format is valid
-
-            DXGI_FORMAT format = ToDXGIFormat(desc.format);
-            int sampleQuality = (desc.sampleCount == SAMPLE_COUNT_1) ? 0 : SampleCountToInt(desc.sampleCount);
-
-            if (desc.depth == 1) // 2d image
-            {
-                resourceDesc = CD3DX12_RESOURCE_DESC::Tex2D(format,
-                    desc.dimensions.x, desc.dimensions.y,
-                    1, 1, SampleCountToInt(desc.sampleCount), sampleQuality, D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET | D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS);
-            }
-            else
-            {
-                assert(false); // Non-2d images is currently unsupported
-            }
+            D3D12_RESOURCE_DESC resourceDesc = ToResourceDesc(desc);
+            D3D12_CLEAR_VALUE clearValue = { resourceDesc.Format, { desc.clearColor.x, desc.clearColor.y, desc.clearColor.z, desc.clearColor.w } };
 
-            D3D12_CLEAR_VALUE clearValue = { format, { desc.clearColor.x, desc.clearColor.y, desc.clearColor.z, desc.clearColor.w } };
-
-            HRESULT result = device->_device->CreateCommittedResource(&heapProperties, D3D12_HEAP_FLAG_ALLOW_ALL_BUFFERS_AND_TEXTURES,
-                &resourceDesc, D3D12_RESOURCE_STATE_RENDER_TARGET, &clearValue, IID_PPV_ARGS(image.resource.ReleaseAndGetAddressOf()));
+            HRESULT result = CreateResource(device, resourceDesc, D3D12_RESOURCE_STATE_RENDER_TARGET, clearValue, heap, heapOffset, image.resource);
             assert(SUCCEEDED(result)); // Failed to create commited resource
 
             {
@@ -223,7 +220,7 @@ namespace Renderer
             return ImageID(static_cast<type>(nextHandle));
         }
 
-        DepthImageID ImageHandlerDX12::CreateDepthImage(RenderDeviceDX12* device, const DepthImageDesc& desc)
+        DepthImageID ImageHandlerDX12::CreateDepthImage(RenderDeviceDX12* device, const DepthImageDesc& desc, TransientHeapID heap, size_t heapOffset)
         {
             size_t nextHandle = _depthImages.size();
 
@@ -233,29 +230,17 @@ namespace Renderer
 
             DepthImage image;
             image.desc = desc;
+            image.heap = heap;
 
             // Create resource
-            auto heapProperties = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT);
-
-            D3D12_RESOURCE_DESC resourceDesc;
-
-            assert(desc.dimensions.x > 0); // Make sure the width is valid
-            assert(desc.dimensions.y > 0); // Make sure the height is valid
-            assert(desc.format != IMAGE_FORMAT_UNKNOWN); // Make sure the format is valid
-
-            int sampleQuality = (desc.sampleCount == SAMPLE_COUNT_1) ? 0 : SampleCountToInt(desc.sampleCount);
-
-            resourceDesc = CD3DX12_RESOURCE_DESC::Tex2D(ToBaseFormat(desc.format),
-                desc.dimensions.x, desc.dimensions.y,
-                1, 1, SampleCountToInt(desc.sampleCount), sampleQuality, D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL );
+            D3D12_RESOURCE_DESC resourceDesc = ToResourceDesc(desc);
 
             D3D12_CLEAR_VALUE clearValue = {};
             clearValue.Format = ToDXGIFormat(desc.format);
             clearValue.DepthStencil.Depth = desc.depthClearValue;
             clearValue.DepthStencil.Stencil = desc.stencilClearValue;
 
-            HRESULT result = device->_device->CreateCommittedResource(&heapProperties, D3D12_HEAP_FLAG_ALLOW_ALL_BUFFERS_AND_TEXTURES,
-                &resourceDesc, D3D12_RESOURCE_STATE_DEPTH_WRITE, &clearValue, IID_PPV_ARGS(image.resource.ReleaseAndGetAddressOf()));
+            HRESULT result = CreateResource(device, resourceDesc, D3D12_RESOURCE_STATE_DEPTH_WRITE, clearValue, heap, heapOffset, image.resource);
             assert(SUCCEEDED(result)); // Failed to create commited resource
 
             {
@@ -344,6 +329,123 @@ namespace Renderer
             return DepthImageID(static_cast<type>(nextHandle));
         }
 
+        void ImageHandlerDX12::GetMemoryRequirements(RenderDeviceDX12* device, const ImageDesc& desc, size_t& size, size_t& alignment)
+        {
+            D3D12_RESOURCE_DESC resourceDesc = ToResourceDesc(desc);
+            D3D12_RESOURCE_ALLOCATION_INFO allocationInfo = device->_device->GetResourceAllocationInfo(0, 1, &resourceDesc);
+
+            size = static_cast<size_t>(allocationInfo.SizeInBytes);
+            alignment = static_cast<size_t>(allocationInfo.Alignment);
+        }
+
+        void ImageHandlerDX12::GetMemoryRequirements(RenderDeviceDX12* device, const DepthImageDesc& desc, size_t& size, size_t& alignment)
+        {
+            D3D12_RESOURCE_DESC resourceDesc = ToResourceDesc(desc);
+            D3D12_RESOURCE_ALLOCATION_INFO allocationInfo = device->_device->GetResourceAllocationInfo(0, 1, &resourceDesc);
+
+            size = static_cast<size_t>(allocationInfo.SizeInBytes);
+            alignment = static_cast<size_t>(allocationInfo.Alignment);
+        }
+
+        TransientHeapID ImageHandlerDX12::CreateTransientHeap(RenderDeviceDX12* device, const TransientHeapDesc& desc)
+        {
+            size_t nextHandle = _heaps.size();
+
+            // Make sure we haven't exceeded the limit of the TransientHeapID type, if this hits you need to change type of TransientHeapID to something bigger
+            assert(nextHandle < TransientHeapID::MaxValue());
+            using type = type_safe::underlying_type<TransientHeapID>;
+
+            // Transient images are all render targets or depth images, which is the only mix every resource heap tier allows in one heap
+            D3D12_HEAP_DESC heapDesc = {};
+            heapDesc.SizeInBytes = desc.size;
+            heapDesc.Properties = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT);
+            heapDesc.Alignment = desc.alignment;
+            heapDesc.Flags = D3D12_HEAP_FLAG_ALLOW_ONLY_RT_DS_TEXTURES;
+
+            Microsoft::WRL::ComPtr<ID3D12Heap> heap;
+            HRESULT result = device->_device->CreateHeap(&heapDesc, IID_PPV_ARGS(heap.ReleaseAndGetAddressOf()));
+            assert(SUCCEEDED(result)); // Failed to create transient heap
+
+            result = heap->SetName(L"Transient Heap");
+            assert(SUCCEEDED(result)); // Failed to name transient heap
+
+            _heaps.push_back(heap);
+            return TransientHeapID(static_cast<type>(nextHandle));
+        }
+
+        void ImageHandlerDX12::DestroyTransientHeap(TransientHeapID heap)
+        {
+            using type = type_safe::underlying_type<TransientHeapID>;
+            assert(static_cast<type>(heap) < _heaps.size()); // Invalid TransientHeapID
+
+            // EndCommandList waits for the GPU to finish, so nothing can still be using the images or the heap by the time this gets called
+            for (auto& image : _images)
+            {
+                if (image.heap == heap)
+                {
+                    image.rtvDescriptorHeap.Reset();
+                    image.srvUavDescriptorHeap.Reset();
+                    image.resource.Reset();
+                    image.heap = TransientHeapID::Invalid();
+                }
+            }
+            for (auto& image : _depthImages)
+            {
+                if (image.heap == heap)
+                {
+                    image.dsvDescriptorHeap.Reset();
+                    image.srvDescriptorHeap.Reset();
+                    image.resource.Reset();
+                    image.heap = TransientHeapID::Invalid();
+                }
+            }
+
+            _heaps[static_cast<type>(heap)].Reset();
+        }
+
+        D3D12_RESOURCE_DESC ImageHandlerDX12::ToResourceDesc(const ImageDesc& desc)
+        {
+            assert(desc.dimensions.x > 0); // Make sure the width is valid
+            assert(desc.dimensions.y > 0); // Make sure the height is valid
+            assert(desc.depth == 1); // Non-2d images is currently unsupported
+            assert(desc.format != IMAGE_FORMAT_UNKNOWN); // Make sure the format is valid
+
+            int sampleQuality = (desc.sampleCount == SAMPLE_COUNT_1) ? 0 : SampleCountToInt(desc.sampleCount);
+
+            return CD3DX12_RESOURCE_DESC::Tex2D(ToDXGIFormat(desc.format),
+                desc.dimensions.x, desc.dimensions.y,
+                1, 1, SampleCountToInt(desc.sampleCount), sampleQuality, D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET | D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS);
+        }
+
+        D3D12_RESOURCE_DESC ImageHandlerDX12::ToResourceDesc(const DepthImageDesc& desc)
+        {
+            assert(desc.dimensions.x > 0); // Make sure the width is valid
+            assert(desc.dimensions.y > 0); // Make sure the height is valid
+            assert(desc.format != IMAGE_FORMAT_UNKNOWN); // Make sure the format is valid
+
+            int sampleQuality = (desc.sampleCount == SAMPLE_COUNT_1) ? 0 : SampleCountToInt(desc.sampleCount);
+
+            return CD3DX12_RESOURCE_DESC::Tex2D(ToBaseFormat(desc.format),
+                desc.dimensions.x, desc.dimensions.y,
+                1, 1, SampleCountToInt(desc.sampleCount), sampleQuality, D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL);
+        }
+
+        HRESULT ImageHandlerDX12::CreateResource(RenderDeviceDX12* device, const D3D12_RESOURCE_DESC& resourceDesc, D3D12_RESOURCE_STATES initialState, const D3D12_CLEAR_VALUE& clearValue, TransientHeapID heap, size_t heapOffset, Microsoft::WRL::ComPtr<ID3D12Resource>& resource)
+        {
+            if (heap == TransientHeapID::Invalid())
+            {
+                auto heapProperties = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT);
+                return device->_device->CreateCommittedResource(&heapProperties, D3D12_HEAP_FLAG_ALLOW_ALL_BUFFERS_AND_TEXTURES,
+                    &resourceDesc, initialState, &clearValue, IID_PPV_ARGS(resource.ReleaseAndGetAddressOf()));
+            }
+
+            using type = type_safe::underlying_type<TransientHeapID>;
+            assert(static_cast<type>(heap) < _heaps.size() && _heaps[static_cast<type>(heap)] != nullptr); // Invalid TransientHeapID
+
+            return device->_device->CreatePlacedResource(_heaps[static_cast<type>(heap)].Get(), heapOffset,
+                &resourceDesc, initialState, &clearValue, IID_PPV_ARGS(resource.ReleaseAndGetAddressOf()));
+        }
+
         const ImageDesc& ImageHandlerDX12::GetDescriptor(const ImageID id)
         {
             using type = type_safe::underlying_type<ImageID>;
@@ -505,30 +607,34 @@ namespace Renderer
         {
             HRESULT hr;
 
-            // we only need one instance of the imaging factory to create decoders and frames
-            static IWICImagingFactory* wicFactory;
-
-            // reset decoder, frame and converter since these will be different for each image we load
-            IWICBitmapDecoder* wicDecoder = NULL;
-            IWICBitmapFrameDecode* wicFrame = NULL;
-            IWICFormatConverter* wicConverter = NULL;
-
-            bool imageConverted = false;
-
-            if (wicFactory == NULL)
+            // COM needs to be initialized on every thread that decodes images, async texture loads run this on job system workers
+            thread_local bool comInitialized = false;
+            if (!comInitialized)
             {
-                // Initialize the COM library
                 CoInitialize(NULL);
+                comInitialized = true;
+            }
 
-                // create the WIC factory
-                hr = CoCreateInstance(
+            // we only need one instance of the imaging factory to create decoders and frames, a function local static is created exactly once even with several threads loading
+            static IWICImagingFactory* wicFactory = []()
+            {
+                IWICImagingFactory* factory = NULL;
+                HRESULT factoryResult = CoCreateInstance(
                     CLSID_WICImagingFactory,
                     NULL,
                     CLSCTX_INPROC_SERVER,
-                    IID_PPV_ARGS(&wicFactory)
+                    IID_PPV_ARGS(&factory)
                 );
-                assert(SUCCEEDED(hr));
-            }
+                assert(SUCCEEDED(factoryResult));
+                return factory;
+            }();
+
+            // reset decoder, frame and converter since these will be different for each image we load
+            IWICBitmapDecoder* wicDecoder = NULL;
+            IWICBitmapFrameDecode* wicFrame = NULL;
+            IWICFormatConverter* wicConverter = NULL;
+
+            bool imageConverted = false;
 
             // load a decoder for the image
             hr = wicFactory->CreateDecoderFromFilename(
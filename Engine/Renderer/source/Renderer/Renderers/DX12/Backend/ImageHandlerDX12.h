@@ -6,6 +6,7 @@
 
 #include "../../../Descriptors/ImageDesc.h"
 #include "../../../Descriptors/DepthImageDesc.h"
+#include "../../../Descriptors/TransientHeapDesc.h"
 
 enum DXGI_FORMAT;
 
@@ -22,9 +23,32 @@ namespace Renderer
             ImageHandlerDX12();
             ~ImageHandlerDX12();
 
+            struct TextureData
+            {
+                u8* imageData = nullptr;
+                D3D12_RESOURCE_DESC resourceDesc = {};
+                int bytesPerRow = 0;
+
+                ~TextureData() { free(imageData); }
+            };
+
             TextureID LoadTexture(RenderDeviceDX12* device, CommandListHandlerDX12* commandListHandler, const TextureDesc& desc);
-            ImageID CreateImage(RenderDeviceDX12* device, const ImageDesc& desc);
-            DepthImageID CreateDepthImage(RenderDeviceDX12* device, const DepthImageDesc& desc);
+
+            // Reads and decodes the image file, this doesn't touch the handler so it's safe to call from any thread
+            void ReadTexture(const TextureDesc& desc, TextureData& data);
+
+            // Uploads data read by ReadTexture and adds the texture
+            TextureID CreateTexture(RenderDeviceDX12* device, CommandListHandlerDX12* commandListHandler, const TextureDesc& desc, TextureData& data);
+            // Images get their own memory unless they're given a transient heap to be placed in
+            ImageID CreateImage(RenderDeviceDX12* device, const ImageDesc& desc, TransientHeapID heap = TransientHeapID::Invalid(), size_t heapOffset = 0);
+            DepthImageID CreateDepthImage(RenderDeviceDX12* device, const DepthImageDesc& desc, TransientHeapID heap = TransientHeapID::Invalid(), size_t heapOffset = 0);
+
+            void GetMemoryRequirements(RenderDeviceDX12* device, const ImageDesc& desc, size_t& size, size_t& alignment);
+            void GetMemoryRequirements(RenderDeviceDX12* device, const DepthImageDesc& desc, size_t& size, size_t& alignment);
+
+            TransientHeapID CreateTransientHeap(RenderDeviceDX12* device, const TransientHeapDesc& desc);
+            // Releases the heap and every image placed in it, their IDs stay invalid
+            void DestroyTransientHeap(TransientHeapID heap);
 
             const ImageDesc& GetDescriptor(const ImageID id);
             const DepthImageDesc& GetDescriptor(const DepthImageID id);
@@ -61,6 +85,7 @@ namespace Renderer
                 D3D12_CPU_DESCRIPTOR_HANDLE uav;
 
                 bool isTexture = false;
+                TransientHeapID heap = TransientHeapID::Invalid();
             };
 
             struct DepthImage
@@ -73,11 +98,17 @@ namespace Renderer
 
                 D3D12_CPU_DESCRIPTOR_HANDLE dsv;
                 D3D12_CPU_DESCRIPTOR_HANDLE srv;
+
+                TransientHeapID heap = TransientHeapID::Invalid();
             };
 
         private:
             void LoadImageDataFromFile(u8** imageData, D3D12_RESOURCE_DESC& resourceDescription, std::wstring fileName, int& bytesPerRow);
 
+            static D3D12_RESOURCE_DESC ToResourceDesc(const ImageDesc& desc);
+            static D3D12_RESOURCE_DESC ToResourceDesc(const DepthImageDesc& desc);
+            HRESULT CreateResource(RenderDeviceDX12* device, const D3D12_RESOURCE_DESC& resourceDesc, D3D12_RESOURCE_STATES initialState, const D3D12_CLEAR_VALUE& clearValue, TransientHeapID heap, size_t heapOffset, Microsoft::WRL::ComPtr<ID3D12Resource>& resource);
+
             static ::DXGI_FORMAT ToDXGIFormat(ImageFormat format);
 
             static ::DXGI_FORMAT ToBaseFormat(DepthImageFormat format);
@@ -93,6 +124,7 @@ namespace Renderer
         private:
             std::vector<Image> _images;
             std::vector<DepthImage> _depthImages;
+            std::vector<Microsoft::WRL::ComPtr<ID3D12Heap>> _heaps;
         };
     }
 }
\ No newline at end of file
@@ -35,6 +35,8 @@ namespace Renderer
 
 
 
+            const MaterialDesc& GetDescriptor(const MaterialID id) { return _materials[static_cast<_MaterialID>(id)].desc; }
+
             VertexShaderID GetVertexShader(const MaterialID id) { return _materials[static_cast<_MaterialID>(id)].vertexShader; }
             PixelShaderID GetPixelShader(const MaterialID id) { return _materials[static_cast<_MaterialID>(id)].pixelShader; }
             
@@ -38,6 +38,7 @@ namespace Renderer
             using type = type_safe::underlying_type<ModelID>;
 
             Model model;
+            model.primitiveDesc = desc;
             
             Vector2 halfSize = Vector2(desc.size.x / 2.0f, desc.size.y / 2.0f);
 
@@ -66,6 +67,14 @@ namespace Renderer
         }
 
         ModelID ModelHandlerDX12::LoadModel(RenderDeviceDX12* device, CommandListHandlerDX12* commandListHandler, const ModelDesc& desc)
+        {
+            TempModelData modelData;
+            LoadFromFile(desc, modelData);
+
+            return CreateModel(device, commandListHandler, desc, modelData);
+        }
+
+        ModelID ModelHandlerDX12::CreateModel(RenderDeviceDX12* device, CommandListHandlerDX12* commandListHandler, const ModelDesc& desc, TempModelData& data)
         {
             size_t handle = _models.size();
             assert(handle < ModelID::MaxValue());
@@ -74,9 +83,7 @@ namespace Renderer
             Model model;
             model.desc = desc;
 
-            TempModelData modelData;
-            LoadFromFile(desc, modelData);
-            InitModel(device, commandListHandler, model, modelData);
+            InitModel(device, commandListHandler, model, data);
 
             _models.push_back(model);
             return ModelID(static_cast<type>(handle));
@@ -103,11 +110,25 @@ namespace Renderer
             return _models[static_cast<type>(id)].numIndices;
         }
 
+        const ModelDesc& ModelHandlerDX12::GetDescriptor(ModelID id)
+        {
+            using type = type_safe::underlying_type<ModelID>;
+
+            return _models[static_cast<type>(id)].desc;
+        }
+
+        const PrimitivePlaneDesc& ModelHandlerDX12::GetPrimitiveDescriptor(ModelID id)
+        {
+            using type = type_safe::underlying_type<ModelID>;
+
+            return _models[static_cast<type>(id)].primitiveDesc;
+        }
+
         void ModelHandlerDX12::LoadFromFile(const ModelDesc& desc, TempModelData& data)
         {
             // How to open files with handles for Capnproto, don't use fstream etc! https://www.mail-archive.com/capnproto@googlegroups.com/msg01052.html
             const std::wstring& wFilePath = StringUtils::StringToWString(desc.path);
-            HANDLE hFile = CreateFile(wFilePath.c_str(), GENERIC_READ, 0, NULL, OPEN_EXISTING, 0, NULL);
+            HANDLE hFile = CreateFile(wFilePath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, 0, NULL); // Share reading, async loads can have the same file open on several threads
 
             kj::HandleInputStream iStream(hFile);
             capnp::InputStreamMessageReader iStreamReader(iStream);
@@ -27,19 +27,8 @@ namespace Renderer
             D3D12_INDEX_BUFFER_VIEW* GetIndexBufferView(ModelID id);
             u32 GetNumIndices(ModelID id);
 
-        private:
-            struct Model
-            {
-                ModelDesc desc;
-
-                Microsoft::WRL::ComPtr<ID3D12Resource> vertexBuffer;
-                Microsoft::WRL::ComPtr<ID3D12Resource> indexBuffer;
-
-                D3D12_VERTEX_BUFFER_VIEW vertexBufferView;
-                D3D12_INDEX_BUFFER_VIEW indexBufferView;
-
-                u32 numIndices;
-            };
+            const ModelDesc& GetDescriptor(ModelID id);
+            const PrimitivePlaneDesc& GetPrimitiveDescriptor(ModelID id);
 
             struct Vertex
             {
@@ -61,8 +50,28 @@ namespace Renderer
                 std::vector<u32> indices;
             };
 
-        private:
+            // Reads and decodes the model file, this doesn't touch the handler so it's safe to call from any thread
             void LoadFromFile(const ModelDesc& desc, TempModelData& data);
+
+            // Uploads data read by LoadFromFile and adds the model
+            ModelID CreateModel(RenderDeviceDX12* device, CommandListHandlerDX12* commandListHandler, const ModelDesc& desc, TempModelData& data);
+
+        private:
+            struct Model
+            {
+                ModelDesc desc; // The path is empty for primitive models
+                PrimitivePlaneDesc primitiveDesc;
+
+                Microsoft::WRL::ComPtr<ID3D12Resource> vertexBuffer;
+                Microsoft::WRL::ComPtr<ID3D12Resource> indexBuffer;
+
+                D3D12_VERTEX_BUFFER_VIEW vertexBufferView;
+                D3D12_INDEX_BUFFER_VIEW indexBufferView;
+
+                u32 numIndices;
+            };
+
+        private:
             void InitModel(RenderDeviceDX12* device, CommandListHandlerDX12* commandListHandler, Model& model, TempModelData& data);
             
         private:
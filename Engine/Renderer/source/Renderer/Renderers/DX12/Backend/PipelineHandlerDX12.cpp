@@ -88,6 +88,13 @@ namespace Renderer
             {
                 numRootDescriptors++;
             }
+
+            // The instance buffer goes last so the other root parameters keep the indices RendererDX12 binds them at
+            if (desc.states.instanceBufferState.enabled)
+            {
+                pipeline.instanceBufferRootIndex = numRootDescriptors;
+                numRootDescriptors++;
+            }
             
             // Create CB root descriptors
             std::vector<D3D12_ROOT_DESCRIPTOR> cbRootDescriptors(numConstantBuffers);
@@ -127,6 +134,15 @@ namespace Renderer
                 rootParameters[rootParamIndex].DescriptorTable = descriptorTable;
                 rootParameters[rootParamIndex].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
             }
+            // Create instance buffer root parameter, instanced draws bind it at the first instance they draw
+            if (desc.states.instanceBufferState.enabled)
+            {
+                u32 rootParamIndex = pipeline.instanceBufferRootIndex;
+                rootParameters[rootParamIndex].ParameterType = D3D12_ROOT_PARAMETER_TYPE_SRV;
+                rootParameters[rootParamIndex].Descriptor.RegisterSpace = 1;
+                rootParameters[rootParamIndex].Descriptor.ShaderRegister = 0;
+                rootParameters[rootParamIndex].ShaderVisibility = ToD3D12ShaderVisibility(desc.states.instanceBufferState.shaderVisibility);
+            }
 
             // Create samplers
             u8 numSamplers = 0;
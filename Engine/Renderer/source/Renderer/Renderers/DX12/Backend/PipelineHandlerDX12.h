@@ -41,12 +41,15 @@ namespace Renderer
             ID3D12RootSignature* GetRootSignature(GraphicsPipelineID id) { return _graphicsPipelines[static_cast<gIDType>(id)].rootSig.Get(); }
             ID3D12RootSignature* GetRootSignature(ComputePipelineID id) { return _computePipelines[static_cast<gIDType>(id)].rootSig.Get(); }
 
+            u32 GetInstanceBufferRootIndex(GraphicsPipelineID id) { return _graphicsPipelines[static_cast<gIDType>(id)].instanceBufferRootIndex; }
+
         private:
             struct GraphicsPipeline
             {
                 GraphicsPipelineDesc desc;
                 MaterialPipelineDesc materialDesc;
                 u64 cacheDescHash;
+                u8 instanceBufferRootIndex = 0; // Only set if desc.states.instanceBufferState is enabled
 
                 Microsoft::WRL::ComPtr<ID3D12PipelineState> pso = nullptr;
                 Microsoft::WRL::ComPtr<ID3D12RootSignature> rootSig = nullptr;
@@ -419,12 +419,15 @@ namespace Renderer
             Backend::ConstantBufferBackendDX12* cbBackend = new Backend::ConstantBufferBackendDX12();
             _constantBufferBackends.push_back(cbBackend);
 
+            // Heaps are allocated in 64KB pages anyway, so small buffers get a whole page and instance buffers as many as they need
+            size_t heapSize = (size + 1024 * 64 - 1) / (1024 * 64) * (1024 * 64);
+
             for (int i = 0; i < Backend::ConstantBufferBackendDX12::FRAME_BUFFER_COUNT; ++i)
             {
                 HRESULT result = _device->CreateCommittedResource(
                     &CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD), // this heap will be used to upload the constant buffer data
                     D3D12_HEAP_FLAG_NONE, // no flags
-                    &CD3DX12_RESOURCE_DESC::Buffer(1024 * 64), // size of the resource heap. Must be a multiple of 64KB for single-textures and constant buffers
+                    &CD3DX12_RESOURCE_DESC::Buffer(heapSize), // size of the resource heap. Must be a multiple of 64KB for single-textures and constant buffers
                     D3D12_RESOURCE_STATE_GENERIC_READ, // will be data that is read from so we keep it in the generic read state
                     nullptr, // we do not have use an optimized clear value for constant buffers
                     IID_PPV_ARGS(cbBackend->uploadHeap[i].ReleaseAndGetAddressOf()));
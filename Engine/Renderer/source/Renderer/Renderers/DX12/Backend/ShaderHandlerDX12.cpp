@@ -31,19 +31,19 @@ namespace Renderer
             _computeShaders.clear();
         }
 
-        VertexShaderID ShaderHandlerDX12::LoadShader(const VertexShaderDesc& desc)
+        VertexShaderID ShaderHandlerDX12::LoadShader(const VertexShaderDesc& desc, ID3DBlob* bytecode)
         {
-            return LoadShader<VertexShaderID>(desc.path, _vertexShaders);
+            return LoadShader<VertexShaderID>(desc.path, _vertexShaders, bytecode);
         }
 
-        PixelShaderID ShaderHandlerDX12::LoadShader(const PixelShaderDesc& desc)
+        PixelShaderID ShaderHandlerDX12::LoadShader(const PixelShaderDesc& desc, ID3DBlob* bytecode)
         {
-            return LoadShader<PixelShaderID>(desc.path, _pixelShaders);
+            return LoadShader<PixelShaderID>(desc.path, _pixelShaders, bytecode);
         }
 
-        ComputeShaderID ShaderHandlerDX12::LoadShader(const ComputeShaderDesc& desc)
+        ComputeShaderID ShaderHandlerDX12::LoadShader(const ComputeShaderDesc& desc, ID3DBlob* bytecode)
         {
-            return LoadShader<ComputeShaderID>(desc.path, _computeShaders);
+            return LoadShader<ComputeShaderID>(desc.path, _computeShaders, bytecode);
         }
 
         ID3DBlob* ShaderHandlerDX12::ReadFile(const std::string& filename)
@@ -55,14 +55,12 @@ namespace Renderer
             return blob;
         }
 
-        bool ShaderHandlerDX12::TryFindExistingShader(const std::string& shaderPath, std::vector<Shader>& shaders, size_t& id)
+        bool ShaderHandlerDX12::TryFindExistingShader(StringID pathID, std::vector<Shader>& shaders, size_t& id)
         {
-            u32 shaderPathHash = StringUtils::fnv1a_32(shaderPath.c_str(), shaderPath.length());
-
             id = 0;
             for (Shader& existingShader : shaders)
             {
-                if (StringUtils::fnv1a_32(existingShader.path.c_str(), existingShader.path.length()) == shaderPathHash)
+                if (existingShader.pathID == pathID)
                 {
                     return true;
                 }
@@ -2,6 +2,7 @@
 #include <Core.h>
 #include <vector>
 #include <cassert>
+#include <Utils/StringID.h>
 #include "d3dx12.h"
 
 #include "../../../Descriptors/VertexShaderDesc.h"
@@ -22,41 +23,60 @@ namespace Renderer
             ShaderHandlerDX12();
             ~ShaderHandlerDX12();
 
-            VertexShaderID LoadShader(const VertexShaderDesc& desc);
-            PixelShaderID LoadShader(const PixelShaderDesc& desc);
-            ComputeShaderID LoadShader(const ComputeShaderDesc& desc);
+            // Pass bytecode that was already read with ReadFile to skip reading it here, the handler takes ownership of it
+            VertexShaderID LoadShader(const VertexShaderDesc& desc, ID3DBlob* bytecode = nullptr);
+            PixelShaderID LoadShader(const PixelShaderDesc& desc, ID3DBlob* bytecode = nullptr);
+            ComputeShaderID LoadShader(const ComputeShaderDesc& desc, ID3DBlob* bytecode = nullptr);
+
+            // This doesn't touch the handler so it's safe to call from any thread
+            ID3DBlob* ReadFile(const std::string& filename);
 
             CD3DX12_SHADER_BYTECODE* GetBytecode(const VertexShaderID id) { return _vertexShaders[static_cast<vsIDType>(id)].bytecode; }
             CD3DX12_SHADER_BYTECODE* GetBytecode(const PixelShaderID id) { return _pixelShaders[static_cast<psIDType>(id)].bytecode; }
             CD3DX12_SHADER_BYTECODE* GetBytecode(const ComputeShaderID id) { return _computeShaders[static_cast<csIDType>(id)].bytecode; }
 
+            const std::string& GetPath(const VertexShaderID id) { return _vertexShaders[static_cast<vsIDType>(id)].path; }
+            const std::string& GetPath(const PixelShaderID id) { return _pixelShaders[static_cast<psIDType>(id)].path; }
+            const std::string& GetPath(const ComputeShaderID id) { return _computeShaders[static_cast<csIDType>(id)].path; }
+
         private:
             struct Shader
             {
                 CD3DX12_SHADER_BYTECODE* bytecode;
+                StringID pathID;
                 std::string path;
             };
 
         private:
             template <typename T>
-            T LoadShader(const std::string& shaderPath, std::vector<Shader>& shaders)
+            T LoadShader(const std::string& shaderPath, std::vector<Shader>& shaders, ID3DBlob* bytecode)
             {
                 size_t id;
                 using idType = type_safe::underlying_type<T>;
 
+                StringID pathID(shaderPath);
+
                 // If shader is already loaded, return ID of already loaded version
-                if (TryFindExistingShader(shaderPath, shaders, id))
+                if (TryFindExistingShader(pathID, shaders, id))
                 {
+                    if (bytecode != nullptr)
+                    {
+                        bytecode->Release();
+                    }
                     return T(static_cast<idType>(id));
                 }
 
-                ID3DBlob* bytecode = ReadFile(shaderPath);
+                if (bytecode == nullptr)
+                {
+                    bytecode = ReadFile(shaderPath);
+                }
                 id = shaders.size();
 
                 assert(id < T::MaxValue());
                 
                 Shader shader;
                 shader.bytecode = new CD3DX12_SHADER_BYTECODE(bytecode);
+                shader.pathID = pathID;
                 shader.path = shaderPath;
 
                 shaders.push_back(shader);
@@ -64,8 +84,7 @@ namespace Renderer
                 return T(static_cast<idType>(id));
             }
 
-            ID3DBlob* ReadFile(const std::string& filename);
-            bool TryFindExistingShader(const std::string& shaderPath, std::vector<Shader>& shaders, size_t& id);
+            bool TryFindExistingShader(StringID pathID, std::vector<Shader>& shaders, size_t& id);
             
         private:
             std::vector<Shader> _vertexShaders;
@@ -20,6 +20,69 @@
 
 namespace Renderer
 {
+    namespace
+    {
+        // What the Read*Async functions hand over to their Finalize*Async
+        struct TextureLoadDataDX12 : public AsyncLoadData
+        {
+            Backend::ImageHandlerDX12::TextureData textureData;
+        };
+
+        struct ModelLoadDataDX12 : public AsyncLoadData
+        {
+            Backend::ModelHandlerDX12::TempModelData modelData;
+        };
+
+        struct ShaderLoadDataDX12 : public AsyncLoadData
+        {
+            ID3DBlob* bytecode = nullptr; // Ownership moves to the shader handler when finalizing
+
+            ~ShaderLoadDataDX12()
+            {
+                if (bytecode != nullptr)
+                {
+                    bytecode->Release();
+                }
+            }
+        };
+
+        bool HasStencil(DepthImageFormat format)
+        {
+            switch (format)
+            {
+            case DepthImageFormat::DEPTH_IMAGE_FORMAT_R32G8X24_TYPELESS:
+            case DepthImageFormat::DEPTH_IMAGE_FORMAT_D32_FLOAT_S8X24_UINT:
+            case DepthImageFormat::DEPTH_IMAGE_FORMAT_X32_TYPELESS_G8X24_UINT:
+            case DepthImageFormat::DEPTH_IMAGE_FORMAT_R24G8_TYPELESS:
+            case DepthImageFormat::DEPTH_IMAGE_FORMAT_D24_UNORM_S8_UINT:
+            case DepthImageFormat::DEPTH_IMAGE_FORMAT_X24_TYPELESS_G8_UINT:
+                return true;
+            default:
+                return false;
+            }
+        }
+
+        D3D12_RESOURCE_STATES ToResourceStates(ResourceState state)
+        {
+            D3D12_RESOURCE_STATES states = D3D12_RESOURCE_STATE_COMMON;
+
+            if (state & RESOURCE_STATE_RENDER_TARGET)
+                states |= D3D12_RESOURCE_STATE_RENDER_TARGET;
+            if (state & RESOURCE_STATE_UNORDERED_ACCESS)
+                states |= D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+            if (state & RESOURCE_STATE_DEPTH_WRITE)
+                states |= D3D12_RESOURCE_STATE_DEPTH_WRITE;
+            if (state & RESOURCE_STATE_DEPTH_READ)
+                states |= D3D12_RESOURCE_STATE_DEPTH_READ;
+            if (state & RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE)
+                states |= D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE;
+            if (state & RESOURCE_STATE_PIXEL_SHADER_RESOURCE)
+                states |= D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+
+            return states;
+        }
+    }
+
     RendererDX12::RendererDX12()
         : _device(new Backend::RenderDeviceDX12())
     {
@@ -39,7 +102,9 @@ namespace Renderer
 
     void RendererDX12::Deinit()
     {
+        DiscardAsyncLoads(); // Reads still running on the job system use the handlers we're about to delete
         _device->FlushGPU(); // Make sure it has finished rendering
+        DestroyTransientResources();
 
         delete(_device);
         delete(_imageHandler);
@@ -60,61 +125,179 @@ namespace Renderer
 
     ImageID RendererDX12::CreateImage(ImageDesc& desc)
     {
+        std::lock_guard<std::mutex> lock(_resourceMutex);
         return _imageHandler->CreateImage(_device, desc);
     }
 
     DepthImageID RendererDX12::CreateDepthImage(DepthImageDesc& desc)
     {
+        std::lock_guard<std::mutex> lock(_resourceMutex);
         return _imageHandler->CreateDepthImage(_device, desc);
     }
 
+    void RendererDX12::GetMemoryRequirements(const ImageDesc& desc, size_t& size, size_t& alignment)
+    {
+        _imageHandler->GetMemoryRequirements(_device, desc, size, alignment);
+    }
+
+    void RendererDX12::GetMemoryRequirements(const DepthImageDesc& desc, size_t& size, size_t& alignment)
+    {
+        _imageHandler->GetMemoryRequirements(_device, desc, size, alignment);
+    }
+
+    TransientHeapID RendererDX12::CreateTransientHeap(TransientHeapDesc& desc)
+    {
+        std::lock_guard<std::mutex> lock(_resourceMutex);
+        return _imageHandler->CreateTransientHeap(_device, desc);
+    }
+
+    void RendererDX12::DestroyTransientHeap(TransientHeapID heap)
+    {
+        std::lock_guard<std::mutex> lock(_resourceMutex);
+        _imageHandler->DestroyTransientHeap(heap);
+    }
+
+    ImageID RendererDX12::CreatePlacedImage(ImageDesc& desc, TransientHeapID heap, size_t offset)
+    {
+        std::lock_guard<std::mutex> lock(_resourceMutex);
+        return _imageHandler->CreateImage(_device, desc, heap, offset);
+    }
+
+    DepthImageID RendererDX12::CreatePlacedImage(DepthImageDesc& desc, TransientHeapID heap, size_t offset)
+    {
+        std::lock_guard<std::mutex> lock(_resourceMutex);
+        return _imageHandler->CreateDepthImage(_device, desc, heap, offset);
+    }
+
+    const ImageDesc& RendererDX12::GetDescriptor(ImageID image)
+    {
+        std::lock_guard<std::mutex> lock(_resourceMutex);
+        return _imageHandler->GetDescriptor(image);
+    }
+
+    const DepthImageDesc& RendererDX12::GetDescriptor(DepthImageID image)
+    {
+        std::lock_guard<std::mutex> lock(_resourceMutex);
+        return _imageHandler->GetDescriptor(image);
+    }
+
+    const GraphicsPipelineDesc& RendererDX12::GetDescriptor(GraphicsPipelineID pipeline)
+    {
+        std::lock_guard<std::mutex> lock(_resourceMutex);
+        return _pipelineHandler->GetDescriptor(pipeline);
+    }
+
+    const MaterialPipelineDesc& RendererDX12::GetDescriptor(MaterialPipelineID pipeline)
+    {
+        std::lock_guard<std::mutex> lock(_resourceMutex);
+        return _pipelineHandler->GetMaterialDescriptor(pipeline);
+    }
+
+    const ComputePipelineDesc& RendererDX12::GetDescriptor(ComputePipelineID pipeline)
+    {
+        std::lock_guard<std::mutex> lock(_resourceMutex);
+        return _pipelineHandler->GetDescriptor(pipeline);
+    }
+
+    const MaterialDesc& RendererDX12::GetDescriptor(MaterialID material)
+    {
+        std::lock_guard<std::mutex> lock(_resourceMutex);
+        return _materialHandler->GetDescriptor(material);
+    }
+
+    const ModelDesc& RendererDX12::GetDescriptor(ModelID model)
+    {
+        std::lock_guard<std::mutex> lock(_resourceMutex);
+        return _modelHandler->GetDescriptor(model);
+    }
+
+    const PrimitivePlaneDesc& RendererDX12::GetPrimitiveDescriptor(ModelID model)
+    {
+        std::lock_guard<std::mutex> lock(_resourceMutex);
+        return _modelHandler->GetPrimitiveDescriptor(model);
+    }
+
+    VertexShaderDesc RendererDX12::GetDescriptor(VertexShaderID shader)
+    {
+        std::lock_guard<std::mutex> lock(_resourceMutex);
+        VertexShaderDesc desc;
+        desc.path = _shaderHandler->GetPath(shader);
+        return desc;
+    }
+
+    PixelShaderDesc RendererDX12::GetDescriptor(PixelShaderID shader)
+    {
+        std::lock_guard<std::mutex> lock(_resourceMutex);
+        PixelShaderDesc desc;
+        desc.path = _shaderHandler->GetPath(shader);
+        return desc;
+    }
+
+    ComputeShaderDesc RendererDX12::GetDescriptor(ComputeShaderID shader)
+    {
+        std::lock_guard<std::mutex> lock(_resourceMutex);
+        ComputeShaderDesc desc;
+        desc.path = _shaderHandler->GetPath(shader);
+        return desc;
+    }
+
     GraphicsPipelineID RendererDX12::CreatePipeline(GraphicsPipelineDesc& desc)
     {
+        std::lock_guard<std::mutex> lock(_resourceMutex);
         return _pipelineHandler->CreatePipeline(_device, _shaderHandler, _imageHandler, desc);
     }
 
     MaterialPipelineID RendererDX12::CreatePipeline(MaterialPipelineDesc& desc)
     {
+        std::lock_guard<std::mutex> lock(_resourceMutex);
         return _pipelineHandler->CreatePipeline(_device, _shaderHandler, _imageHandler, _materialHandler, desc);
     }
 
     ComputePipelineID RendererDX12::CreatePipeline(ComputePipelineDesc& desc)
     {
+        std::lock_guard<std::mutex> lock(_resourceMutex);
         return _pipelineHandler->CreatePipeline(_device, _shaderHandler, _imageHandler, desc);
     }
 
     ModelID RendererDX12::CreatePrimitiveModel(PrimitivePlaneDesc& desc)
     {
+        std::lock_guard<std::mutex> lock(_resourceMutex);
         return _modelHandler->CreatePrimitiveModel(_device, _commandListHandler, desc);
     }
 
     TextureID RendererDX12::LoadTexture(TextureDesc& desc)
     {
+        std::lock_guard<std::mutex> lock(_resourceMutex);
         return _imageHandler->LoadTexture(_device, _commandListHandler, desc);
     }
 
     ModelID RendererDX12::LoadModel(ModelDesc& desc)
     {
+        std::lock_guard<std::mutex> lock(_resourceMutex);
         return _modelHandler->LoadModel(_device, _commandListHandler, desc);
     }
 
     MaterialID RendererDX12::LoadMaterial(MaterialDesc& desc)
     {
+        std::lock_guard<std::mutex> lock(_resourceMutex);
         return _materialHandler->LoadMaterial(_device, _commandListHandler, _shaderHandler, _imageHandler, desc);
     }
 
     VertexShaderID RendererDX12::LoadShader(VertexShaderDesc& desc)
     {
+        std::lock_guard<std::mutex> lock(_resourceMutex);
         return _shaderHandler->LoadShader(desc);
     }
 
     PixelShaderID RendererDX12::LoadShader(PixelShaderDesc& desc)
     {
+        std::lock_guard<std::mutex> lock(_resourceMutex);
         return _shaderHandler->LoadShader(desc);
     }
 
     ComputeShaderID RendererDX12::LoadShader(ComputeShaderDesc& desc)
     {
+        std::lock_guard<std::mutex> lock(_resourceMutex);
         return _shaderHandler->LoadShader(desc);
     }
 
@@ -128,6 +311,82 @@ namespace Renderer
         _commandListHandler->EndCommandList(_device, commandListID);
     }
 
+    // ID3D12GraphicsCommandList has no render passes, so load actions become clears and discards when the render pass begins and store actions discards when it ends.
+    // Pipelines still bind the render targets they were created with, binding the attachments here covers passes that only clear
+    void RendererDX12::BeginRenderPass(CommandListID commandListID, const RenderPassAttachment* attachments, u32 numAttachments)
+    {
+        ID3D12GraphicsCommandList* commandList = _commandListHandler->GetCommandList(commandListID);
+
+        D3D12_CPU_DESCRIPTOR_HANDLE rtvs[MAX_RENDER_TARGETS] = {};
+        D3D12_CPU_DESCRIPTOR_HANDLE dsv = {};
+        u32 numRenderTargets = 0;
+        bool hasDepth = false;
+
+        for (u32 i = 0; i < numAttachments; i++)
+        {
+            const RenderPassAttachment& attachment = attachments[i];
+
+            if (attachment.depthImage != DepthImageID::Invalid())
+            {
+                dsv = _imageHandler->GetDSV(attachment.depthImage);
+                hasDepth = true;
+
+                if (attachment.loadAction == RENDER_PASS_LOAD_ACTION_CLEAR)
+                {
+                    // The clear value the image was created with is its optimized clear value, clearing to anything else is slower
+                    const DepthImageDesc& desc = _imageHandler->GetDescriptor(attachment.depthImage);
+                    D3D12_CLEAR_FLAGS flags = HasStencil(desc.format) ? D3D12_CLEAR_FLAG_DEPTH | D3D12_CLEAR_FLAG_STENCIL : D3D12_CLEAR_FLAG_DEPTH;
+                    commandList->ClearDepthStencilView(dsv, flags, desc.depthClearValue, desc.stencilClearValue, 0, NULL);
+                }
+                else if (attachment.loadAction == RENDER_PASS_LOAD_ACTION_DISCARD)
+                {
+                    commandList->DiscardResource(_imageHandler->GetResource(attachment.depthImage), nullptr);
+                }
+            }
+            else
+            {
+                assert(numRenderTargets < static_cast<u32>(MAX_RENDER_TARGETS)); // RenderGraph never puts more than MAX_RENDER_TARGETS in one render pass
+                D3D12_CPU_DESCRIPTOR_HANDLE rtv = _imageHandler->GetRTV(attachment.image);
+                rtvs[numRenderTargets++] = rtv;
+
+                if (attachment.loadAction == RENDER_PASS_LOAD_ACTION_CLEAR)
+                {
+                    const ImageDesc& desc = _imageHandler->GetDescriptor(attachment.image);
+                    const float clearColor[] = { desc.clearColor.x, desc.clearColor.y, desc.clearColor.z, desc.clearColor.w };
+                    commandList->ClearRenderTargetView(rtv, clearColor, 0, NULL);
+                }
+                else if (attachment.loadAction == RENDER_PASS_LOAD_ACTION_DISCARD)
+                {
+                    commandList->DiscardResource(_imageHandler->GetResource(attachment.image), nullptr);
+                }
+            }
+        }
+
+        _commandListHandler->SetRenderTargets(commandListID, numRenderTargets, rtvs, hasDepth ? &dsv : nullptr);
+    }
+
+    void RendererDX12::EndRenderPass(CommandListID commandListID, const RenderPassAttachment* attachments, u32 numAttachments)
+    {
+        ID3D12GraphicsCommandList* commandList = _commandListHandler->GetCommandList(commandListID);
+
+        for (u32 i = 0; i < numAttachments; i++)
+        {
+            const RenderPassAttachment& attachment = attachments[i];
+            if (attachment.storeAction != RENDER_PASS_STORE_ACTION_DISCARD)
+                continue;
+
+            // Nothing reads it before it gets cleared, discarded or the graph ends, so the driver can drop it instead of resolving compression or writing it back
+            if (attachment.depthImage != DepthImageID::Invalid())
+            {
+                commandList->DiscardResource(_imageHandler->GetResource(attachment.depthImage), nullptr);
+            }
+            else
+            {
+                commandList->DiscardResource(_imageHandler->GetResource(attachment.image), nullptr);
+            }
+        }
+    }
+
     void RendererDX12::Clear(CommandListID commandListID, ImageID imageID, Vector4 color)
     {
         ID3D12GraphicsCommandList* commandList = _commandListHandler->GetCommandList(commandListID);
@@ -182,6 +441,29 @@ namespace Renderer
         commandList->DrawIndexedInstanced(numIndices, 1, 0, 0, 0);
     }
 
+    void RendererDX12::DrawInstanced(CommandListID commandListID, ModelID modelID, const InstanceRange& instances)
+    {
+        ID3D12GraphicsCommandList* commandList = _commandListHandler->GetCommandList(commandListID);
+
+        GraphicsPipelineID pipelineID = _commandListHandler->GetGraphicsPipeline(commandListID);
+        assert(pipelineID != GraphicsPipelineID::Invalid()); // Set a pipeline before drawing
+        assert(_pipelineHandler->GetDescriptor(pipelineID).states.instanceBufferState.enabled); // The bound pipeline has no instance buffer to read from
+
+        // SV_InstanceID doesn't include StartInstanceLocation, so the buffer gets bound at the first instance instead
+        ID3D12Resource* resource = static_cast<ID3D12Resource*>(instances.gpuResource);
+        D3D12_GPU_VIRTUAL_ADDRESS address = resource->GetGPUVirtualAddress() + static_cast<u64>(instances.first) * InstanceBuffer::STRIDE;
+        commandList->SetGraphicsRootShaderResourceView(_pipelineHandler->GetInstanceBufferRootIndex(pipelineID), address);
+
+        D3D12_VERTEX_BUFFER_VIEW* vertexBufferView = _modelHandler->GetVertexBufferView(modelID);
+        D3D12_INDEX_BUFFER_VIEW* indexBufferView = _modelHandler->GetIndexBufferView(modelID);
+        u32 numIndices = _modelHandler->GetNumIndices(modelID);
+
+        commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+        commandList->IASetVertexBuffers(0, 1, vertexBufferView);
+        commandList->IASetIndexBuffer(indexBufferView);
+        commandList->DrawIndexedInstanced(numIndices, instances.count, 0, 0, 0);
+    }
+
     void RendererDX12::PopMarker(CommandListID commandListID)
     {
         ID3D12GraphicsCommandList* commandList = _commandListHandler->GetCommandList(commandListID);
@@ -203,6 +485,48 @@ namespace Renderer
         PIXBeginEvent(commandList, PIX_COLOR(red, green, blue), name.c_str());
     }
 
+    void RendererDX12::ResourceBarriers(CommandListID commandListID, const ResourceBarrier* barriers, u32 numBarriers)
+    {
+        ID3D12GraphicsCommandList* commandList = _commandListHandler->GetCommandList(commandListID);
+
+        // Submit in chunks so a batch never needs a heap allocation
+        const u32 maxBarriersPerChunk = 32;
+        D3D12_RESOURCE_BARRIER d3dBarriers[maxBarriersPerChunk];
+        u32 numD3DBarriers = 0;
+
+        for (u32 i = 0; i < numBarriers; i++)
+        {
+            const ResourceBarrier& barrier = barriers[i];
+            ID3D12Resource* resource = barrier.image != ImageID::Invalid() ? _imageHandler->GetResource(barrier.image) : _imageHandler->GetResource(barrier.depthImage);
+
+            switch (barrier.type)
+            {
+            case RESOURCE_BARRIER_TYPE_TRANSITION:
+                d3dBarriers[numD3DBarriers++] = CD3DX12_RESOURCE_BARRIER::Transition(resource, ToResourceStates(barrier.before), ToResourceStates(barrier.after));
+                break;
+            case RESOURCE_BARRIER_TYPE_UAV:
+                d3dBarriers[numD3DBarriers++] = CD3DX12_RESOURCE_BARRIER::UAV(resource);
+                break;
+            case RESOURCE_BARRIER_TYPE_ALIASING:
+                d3dBarriers[numD3DBarriers++] = CD3DX12_RESOURCE_BARRIER::Aliasing(nullptr, resource); // Any resource that used the memory before
+                break;
+            default:
+                assert(false); // Invalid barrier type, did we add to the enum?
+            }
+
+            if (numD3DBarriers == maxBarriersPerChunk)
+            {
+                commandList->ResourceBarrier(numD3DBarriers, d3dBarriers);
+                numD3DBarriers = 0;
+            }
+        }
+
+        if (numD3DBarriers > 0)
+        {
+            commandList->ResourceBarrier(numD3DBarriers, d3dBarriers);
+        }
+    }
+
     void RendererDX12::SetConstantBuffer(CommandListID commandListID, u32 slot, void* gpuResource)
     {
         ID3D12GraphicsCommandList* commandList = _commandListHandler->GetCommandList(commandListID);
@@ -221,6 +545,7 @@ namespace Renderer
 
         commandList->SetPipelineState(pso);
         commandList->SetGraphicsRootSignature(rootSig);
+        _commandListHandler->SetGraphicsPipeline(commandListID, pipelineID);
 
         // Set textures
         //commandList->SetGraphicsRootShaderResourceView();
@@ -250,11 +575,11 @@ namespace Renderer
             DepthImageID imageID = desc.MutableResourceToDepthImageID(resource);
             D3D12_CPU_DESCRIPTOR_HANDLE dsv = _imageHandler->GetDSV(imageID);
 
-            commandList->OMSetRenderTargets(boundRenderTargets, rtvs, false, &dsv);
+            _commandListHandler->SetRenderTargets(commandListID, boundRenderTargets, rtvs, &dsv);
         }
         else
         {
-            commandList->OMSetRenderTargets(boundRenderTargets, rtvs, false, nullptr);
+            _commandListHandler->SetRenderTargets(commandListID, boundRenderTargets, rtvs, nullptr);
         }
     }
 
@@ -361,7 +686,7 @@ namespace Renderer
 
         // Set rendertarget
         D3D12_CPU_DESCRIPTOR_HANDLE rtv = swapChain->rtvs[frameIndex];
-        commandList->OMSetRenderTargets(1, &rtv, false, nullptr);
+        _commandListHandler->SetRenderTargets(commandListID, 1, &rtv, nullptr);
 
         // Set viewport and scissor rect
         D3D12_VIEWPORT viewport = {};
@@ -436,7 +761,7 @@ namespace Renderer
 
         // Set rendertarget
         D3D12_CPU_DESCRIPTOR_HANDLE rtv = swapChain->rtvs[frameIndex];
-        commandList->OMSetRenderTargets(1, &rtv, false, nullptr);
+        _commandListHandler->SetRenderTargets(commandListID, 1, &rtv, nullptr);
 
         // Set viewport and scissor rect
         D3D12_VIEWPORT viewport = {};
@@ -480,6 +805,81 @@ namespace Renderer
 
     Backend::ConstantBufferBackend* RendererDX12::CreateConstantBufferBackend(size_t size)
     {
+        std::lock_guard<std::mutex> lock(_resourceMutex);
         return _device->CreateConstantBufferBackend(size);
     }
+
+    AsyncLoadData* RendererDX12::ReadTextureAsync(const TextureDesc& desc)
+    {
+        TextureLoadDataDX12* data = new TextureLoadDataDX12();
+        _imageHandler->ReadTexture(desc, data->textureData);
+        return data;
+    }
+
+    TextureID RendererDX12::FinalizeTextureAsync(TextureDesc& desc, AsyncLoadData* data)
+    {
+        std::lock_guard<std::mutex> lock(_resourceMutex);
+        return _imageHandler->CreateTexture(_device, _commandListHandler, desc, static_cast<TextureLoadDataDX12*>(data)->textureData);
+    }
+
+    AsyncLoadData* RendererDX12::ReadModelAsync(const ModelDesc& desc)
+    {
+        ModelLoadDataDX12* data = new ModelLoadDataDX12();
+        _modelHandler->LoadFromFile(desc, data->modelData);
+        return data;
+    }
+
+    ModelID RendererDX12::FinalizeModelAsync(ModelDesc& desc, AsyncLoadData* data)
+    {
+        std::lock_guard<std::mutex> lock(_resourceMutex);
+        return _modelHandler->CreateModel(_device, _commandListHandler, desc, static_cast<ModelLoadDataDX12*>(data)->modelData);
+    }
+
+    AsyncLoadData* RendererDX12::ReadShaderAsync(const VertexShaderDesc& desc)
+    {
+        ShaderLoadDataDX12* data = new ShaderLoadDataDX12();
+        data->bytecode = _shaderHandler->ReadFile(desc.path);
+        return data;
+    }
+
+    VertexShaderID RendererDX12::FinalizeShaderAsync(VertexShaderDesc& desc, AsyncLoadData* data)
+    {
+        std::lock_guard<std::mutex> lock(_resourceMutex);
+        ShaderLoadDataDX12* shaderData = static_cast<ShaderLoadDataDX12*>(data);
+        ID3DBlob* bytecode = shaderData->bytecode;
+        shaderData->bytecode = nullptr;
+        return _shaderHandler->LoadShader(desc, bytecode);
+    }
+
+    AsyncLoadData* RendererDX12::ReadShaderAsync(const PixelShaderDesc& desc)
+    {
+        ShaderLoadDataDX12* data = new ShaderLoadDataDX12();
+        data->bytecode = _shaderHandler->ReadFile(desc.path);
+        return data;
+    }
+
+    PixelShaderID RendererDX12::FinalizeShaderAsync(PixelShaderDesc& desc, AsyncLoadData* data)
+    {
+        std::lock_guard<std::mutex> lock(_resourceMutex);
+        ShaderLoadDataDX12* shaderData = static_cast<ShaderLoadDataDX12*>(data);
+        ID3DBlob* bytecode = shaderData->bytecode;
+        shaderData->bytecode = nullptr;
+        return _shaderHandler->LoadShader(desc, bytecode);
+    }
+
+    AsyncLoadData* RendererDX12::ReadShaderAsync(const ComputeShaderDesc& desc)
+    {
+        ShaderLoadDataDX12* data = new ShaderLoadDataDX12();
+        data->bytecode = _shaderHandler->ReadFile(desc.path);
+        return data;
+    }
+
+    ComputeShaderID RendererDX12::FinalizeShaderAsync(ComputeShaderDesc& desc, AsyncLoadData* data)
+    {
+        std::lock_guard<std::mutex> lock(_resourceMutex);
+        ShaderLoadDataDX12* shaderData = static_cast<ShaderLoadDataDX12*>(data);
+        ID3DBlob* bytecode = shaderData->bytecode;
+        shaderData->bytecode = nullptr;
+        return _shaderHandler->LoadShader(desc, bytecode);
+    }
 }
\ No newline at end of file
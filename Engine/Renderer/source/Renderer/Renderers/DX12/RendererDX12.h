@@ -1,5 +1,6 @@
 #pragma once
 #include "../../Renderer.h"
+#include <mutex>
 
 namespace Renderer
 {
@@ -26,6 +27,28 @@ namespace Renderer
         ImageID CreateImage(ImageDesc& desc) override;
         DepthImageID CreateDepthImage(DepthImageDesc& desc) override;
 
+        // Transient memory
+        void GetMemoryRequirements(const ImageDesc& desc, size_t& size, size_t& alignment) override;
+        void GetMemoryRequirements(const DepthImageDesc& desc, size_t& size, size_t& alignment) override;
+        TransientHeapID CreateTransientHeap(TransientHeapDesc& desc) override;
+        void DestroyTransientHeap(TransientHeapID heap) override;
+        ImageID CreatePlacedImage(ImageDesc& desc, TransientHeapID heap, size_t offset) override;
+        DepthImageID CreatePlacedImage(DepthImageDesc& desc, TransientHeapID heap, size_t offset) override;
+
+        const ImageDesc& GetDescriptor(ImageID image) override;
+        const DepthImageDesc& GetDescriptor(DepthImageID image) override;
+
+        const GraphicsPipelineDesc& GetDescriptor(GraphicsPipelineID pipeline) override;
+        const MaterialPipelineDesc& GetDescriptor(MaterialPipelineID pipeline) override;
+        const ComputePipelineDesc& GetDescriptor(ComputePipelineID pipeline) override;
+        const MaterialDesc& GetDescriptor(MaterialID material) override;
+        const ModelDesc& GetDescriptor(ModelID model) override;
+        const PrimitivePlaneDesc& GetPrimitiveDescriptor(ModelID model) override;
+
+        VertexShaderDesc GetDescriptor(VertexShaderID shader) override;
+        PixelShaderDesc GetDescriptor(PixelShaderID shader) override;
+        ComputeShaderDesc GetDescriptor(ComputeShaderID shader) override;
+
         GraphicsPipelineID CreatePipeline(GraphicsPipelineDesc& desc) override;
         MaterialPipelineID CreatePipeline(MaterialPipelineDesc& desc) override;
         ComputePipelineID CreatePipeline(ComputePipelineDesc& desc) override;
@@ -44,11 +67,15 @@ namespace Renderer
         // Command List Functions
         CommandListID BeginCommandList() override;
         void EndCommandList(CommandListID commandListID) override;
+        void BeginRenderPass(CommandListID commandListID, const RenderPassAttachment* attachments, u32 numAttachments) override;
+        void EndRenderPass(CommandListID commandListID, const RenderPassAttachment* attachments, u32 numAttachments) override;
         void Clear(CommandListID commandListID, ImageID image, Vector4 color) override;
         void Clear(CommandListID commandListID, DepthImageID image, DepthClearFlags clearFlags, f32 depth, u8 stencil) override;
         void Draw(CommandListID commandListID, ModelID model) override;
+        void DrawInstanced(CommandListID commandListID, ModelID model, const InstanceRange& instances) override;
         void PopMarker(CommandListID commandListID) override;
         void PushMarker(CommandListID commandListID, Vector3 color, std::string name) override;
+        void ResourceBarriers(CommandListID commandListID, const ResourceBarrier* barriers, u32 numBarriers) override;
         void SetConstantBuffer(CommandListID commandListID, u32 slot, void* gpuResource) override;
         void SetPipeline(CommandListID commandListID, GraphicsPipelineID pipeline) override;
         void SetPipeline(CommandListID commandList, MaterialPipelineID pipeline) override;
@@ -63,6 +90,19 @@ namespace Renderer
     protected:
         Backend::ConstantBufferBackend* CreateConstantBufferBackend(size_t size) override;
 
+        // Async loading, materials use the default of loading everything when finalizing
+        AsyncLoadData* ReadTextureAsync(const TextureDesc& desc) override;
+        TextureID FinalizeTextureAsync(TextureDesc& desc, AsyncLoadData* data) override;
+        AsyncLoadData* ReadModelAsync(const ModelDesc& desc) override;
+        ModelID FinalizeModelAsync(ModelDesc& desc, AsyncLoadData* data) override;
+
+        AsyncLoadData* ReadShaderAsync(const VertexShaderDesc& desc) override;
+        VertexShaderID FinalizeShaderAsync(VertexShaderDesc& desc, AsyncLoadData* data) override;
+        AsyncLoadData* ReadShaderAsync(const PixelShaderDesc& desc) override;
+        PixelShaderID FinalizeShaderAsync(PixelShaderDesc& desc, AsyncLoadData* data) override;
+        AsyncLoadData* ReadShaderAsync(const ComputeShaderDesc& desc) override;
+        ComputeShaderID FinalizeShaderAsync(ComputeShaderDesc& desc, AsyncLoadData* data) override;
+
     private:
         Backend::RenderDeviceDX12* _device = nullptr;
         Backend::ImageHandlerDX12* _imageHandler = nullptr;
@@ -71,5 +111,7 @@ namespace Renderer
         Backend::MaterialHandlerDX12* _materialHandler = nullptr;
         Backend::PipelineHandlerDX12* _pipelineHandler = nullptr;
         Backend::CommandListHandlerDX12* _commandListHandler = nullptr;
+
+        std::mutex _resourceMutex; // Creating and loading can be called from RenderPass execute lambdas running on several threads at once
     };
 }
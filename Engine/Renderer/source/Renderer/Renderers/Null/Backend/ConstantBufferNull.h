@@ -0,0 +1,50 @@
+#pragma once
+#include <Core.h>
+#include <vector>
+#include "../../../ConstantBuffer.h"
+
+namespace Renderer
+{
+    namespace Backend
+    {
+        // What GetGPUResource hands out for the null renderer, knowing the size lets commands that read from it check their ranges
+        struct BufferNull
+        {
+            std::vector<u8> data;
+        };
+
+        struct ConstantBufferBackendNull : public ConstantBufferBackend
+        {
+            ConstantBufferBackendNull(size_t size)
+            {
+                for (u32 i = 0; i < FRAME_BUFFER_COUNT; i++)
+                {
+                    buffers[i].data.resize(size);
+                }
+            }
+
+            static const u32 FRAME_BUFFER_COUNT = 3; // Same as ConstantBufferBackendDX12
+
+            BufferNull buffers[FRAME_BUFFER_COUNT];
+
+        private:
+            void Apply(u32 frameIndex, void* data, size_t size) override
+            {
+                Write(frameIndex, 0, data, size);
+            }
+
+            void Write(u32 frameIndex, size_t offset, const void* data, size_t size) override
+            {
+                assert(frameIndex < FRAME_BUFFER_COUNT); // Frame index out of range
+                assert(offset + size <= buffers[frameIndex].data.size()); // Writing past the end of the buffer
+                memcpy(buffers[frameIndex].data.data() + offset, data, size);
+            }
+
+            void* GetGPUResource(u32 frameIndex) override
+            {
+                assert(frameIndex < FRAME_BUFFER_COUNT); // Frame index out of range
+                return static_cast<void*>(&buffers[frameIndex]);
+            }
+        };
+    }
+}
\ No newline at end of file
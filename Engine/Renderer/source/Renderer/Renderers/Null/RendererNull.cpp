@@ -0,0 +1,810 @@
+#include "RendererNull.h"
+#include "Backend/ConstantBufferNull.h"
+#include <Logging/Logger.h>
+#include <Utils/XXHash64.h>
+
+namespace Renderer
+{
+    namespace
+    {
+        // What a render target or depth image of the size would need in a D3D12 heap, so RenderGraph aliases the same way it would on a GPU
+        const size_t RESOURCE_ALIGNMENT = 64 * 1024;
+        const size_t MSAA_RESOURCE_ALIGNMENT = 4 * 1024 * 1024;
+
+        u32 BytesPerPixel(ImageFormat format)
+        {
+            // The formats are ordered from largest to smallest texel
+            if (format == IMAGE_FORMAT_UNKNOWN)
+                return 0;
+            if (format <= IMAGE_FORMAT_R32G32B32A32_SINT)
+                return 16;
+            if (format <= IMAGE_FORMAT_R32G32B32_SINT)
+                return 12;
+            if (format <= IMAGE_FORMAT_R32G32_SINT)
+                return 8;
+            if (format <= IMAGE_FORMAT_R24G8_TYPELESS)
+                return 4;
+            if (format <= IMAGE_FORMAT_R16_SINT)
+                return 2;
+
+            return 1;
+        }
+
+        u32 BytesPerPixel(DepthImageFormat format)
+        {
+            switch (format)
+            {
+            case DepthImageFormat::DEPTH_IMAGE_FORMAT_UNKNOWN:
+                return 0;
+            case DepthImageFormat::DEPTH_IMAGE_FORMAT_R32G8X24_TYPELESS:
+            case DepthImageFormat::DEPTH_IMAGE_FORMAT_D32_FLOAT_S8X24_UINT:
+            case DepthImageFormat::DEPTH_IMAGE_FORMAT_R32_FLOAT_X8X24_TYPELESS:
+            case DepthImageFormat::DEPTH_IMAGE_FORMAT_X32_TYPELESS_G8X24_UINT:
+                return 8;
+            case DepthImageFormat::DEPTH_IMAGE_FORMAT_R16_TYPELESS:
+            case DepthImageFormat::DEPTH_IMAGE_FORMAT_D16_UNORM:
+            case DepthImageFormat::DEPTH_IMAGE_FORMAT_R16_UNORM:
+                return 2;
+            default:
+                return 4;
+            }
+        }
+
+        void CalculateMemoryRequirements(Vector2i dimensions, u32 depth, u32 bytesPerPixel, SampleCount sampleCount, size_t& size, size_t& alignment)
+        {
+            alignment = sampleCount == SAMPLE_COUNT_1 ? RESOURCE_ALIGNMENT : MSAA_RESOURCE_ALIGNMENT;
+
+            size_t bytes = static_cast<size_t>(dimensions.x) * static_cast<size_t>(dimensions.y) * depth * bytesPerPixel * SampleCountToInt(sampleCount);
+            size = (bytes + alignment - 1) / alignment * alignment;
+        }
+
+        // Everything a GraphicsPipelineDesc needs to match to give back the same pipeline, like PipelineHandlerDX12 does
+        struct GraphicsPipelineCacheDesc
+        {
+            GraphicsPipelineDesc::States states;
+            RasterizerState rasterizerState;
+            DepthStencilState depthStencilState;
+            ImageID renderTargets[MAX_RENDER_TARGETS];
+            DepthImageID depthStencil = DepthImageID::Invalid();
+            MaterialID material = MaterialID::Invalid();
+        };
+
+        template <typename Desc>
+        u64 CalculateCacheDescHash(const Desc& desc, GraphicsPipelineCacheDesc& cacheDesc)
+        {
+            assert(desc.MutableResourceToImageID != nullptr); // You need to bind this function pointer before creating pipeline, maybe use RenderGraph::InitializePipelineDesc?
+            assert(desc.MutableResourceToDepthImageID != nullptr); // You need to bind this function pointer before creating pipeline, maybe use RenderGraph::InitializePipelineDesc?
+
+            std::fill_n(cacheDesc.renderTargets, MAX_RENDER_TARGETS, ImageID::Invalid());
+            for (int i = 0; i < MAX_RENDER_TARGETS; i++)
+            {
+                if (desc.renderTargets[i] == RenderPassMutableResource::Invalid())
+                    break;
+
+                cacheDesc.renderTargets[i] = desc.MutableResourceToImageID(desc.renderTargets[i]);
+            }
+
+            if (desc.depthStencil != RenderPassMutableResource::Invalid())
+            {
+                cacheDesc.depthStencil = desc.MutableResourceToDepthImageID(desc.depthStencil);
+            }
+
+            return XXHash64::hash(&cacheDesc, sizeof(cacheDesc), 0);
+        }
+    }
+
+    RendererNull::RendererNull()
+    {
+
+    }
+
+    void RendererNull::InitWindow(Window* /*window*/)
+    {
+        // There's no swap chain, Present only checks what it's given
+    }
+
+    void RendererNull::Deinit()
+    {
+        DiscardAsyncLoads();
+        DestroyTransientResources();
+
+        for (u32 i = 0; i < _numCommandLists; i++)
+        {
+            if (_commandLists[i].isRecording)
+            {
+                LOG_ERROR(LOG_CATEGORY_RENDERER, "RendererNull: Command list %u is still recording at Deinit", i);
+                _stats.numValidationErrors++;
+            }
+        }
+    }
+
+    ImageID RendererNull::CreateImage(ImageDesc& desc)
+    {
+        std::lock_guard<std::mutex> lock(_resourceMutex);
+
+        size_t nextHandle = _images.size();
+        assert(nextHandle < ImageID::MaxValue()); // If this hits you need to change type of ImageID to something bigger
+        using type = type_safe::underlying_type<ImageID>;
+
+        Image image;
+        image.desc = desc;
+        _images.push_back(image);
+
+        return ImageID(static_cast<type>(nextHandle));
+    }
+
+    DepthImageID RendererNull::CreateDepthImage(DepthImageDesc& desc)
+    {
+        std::lock_guard<std::mutex> lock(_resourceMutex);
+
+        size_t nextHandle = _depthImages.size();
+        assert(nextHandle < DepthImageID::MaxValue()); // If this hits you need to change type of DepthImageID to something bigger
+        using type = type_safe::underlying_type<DepthImageID>;
+
+        DepthImage image;
+        image.desc = desc;
+        _depthImages.push_back(image);
+
+        return DepthImageID(static_cast<type>(nextHandle));
+    }
+
+    void RendererNull::GetMemoryRequirements(const ImageDesc& desc, size_t& size, size_t& alignment)
+    {
+        CalculateMemoryRequirements(desc.dimensions, desc.depth, BytesPerPixel(desc.format), desc.sampleCount, size, alignment);
+    }
+
+    void RendererNull::GetMemoryRequirements(const DepthImageDesc& desc, size_t& size, size_t& alignment)
+    {
+        CalculateMemoryRequirements(desc.dimensions, 1, BytesPerPixel(desc.format), desc.sampleCount, size, alignment);
+    }
+
+    TransientHeapID RendererNull::CreateTransientHeap(TransientHeapDesc& desc)
+    {
+        std::lock_guard<std::mutex> lock(_resourceMutex);
+
+        size_t nextHandle = _heaps.size();
+        assert(nextHandle < TransientHeapID::MaxValue()); // If this hits you need to change type of TransientHeapID to something bigger
+        using type = type_safe::underlying_type<TransientHeapID>;
+
+        TransientHeap heap;
+        heap.desc = desc;
+        _heaps.push_back(heap);
+
+        return TransientHeapID(static_cast<type>(nextHandle));
+    }
+
+    void RendererNull::DestroyTransientHeap(TransientHeapID heapID)
+    {
+        std::lock_guard<std::mutex> lock(_resourceMutex);
+
+        using type = type_safe::underlying_type<TransientHeapID>;
+        assert(static_cast<type>(heapID) < _heaps.size()); // Destroying a heap that was never created
+        _heaps[static_cast<type>(heapID)].destroyed = true;
+
+        // Like on the GPU the images placed in it go with it, their IDs stay invalid
+        for (Image& image : _images)
+        {
+            if (image.heap == heapID)
+            {
+                image.destroyed = true;
+            }
+        }
+
+        for (DepthImage& image : _depthImages)
+        {
+            if (image.heap == heapID)
+            {
+                image.destroyed = true;
+            }
+        }
+    }
+
+    ImageID RendererNull::CreatePlacedImage(ImageDesc& desc, TransientHeapID heap, size_t offset)
+    {
+        size_t size, alignment;
+        GetMemoryRequirements(desc, size, alignment);
+
+        ImageID imageID = CreateImage(desc);
+
+        std::lock_guard<std::mutex> lock(_resourceMutex);
+        using heapType = type_safe::underlying_type<TransientHeapID>;
+        assert(static_cast<heapType>(heap) < _heaps.size() && !_heaps[static_cast<heapType>(heap)].destroyed); // Placing an image in a heap that doesn't exist
+        assert(offset % alignment == 0 && offset + size <= _heaps[static_cast<heapType>(heap)].desc.size); // The image doesn't fit where it's being placed
+
+        using type = type_safe::underlying_type<ImageID>;
+        _images[static_cast<type>(imageID)].heap = heap;
+
+        return imageID;
+    }
+
+    DepthImageID RendererNull::CreatePlacedImage(DepthImageDesc& desc, TransientHeapID heap, size_t offset)
+    {
+        size_t size, alignment;
+        GetMemoryRequirements(desc, size, alignment);
+
+        DepthImageID imageID = CreateDepthImage(desc);
+
+        std::lock_guard<std::mutex> lock(_resourceMutex);
+        using heapType = type_safe::underlying_type<TransientHeapID>;
+        assert(static_cast<heapType>(heap) < _heaps.size() && !_heaps[static_cast<heapType>(heap)].destroyed); // Placing an image in a heap that doesn't exist
+        assert(offset % alignment == 0 && offset + size <= _heaps[static_cast<heapType>(heap)].desc.size); // The image doesn't fit where it's being placed
+
+        using type = type_safe::underlying_type<DepthImageID>;
+        _depthImages[static_cast<type>(imageID)].heap = heap;
+
+        return imageID;
+    }
+
+    const ImageDesc& RendererNull::GetDescriptor(ImageID image)
+    {
+        std::lock_guard<std::mutex> lock(_resourceMutex);
+        using type = type_safe::underlying_type<ImageID>;
+        assert(static_cast<type>(image) < _images.size()); // Invalid ImageID
+        return _images[static_cast<type>(image)].desc;
+    }
+
+    const DepthImageDesc& RendererNull::GetDescriptor(DepthImageID image)
+    {
+        std::lock_guard<std::mutex> lock(_resourceMutex);
+        using type = type_safe::underlying_type<DepthImageID>;
+        assert(static_cast<type>(image) < _depthImages.size()); // Invalid DepthImageID
+        return _depthImages[static_cast<type>(image)].desc;
+    }
+
+    const GraphicsPipelineDesc& RendererNull::GetDescriptor(GraphicsPipelineID pipeline)
+    {
+        std::lock_guard<std::mutex> lock(_resourceMutex);
+        using type = type_safe::underlying_type<GraphicsPipelineID>;
+        assert(static_cast<type>(pipeline) < _graphicsPipelines.size()); // Invalid GraphicsPipelineID
+        return _graphicsPipelines[static_cast<type>(pipeline)].desc;
+    }
+
+    const MaterialPipelineDesc& RendererNull::GetDescriptor(MaterialPipelineID pipeline)
+    {
+        std::lock_guard<std::mutex> lock(_resourceMutex);
+        using type = type_safe::underlying_type<MaterialPipelineID>;
+        assert(static_cast<type>(pipeline) < _graphicsPipelines.size()); // Invalid MaterialPipelineID
+        return _graphicsPipelines[static_cast<type>(pipeline)].materialDesc;
+    }
+
+    const ComputePipelineDesc& RendererNull::GetDescriptor(ComputePipelineID pipeline)
+    {
+        std::lock_guard<std::mutex> lock(_resourceMutex);
+        using type = type_safe::underlying_type<ComputePipelineID>;
+        assert(static_cast<type>(pipeline) < _computePipelines.size()); // Invalid ComputePipelineID
+        return _computePipelines[static_cast<type>(pipeline)].desc;
+    }
+
+    const MaterialDesc& RendererNull::GetDescriptor(MaterialID material)
+    {
+        std::lock_guard<std::mutex> lock(_resourceMutex);
+        using type = type_safe::underlying_type<MaterialID>;
+        assert(static_cast<type>(material) < _materials.size()); // Invalid MaterialID
+        return _materials[static_cast<type>(material)];
+    }
+
+    const ModelDesc& RendererNull::GetDescriptor(ModelID model)
+    {
+        std::lock_guard<std::mutex> lock(_resourceMutex);
+        using type = type_safe::underlying_type<ModelID>;
+        assert(static_cast<type>(model) < _models.size()); // Invalid ModelID
+        return _models[static_cast<type>(model)].desc;
+    }
+
+    const PrimitivePlaneDesc& RendererNull::GetPrimitiveDescriptor(ModelID model)
+    {
+        std::lock_guard<std::mutex> lock(_resourceMutex);
+        using type = type_safe::underlying_type<ModelID>;
+        assert(static_cast<type>(model) < _models.size()); // Invalid ModelID
+        return _models[static_cast<type>(model)].primitiveDesc;
+    }
+
+    VertexShaderDesc RendererNull::GetDescriptor(VertexShaderID shader)
+    {
+        std::lock_guard<std::mutex> lock(_resourceMutex);
+        using type = type_safe::underlying_type<VertexShaderID>;
+        assert(static_cast<type>(shader) < _vertexShaders.size()); // Invalid VertexShaderID
+        VertexShaderDesc desc;
+        desc.path = _vertexShaders[static_cast<type>(shader)].path;
+        return desc;
+    }
+
+    PixelShaderDesc RendererNull::GetDescriptor(PixelShaderID shader)
+    {
+        std::lock_guard<std::mutex> lock(_resourceMutex);
+        using type = type_safe::underlying_type<PixelShaderID>;
+        assert(static_cast<type>(shader) < _pixelShaders.size()); // Invalid PixelShaderID
+        PixelShaderDesc desc;
+        desc.path = _pixelShaders[static_cast<type>(shader)].path;
+        return desc;
+    }
+
+    ComputeShaderDesc RendererNull::GetDescriptor(ComputeShaderID shader)
+    {
+        std::lock_guard<std::mutex> lock(_resourceMutex);
+        using type = type_safe::underlying_type<ComputeShaderID>;
+        assert(static_cast<type>(shader) < _computeShaders.size()); // Invalid ComputeShaderID
+        ComputeShaderDesc desc;
+        desc.path = _computeShaders[static_cast<type>(shader)].path;
+        return desc;
+    }
+
+    GraphicsPipelineID RendererNull::CreatePipeline(GraphicsPipelineDesc& desc)
+    {
+        GraphicsPipelineCacheDesc cacheDesc;
+        cacheDesc.states = desc.states;
+        u64 cacheDescHash = CalculateCacheDescHash(desc, cacheDesc);
+
+        std::lock_guard<std::mutex> lock(_resourceMutex);
+        using type = type_safe::underlying_type<GraphicsPipelineID>;
+
+        for (size_t i = 0; i < _graphicsPipelines.size(); i++)
+        {
+            if (_graphicsPipelines[i].cacheDescHash == cacheDescHash)
+                return GraphicsPipelineID(static_cast<type>(i));
+        }
+
+        size_t nextHandle = _graphicsPipelines.size();
+        assert(nextHandle < GraphicsPipelineID::MaxValue()); // If this hits you need to change type of GraphicsPipelineID to something bigger
+
+        GraphicsPipeline pipeline;
+        pipeline.desc = desc;
+        pipeline.cacheDescHash = cacheDescHash;
+        _graphicsPipelines.push_back(pipeline);
+
+        return GraphicsPipelineID(static_cast<type>(nextHandle));
+    }
+
+    MaterialPipelineID RendererNull::CreatePipeline(MaterialPipelineDesc& desc)
+    {
+        // Material pipelines share IDs with graphics pipelines like they do in PipelineHandlerDX12, the material fills in everything but these
+        GraphicsPipelineCacheDesc cacheDesc;
+        cacheDesc.material = desc.material;
+        cacheDesc.rasterizerState = desc.states.rasterizerState;
+        cacheDesc.depthStencilState = desc.states.depthStencilState;
+        u64 cacheDescHash = CalculateCacheDescHash(desc, cacheDesc);
+
+        std::lock_guard<std::mutex> lock(_resourceMutex);
+        using type = type_safe::underlying_type<MaterialPipelineID>;
+
+        using materialType = type_safe::underlying_type<MaterialID>;
+        assert(static_cast<materialType>(desc.material) < _materials.size()); // Creating a pipeline for a material that was never loaded
+
+        for (size_t i = 0; i < _graphicsPipelines.size(); i++)
+        {
+            if (_graphicsPipelines[i].cacheDescHash == cacheDescHash)
+                return MaterialPipelineID(static_cast<type>(i));
+        }
+
+        size_t nextHandle = _graphicsPipelines.size();
+        assert(nextHandle < MaterialPipelineID::MaxValue()); // If this hits you need to change type of MaterialPipelineID to something bigger
+
+        GraphicsPipeline pipeline;
+        pipeline.desc.states.rasterizerState = desc.states.rasterizerState;
+        pipeline.desc.states.depthStencilState = desc.states.depthStencilState;
+        pipeline.material = desc.material;
+        pipeline.materialDesc = desc;
+        pipeline.cacheDescHash = cacheDescHash;
+        _graphicsPipelines.push_back(pipeline);
+
+        return MaterialPipelineID(static_cast<type>(nextHandle));
+    }
+
+    ComputePipelineID RendererNull::CreatePipeline(ComputePipelineDesc& desc)
+    {
+        u64 cacheDescHash = XXHash64::hash(&desc, sizeof(desc), 0);
+
+        std::lock_guard<std::mutex> lock(_resourceMutex);
+        using type = type_safe::underlying_type<ComputePipelineID>;
+
+        for (size_t i = 0; i < _computePipelines.size(); i++)
+        {
+            if (_computePipelines[i].cacheDescHash == cacheDescHash)
+                return ComputePipelineID(static_cast<type>(i));
+        }
+
+        size_t nextHandle = _computePipelines.size();
+        assert(nextHandle < ComputePipelineID::MaxValue()); // If this hits you need to change type of ComputePipelineID to something bigger
+
+        ComputePipeline pipeline;
+        pipeline.desc = desc;
+        pipeline.cacheDescHash = cacheDescHash;
+        _computePipelines.push_back(pipeline);
+
+        return ComputePipelineID(static_cast<type>(nextHandle));
+    }
+
+    ModelID RendererNull::CreatePrimitiveModel(PrimitivePlaneDesc& desc)
+    {
+        std::lock_guard<std::mutex> lock(_resourceMutex);
+        size_t nextHandle = _models.size();
+        assert(nextHandle < ModelID::MaxValue()); // If this hits you need to change type of ModelID to something bigger
+        using type = type_safe::underlying_type<ModelID>;
+
+        Model model;
+        model.primitiveDesc = desc;
+        _models.push_back(model);
+
+        return ModelID(static_cast<type>(nextHandle));
+    }
+
+    TextureID RendererNull::LoadTexture(TextureDesc& /*desc*/)
+    {
+        std::lock_guard<std::mutex> lock(_resourceMutex);
+        assert(_numTextures < TextureID::MaxValue()); // If this hits you need to change type of TextureID to something bigger
+        using type = type_safe::underlying_type<TextureID>;
+        return TextureID(static_cast<type>(_numTextures++));
+    }
+
+    ModelID RendererNull::LoadModel(ModelDesc& desc)
+    {
+        std::lock_guard<std::mutex> lock(_resourceMutex);
+        size_t nextHandle = _models.size();
+        assert(nextHandle < ModelID::MaxValue()); // If this hits you need to change type of ModelID to something bigger
+        using type = type_safe::underlying_type<ModelID>;
+
+        Model model;
+        model.desc = desc;
+        _models.push_back(model);
+
+        return ModelID(static_cast<type>(nextHandle));
+    }
+
+    MaterialID RendererNull::LoadMaterial(MaterialDesc& desc)
+    {
+        std::lock_guard<std::mutex> lock(_resourceMutex);
+        size_t nextHandle = _materials.size();
+        assert(nextHandle < MaterialID::MaxValue()); // If this hits you need to change type of MaterialID to something bigger
+        using type = type_safe::underlying_type<MaterialID>;
+
+        _materials.push_back(desc);
+
+        return MaterialID(static_cast<type>(nextHandle));
+    }
+
+    template <typename ID>
+    ID RendererNull::LoadShader(const std::string& path, std::vector<Shader>& shaders)
+    {
+        using type = type_safe::underlying_type<ID>;
+        StringID pathID(path);
+
+        std::lock_guard<std::mutex> lock(_resourceMutex);
+        for (size_t i = 0; i < shaders.size(); i++)
+        {
+            if (shaders[i].pathID == pathID)
+                return ID(static_cast<type>(i));
+        }
+
+        size_t nextHandle = shaders.size();
+        assert(nextHandle < ID::MaxValue()); // If this hits you need to change the type of the shader ID to something bigger
+
+        Shader shader;
+        shader.pathID = pathID;
+        shader.path = path;
+        shaders.push_back(shader);
+
+        return ID(static_cast<type>(nextHandle));
+    }
+
+    VertexShaderID RendererNull::LoadShader(VertexShaderDesc& desc)
+    {
+        return LoadShader<VertexShaderID>(desc.path, _vertexShaders);
+    }
+
+    PixelShaderID RendererNull::LoadShader(PixelShaderDesc& desc)
+    {
+        return LoadShader<PixelShaderID>(desc.path, _pixelShaders);
+    }
+
+    ComputeShaderID RendererNull::LoadShader(ComputeShaderDesc& desc)
+    {
+        return LoadShader<ComputeShaderID>(desc.path, _computeShaders);
+    }
+
+    CommandListID RendererNull::BeginCommandList()
+    {
+        std::lock_guard<std::mutex> lock(_commandListMutex);
+        using type = type_safe::underlying_type<CommandListID>;
+
+        CommandListID id;
+        if (_availableCommandLists.size() > 0)
+        {
+            id = _availableCommandLists.front();
+            _availableCommandLists.pop();
+        }
+        else
+        {
+            assert(_numCommandLists < MAX_COMMAND_LISTS); // More command lists recording at once than CommandListID can tell apart
+            id = CommandListID(static_cast<type>(_numCommandLists++));
+        }
+
+        CommandList& commandList = _commandLists[static_cast<type>(id)];
+        commandList = CommandList();
+        commandList.isRecording = true;
+
+        return id;
+    }
+
+    void RendererNull::EndCommandList(CommandListID commandListID)
+    {
+        using type = type_safe::underlying_type<CommandListID>;
+        assert(static_cast<type>(commandListID) < _numCommandLists); // Ending a command list that was never begun
+        CommandList& commandList = _commandLists[static_cast<type>(commandListID)];
+
+        Validate(commandList, commandList.isRecording, "Ending a command list that isn't recording");
+        Validate(commandList, commandList.markerDepth == 0, "Command list ended with markers that were never popped");
+        Validate(commandList, !commandList.inRenderPass, "Command list ended inside a render pass");
+        commandList.isRecording = false;
+
+        std::lock_guard<std::mutex> lock(_commandListMutex);
+        for (u32 i = 0; i < COMMAND_TYPE_COUNT; i++)
+        {
+            _stats.numCommands[i] += commandList.stats.numCommands[i];
+        }
+        _stats.numCommandLists++;
+        _stats.numValidationErrors += commandList.stats.numValidationErrors;
+
+        _availableCommandLists.push(commandListID);
+    }
+
+    void RendererNull::BeginRenderPass(CommandListID commandListID, const RenderPassAttachment* attachments, u32 numAttachments)
+    {
+        CommandList& commandList = GetCommandList(commandListID, COMMAND_TYPE_BEGIN_RENDER_PASS);
+
+        Validate(commandList, !commandList.inRenderPass, "Render pass begun inside another render pass");
+        commandList.inRenderPass = true;
+
+        u32 numRenderTargets = 0;
+        for (u32 i = 0; i < numAttachments; i++)
+        {
+            Validate(commandList, IsValid(attachments[i]), "Render pass attachment is not a valid image");
+
+            if (attachments[i].depthImage == DepthImageID::Invalid())
+            {
+                numRenderTargets++;
+            }
+        }
+        Validate(commandList, numRenderTargets <= static_cast<u32>(MAX_RENDER_TARGETS), "Render pass has more than MAX_RENDER_TARGETS render targets");
+    }
+
+    void RendererNull::EndRenderPass(CommandListID commandListID, const RenderPassAttachment* attachments, u32 numAttachments)
+    {
+        CommandList& commandList = GetCommandList(commandListID, COMMAND_TYPE_END_RENDER_PASS);
+
+        Validate(commandList, commandList.inRenderPass, "Render pass ended without being begun");
+        commandList.inRenderPass = false;
+
+        for (u32 i = 0; i < numAttachments; i++)
+        {
+            Validate(commandList, IsValid(attachments[i]), "Render pass attachment is not a valid image");
+        }
+    }
+
+    void RendererNull::Clear(CommandListID commandListID, ImageID image, Vector4 /*color*/)
+    {
+        CommandList& commandList = GetCommandList(commandListID, COMMAND_TYPE_CLEAR_IMAGE);
+        Validate(commandList, IsValid(image), "Clearing an invalid image");
+    }
+
+    void RendererNull::Clear(CommandListID commandListID, DepthImageID image, DepthClearFlags /*clearFlags*/, f32 /*depth*/, u8 /*stencil*/)
+    {
+        CommandList& commandList = GetCommandList(commandListID, COMMAND_TYPE_CLEAR_DEPTH_IMAGE);
+        Validate(commandList, IsValid(image), "Clearing an invalid depth image");
+    }
+
+    void RendererNull::Draw(CommandListID commandListID, ModelID model)
+    {
+        CommandList& commandList = GetCommandList(commandListID, COMMAND_TYPE_DRAW);
+
+        using type = type_safe::underlying_type<ModelID>;
+        std::lock_guard<std::mutex> lock(_resourceMutex);
+        Validate(commandList, static_cast<type>(model) < _models.size(), "Drawing an invalid model");
+        Validate(commandList, commandList.boundGraphicsPipeline != GraphicsPipelineID::Invalid(), "Drawing without a graphics pipeline set");
+    }
+
+    void RendererNull::DrawInstanced(CommandListID commandListID, ModelID model, const InstanceRange& instances)
+    {
+        CommandList& commandList = GetCommandList(commandListID, COMMAND_TYPE_DRAW_INSTANCED);
+
+        using type = type_safe::underlying_type<ModelID>;
+        using pipelineType = type_safe::underlying_type<GraphicsPipelineID>;
+        std::lock_guard<std::mutex> lock(_resourceMutex);
+        Validate(commandList, static_cast<type>(model) < _models.size(), "Drawing an invalid model");
+        Validate(commandList, instances.count > 0, "Drawing zero instances");
+
+        if (commandList.boundGraphicsPipeline == GraphicsPipelineID::Invalid())
+        {
+            Validate(commandList, false, "Drawing without a graphics pipeline set");
+        }
+        else
+        {
+            const GraphicsPipeline& pipeline = _graphicsPipelines[static_cast<pipelineType>(commandList.boundGraphicsPipeline)];
+            Validate(commandList, pipeline.desc.states.instanceBufferState.enabled, "The bound pipeline has no instance buffer to read from");
+        }
+
+        if (instances.gpuResource == nullptr)
+        {
+            Validate(commandList, false, "Drawing instances without an instance buffer");
+        }
+        else
+        {
+            const Backend::BufferNull* buffer = static_cast<const Backend::BufferNull*>(instances.gpuResource);
+            size_t end = (static_cast<size_t>(instances.first) + instances.count) * InstanceBuffer::STRIDE;
+            Validate(commandList, end <= buffer->data.size(), "Drawing instances past the end of the instance buffer");
+        }
+    }
+
+    void RendererNull::PopMarker(CommandListID commandListID)
+    {
+        CommandList& commandList = GetCommandList(commandListID, COMMAND_TYPE_POP_MARKER);
+
+        Validate(commandList, commandList.markerDepth > 0, "Popping a marker that was never pushed");
+        if (commandList.markerDepth > 0)
+        {
+            commandList.markerDepth--;
+        }
+    }
+
+    void RendererNull::PushMarker(CommandListID commandListID, Vector3 /*color*/, std::string /*name*/)
+    {
+        CommandList& commandList = GetCommandList(commandListID, COMMAND_TYPE_PUSH_MARKER);
+        commandList.markerDepth++;
+    }
+
+    void RendererNull::ResourceBarriers(CommandListID commandListID, const ResourceBarrier* barriers, u32 numBarriers)
+    {
+        CommandList& commandList = GetCommandList(commandListID, COMMAND_TYPE_RESOURCE_BARRIERS);
+
+        for (u32 i = 0; i < numBarriers; i++)
+        {
+            const ResourceBarrier& barrier = barriers[i];
+            bool isValid = barrier.image != ImageID::Invalid() ? IsValid(barrier.image) : IsValid(barrier.depthImage);
+            Validate(commandList, isValid, "Resource barrier on an invalid image");
+        }
+    }
+
+    void RendererNull::SetConstantBuffer(CommandListID commandListID, u32 slot, void* gpuResource)
+    {
+        CommandList& commandList = GetCommandList(commandListID, COMMAND_TYPE_SET_CONSTANT_BUFFER);
+
+        Validate(commandList, gpuResource != nullptr, "Setting a constant buffer that doesn't exist");
+        Validate(commandList, slot < static_cast<u32>(MAX_CONSTANT_BUFFERS), "Constant buffer slot out of range");
+    }
+
+    void RendererNull::SetPipeline(CommandListID commandListID, GraphicsPipelineID pipeline)
+    {
+        CommandList& commandList = GetCommandList(commandListID, COMMAND_TYPE_SET_GRAPHICS_PIPELINE);
+
+        using type = type_safe::underlying_type<GraphicsPipelineID>;
+        std::lock_guard<std::mutex> lock(_resourceMutex);
+        bool isValid = static_cast<type>(pipeline) < _graphicsPipelines.size();
+        Validate(commandList, isValid, "Setting an invalid graphics pipeline");
+
+        commandList.boundGraphicsPipeline = isValid ? pipeline : GraphicsPipelineID::Invalid();
+    }
+
+    void RendererNull::SetPipeline(CommandListID commandListID, MaterialPipelineID pipeline)
+    {
+        CommandList& commandList = GetCommandList(commandListID, COMMAND_TYPE_SET_MATERIAL_PIPELINE);
+
+        using type = type_safe::underlying_type<MaterialPipelineID>;
+        std::lock_guard<std::mutex> lock(_resourceMutex);
+        bool isValid = static_cast<type>(pipeline) < _graphicsPipelines.size() && _graphicsPipelines[static_cast<type>(pipeline)].material != MaterialID::Invalid();
+        Validate(commandList, isValid, "Setting an invalid material pipeline");
+
+        // A MaterialPipelineID is just a GraphicsPipelineID
+        commandList.boundGraphicsPipeline = isValid ? GraphicsPipelineID(static_cast<type>(pipeline)) : GraphicsPipelineID::Invalid();
+    }
+
+    void RendererNull::SetPipeline(CommandListID commandListID, ComputePipelineID pipeline)
+    {
+        CommandList& commandList = GetCommandList(commandListID, COMMAND_TYPE_SET_COMPUTE_PIPELINE);
+
+        using type = type_safe::underlying_type<ComputePipelineID>;
+        std::lock_guard<std::mutex> lock(_resourceMutex);
+        Validate(commandList, static_cast<type>(pipeline) < _computePipelines.size(), "Setting an invalid compute pipeline");
+    }
+
+    void RendererNull::SetScissorRect(CommandListID commandListID, ScissorRect scissorRect)
+    {
+        CommandList& commandList = GetCommandList(commandListID, COMMAND_TYPE_SET_SCISSOR_RECT);
+        Validate(commandList, scissorRect.left <= scissorRect.right && scissorRect.top <= scissorRect.bottom, "Scissor rect is inside out");
+    }
+
+    void RendererNull::SetViewport(CommandListID commandListID, Viewport viewport)
+    {
+        CommandList& commandList = GetCommandList(commandListID, COMMAND_TYPE_SET_VIEWPORT);
+        Validate(commandList, viewport.width > 0.0f && viewport.height > 0.0f, "Viewport has no area");
+    }
+
+    void RendererNull::Present(Window* /*window*/, ImageID image)
+    {
+        std::lock_guard<std::mutex> lock(_commandListMutex);
+        _stats.numPresents++;
+
+        if (!IsValid(image))
+        {
+            LOG_ERROR(LOG_CATEGORY_RENDERER, "RendererNull: Presenting an invalid image");
+            _stats.numValidationErrors++;
+        }
+    }
+
+    void RendererNull::Present(Window* /*window*/, DepthImageID image)
+    {
+        std::lock_guard<std::mutex> lock(_commandListMutex);
+        _stats.numPresents++;
+
+        if (!IsValid(image))
+        {
+            LOG_ERROR(LOG_CATEGORY_RENDERER, "RendererNull: Presenting an invalid depth image");
+            _stats.numValidationErrors++;
+        }
+    }
+
+    RendererNullStats RendererNull::GetStats()
+    {
+        std::lock_guard<std::mutex> lock(_commandListMutex);
+        return _stats;
+    }
+
+    void RendererNull::LogStats()
+    {
+        RendererNullStats stats = GetStats();
+
+        LOG_INFO(LOG_CATEGORY_RENDERER, "RendererNull: %llu command lists, %llu presents, %llu validation errors",
+            static_cast<unsigned long long>(stats.numCommandLists), static_cast<unsigned long long>(stats.numPresents), static_cast<unsigned long long>(stats.numValidationErrors));
+
+        for (u32 i = 0; i < COMMAND_TYPE_COUNT; i++)
+        {
+            if (stats.numCommands[i] == 0)
+                continue;
+
+            LOG_INFO(LOG_CATEGORY_RENDERER, "  %-20s %10llu", CommandTypeToString(static_cast<CommandType>(i)), static_cast<unsigned long long>(stats.numCommands[i]));
+        }
+    }
+
+    Backend::ConstantBufferBackend* RendererNull::CreateConstantBufferBackend(size_t size)
+    {
+        return new Backend::ConstantBufferBackendNull(size);
+    }
+
+    RendererNull::CommandList& RendererNull::GetCommandList(CommandListID commandListID, CommandType commandType)
+    {
+        using type = type_safe::underlying_type<CommandListID>;
+        assert(static_cast<type>(commandListID) < _numCommandLists); // Recording into a command list that was never begun
+        CommandList& commandList = _commandLists[static_cast<type>(commandListID)];
+
+        Validate(commandList, commandList.isRecording, "Recording into a command list that has ended");
+        commandList.stats.numCommands[commandType]++;
+
+        return commandList;
+    }
+
+    void RendererNull::Validate(CommandList& commandList, bool condition, const char* message)
+    {
+        if (condition)
+            return;
+
+        LOG_ERROR(LOG_CATEGORY_RENDERER, "RendererNull: %s", message);
+        commandList.stats.numValidationErrors++;
+    }
+
+    bool RendererNull::IsValid(ImageID image)
+    {
+        using type = type_safe::underlying_type<ImageID>;
+        std::lock_guard<std::mutex> lock(_resourceMutex);
+        return static_cast<type>(image) < _images.size() && !_images[static_cast<type>(image)].destroyed;
+    }
+
+    bool RendererNull::IsValid(DepthImageID image)
+    {
+        using type = type_safe::underlying_type<DepthImageID>;
+        std::lock_guard<std::mutex> lock(_resourceMutex);
+        return static_cast<type>(image) < _depthImages.size() && !_depthImages[static_cast<type>(image)].destroyed;
+    }
+
+    bool RendererNull::IsValid(const RenderPassAttachment& attachment)
+    {
+        return attachment.depthImage != DepthImageID::Invalid() ? IsValid(attachment.depthImage) : IsValid(attachment.image);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,195 @@
+#pragma once
+#include "../../Renderer.h"
+#include "../../Commands/CommandType.h"
+#include <Utils/StringID.h>
+#include <mutex>
+#include <queue>
+
+namespace Renderer
+{
+    struct RendererNullStats
+    {
+        u64 numCommands[COMMAND_TYPE_COUNT] = {};
+        u64 numCommandLists = 0;
+        u64 numPresents = 0;
+        u64 numValidationErrors = 0;
+    };
+
+    // A backend that creates nothing on a GPU, for running the engine headless and measuring what it costs on the CPU.
+    // Resources are just IDs and the descriptors they were created with, constant buffers live in CPU memory.
+    // Every command gets counted and checked, marker and render pass balance, a bound pipeline before drawing and that every ID it uses was created,
+    // problems get logged and counted in numValidationErrors instead of asserting so a CI run can report all of them
+    class RendererNull : public Renderer
+    {
+    public:
+        RendererNull();
+
+        void InitWindow(Window* window) override;
+        void Deinit() override;
+
+        // Creation
+        ImageID CreateImage(ImageDesc& desc) override;
+        DepthImageID CreateDepthImage(DepthImageDesc& desc) override;
+
+        // Transient memory
+        void GetMemoryRequirements(const ImageDesc& desc, size_t& size, size_t& alignment) override;
+        void GetMemoryRequirements(const DepthImageDesc& desc, size_t& size, size_t& alignment) override;
+        TransientHeapID CreateTransientHeap(TransientHeapDesc& desc) override;
+        void DestroyTransientHeap(TransientHeapID heap) override;
+        ImageID CreatePlacedImage(ImageDesc& desc, TransientHeapID heap, size_t offset) override;
+        DepthImageID CreatePlacedImage(DepthImageDesc& desc, TransientHeapID heap, size_t offset) override;
+
+        const ImageDesc& GetDescriptor(ImageID image) override;
+        const DepthImageDesc& GetDescriptor(DepthImageID image) override;
+
+        const GraphicsPipelineDesc& GetDescriptor(GraphicsPipelineID pipeline) override;
+        const MaterialPipelineDesc& GetDescriptor(MaterialPipelineID pipeline) override;
+        const ComputePipelineDesc& GetDescriptor(ComputePipelineID pipeline) override;
+        const MaterialDesc& GetDescriptor(MaterialID material) override;
+        const ModelDesc& GetDescriptor(ModelID model) override;
+        const PrimitivePlaneDesc& GetPrimitiveDescriptor(ModelID model) override;
+
+        VertexShaderDesc GetDescriptor(VertexShaderID shader) override;
+        PixelShaderDesc GetDescriptor(PixelShaderID shader) override;
+        ComputeShaderDesc GetDescriptor(ComputeShaderID shader) override;
+
+        GraphicsPipelineID CreatePipeline(GraphicsPipelineDesc& desc) override;
+        MaterialPipelineID CreatePipeline(MaterialPipelineDesc& desc) override;
+        ComputePipelineID CreatePipeline(ComputePipelineDesc& desc) override;
+
+        ModelID CreatePrimitiveModel(PrimitivePlaneDesc& desc) override;
+
+        // Loading, nothing gets read from disk
+        TextureID LoadTexture(TextureDesc& desc) override;
+        ModelID LoadModel(ModelDesc& desc) override;
+        MaterialID LoadMaterial(MaterialDesc& desc) override;
+
+        VertexShaderID LoadShader(VertexShaderDesc& desc) override;
+        PixelShaderID LoadShader(PixelShaderDesc& desc) override;
+        ComputeShaderID LoadShader(ComputeShaderDesc& desc) override;
+
+        // Command List Functions
+        CommandListID BeginCommandList() override;
+        void EndCommandList(CommandListID commandListID) override;
+        void BeginRenderPass(CommandListID commandListID, const RenderPassAttachment* attachments, u32 numAttachments) override;
+        void EndRenderPass(CommandListID commandListID, const RenderPassAttachment* attachments, u32 numAttachments) override;
+        void Clear(CommandListID commandListID, ImageID image, Vector4 color) override;
+        void Clear(CommandListID commandListID, DepthImageID image, DepthClearFlags clearFlags, f32 depth, u8 stencil) override;
+        void Draw(CommandListID commandListID, ModelID model) override;
+        void DrawInstanced(CommandListID commandListID, ModelID model, const InstanceRange& instances) override;
+        void PopMarker(CommandListID commandListID) override;
+        void PushMarker(CommandListID commandListID, Vector3 color, std::string name) override;
+        void ResourceBarriers(CommandListID commandListID, const ResourceBarrier* barriers, u32 numBarriers) override;
+        void SetConstantBuffer(CommandListID commandListID, u32 slot, void* gpuResource) override;
+        void SetPipeline(CommandListID commandListID, GraphicsPipelineID pipeline) override;
+        void SetPipeline(CommandListID commandListID, MaterialPipelineID pipeline) override;
+        void SetPipeline(CommandListID commandListID, ComputePipelineID pipeline) override;
+        void SetScissorRect(CommandListID commandListID, ScissorRect scissorRect) override;
+        void SetViewport(CommandListID commandListID, Viewport viewport) override;
+
+        // Non-commandlist based present functions
+        void Present(Window* window, ImageID image) override;
+        void Present(Window* window, DepthImageID image) override;
+
+        // Summed over every command list that has ended so far
+        RendererNullStats GetStats();
+
+        // Logs how many of every command type got executed and how many validation errors there were
+        void LogStats();
+
+    protected:
+        Backend::ConstantBufferBackend* CreateConstantBufferBackend(size_t size) override;
+
+    private:
+        struct Image
+        {
+            ImageDesc desc;
+            TransientHeapID heap = TransientHeapID::Invalid();
+            bool destroyed = false;
+        };
+
+        struct DepthImage
+        {
+            DepthImageDesc desc;
+            TransientHeapID heap = TransientHeapID::Invalid();
+            bool destroyed = false;
+        };
+
+        struct TransientHeap
+        {
+            TransientHeapDesc desc;
+            bool destroyed = false;
+        };
+
+        struct GraphicsPipeline
+        {
+            GraphicsPipelineDesc desc;
+            MaterialID material = MaterialID::Invalid(); // Only set for material pipelines
+            MaterialPipelineDesc materialDesc;
+            u64 cacheDescHash = 0;
+        };
+
+        struct ComputePipeline
+        {
+            ComputePipelineDesc desc;
+            u64 cacheDescHash = 0;
+        };
+
+        struct Model
+        {
+            ModelDesc desc; // The path is empty for primitive models
+            PrimitivePlaneDesc primitiveDesc;
+        };
+
+        struct Shader
+        {
+            StringID pathID;
+            std::string path;
+        };
+
+        // Only touched by the thread executing the command list, its stats get added to _stats when it ends
+        struct CommandList
+        {
+            bool isRecording = false;
+            bool inRenderPass = false;
+            u32 markerDepth = 0;
+            GraphicsPipelineID boundGraphicsPipeline = GraphicsPipelineID::Invalid();
+            RendererNullStats stats;
+        };
+
+        CommandList& GetCommandList(CommandListID commandListID, CommandType type);
+        void Validate(CommandList& commandList, bool condition, const char* message);
+
+        bool IsValid(ImageID image);
+        bool IsValid(DepthImageID image);
+        bool IsValid(const RenderPassAttachment& attachment);
+
+        template <typename ID>
+        ID LoadShader(const std::string& path, std::vector<Shader>& shaders);
+
+    private:
+        std::vector<Image> _images;
+        std::vector<DepthImage> _depthImages;
+        std::vector<TransientHeap> _heaps;
+        std::vector<GraphicsPipeline> _graphicsPipelines;
+        std::vector<ComputePipeline> _computePipelines;
+
+        u32 _numTextures = 0;
+        std::vector<Model> _models;
+        std::vector<MaterialDesc> _materials;
+        std::vector<Shader> _vertexShaders; // By path, shaders get loaded again every time a pipeline is set up
+        std::vector<Shader> _pixelShaders;
+        std::vector<Shader> _computeShaders;
+
+        static const u32 MAX_COMMAND_LISTS = 255; // CommandListID is a u8 and its max value is Invalid
+
+        CommandList _commandLists[MAX_COMMAND_LISTS]; // Fixed so command lists executing on other threads never see it move
+        u32 _numCommandLists = 0;
+        std::queue<CommandListID> _availableCommandLists;
+
+        RendererNullStats _stats;
+
+        std::mutex _resourceMutex; // Creating and loading can be called from RenderPass execute lambdas running on several threads at once
+        std::mutex _commandListMutex;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,215 @@
+#include "TransientResourcePool.h"
+#include "Renderer.h"
+#include <Utils/StringUtils.h>
+#include <Profiling/Profiler.h>
+
+namespace Renderer
+{
+    namespace
+    {
+        // Everything in a desc that affects the memory or the image, zeroed first so padding hashes the same every time
+        struct DescKey
+        {
+            i32 width;
+            i32 height;
+            u32 depth;
+            u32 format;
+            u32 sampleCount;
+            f32 clear[4];
+        };
+
+        u32 HashKey(const DescKey& key)
+        {
+            return StringUtils::fnv1a_32(reinterpret_cast<const char*>(&key), sizeof(DescKey) - 1); // fnv1a_32 includes the last character
+        }
+
+        DescKey GetKey(const ImageDesc& desc)
+        {
+            DescKey key;
+            memset(&key, 0, sizeof(DescKey));
+            key.width = desc.dimensions.x;
+            key.height = desc.dimensions.y;
+            key.depth = desc.depth;
+            key.format = static_cast<u32>(desc.format);
+            key.sampleCount = static_cast<u32>(desc.sampleCount);
+            key.clear[0] = desc.clearColor.x;
+            key.clear[1] = desc.clearColor.y;
+            key.clear[2] = desc.clearColor.z;
+            key.clear[3] = desc.clearColor.w;
+            return key;
+        }
+
+        DescKey GetKey(const DepthImageDesc& desc)
+        {
+            DescKey key;
+            memset(&key, 0, sizeof(DescKey));
+            key.width = desc.dimensions.x;
+            key.height = desc.dimensions.y;
+            key.depth = 1;
+            key.format = static_cast<u32>(desc.format);
+            key.sampleCount = static_cast<u32>(desc.sampleCount);
+            key.clear[0] = desc.depthClearValue;
+            key.clear[1] = static_cast<f32>(desc.stencilClearValue);
+            return key;
+        }
+
+        template <typename Desc, typename Registered>
+        u32 Register(Renderer* renderer, const Desc& desc, std::vector<Registered>& descs, robin_hood::unordered_map<u32, u32>& lookup)
+        {
+            DescKey key = GetKey(desc);
+            u32 hash = HashKey(key);
+
+            auto it = lookup.find(hash);
+            if (it != lookup.end())
+            {
+                DescKey registeredKey = GetKey(descs[it->second].desc);
+                if (memcmp(&key, &registeredKey, sizeof(DescKey)) == 0)
+                    return it->second;
+            }
+
+            u32 index = static_cast<u32>(descs.size());
+
+            Registered registered;
+            registered.desc = desc;
+            renderer->GetMemoryRequirements(desc, registered.size, registered.alignment);
+            registered.alignment = registered.alignment < TransientResourcePool::MIN_ALIGNMENT ? TransientResourcePool::MIN_ALIGNMENT : registered.alignment;
+            descs.push_back(registered);
+
+            // On the off chance two descs collide the first one keeps the lookup and the other gets registered again every time, which still works
+            lookup.emplace(hash, index);
+            return index;
+        }
+    }
+
+    u32 TransientResourcePool::RegisterDesc(const ImageDesc& desc)
+    {
+        return Register(_renderer, desc, _imageDescs, _imageDescLookup);
+    }
+
+    u32 TransientResourcePool::RegisterDesc(const DepthImageDesc& desc)
+    {
+        return Register(_renderer, desc, _depthImageDescs, _depthImageDescLookup);
+    }
+
+    void TransientResourcePool::ReserveBlocks(const TransientHeapDesc* blocks, u32 numBlocks)
+    {
+        PROFILE_SCOPE("TransientResourcePool::ReserveBlocks");
+
+        _numReservations++;
+
+        if (_blocks.size() < numBlocks)
+        {
+            _blocks.resize(numBlocks);
+        }
+
+        for (u32 i = 0; i < numBlocks; i++)
+        {
+            Block& block = _blocks[i];
+            block.lastReservation = _numReservations;
+
+            if (block.heap != TransientHeapID::Invalid() && block.size >= blocks[i].size && block.alignment >= blocks[i].alignment)
+                continue;
+
+            DestroyBlock(i);
+
+            TransientHeapDesc heapDesc;
+            heapDesc.size = (blocks[i].size + HEAP_SIZE_GRANULARITY - 1) / HEAP_SIZE_GRANULARITY * HEAP_SIZE_GRANULARITY;
+            heapDesc.alignment = blocks[i].alignment;
+
+            block.heap = _renderer->CreateTransientHeap(heapDesc);
+            block.size = heapDesc.size;
+            block.alignment = heapDesc.alignment;
+            _numAllocatedBytes += block.size;
+        }
+
+        for (u32 i = numBlocks; i < _blocks.size(); i++)
+        {
+            if (_blocks[i].heap != TransientHeapID::Invalid() && _blocks[i].lastReservation + RESERVATIONS_BEFORE_EVICTION < _numReservations)
+            {
+                DestroyBlock(i);
+            }
+        }
+    }
+
+    ImageID TransientResourcePool::GetImage(u32 desc, u32 block, size_t offset)
+    {
+        u64 key = GetImageKey(desc, false, block, offset);
+
+        auto it = _images.find(key);
+        if (it != _images.end())
+            return ImageID(it->second);
+
+        assert(block < _blocks.size() && _blocks[block].heap != TransientHeapID::Invalid()); // Reserve the block before placing images in it
+
+        ImageDesc imageDesc = _imageDescs[desc].desc;
+        ImageID image = _renderer->CreatePlacedImage(imageDesc, _blocks[block].heap, offset);
+
+        using type = type_safe::underlying_type<ImageID>;
+        _images.emplace(key, static_cast<type>(image));
+        return image;
+    }
+
+    DepthImageID TransientResourcePool::GetDepthImage(u32 desc, u32 block, size_t offset)
+    {
+        u64 key = GetImageKey(desc, true, block, offset);
+
+        auto it = _images.find(key);
+        if (it != _images.end())
+            return DepthImageID(it->second);
+
+        assert(block < _blocks.size() && _blocks[block].heap != TransientHeapID::Invalid()); // Reserve the block before placing images in it
+
+        DepthImageDesc imageDesc = _depthImageDescs[desc].desc;
+        DepthImageID image = _renderer->CreatePlacedImage(imageDesc, _blocks[block].heap, offset);
+
+        using type = type_safe::underlying_type<DepthImageID>;
+        _images.emplace(key, static_cast<type>(image));
+        return image;
+    }
+
+    void TransientResourcePool::Clear()
+    {
+        for (u32 i = 0; i < _blocks.size(); i++)
+        {
+            DestroyBlock(i);
+        }
+
+        _blocks.clear();
+        _images.clear();
+    }
+
+    void TransientResourcePool::DestroyBlock(u32 block)
+    {
+        Block& destroyed = _blocks[block];
+        if (destroyed.heap == TransientHeapID::Invalid())
+            return;
+
+        // The images placed in the heap go with it
+        for (auto it = _images.begin(); it != _images.end();)
+        {
+            if (static_cast<u32>((it->first >> 32) & 0xFF) == block)
+            {
+                it = _images.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
+        _renderer->DestroyTransientHeap(destroyed.heap);
+        _numAllocatedBytes -= destroyed.size;
+
+        destroyed.heap = TransientHeapID::Invalid();
+        destroyed.size = 0;
+    }
+
+    u64 TransientResourcePool::GetImageKey(u32 desc, bool isDepth, u32 block, size_t offset)
+    {
+        assert(desc < (1u << 23)); // Out of bits for the desc
+        assert(block < 256); // Out of bits for the block
+
+        // Offsets are aligned to at least MIN_ALIGNMENT so the low 16 bits are always zero
+        return (static_cast<u64>(isDepth) << 63) | (static_cast<u64>(desc) << 40) | (static_cast<u64>(block) << 32) | static_cast<u64>(offset >> 16);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,85 @@
+#pragma once
+#include <Core.h>
+#include <Containers/RobinHood.h>
+#include <vector>
+#include "Descriptors/ImageDesc.h"
+#include "Descriptors/DepthImageDesc.h"
+#include "Descriptors/TransientHeapDesc.h"
+
+namespace Renderer
+{
+    class Renderer;
+
+    // Keeps the memory and images behind RenderGraph transient resources alive across frames, so a graph that compiles to the same aliasing plan as last frame
+    // creates nothing. Descs are registered once per hash, images get pooled by desc, memory block and offset.
+    // Only the thread compiling RenderGraphs should touch this.
+    class TransientResourcePool
+    {
+    public:
+        static const u32 INVALID_DESC = 0xFFFFFFFF;
+        static const u32 RESERVATIONS_BEFORE_EVICTION = 120; // Blocks no graph has used for this many setups get destroyed
+        static constexpr size_t MIN_ALIGNMENT = 64 * 1024;
+        static constexpr size_t HEAP_SIZE_GRANULARITY = 4 * 1024 * 1024; // Heaps get rounded up to this, so small changes in size don't recreate them
+        static constexpr size_t MAX_BLOCK_SIZE = 256 * 1024 * 1024; // RenderGraphs pack transients into blocks up to this size, bigger transients get a block of their own
+
+        TransientResourcePool(Renderer* renderer)
+            : _renderer(renderer)
+        {
+
+        }
+
+        // Returns the same index for every desc that hashes the same, debug names don't count so the first one registered names the rest
+        u32 RegisterDesc(const ImageDesc& desc);
+        u32 RegisterDesc(const DepthImageDesc& desc);
+
+        const ImageDesc& GetImageDesc(u32 desc) const { return _imageDescs[desc].desc; }
+        const DepthImageDesc& GetDepthImageDesc(u32 desc) const { return _depthImageDescs[desc].desc; }
+        size_t GetSize(u32 desc, bool isDepth) const { return isDepth ? _depthImageDescs[desc].size : _imageDescs[desc].size; }
+        size_t GetAlignment(u32 desc, bool isDepth) const { return isDepth ? _depthImageDescs[desc].alignment : _imageDescs[desc].alignment; }
+
+        // Called every time a graph is set up with the blocks its aliasing plan needs, recreates blocks that are too small and evicts ones nothing has used in a while
+        void ReserveBlocks(const TransientHeapDesc* blocks, u32 numBlocks);
+
+        ImageID GetImage(u32 desc, u32 block, size_t offset);
+        DepthImageID GetDepthImage(u32 desc, u32 block, size_t offset);
+
+        size_t GetNumAllocatedBytes() const { return _numAllocatedBytes; }
+
+        // Destroys every heap and image, the backend calls this before tearing down
+        void Clear();
+
+    private:
+        template <typename Desc>
+        struct RegisteredDesc
+        {
+            Desc desc;
+            size_t size = 0;
+            size_t alignment = 0;
+        };
+
+        struct Block
+        {
+            TransientHeapID heap = TransientHeapID::Invalid();
+            size_t size = 0;
+            size_t alignment = 0;
+            u64 lastReservation = 0;
+        };
+
+        void DestroyBlock(u32 block);
+        static u64 GetImageKey(u32 desc, bool isDepth, u32 block, size_t offset);
+
+    private:
+        Renderer* _renderer;
+
+        std::vector<RegisteredDesc<ImageDesc>> _imageDescs;
+        std::vector<RegisteredDesc<DepthImageDesc>> _depthImageDescs;
+        robin_hood::unordered_map<u32, u32> _imageDescLookup; // Desc hash to index
+        robin_hood::unordered_map<u32, u32> _depthImageDescLookup;
+
+        std::vector<Block> _blocks;
+        robin_hood::unordered_map<u64, u16> _images; // Placed ImageIDs and DepthImageIDs by GetImageKey
+
+        u64 _numReservations = 0;
+        size_t _numAllocatedBytes = 0;
+    };
+}
\ No newline at end of file
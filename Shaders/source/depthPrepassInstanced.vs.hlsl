@@ -0,0 +1,35 @@
+
+struct VS_INPUT
+{
+    float3 pos : POSITION;
+    uint instanceID : SV_InstanceID;
+};
+
+struct VS_OUTPUT
+{
+    float4 pos: SV_POSITION;
+};
+
+struct VIEW_CB
+{
+    float4x4 view;
+    float4x4 proj;
+};
+
+struct INSTANCE
+{
+    float4 color;
+    float4x4 model;
+};
+
+ConstantBuffer<VIEW_CB> viewCB : register(b0);
+StructuredBuffer<INSTANCE> instances : register(t0, space1); // Bound at the first instance of the draw, so SV_InstanceID indexes it directly
+
+VS_OUTPUT main(VS_INPUT input)
+{
+    VS_OUTPUT output;
+
+    float4x4 model = instances[input.instanceID].model;
+    output.pos = mul(mul(mul(float4(input.pos, 1.0f), model), viewCB.view), viewCB.proj);
+    return output;
+}
\ No newline at end of file
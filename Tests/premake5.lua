@@ -0,0 +1,39 @@
+TESTS_NAME = "Tests"
+
+project (TESTS_NAME)
+    kind "ConsoleApp"
+    language "C++"
+    location "build"
+    filename (TESTS_NAME .. _AMD_VS_SUFFIX)
+    uuid "3F3B938C-ABC6-0051-B4D7-834520E25C56"
+    targetdir "../bin"
+    objdir "build/%{_AMD_SAMPLE_DIR_LAYOUT}"
+    warnings "Extra"
+    floatingpoint "Fast"
+    dependson { CORE_NAME, RENDERER_NAME }
+
+    files { "source/**.h", "source/**.cpp" }
+    links { CORE_NAME, RENDERER_NAME }
+    includedirs { "../Engine/%{CORE_NAME}/source", "../Engine/%{RENDERER_NAME}/source" }
+
+    defines { "_CRT_SECURE_NO_WARNINGS", "NOMINMAX" }
+
+    filter "configurations:Debug"
+        defines { "WIN32", "_DEBUG", "DEBUG", "_CONSOLE" }
+        flags { "FatalWarnings" }
+        symbols "On"
+        targetsuffix ("_Debug" .. _AMD_VS_SUFFIX)
+
+    filter "configurations:Release"
+        defines { "WIN32", "NDEBUG", "PROFILE", "_CONSOLE", "RELEASE" }
+        flags { "LinkTimeOptimization", "FatalWarnings" }
+        symbols "On"
+        targetsuffix ("_Release" .. _AMD_VS_SUFFIX)
+        optimize "On"
+
+    filter "configurations:Final"
+        defines { "WIN32", "NDEBUG", "PROFILE", "_CONSOLE", "FINAL" }
+        flags { "LinkTimeOptimization", "FatalWarnings" }
+        symbols "On"
+        targetsuffix ("_Final" .. _AMD_VS_SUFFIX)
+        optimize "On"
\ No newline at end of file
@@ -0,0 +1,178 @@
+#include <Core.h>
+#include <Jobs/JobSystem.h>
+#include <Renderer/Renderers/Null/RendererNull.h>
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include "Test.h"
+
+// Async loads on a backend that reads and finalizes models slowly and counts what happened to every load
+
+using namespace Renderer;
+
+namespace
+{
+    const u32 FINALIZE_MS = 2;
+
+    std::atomic<u32> _numLiveLoadData = 0;
+
+    struct StubLoadData : AsyncLoadData
+    {
+        StubLoadData(const std::string& path) : path(path) { _numLiveLoadData.fetch_add(1, std::memory_order_relaxed); }
+        ~StubLoadData() { _numLiveLoadData.fetch_sub(1, std::memory_order_relaxed); }
+
+        std::string path;
+    };
+
+    class StubLoadingRenderer : public RendererNull
+    {
+    public:
+        std::atomic<u32> numReads = 0;
+        u32 numFinalizes = 0;
+        u32 numFinalizesWithoutData = 0; // Finalize has to get back what its read returned
+
+    protected:
+        AsyncLoadData* ReadModelAsync(const ModelDesc& desc) override
+        {
+            numReads.fetch_add(1, std::memory_order_relaxed);
+            return new StubLoadData(desc.path);
+        }
+
+        ModelID FinalizeModelAsync(ModelDesc& desc, AsyncLoadData* data) override
+        {
+            StubLoadData* loadData = static_cast<StubLoadData*>(data);
+            numFinalizesWithoutData += loadData == nullptr || loadData->path != desc.path ? 1 : 0;
+            numFinalizes++;
+
+            // Slower than any budget the tests give, so the budget decides how many get finalized
+            std::this_thread::sleep_for(std::chrono::milliseconds(FINALIZE_MS));
+            return LoadModel(desc);
+        }
+    };
+
+    ModelDesc GetModelDesc(u32 index)
+    {
+        ModelDesc desc;
+        desc.path = "Model" + std::to_string(index);
+        return desc;
+    }
+}
+
+TEST(AsyncLoadFinalizesAtLeastOneLoadPerCall)
+{
+    StubLoadingRenderer renderer;
+    for (u32 i = 0; i < 3; i++)
+    {
+        renderer.LoadModelAsync(GetModelDesc(i));
+    }
+    CHECK(renderer.GetNumPendingAsyncLoads() == 3);
+
+    // A budget every load blows on its own still has to make progress
+    CHECK(renderer.FinalizeAsyncLoads(0.0f) == 1);
+    CHECK(renderer.FinalizeAsyncLoads(0.0f) == 1);
+    CHECK(renderer.GetNumPendingAsyncLoads() == 1);
+
+    CHECK(renderer.FinalizeAsyncLoads(1000.0f) == 1);
+    CHECK(renderer.FinalizeAsyncLoads(1000.0f) == 0);
+    CHECK(renderer.GetNumPendingAsyncLoads() == 0);
+    CHECK(renderer.numFinalizes == 3);
+    CHECK(renderer.numFinalizesWithoutData == 0);
+    CHECK(_numLiveLoadData.load() == 0);
+
+    renderer.Deinit();
+}
+
+TEST(AsyncHandleBecomesReadyWhenFinalized)
+{
+    StubLoadingRenderer renderer;
+
+    AsyncHandle<ModelID> empty;
+    CHECK(!empty.IsValid());
+    CHECK(!empty.IsReady());
+
+    AsyncHandle<ModelID> handle = renderer.LoadModelAsync(GetModelDesc(0));
+    AsyncHandle<ModelID> copy = handle;
+    CHECK(handle.IsValid());
+    CHECK(!handle.IsReady());
+
+    // Reading alone doesn't make it ready, only finalizing does
+    ModelID readyID = ModelID::Invalid();
+    u32 numReadyCalls = 0;
+    handle.OnReady([&](ModelID id) { readyID = id; numReadyCalls++; });
+    CHECK(renderer.numReads.load() == 1);
+    CHECK(numReadyCalls == 0);
+
+    renderer.FinalizeAsyncLoads(1000.0f);
+    CHECK(handle.IsReady());
+    CHECK(copy.IsReady());
+    CHECK(numReadyCalls == 1);
+    CHECK(readyID == handle.Get());
+    CHECK(renderer.GetDescriptor(handle.Get()).path == "Model0");
+
+    // Once it's ready OnReady runs right away
+    handle.OnReady([&](ModelID id) { readyID = id; numReadyCalls++; });
+    CHECK(numReadyCalls == 2);
+
+    renderer.Deinit();
+}
+
+TEST(AsyncLoadsReadOnTheJobSystem)
+{
+    Jobs::JobSystemDesc jobSystemDesc;
+    jobSystemDesc.numWorkers = 3;
+    Jobs::JobSystem::Init(jobSystemDesc);
+
+    const u32 NUM_LOADS = 32;
+    StubLoadingRenderer renderer;
+    AsyncHandle<ModelID> handles[NUM_LOADS];
+    for (u32 i = 0; i < NUM_LOADS; i++)
+    {
+        handles[i] = renderer.LoadModelAsync(GetModelDesc(i));
+    }
+
+    renderer.WaitForAsyncLoads();
+
+    u32 numWrong = 0;
+    for (u32 i = 0; i < NUM_LOADS; i++)
+    {
+        numWrong += handles[i].IsReady() && renderer.GetDescriptor(handles[i].Get()).path == GetModelDesc(i).path ? 0 : 1;
+    }
+    CHECK(numWrong == 0);
+    CHECK(renderer.numReads.load() == NUM_LOADS);
+    CHECK(renderer.numFinalizes == NUM_LOADS);
+    CHECK(renderer.GetNumPendingAsyncLoads() == 0);
+
+    renderer.Deinit();
+    Jobs::JobSystem::Shutdown();
+}
+
+TEST(AsyncLoadsDiscardedAtShutdownNeverFinalize)
+{
+    Jobs::JobSystemDesc jobSystemDesc;
+    jobSystemDesc.numWorkers = 3;
+    Jobs::JobSystem::Init(jobSystemDesc);
+
+    StubLoadingRenderer renderer;
+    AsyncHandle<ModelID> handle = renderer.LoadModelAsync(GetModelDesc(0));
+    u32 numReadyCalls = 0;
+    handle.OnReady([&](ModelID) { numReadyCalls++; });
+    for (u32 i = 1; i < 16; i++)
+    {
+        renderer.LoadModelAsync(GetModelDesc(i));
+    }
+
+    // Deinit waits for the reads still running and throws away what they read
+    renderer.Deinit();
+
+    CHECK(renderer.numReads.load() == 16);
+    CHECK(renderer.numFinalizes == 0);
+    CHECK(numReadyCalls == 0);
+    CHECK(!handle.IsReady());
+    CHECK(renderer.GetNumPendingAsyncLoads() == 0);
+    CHECK(_numLiveLoadData.load() == 0);
+
+    Jobs::JobSystem::Shutdown();
+}
\ No newline at end of file
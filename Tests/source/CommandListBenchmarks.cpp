@@ -0,0 +1,97 @@
+#include <Core.h>
+#include <Memory/StackAllocator.h>
+#include <Renderer/Renderers/Null/RendererNull.h>
+
+#include <chrono>
+#include <cstdio>
+
+#include "Test.h"
+
+using namespace Renderer;
+using Builder = RenderGraphBuilder;
+
+namespace
+{
+    const u32 NUM_DRAWS = 32 * 1024; // Four commands each, so a frame records over 128k commands
+    const u32 NUM_ITERATIONS = 20;
+    const size_t GRAPH_ALLOCATOR_SIZE = 1 * 1024 * 1024;
+    const size_t FRAME_ALLOCATOR_SIZE = 32 * 1024 * 1024;
+
+    // The commands the benchmark records do nothing on the backend, so replaying measures walking the command stream and dispatching it
+    class DiscardingRenderer : public RendererNull
+    {
+    public:
+        void Draw(CommandListID /*commandListID*/, ModelID /*model*/) override {}
+        void SetConstantBuffer(CommandListID /*commandListID*/, u32 /*slot*/, void* /*gpuResource*/) override {}
+        void SetPipeline(CommandListID /*commandListID*/, GraphicsPipelineID /*pipeline*/) override {}
+        void SetScissorRect(CommandListID /*commandListID*/, ScissorRect /*scissorRect*/) override {}
+    };
+
+    struct PassData
+    {
+    };
+}
+
+BENCHMARK(CommandListRecordAndReplay)
+{
+    DiscardingRenderer renderer;
+
+    ImageDesc imageDesc;
+    imageDesc.debugName = "Target";
+    imageDesc.dimensions = Vector2i(64, 64);
+    imageDesc.format = IMAGE_FORMAT_R8G8B8A8_UNORM;
+    ImageID target = renderer.CreateImage(imageDesc);
+
+    Memory::StackAllocator graphAllocator(GRAPH_ALLOCATOR_SIZE);
+    graphAllocator.Init();
+    Memory::StackAllocator frameAllocator(FRAME_ALLOCATOR_SIZE);
+    frameAllocator.Init();
+
+    RenderGraphDesc desc;
+    desc.allocator = &graphAllocator;
+    desc.frameAllocator = &frameAllocator;
+    RenderGraph renderGraph = renderer.CreateRenderGraph(desc);
+
+    // Every command changes what's bound so none of them get filtered
+    static u8 instanceData[256][256];
+    f64 recordMS = 0.0;
+    renderGraph.AddPass<PassData>("Record",
+        [&](PassData&, Builder& builder)
+        {
+            builder.Write(target, Builder::WRITE_MODE_RENDERTARGET, Builder::LOAD_MODE_LOAD);
+            return true;
+        },
+        [&](PassData&, CommandList& commandList)
+        {
+            std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+            for (u32 i = 0; i < NUM_DRAWS; i++)
+            {
+                commandList.SetPipeline(GraphicsPipelineID(static_cast<u16>(i & 7)));
+                commandList.SetScissorRect(0, i, 0, i);
+                commandList.SetConstantBuffer(1, instanceData[i & 255]);
+                commandList.Draw(ModelID(static_cast<u16>(i & 255)));
+            }
+            recordMS = std::chrono::duration<f64, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+        });
+
+    // RenderGraph::Execute records the pass and then replays the list, so the replay is whatever it took on top of recording
+    f64 fastestRecordMS = 0.0;
+    f64 fastestReplayMS = 0.0;
+    for (u32 i = 0; i < NUM_ITERATIONS; i++)
+    {
+        frameAllocator.Reset();
+        renderGraph.Setup();
+
+        f64 executeMS = Tests::MeasureMS(1, [&renderGraph]() { renderGraph.Execute(); });
+        f64 replayMS = executeMS - recordMS;
+
+        fastestRecordMS = (i == 0 || recordMS < fastestRecordMS) ? recordMS : fastestRecordMS;
+        fastestReplayMS = (i == 0 || replayMS < fastestReplayMS) ? replayMS : fastestReplayMS;
+    }
+
+    u32 numCommands = NUM_DRAWS * 4;
+    printf("    %u commands: record %.3f ms (%.1f commands/us), replay %.3f ms (%.1f commands/us)\n", numCommands,
+        fastestRecordMS, numCommands / (fastestRecordMS * 1000.0), fastestReplayMS, numCommands / (fastestReplayMS * 1000.0));
+
+    renderer.Deinit();
+}
\ No newline at end of file
@@ -0,0 +1,172 @@
+#include <Core.h>
+#include <Memory/StackAllocator.h>
+#include <Profiling/FrameStats.h>
+#include <Renderer/DrawList.h>
+#include <Renderer/InstanceData.h>
+#include <Renderer/Renderers/Null/RendererNull.h>
+
+#include <functional>
+#include <vector>
+
+#include "Test.h"
+
+// CommandList merges DrawInstanced calls of the same model on neighbouring instances into one draw, these check what reaches the backend and what FrameStats counts
+
+using namespace Renderer;
+using Builder = RenderGraphBuilder;
+
+namespace
+{
+    const size_t ALLOCATOR_SIZE = 4 * 1024 * 1024;
+    const u32 NUM_INSTANCES = 64;
+
+    struct InstancedDraw
+    {
+        u16 model;
+        u32 first;
+        u32 count;
+    };
+
+    // Notes every draw that reaches it, none of the models or pipelines exist so RendererNull's validation is left out
+    class DrawCountingRenderer : public RendererNull
+    {
+    public:
+        void Draw(CommandListID /*commandListID*/, ModelID /*model*/) override { numDraws++; }
+
+        void DrawInstanced(CommandListID /*commandListID*/, ModelID model, const InstanceRange& instances) override
+        {
+            instancedDraws.push_back({ static_cast<u16>(model), instances.first, instances.count });
+        }
+
+        std::vector<InstancedDraw> instancedDraws;
+        u32 numDraws = 0;
+    };
+
+    struct PassData
+    {
+    };
+
+    // Records one pass of one frame, returns the draws batched according to FrameStats
+    u64 RecordFrame(DrawCountingRenderer& renderer, const std::function<void(CommandList&)>& record)
+    {
+        ImageDesc imageDesc;
+        imageDesc.debugName = "Target";
+        imageDesc.dimensions = Vector2i(64, 64);
+        imageDesc.format = IMAGE_FORMAT_R8G8B8A8_UNORM;
+        ImageID target = renderer.CreateImage(imageDesc);
+
+        Memory::StackAllocator allocator(ALLOCATOR_SIZE);
+        allocator.Init();
+
+        RenderGraphDesc desc;
+        desc.allocator = &allocator;
+        RenderGraph renderGraph = renderer.CreateRenderGraph(desc);
+
+        renderGraph.AddPass<PassData>("Pass",
+            [target](PassData&, Builder& builder)
+            {
+                builder.Write(target, Builder::WRITE_MODE_RENDERTARGET, Builder::LOAD_MODE_LOAD);
+                return true;
+            },
+            [&record](PassData&, CommandList& commandList)
+            {
+                record(commandList);
+            });
+
+        Profiling::FrameStats::EndFrame(); // Leaves whatever was counted before this frame in the last one
+        renderGraph.Setup();
+        renderGraph.Execute();
+        Profiling::FrameStats::EndFrame();
+
+        return Profiling::FrameStats::GetLastFrameCounter(Profiling::FRAME_COUNTER_DRAWS_BATCHED);
+    }
+}
+
+TEST(DrawBatchingMergesNeighbouringInstancesOfOneModel)
+{
+    DrawCountingRenderer renderer;
+    InstanceBuffer instanceBuffer = renderer.CreateInstanceBuffer(NUM_INSTANCES);
+    instanceBuffer.Reset(0);
+
+    u64 numBatched = RecordFrame(renderer, [&](CommandList& commandList)
+    {
+        for (u32 i = 0; i < NUM_INSTANCES; i++)
+        {
+            commandList.DrawInstanced(ModelID(1), instanceBuffer.Allocate(1));
+        }
+    });
+
+    CHECK(renderer.instancedDraws.size() == 1 && renderer.instancedDraws[0].first == 0 && renderer.instancedDraws[0].count == NUM_INSTANCES);
+    CHECK(numBatched == NUM_INSTANCES - 1);
+
+    renderer.Deinit();
+}
+
+TEST(DrawBatchingStopsAtAnotherModelOrAGap)
+{
+    DrawCountingRenderer renderer;
+    InstanceBuffer instanceBuffer = renderer.CreateInstanceBuffer(NUM_INSTANCES);
+    instanceBuffer.Reset(0);
+
+    u64 numBatched = RecordFrame(renderer, [&](CommandList& commandList)
+    {
+        InstanceRange instances = instanceBuffer.Allocate(8);
+        for (u32 i = 0; i < 8; i++)
+        {
+            InstanceRange instance = instances;
+            instance.first = instances.first + i;
+            instance.count = 1;
+
+            // Model 2 in the middle splits the first four, and skipping instance 6 splits the last three
+            if (i == 6)
+                continue;
+            commandList.DrawInstanced(ModelID(i == 3 ? 2 : 1), instance);
+        }
+    });
+
+    CHECK(renderer.instancedDraws.size() == 4);
+    if (renderer.instancedDraws.size() == 4)
+    {
+        CHECK(renderer.instancedDraws[0].model == 1 && renderer.instancedDraws[0].first == 0 && renderer.instancedDraws[0].count == 3);
+        CHECK(renderer.instancedDraws[1].model == 2 && renderer.instancedDraws[1].first == 3 && renderer.instancedDraws[1].count == 1);
+        CHECK(renderer.instancedDraws[2].model == 1 && renderer.instancedDraws[2].first == 4 && renderer.instancedDraws[2].count == 2);
+        CHECK(renderer.instancedDraws[3].model == 1 && renderer.instancedDraws[3].first == 7 && renderer.instancedDraws[3].count == 1);
+    }
+    CHECK(numBatched == 3);
+
+    renderer.Deinit();
+}
+
+TEST(DrawBatchingMergesInstancedDrawListSubmits)
+{
+    DrawCountingRenderer renderer;
+    InstanceBuffer instanceBuffer = renderer.CreateInstanceBuffer(NUM_INSTANCES);
+    instanceBuffer.Reset(0);
+
+    InstanceData instance(&renderer); // Which draws merge doesn't depend on what gets written for them, so every packet can share one
+    Memory::StackAllocator drawListAllocator(ALLOCATOR_SIZE);
+    drawListAllocator.Init();
+
+    // Two models spread over the list in the order they were found, sorting groups them so each one becomes a single draw
+    DrawList drawList(&drawListAllocator, NUM_INSTANCES);
+    for (u32 i = 0; i < NUM_INSTANCES; i++)
+    {
+        DrawPacket packet;
+        packet.model = ModelID(static_cast<u16>(1 + i % 2));
+        packet.depth = static_cast<f32>(i) / NUM_INSTANCES;
+        packet.instance = &instance;
+        drawList.AddDraw(packet);
+    }
+    drawList.Sort();
+
+    u64 numBatched = RecordFrame(renderer, [&](CommandList& commandList)
+    {
+        drawList.Submit(commandList, instanceBuffer);
+    });
+
+    CHECK(renderer.instancedDraws.size() == 2);
+    CHECK(renderer.numDraws == 0);
+    CHECK(numBatched == NUM_INSTANCES - 2);
+
+    renderer.Deinit();
+}
\ No newline at end of file
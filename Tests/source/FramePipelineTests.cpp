@@ -0,0 +1,102 @@
+#include <Core.h>
+#include <Jobs/JobSystem.h>
+#include <Utils/FramePipeline.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "Test.h"
+
+// Runs a simulation and a render stage on two threads like the Demo does, the render thread joins the job system and reads every snapshot on it.
+// Run these under ThreadSanitizer as well, a slot handed over too early shows up as a race on the snapshot's values
+
+namespace
+{
+    const u32 NUM_FRAMES = 2000;
+    const u32 NUM_SNAPSHOT_VALUES = 1024;
+
+    struct Snapshot
+    {
+        u64 frame = 0;
+        std::vector<u64> values;
+    };
+}
+
+TEST(FramePipelineHandsOverSnapshotsInOrder)
+{
+    for (bool useFibers : { false, true })
+    {
+        Jobs::JobSystemDesc jobSystemDesc;
+        jobSystemDesc.numWorkers = 2;
+        jobSystemDesc.useFibers = useFibers;
+        Jobs::JobSystem::Init(jobSystemDesc);
+
+        for (u32 latency = 1; latency <= FramePipeline<Snapshot>::MAX_LATENCY; latency++)
+        {
+            FramePipeline<Snapshot> framePipeline(latency);
+
+            std::atomic<u32> numOutOfOrder = 0;
+            std::atomic<u32> numTorn = 0;
+            std::atomic<u32> numTooFarAhead = 0;
+            bool renderThreadRegistered = false; // Read once the render thread has joined
+
+            std::thread renderThread([&]()
+            {
+                renderThreadRegistered = Jobs::JobSystem::RegisterThread();
+
+                u64 expectedFrame = 0;
+                while (Snapshot* snapshot = framePipeline.BeginRead())
+                {
+                    // Frame f can only be read once it was written, and the simulation can't have started more than latency frames past it
+                    u64 written = framePipeline.GetFramesWritten();
+                    numTooFarAhead.fetch_add(written > snapshot->frame + latency + 1 ? 1 : 0, std::memory_order_relaxed);
+                    numOutOfOrder.fetch_add(snapshot->frame != expectedFrame ? 1 : 0, std::memory_order_relaxed);
+                    expectedFrame++;
+
+                    // Render work fans out over the job system like the Demo's render graph does
+                    Jobs::JobSystem::ParallelFor(NUM_SNAPSHOT_VALUES, 64, [snapshot, &numTorn](u32 begin, u32 end)
+                    {
+                        for (u32 i = begin; i < end; i++)
+                        {
+                            numTorn.fetch_add(snapshot->values[i] != snapshot->frame * NUM_SNAPSHOT_VALUES + i ? 1 : 0, std::memory_order_relaxed);
+                        }
+                    });
+
+                    framePipeline.EndRead();
+                }
+
+                if (renderThreadRegistered)
+                {
+                    Jobs::JobSystem::UnregisterThread();
+                }
+            });
+
+            // The simulation fills in the next free slot on the thread that called Init, with its own jobs
+            for (u64 frame = 0; frame < NUM_FRAMES; frame++)
+            {
+                Snapshot& snapshot = framePipeline.BeginWrite();
+                snapshot.frame = frame;
+                snapshot.values.resize(NUM_SNAPSHOT_VALUES);
+                Jobs::JobSystem::ParallelFor(NUM_SNAPSHOT_VALUES, 64, [&snapshot, frame](u32 begin, u32 end)
+                {
+                    for (u32 i = begin; i < end; i++)
+                    {
+                        snapshot.values[i] = frame * NUM_SNAPSHOT_VALUES + i;
+                    }
+                });
+                framePipeline.EndWrite();
+            }
+            framePipeline.Stop();
+            renderThread.join();
+
+            CHECK(renderThreadRegistered);
+            CHECK(numOutOfOrder.load() == 0);
+            CHECK(numTorn.load() == 0);
+            CHECK(numTooFarAhead.load() == 0);
+            CHECK(framePipeline.GetFramesRead() == NUM_FRAMES);
+        }
+
+        Jobs::JobSystem::Shutdown();
+    }
+}
\ No newline at end of file
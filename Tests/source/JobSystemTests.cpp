@@ -0,0 +1,290 @@
+#include <Core.h>
+#include <Jobs/JobSystem.h>
+#include <Jobs/WorkStealingDeque.h>
+
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "Test.h"
+
+// These hammer the deque and the fiber switches from many threads at once, so they are the ones to run under ThreadSanitizer
+
+namespace
+{
+    const u32 NUM_THIEVES = 3;
+    const u32 NUM_DEQUE_ITEMS = 200000;
+    const u32 NUM_CHAINS = 64;
+    const u32 CHAIN_DEPTH = 32;
+    const u32 NUM_FAN_OUTS = 200;
+    const u32 FAN_OUT_SIZE = 16;
+
+    // Tests oversubscribe on purpose, more threads than cores makes for more preemption in the middle of a steal or a fiber switch
+    const u32 TEST_WORKER_COUNTS[] = { 0, 1, 3, 7 };
+
+    // Benchmarks go from one thread up to one per core, the job system counts the thread calling Init so numWorkers + 1 threads run jobs
+    std::vector<u32> GetBenchmarkWorkerCounts()
+    {
+        u32 numCores = std::thread::hardware_concurrency();
+        numCores = numCores > 0 ? numCores : 1;
+
+        std::vector<u32> workerCounts;
+        for (u32 numThreads = 1; numThreads < numCores; numThreads *= 2)
+        {
+            workerCounts.push_back(numThreads - 1);
+        }
+        workerCounts.push_back(numCores - 1);
+
+        return workerCounts;
+    }
+
+    void InitJobSystem(u32 numWorkers, bool useFibers)
+    {
+        Jobs::JobSystemDesc desc;
+        desc.numWorkers = numWorkers;
+        desc.useFibers = useFibers;
+        Jobs::JobSystem::Init(desc);
+    }
+
+    std::atomic<u32> _numChainJobs = 0;
+
+    // Every link schedules the next one and parks on it, so a deep chain keeps fibers parked on each other
+    void RunChain(u32 depth)
+    {
+        if (depth > 0)
+        {
+            Jobs::JobCounter counter;
+            Jobs::JobSystem::Schedule([depth]() { RunChain(depth - 1); }, &counter);
+            Jobs::JobSystem::WaitForCounter(&counter);
+        }
+
+        _numChainJobs.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+TEST(WorkStealingDequeHandsOutEveryItemOnce)
+{
+    Jobs::WorkStealingDeque<u32, 1024> deque;
+    std::vector<u32> items(NUM_DEQUE_ITEMS);
+    std::vector<std::atomic<u32>> timesTaken(NUM_DEQUE_ITEMS);
+    for (u32 i = 0; i < NUM_DEQUE_ITEMS; i++)
+    {
+        items[i] = i;
+        timesTaken[i].store(0, std::memory_order_relaxed);
+    }
+
+    std::atomic<bool> ownerDone = false;
+    std::atomic<u32> numStolen = 0;
+
+    std::vector<std::thread> thieves;
+    for (u32 i = 0; i < NUM_THIEVES; i++)
+    {
+        thieves.emplace_back([&]()
+        {
+            while (!ownerDone.load(std::memory_order_acquire) || !deque.IsEmpty())
+            {
+                if (u32* item = deque.Steal())
+                {
+                    timesTaken[*item].fetch_add(1, std::memory_order_relaxed);
+                    numStolen.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        });
+    }
+
+    // The owner keeps the deque close to empty so it races the thieves for the last item as often as possible
+    u32 numPopped = 0;
+    for (u32 i = 0; i < NUM_DEQUE_ITEMS; i++)
+    {
+        while (!deque.Push(&items[i]))
+        {
+            if (u32* item = deque.Pop())
+            {
+                timesTaken[*item].fetch_add(1, std::memory_order_relaxed);
+                numPopped++;
+            }
+        }
+
+        if ((i & 3) == 0)
+        {
+            if (u32* item = deque.Pop())
+            {
+                timesTaken[*item].fetch_add(1, std::memory_order_relaxed);
+                numPopped++;
+            }
+        }
+    }
+    while (u32* item = deque.Pop())
+    {
+        timesTaken[*item].fetch_add(1, std::memory_order_relaxed);
+        numPopped++;
+    }
+    ownerDone.store(true, std::memory_order_release);
+
+    for (std::thread& thief : thieves)
+    {
+        thief.join();
+    }
+
+    u32 numWrong = 0;
+    for (u32 i = 0; i < NUM_DEQUE_ITEMS; i++)
+    {
+        numWrong += timesTaken[i].load(std::memory_order_relaxed) != 1 ? 1 : 0;
+    }
+    CHECK(numWrong == 0);
+    CHECK(numPopped + numStolen.load() == NUM_DEQUE_ITEMS);
+    CHECK(deque.IsEmpty());
+}
+
+TEST(WaitForCounterResumesEveryParkedJob)
+{
+    for (u32 numWorkers : TEST_WORKER_COUNTS)
+    {
+        for (bool useFibers : { false, true })
+        {
+            InitJobSystem(numWorkers, useFibers);
+
+            _numChainJobs.store(0, std::memory_order_relaxed);
+            Jobs::JobCounter chains;
+            for (u32 i = 0; i < NUM_CHAINS; i++)
+            {
+                Jobs::JobSystem::Schedule([]() { RunChain(CHAIN_DEPTH); }, &chains);
+            }
+            Jobs::JobSystem::Wait(&chains);
+            CHECK(_numChainJobs.load() == NUM_CHAINS * (CHAIN_DEPTH + 1));
+
+            // Parks in the middle of a job that other jobs are also touching, the leaves must be visible to the job once it resumes
+            std::atomic<u32> numLeaves = 0;
+            std::atomic<u32> numMissedLeaves = 0;
+            Jobs::JobCounter fanOuts;
+            for (u32 i = 0; i < NUM_FAN_OUTS; i++)
+            {
+                Jobs::JobSystem::Schedule([&numLeaves, &numMissedLeaves]()
+                {
+                    u32 leaves[FAN_OUT_SIZE] = {};
+                    Jobs::JobCounter counter;
+                    for (u32 j = 0; j < FAN_OUT_SIZE; j++)
+                    {
+                        u32* leaf = &leaves[j];
+                        Jobs::JobSystem::Schedule([leaf, &numLeaves]() { *leaf = 1; numLeaves.fetch_add(1, std::memory_order_relaxed); }, &counter);
+                    }
+                    Jobs::JobSystem::WaitForCounter(&counter);
+
+                    for (u32 j = 0; j < FAN_OUT_SIZE; j++)
+                    {
+                        numMissedLeaves.fetch_add(leaves[j] == 1 ? 0 : 1, std::memory_order_relaxed);
+                    }
+                }, &fanOuts);
+            }
+            Jobs::JobSystem::Wait(&fanOuts);
+            CHECK(numLeaves.load() == NUM_FAN_OUTS * FAN_OUT_SIZE);
+            CHECK(numMissedLeaves.load() == 0);
+
+            Jobs::JobSystem::Shutdown();
+        }
+    }
+}
+
+TEST(ParallelForCoversRangeOnce)
+{
+    const u32 COUNT = 100000;
+
+    for (u32 numWorkers : TEST_WORKER_COUNTS)
+    {
+        InitJobSystem(numWorkers, true);
+
+        std::vector<std::atomic<u32>> timesVisited(COUNT);
+        for (std::atomic<u32>& visited : timesVisited)
+        {
+            visited.store(0, std::memory_order_relaxed);
+        }
+
+        // Nested so chunks schedule from workers as well as from the thread that called Init
+        Jobs::JobSystem::ParallelFor(COUNT / 1000, 1, [&timesVisited](u32 begin, u32 end)
+        {
+            for (u32 i = begin; i < end; i++)
+            {
+                Jobs::JobSystem::ParallelFor(1000, 64, [&timesVisited, i](u32 innerBegin, u32 innerEnd)
+                {
+                    for (u32 j = innerBegin; j < innerEnd; j++)
+                    {
+                        timesVisited[i * 1000 + j].fetch_add(1, std::memory_order_relaxed);
+                    }
+                });
+            }
+        });
+
+        u32 numWrong = 0;
+        for (std::atomic<u32>& visited : timesVisited)
+        {
+            numWrong += visited.load(std::memory_order_relaxed) != 1 ? 1 : 0;
+        }
+        CHECK(numWrong == 0);
+
+        Jobs::JobSystem::Shutdown();
+    }
+}
+
+BENCHMARK(ParallelForScaling)
+{
+    const u32 COUNT = 1 << 22;
+    std::vector<f32> values(COUNT);
+
+    f64 singleThreadedMS = 0.0;
+    for (u32 numWorkers : GetBenchmarkWorkerCounts())
+    {
+        InitJobSystem(numWorkers, true);
+
+        f64 ms = Tests::MeasureMS(10, [&values]()
+        {
+            Jobs::JobSystem::ParallelFor(COUNT, 4096, [&values](u32 begin, u32 end)
+            {
+                for (u32 i = begin; i < end; i++)
+                {
+                    f32 x = static_cast<f32>(i);
+                    values[i] = std::sqrt(x) * std::sin(x) + std::cos(x * 0.5f);
+                }
+            });
+        });
+        singleThreadedMS = numWorkers == 0 ? ms : singleThreadedMS;
+
+        printf("    %2u threads: %8.3f ms, %5.2fx\n", numWorkers + 1, ms, singleThreadedMS / ms);
+
+        Jobs::JobSystem::Shutdown();
+    }
+}
+
+BENCHMARK(ScheduleScaling)
+{
+    const u32 NUM_JOBS = 200000;
+
+    for (u32 numWorkers : GetBenchmarkWorkerCounts())
+    {
+        InitJobSystem(numWorkers, true);
+
+        // Empty jobs from every thread at once, this is all scheduling, stealing and counter overhead
+        std::atomic<u32> numRun = 0;
+        f64 ms = Tests::MeasureMS(5, [&numRun, numWorkers]()
+        {
+            u32 numProducers = numWorkers + 1;
+            Jobs::JobSystem::ParallelFor(numProducers, 1, [&numRun, numProducers](u32 begin, u32 end)
+            {
+                for (u32 producer = begin; producer < end; producer++)
+                {
+                    Jobs::JobCounter producerCounter;
+                    for (u32 i = 0; i < NUM_JOBS / numProducers; i++)
+                    {
+                        Jobs::JobSystem::Schedule([&numRun]() { numRun.fetch_add(1, std::memory_order_relaxed); }, &producerCounter);
+                    }
+                    Jobs::JobSystem::WaitForCounter(&producerCounter);
+                }
+            });
+        });
+
+        printf("    %2u threads: %8.3f ms, %6.1f jobs/us\n", numWorkers + 1, ms, NUM_JOBS / (ms * 1000.0));
+
+        Jobs::JobSystem::Shutdown();
+    }
+}
\ No newline at end of file
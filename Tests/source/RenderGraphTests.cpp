@@ -0,0 +1,699 @@
+#include <Core.h>
+#include <Memory/StackAllocator.h>
+#include <Renderer/Renderers/Null/RendererNull.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "Test.h"
+
+// Runs sample graphs on RendererNull and checks the transitions the RenderGraph plans around every pass against what the passes declared
+
+using namespace Renderer;
+using Builder = RenderGraphBuilder;
+
+namespace
+{
+    const size_t ALLOCATOR_SIZE = 4 * 1024 * 1024;
+
+    std::string StateToString(ResourceState state)
+    {
+        const struct { ResourceState state; const char* name; } names[] =
+        {
+            { RESOURCE_STATE_RENDER_TARGET, "RENDER_TARGET" },
+            { RESOURCE_STATE_UNORDERED_ACCESS, "UNORDERED_ACCESS" },
+            { RESOURCE_STATE_DEPTH_WRITE, "DEPTH_WRITE" },
+            { RESOURCE_STATE_DEPTH_READ, "DEPTH_READ" },
+            { RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE, "NON_PIXEL_SHADER_RESOURCE" },
+            { RESOURCE_STATE_PIXEL_SHADER_RESOURCE, "PIXEL_SHADER_RESOURCE" }
+        };
+
+        std::string result;
+        for (auto& name : names)
+        {
+            if (state & name.state)
+            {
+                result += result.empty() ? name.name : std::string("|") + name.name;
+            }
+        }
+        return result.empty() ? "COMMON" : result;
+    }
+
+    // Turns what the graph records into one line per pass marker and one per barrier, so a test can spell out the frame it expects
+    class BarrierRecordingRenderer : public RendererNull
+    {
+    public:
+        void PushMarker(CommandListID commandListID, Vector3 color, std::string name) override
+        {
+            RendererNull::PushMarker(commandListID, color, name);
+            if (name != "RenderGraph")
+            {
+                trace.push_back("pass " + name);
+            }
+        }
+
+        void ResourceBarriers(CommandListID commandListID, const ResourceBarrier* barriers, u32 numBarriers) override
+        {
+            RendererNull::ResourceBarriers(commandListID, barriers, numBarriers);
+            for (u32 i = 0; i < numBarriers; i++)
+            {
+                const ResourceBarrier& barrier = barriers[i];
+                std::string resource = barrier.image != ImageID::Invalid() ? "image" + std::to_string(static_cast<u16>(barrier.image)) : "depth" + std::to_string(static_cast<u16>(barrier.depthImage));
+
+                switch (barrier.type)
+                {
+                    case RESOURCE_BARRIER_TYPE_TRANSITION: trace.push_back(resource + " " + StateToString(barrier.before) + " -> " + StateToString(barrier.after)); break;
+                    case RESOURCE_BARRIER_TYPE_UAV: trace.push_back(resource + " uav"); break;
+                    case RESOURCE_BARRIER_TYPE_ALIASING: trace.push_back(resource + " aliasing"); break;
+                }
+                recordedBarriers.push_back(barrier);
+            }
+        }
+
+        std::vector<std::string> trace;
+        std::vector<ResourceBarrier> recordedBarriers;
+    };
+
+    struct PassData
+    {
+    };
+
+    // A fresh renderer with three images and a depth image, they get IDs 0 to 2 and 0
+    struct SampleScene
+    {
+        SampleScene()
+            : allocator(ALLOCATOR_SIZE)
+        {
+            allocator.Init();
+
+            ImageDesc imageDesc;
+            imageDesc.debugName = "Image";
+            imageDesc.dimensions = Vector2i(64, 64);
+            imageDesc.format = IMAGE_FORMAT_R8G8B8A8_UNORM;
+            for (ImageID& image : images)
+            {
+                image = renderer.CreateImage(imageDesc);
+            }
+
+            DepthImageDesc depthImageDesc;
+            depthImageDesc.debugName = "Depth";
+            depthImageDesc.dimensions = Vector2i(64, 64);
+            depthImageDesc.format = DEPTH_IMAGE_FORMAT_D32_FLOAT;
+            depth = renderer.CreateDepthImage(depthImageDesc);
+        }
+
+        ~SampleScene()
+        {
+            renderer.Deinit();
+        }
+
+        void AddPass(RenderGraph& renderGraph, const char* name, std::function<void(Builder&)> setup)
+        {
+            renderGraph.AddPass<PassData>(name, [setup](PassData&, Builder& builder) { setup(builder); return true; }, [](PassData&, CommandList&) {});
+        }
+
+        BarrierRecordingRenderer renderer;
+        Memory::StackAllocator allocator;
+        ImageID images[3];
+        DepthImageID depth;
+    };
+
+    // Every transition has to start from the state the last one left the resource in, and the frame has to leave everything in its home state
+    bool IsChainedAndReturnsHome(const std::vector<ResourceBarrier>& barriers)
+    {
+        std::vector<u32> imageStates(ImageID::MaxValue() + 1, RESOURCE_STATE_RENDER_TARGET);
+        std::vector<u32> depthStates(DepthImageID::MaxValue() + 1, RESOURCE_STATE_DEPTH_WRITE);
+
+        for (const ResourceBarrier& barrier : barriers)
+        {
+            u32& state = barrier.image != ImageID::Invalid() ? imageStates[static_cast<u16>(barrier.image)] : depthStates[static_cast<u16>(barrier.depthImage)];
+            if (barrier.type == RESOURCE_BARRIER_TYPE_TRANSITION)
+            {
+                if (state != static_cast<u32>(barrier.before))
+                    return false;
+
+                state = barrier.after;
+            }
+            else if (barrier.type == RESOURCE_BARRIER_TYPE_UAV && state != RESOURCE_STATE_UNORDERED_ACCESS)
+            {
+                return false;
+            }
+        }
+
+        for (u32 state : imageStates)
+        {
+            if (state != RESOURCE_STATE_RENDER_TARGET)
+                return false;
+        }
+        for (u32 state : depthStates)
+        {
+            if (state != RESOURCE_STATE_DEPTH_WRITE)
+                return false;
+        }
+        return true;
+    }
+
+    const RenderGraph::TransientPlacement* FindPlacement(SampleScene& scene, RenderGraph& renderGraph, const char* debugName)
+    {
+        TransientResourcePool& pool = scene.renderer.GetTransientResourcePool();
+        for (const RenderGraph::TransientPlacement& placement : renderGraph.GetAliasingPlan())
+        {
+            const std::string& name = placement.isDepth ? pool.GetDepthImageDesc(placement.desc).debugName : pool.GetImageDesc(placement.desc).debugName;
+            if (name == debugName)
+                return &placement;
+        }
+        return nullptr;
+    }
+
+    bool CheckTrace(const std::vector<std::string>& trace, const std::vector<std::string>& expected)
+    {
+        if (trace == expected)
+            return true;
+
+        printf("    Recorded:\n");
+        for (const std::string& line : trace)
+        {
+            printf("        %s\n", line.c_str());
+        }
+        return false;
+    }
+}
+
+TEST(RenderGraphMergesReadsBetweenWrites)
+{
+    SampleScene scene;
+    ImageID albedo = scene.images[0];
+    ImageID lit = scene.images[1];
+
+    RenderGraphDesc desc;
+    desc.allocator = &scene.allocator;
+    RenderGraph renderGraph = scene.renderer.CreateRenderGraph(desc);
+
+    scene.AddPass(renderGraph, "gbuffer", [&](Builder& builder)
+    {
+        builder.Write(albedo, Builder::WRITE_MODE_RENDERTARGET, Builder::LOAD_MODE_CLEAR);
+        builder.Write(scene.depth, Builder::WRITE_MODE_RENDERTARGET, Builder::LOAD_MODE_CLEAR);
+    });
+    scene.AddPass(renderGraph, "lighting", [&](Builder& builder)
+    {
+        builder.Read(albedo, Builder::SHADER_STAGE_PIXEL);
+        builder.Read(scene.depth, Builder::SHADER_STAGE_PIXEL);
+        builder.Write(lit, Builder::WRITE_MODE_RENDERTARGET, Builder::LOAD_MODE_CLEAR);
+    });
+    scene.AddPass(renderGraph, "particles", [&](Builder& builder)
+    {
+        builder.Read(albedo, Builder::SHADER_STAGE_VERTEX);
+        builder.Read(scene.depth, Builder::SHADER_STAGE_NONE);
+        builder.Write(lit, Builder::WRITE_MODE_RENDERTARGET, Builder::LOAD_MODE_LOAD);
+    });
+
+    renderGraph.Setup();
+    renderGraph.Execute();
+
+    // Both readers get what they need from one transition before the first of them
+    CHECK(CheckTrace(scene.renderer.trace,
+    {
+        "pass gbuffer",
+        "image0 RENDER_TARGET -> NON_PIXEL_SHADER_RESOURCE|PIXEL_SHADER_RESOURCE",
+        "depth0 DEPTH_WRITE -> DEPTH_READ|PIXEL_SHADER_RESOURCE",
+        "pass lighting",
+        "pass particles",
+        "image0 NON_PIXEL_SHADER_RESOURCE|PIXEL_SHADER_RESOURCE -> RENDER_TARGET",
+        "depth0 DEPTH_READ|PIXEL_SHADER_RESOURCE -> DEPTH_WRITE"
+    }));
+    CHECK(IsChainedAndReturnsHome(scene.renderer.recordedBarriers));
+}
+
+TEST(RenderGraphSeparatesUnorderedAccessWrites)
+{
+    SampleScene scene;
+    ImageID particles = scene.images[2];
+    ImageID output = scene.images[1];
+
+    RenderGraphDesc desc;
+    desc.allocator = &scene.allocator;
+    RenderGraph renderGraph = scene.renderer.CreateRenderGraph(desc);
+
+    scene.AddPass(renderGraph, "emit", [&](Builder& builder)
+    {
+        builder.Write(particles, Builder::WRITE_MODE_UAV, Builder::LOAD_MODE_LOAD);
+    });
+    scene.AddPass(renderGraph, "simulate", [&](Builder& builder)
+    {
+        builder.Write(particles, Builder::WRITE_MODE_UAV, Builder::LOAD_MODE_LOAD);
+    });
+    scene.AddPass(renderGraph, "draw", [&](Builder& builder)
+    {
+        builder.Read(particles, Builder::SHADER_STAGE_PIXEL);
+        builder.Write(output, Builder::WRITE_MODE_RENDERTARGET, Builder::LOAD_MODE_CLEAR);
+    });
+
+    renderGraph.Setup();
+    renderGraph.Execute();
+
+    // The second write is already in the right state but still has to wait for the first one
+    CHECK(CheckTrace(scene.renderer.trace,
+    {
+        "image2 RENDER_TARGET -> UNORDERED_ACCESS",
+        "pass emit",
+        "image2 uav",
+        "pass simulate",
+        "image2 UNORDERED_ACCESS -> PIXEL_SHADER_RESOURCE",
+        "pass draw",
+        "image2 PIXEL_SHADER_RESOURCE -> RENDER_TARGET"
+    }));
+    CHECK(IsChainedAndReturnsHome(scene.renderer.recordedBarriers));
+}
+
+TEST(RenderGraphReturnsResourcesHomeEveryFrame)
+{
+    SampleScene scene;
+    ImageID shadow = scene.images[0];
+    ImageID backbuffer = scene.images[1];
+
+    // Kept across frames like the Demo does, so the second frame runs the compiled graph again
+    Memory::StackAllocator frameAllocator(ALLOCATOR_SIZE);
+    frameAllocator.Init();
+
+    RenderGraphDesc desc;
+    desc.allocator = &scene.allocator;
+    desc.frameAllocator = &frameAllocator;
+    RenderGraph renderGraph = scene.renderer.CreateRenderGraph(desc);
+
+    scene.AddPass(renderGraph, "prepass", [&](Builder& builder)
+    {
+        builder.Write(scene.depth, Builder::WRITE_MODE_RENDERTARGET, Builder::LOAD_MODE_CLEAR);
+    });
+    scene.AddPass(renderGraph, "shadows", [&](Builder& builder)
+    {
+        builder.Read(scene.depth, Builder::SHADER_STAGE_COMPUTE);
+        builder.Write(shadow, Builder::WRITE_MODE_UAV, Builder::LOAD_MODE_DISCARD);
+    });
+    scene.AddPass(renderGraph, "opaque", [&](Builder& builder)
+    {
+        builder.Read(scene.depth, Builder::SHADER_STAGE_NONE);
+        builder.Read(shadow, Builder::SHADER_STAGE_PIXEL);
+        builder.Write(backbuffer, Builder::WRITE_MODE_RENDERTARGET, Builder::LOAD_MODE_CLEAR);
+    });
+
+    std::vector<std::string> frames[2];
+    for (std::vector<std::string>& frame : frames)
+    {
+        frameAllocator.Reset();
+        scene.renderer.trace.clear();
+        scene.renderer.recordedBarriers.clear();
+
+        renderGraph.Setup();
+        renderGraph.Execute();
+
+        frame = scene.renderer.trace;
+        CHECK(IsChainedAndReturnsHome(scene.renderer.recordedBarriers));
+    }
+
+    CHECK(renderGraph.GetNumCompiles() == 1);
+    CHECK(CheckTrace(frames[0],
+    {
+        "pass prepass",
+        "depth0 DEPTH_WRITE -> DEPTH_READ|NON_PIXEL_SHADER_RESOURCE",
+        "image0 RENDER_TARGET -> UNORDERED_ACCESS",
+        "pass shadows",
+        "image0 UNORDERED_ACCESS -> PIXEL_SHADER_RESOURCE",
+        "pass opaque",
+        "image0 PIXEL_SHADER_RESOURCE -> RENDER_TARGET",
+        "depth0 DEPTH_READ|NON_PIXEL_SHADER_RESOURCE -> DEPTH_WRITE"
+    }));
+    CHECK(CheckTrace(frames[1], frames[0]));
+}
+
+TEST(RenderGraphTransientsStartAndEndHome)
+{
+    SampleScene scene;
+    ImageID backbuffer = scene.images[0];
+
+    RenderGraphDesc desc;
+    desc.allocator = &scene.allocator;
+    RenderGraph renderGraph = scene.renderer.CreateRenderGraph(desc);
+
+    ImageDesc hdrDesc;
+    hdrDesc.debugName = "HDR";
+    hdrDesc.dimensions = Vector2i(256, 256);
+    hdrDesc.format = IMAGE_FORMAT_R16G16B16A16_FLOAT;
+
+    ImageDesc bloomDesc = hdrDesc;
+    bloomDesc.debugName = "Bloom";
+    bloomDesc.dimensions = Vector2i(128, 128);
+
+    DepthImageDesc depthDesc;
+    depthDesc.debugName = "SceneDepth";
+    depthDesc.dimensions = Vector2i(256, 256);
+
+    ImageID hdr;
+    ImageID bloom;
+    ImageID blurred;
+    DepthImageID depth;
+    scene.AddPass(renderGraph, "scene", [&](Builder& builder)
+    {
+        hdr = builder.Create(hdrDesc);
+        depth = builder.Create(depthDesc);
+        builder.Write(hdr, Builder::WRITE_MODE_RENDERTARGET, Builder::LOAD_MODE_CLEAR);
+        builder.Write(depth, Builder::WRITE_MODE_RENDERTARGET, Builder::LOAD_MODE_CLEAR);
+    });
+    scene.AddPass(renderGraph, "bright", [&](Builder& builder)
+    {
+        bloom = builder.Create(bloomDesc);
+        builder.Read(hdr, Builder::SHADER_STAGE_COMPUTE);
+        builder.Write(bloom, Builder::WRITE_MODE_UAV, Builder::LOAD_MODE_DISCARD);
+    });
+    scene.AddPass(renderGraph, "blur", [&](Builder& builder)
+    {
+        blurred = builder.Create(bloomDesc);
+        builder.Read(bloom, Builder::SHADER_STAGE_COMPUTE);
+        builder.Write(blurred, Builder::WRITE_MODE_UAV, Builder::LOAD_MODE_DISCARD);
+    });
+    scene.AddPass(renderGraph, "composite", [&](Builder& builder)
+    {
+        builder.Read(hdr, Builder::SHADER_STAGE_PIXEL);
+        builder.Read(blurred, Builder::SHADER_STAGE_PIXEL);
+        builder.Read(depth, Builder::SHADER_STAGE_PIXEL);
+        builder.Write(backbuffer, Builder::WRITE_MODE_RENDERTARGET, Builder::LOAD_MODE_CLEAR);
+    });
+
+    renderGraph.Setup();
+    renderGraph.Execute();
+
+    // Transients that share memory go through aliasing barriers, but every one of them starts and ends in its home state like the imported images
+    u32 numAliasingBarriers = 0;
+    for (const ResourceBarrier& barrier : scene.renderer.recordedBarriers)
+    {
+        numAliasingBarriers += barrier.type == RESOURCE_BARRIER_TYPE_ALIASING ? 1 : 0;
+    }
+    CHECK(numAliasingBarriers == 4);
+    CHECK(IsChainedAndReturnsHome(scene.renderer.recordedBarriers));
+    CHECK(scene.renderer.GetStats().numValidationErrors == 0);
+}
+
+namespace
+{
+    // Three transients of the same size where every one of them is written by one pass and read by the next, so the first and the last never live at the same time
+    void AddTransientChain(SampleScene& scene, RenderGraph& renderGraph, Builder::Queue blurQueue)
+    {
+        static ImageDesc descs[3];
+        const char* names[3] = { "Scene", "Bright", "Blur" };
+        for (u32 i = 0; i < 3; i++)
+        {
+            descs[i].debugName = names[i];
+            descs[i].dimensions = Vector2i(1024, 1024);
+            descs[i].format = IMAGE_FORMAT_R16G16B16A16_FLOAT;
+            descs[i].clearColor = Vector4(static_cast<f32>(i), 0.0f, 0.0f, 1.0f); // Keeps the pool from sharing one desc, and so one debug name, between them
+        }
+
+        static ImageID transients[3];
+        ImageID backbuffer = scene.images[0];
+        scene.AddPass(renderGraph, "scene", [](Builder& builder)
+        {
+            transients[0] = builder.Create(descs[0]);
+            builder.Write(transients[0], Builder::WRITE_MODE_RENDERTARGET, Builder::LOAD_MODE_CLEAR);
+        });
+        scene.AddPass(renderGraph, "bright", [](Builder& builder)
+        {
+            transients[1] = builder.Create(descs[1]);
+            builder.Read(transients[0], Builder::SHADER_STAGE_COMPUTE);
+            builder.Write(transients[1], Builder::WRITE_MODE_UAV, Builder::LOAD_MODE_DISCARD);
+        });
+        scene.AddPass(renderGraph, "blur", [blurQueue](Builder& builder)
+        {
+            builder.SetQueue(blurQueue);
+            transients[2] = builder.Create(descs[2]);
+            builder.Read(transients[1], Builder::SHADER_STAGE_COMPUTE);
+            builder.Write(transients[2], Builder::WRITE_MODE_UAV, Builder::LOAD_MODE_DISCARD);
+        });
+        scene.AddPass(renderGraph, "composite", [backbuffer](Builder& builder)
+        {
+            builder.Read(transients[2], Builder::SHADER_STAGE_PIXEL);
+            builder.Write(backbuffer, Builder::WRITE_MODE_RENDERTARGET, Builder::LOAD_MODE_CLEAR);
+        });
+    }
+
+    const size_t TRANSIENT_SIZE = 1024 * 1024 * 8; // 1024x1024 at 8 bytes per pixel
+}
+
+TEST(RenderGraphAliasesTransientsThatNeverLiveTogether)
+{
+    SampleScene scene;
+
+    RenderGraphDesc desc;
+    desc.allocator = &scene.allocator;
+    RenderGraph renderGraph = scene.renderer.CreateRenderGraph(desc);
+    AddTransientChain(scene, renderGraph, Builder::QUEUE_GRAPHICS);
+
+    renderGraph.Setup();
+    renderGraph.Execute();
+
+    const RenderGraph::TransientPlacement* sceneImage = FindPlacement(scene, renderGraph, "Scene");
+    const RenderGraph::TransientPlacement* bright = FindPlacement(scene, renderGraph, "Bright");
+    const RenderGraph::TransientPlacement* blur = FindPlacement(scene, renderGraph, "Blur");
+    CHECK(sceneImage != nullptr && bright != nullptr && blur != nullptr);
+    if (sceneImage == nullptr || bright == nullptr || blur == nullptr)
+        return;
+
+    // Scene lives in the first two passes and Blur in the last two, Bright overlaps both
+    CHECK(sceneImage->firstPass == 0 && sceneImage->lastPass == 1);
+    CHECK(bright->firstPass == 1 && bright->lastPass == 2);
+    CHECK(blur->firstPass == 2 && blur->lastPass == 3);
+
+    CHECK(sceneImage->block == blur->block && sceneImage->offset == blur->offset);
+    CHECK(bright->block != sceneImage->block || bright->offset >= sceneImage->offset + sceneImage->size || sceneImage->offset >= bright->offset + bright->size);
+
+    CHECK(renderGraph.GetTransientBytesRequested() == 3 * TRANSIENT_SIZE);
+    CHECK(renderGraph.GetTransientBytesAllocated() == 2 * TRANSIENT_SIZE);
+    CHECK(renderGraph.GetTransientBytesRequested() - renderGraph.GetTransientBytesAllocated() == TRANSIENT_SIZE);
+    CHECK(scene.renderer.GetStats().numValidationErrors == 0);
+}
+
+TEST(RenderGraphKeepsAsyncTransientsForTheWholeGraph)
+{
+    SampleScene scene;
+
+    RenderGraphDesc desc;
+    desc.allocator = &scene.allocator;
+    RenderGraph renderGraph = scene.renderer.CreateRenderGraph(desc);
+    AddTransientChain(scene, renderGraph, Builder::QUEUE_ASYNC_COMPUTE);
+
+    renderGraph.Setup();
+    renderGraph.Execute();
+
+    const RenderGraph::TransientPlacement* sceneImage = FindPlacement(scene, renderGraph, "Scene");
+    const RenderGraph::TransientPlacement* bright = FindPlacement(scene, renderGraph, "Bright");
+    const RenderGraph::TransientPlacement* blur = FindPlacement(scene, renderGraph, "Blur");
+    CHECK(sceneImage != nullptr && bright != nullptr && blur != nullptr);
+    if (sceneImage == nullptr || bright == nullptr || blur == nullptr)
+        return;
+
+    // Blur runs on the async compute queue, so it and Bright which it reads overlap whatever the graphics queue does and keep their memory from the first pass to the last
+    CHECK(renderGraph.GetPassQueue(2) == Builder::QUEUE_ASYNC_COMPUTE);
+    CHECK(bright->firstPass == 0 && bright->lastPass == 3);
+    CHECK(blur->firstPass == 0 && blur->lastPass == 3);
+    CHECK(sceneImage->firstPass == 0 && sceneImage->lastPass == 1);
+
+    CHECK(sceneImage->offset != blur->offset || sceneImage->block != blur->block);
+    CHECK(renderGraph.GetTransientBytesRequested() == 3 * TRANSIENT_SIZE);
+    CHECK(renderGraph.GetTransientBytesAllocated() == 3 * TRANSIENT_SIZE);
+    CHECK(IsChainedAndReturnsHome(scene.renderer.recordedBarriers));
+}
+
+TEST(RenderGraphRecompilesOnlyWhenTheTopologyChanges)
+{
+    SampleScene scene;
+    ImageID backbuffer = scene.images[0];
+
+    Memory::StackAllocator frameAllocator(ALLOCATOR_SIZE);
+    frameAllocator.Init();
+
+    RenderGraphDesc desc;
+    desc.allocator = &scene.allocator;
+    desc.frameAllocator = &frameAllocator;
+    RenderGraph renderGraph = scene.renderer.CreateRenderGraph(desc);
+
+    bool clearBackbuffer = true;
+    scene.AddPass(renderGraph, "opaque", [&](Builder& builder)
+    {
+        builder.Write(scene.depth, Builder::WRITE_MODE_RENDERTARGET, Builder::LOAD_MODE_CLEAR);
+        builder.Write(backbuffer, Builder::WRITE_MODE_RENDERTARGET, clearBackbuffer ? Builder::LOAD_MODE_CLEAR : Builder::LOAD_MODE_LOAD);
+    });
+
+    // Only the previous compile is kept, so going back to the first topology compiles it again
+    const bool clears[] = { true, true, false, false, true };
+    const u32 expectedCompiles[] = { 1, 1, 2, 2, 3 };
+    for (u32 frame = 0; frame < 5; frame++)
+    {
+        frameAllocator.Reset();
+        scene.renderer.recordedBarriers.clear();
+        clearBackbuffer = clears[frame];
+
+        renderGraph.Setup();
+        renderGraph.Execute();
+
+        CHECK(renderGraph.GetNumCompiles() == expectedCompiles[frame]);
+        CHECK(IsChainedAndReturnsHome(scene.renderer.recordedBarriers));
+    }
+}
+
+namespace
+{
+    const u32 PASS_NOT_EXECUTING = 0xFFFFFFFF;
+
+    u32 FindExecutingPass(RenderGraph& renderGraph, const char* name)
+    {
+        for (u32 i = 0; i < renderGraph.GetNumExecutingPasses(); i++)
+        {
+            if (std::string(renderGraph.GetExecutingPassName(i)) == name)
+                return i;
+        }
+        return PASS_NOT_EXECUTING;
+    }
+
+    bool CheckSyncs(RenderGraph& renderGraph, const std::vector<RenderGraph::QueueSync>& expected)
+    {
+        const std::vector<RenderGraph::QueueSync>& syncs = renderGraph.GetQueueSyncs();
+        bool matches = syncs.size() == expected.size();
+        for (size_t i = 0; i < syncs.size() && matches; i++)
+        {
+            matches = syncs[i].signalPass == expected[i].signalPass && syncs[i].waitPass == expected[i].waitPass;
+        }
+
+        if (!matches)
+        {
+            printf("    Queue syncs:\n");
+            for (const RenderGraph::QueueSync& sync : syncs)
+            {
+                printf("      %s -> %s\n", renderGraph.GetExecutingPassName(sync.signalPass), renderGraph.GetExecutingPassName(sync.waitPass));
+            }
+        }
+        return matches;
+    }
+}
+
+TEST(RenderGraphKeepsRasterizingPassesOnTheGraphicsQueue)
+{
+    SampleScene scene;
+
+    RenderGraphDesc desc;
+    desc.allocator = &scene.allocator;
+    RenderGraph renderGraph = scene.renderer.CreateRenderGraph(desc);
+
+    scene.AddPass(renderGraph, "raster", [&](Builder& builder)
+    {
+        builder.SetQueue(Builder::QUEUE_ASYNC_COMPUTE);
+        builder.Write(scene.images[0], Builder::WRITE_MODE_RENDERTARGET, Builder::LOAD_MODE_CLEAR);
+    });
+    scene.AddPass(renderGraph, "shade", [&](Builder& builder)
+    {
+        builder.SetQueue(Builder::QUEUE_ASYNC_COMPUTE);
+        builder.Read(scene.depth, Builder::SHADER_STAGE_PIXEL);
+        builder.Write(scene.images[1], Builder::WRITE_MODE_UAV, Builder::LOAD_MODE_LOAD);
+    });
+    scene.AddPass(renderGraph, "compute", [&](Builder& builder)
+    {
+        builder.SetQueue(Builder::QUEUE_ASYNC_COMPUTE);
+        builder.Read(scene.depth, Builder::SHADER_STAGE_COMPUTE);
+        builder.Write(scene.images[2], Builder::WRITE_MODE_UAV, Builder::LOAD_MODE_LOAD);
+    });
+
+    renderGraph.Setup();
+    renderGraph.Execute();
+
+    u32 raster = FindExecutingPass(renderGraph, "raster");
+    u32 shade = FindExecutingPass(renderGraph, "shade");
+    u32 compute = FindExecutingPass(renderGraph, "compute");
+    CHECK(raster != PASS_NOT_EXECUTING && shade != PASS_NOT_EXECUTING && compute != PASS_NOT_EXECUTING);
+    if (raster == PASS_NOT_EXECUTING || shade == PASS_NOT_EXECUTING || compute == PASS_NOT_EXECUTING)
+        return;
+
+    // Rendering to a target and reading in a pixel shader both need the graphics queue, only the pass doing neither stays async
+    CHECK(renderGraph.GetPassQueue(raster) == Builder::QUEUE_GRAPHICS);
+    CHECK(renderGraph.GetPassQueue(shade) == Builder::QUEUE_GRAPHICS);
+    CHECK(renderGraph.GetPassQueue(compute) == Builder::QUEUE_ASYNC_COMPUTE);
+    CHECK(CheckSyncs(renderGraph, {}));
+}
+
+TEST(RenderGraphSyncsQueuesOnlyAcrossDependencies)
+{
+    SampleScene scene;
+
+    RenderGraphDesc desc;
+    desc.allocator = &scene.allocator;
+    RenderGraph renderGraph = scene.renderer.CreateRenderGraph(desc);
+
+    scene.AddPass(renderGraph, "scene", [&](Builder& builder)
+    {
+        builder.Write(scene.images[0], Builder::WRITE_MODE_RENDERTARGET, Builder::LOAD_MODE_CLEAR);
+    });
+    scene.AddPass(renderGraph, "ssao", [&](Builder& builder)
+    {
+        builder.SetQueue(Builder::QUEUE_ASYNC_COMPUTE);
+        builder.Read(scene.images[0], Builder::SHADER_STAGE_COMPUTE);
+        builder.Write(scene.images[1], Builder::WRITE_MODE_UAV, Builder::LOAD_MODE_DISCARD);
+    });
+    scene.AddPass(renderGraph, "composite", [&](Builder& builder)
+    {
+        builder.Read(scene.images[1], Builder::SHADER_STAGE_PIXEL);
+        builder.Write(scene.images[2], Builder::WRITE_MODE_RENDERTARGET, Builder::LOAD_MODE_CLEAR);
+    });
+
+    renderGraph.Setup();
+    renderGraph.Execute();
+
+    CHECK(renderGraph.GetNumExecutingPasses() == 3);
+    CHECK(renderGraph.GetPassQueue(0) == Builder::QUEUE_GRAPHICS);
+    CHECK(renderGraph.GetPassQueue(1) == Builder::QUEUE_ASYNC_COMPUTE);
+    CHECK(renderGraph.GetPassQueue(2) == Builder::QUEUE_GRAPHICS);
+
+    // The async pass waits for the scene it reads, and the composite waits for the async pass, nothing else
+    CHECK(CheckSyncs(renderGraph, { { 0, 1 }, { 1, 2 } }));
+    CHECK(IsChainedAndReturnsHome(scene.renderer.recordedBarriers));
+}
+
+TEST(RenderGraphSkipsSyncsAnEarlierWaitCovers)
+{
+    SampleScene scene;
+
+    RenderGraphDesc desc;
+    desc.allocator = &scene.allocator;
+    RenderGraph renderGraph = scene.renderer.CreateRenderGraph(desc);
+
+    scene.AddPass(renderGraph, "scene", [&](Builder& builder)
+    {
+        builder.Write(scene.images[0], Builder::WRITE_MODE_RENDERTARGET, Builder::LOAD_MODE_CLEAR);
+        builder.Write(scene.depth, Builder::WRITE_MODE_RENDERTARGET, Builder::LOAD_MODE_CLEAR);
+    });
+    scene.AddPass(renderGraph, "ssao", [&](Builder& builder)
+    {
+        builder.SetQueue(Builder::QUEUE_ASYNC_COMPUTE);
+        builder.Read(scene.images[0], Builder::SHADER_STAGE_COMPUTE);
+        builder.Write(scene.images[1], Builder::WRITE_MODE_UAV, Builder::LOAD_MODE_DISCARD);
+    });
+    scene.AddPass(renderGraph, "fog", [&](Builder& builder)
+    {
+        builder.SetQueue(Builder::QUEUE_ASYNC_COMPUTE);
+        builder.Read(scene.depth, Builder::SHADER_STAGE_COMPUTE);
+        builder.Write(scene.images[2], Builder::WRITE_MODE_UAV, Builder::LOAD_MODE_DISCARD);
+    });
+    scene.AddPass(renderGraph, "composite", [&](Builder& builder)
+    {
+        builder.Read(scene.images[1], Builder::SHADER_STAGE_PIXEL);
+        builder.Read(scene.images[2], Builder::SHADER_STAGE_PIXEL);
+        builder.Write(scene.images[0], Builder::WRITE_MODE_RENDERTARGET, Builder::LOAD_MODE_LOAD);
+    });
+
+    renderGraph.Setup();
+    renderGraph.Execute();
+
+    CHECK(renderGraph.GetNumExecutingPasses() == 4);
+    CHECK(renderGraph.GetPassQueue(1) == Builder::QUEUE_ASYNC_COMPUTE);
+    CHECK(renderGraph.GetPassQueue(2) == Builder::QUEUE_ASYNC_COMPUTE);
+
+    // The async queue already waited for the scene before ssao, so fog doesn't wait again, and waiting for fog covers ssao before it on the same queue
+    CHECK(CheckSyncs(renderGraph, { { 0, 1 }, { 2, 3 } }));
+    CHECK(IsChainedAndReturnsHome(scene.renderer.recordedBarriers));
+}
\ No newline at end of file
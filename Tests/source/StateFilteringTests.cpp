@@ -0,0 +1,327 @@
+#include <Core.h>
+#include <Jobs/JobSystem.h>
+#include <Memory/StackAllocator.h>
+#include <Memory/PerThreadStackAllocator.h>
+#include <Profiling/FrameStats.h>
+#include <Renderer/Renderers/Null/RendererNull.h>
+
+#include <random>
+#include <vector>
+
+#include "Test.h"
+
+// CommandList drops state commands that wouldn't change what's bound, these record the same commands with filtering and check that a backend applying
+// only what got through ends up drawing with exactly what it would have drawn with if every command had reached it
+
+using namespace Renderer;
+using Builder = RenderGraphBuilder;
+
+namespace
+{
+    const u32 NUM_SLOTS = 3;
+    const i32 MATERIAL_PIPELINE_OFFSET = 1000; // Material pipelines share one number space with graphics pipelines in DrawState
+    const size_t ALLOCATOR_SIZE = 4 * 1024 * 1024;
+    const size_t THREAD_ALLOCATOR_SIZE = 1 * 1024 * 1024;
+
+    enum OpType
+    {
+        OP_TYPE_GRAPHICS_PIPELINE,
+        OP_TYPE_MATERIAL_PIPELINE,
+        OP_TYPE_VIEWPORT,
+        OP_TYPE_SCISSOR_RECT,
+        OP_TYPE_CONSTANT_BUFFER,
+        OP_TYPE_DRAW,
+        OP_TYPE_COUNT
+    };
+
+    struct Op
+    {
+        OpType type;
+        u32 value; // Pipeline, viewport width, scissor right, constant buffer or model
+        u32 slot = 0;
+    };
+
+    // What a draw sees bound
+    struct DrawState
+    {
+        i32 pipeline = -1;
+        f32 viewportWidth = -1.0f;
+        i32 scissorRight = -1;
+        void* constantBuffers[NUM_SLOTS] = {};
+        u32 model = 0;
+
+        bool operator==(const DrawState& other) const
+        {
+            for (u32 i = 0; i < NUM_SLOTS; i++)
+            {
+                if (constantBuffers[i] != other.constantBuffers[i])
+                    return false;
+            }
+            return pipeline == other.pipeline && viewportWidth == other.viewportWidth && scissorRight == other.scissorRight && model == other.model;
+        }
+
+        // Binding a different pipeline unbinds the constant buffers, binding the same one again keeps them like it does in DX12
+        void SetPipeline(i32 newPipeline)
+        {
+            if (pipeline != newPipeline)
+            {
+                for (void*& constantBuffer : constantBuffers)
+                {
+                    constantBuffer = nullptr;
+                }
+            }
+            pipeline = newPipeline;
+        }
+    };
+
+    void* _constantBuffers[4];
+
+    // Applies the state commands that reach it and notes what every draw sees, none of the IDs exist so RendererNull's validation is left out
+    class StateTrackingRenderer : public RendererNull
+    {
+    public:
+        using RendererNull::SetPipeline; // Compute pipelines stay with RendererNull
+
+        void SetPipeline(CommandListID /*commandListID*/, GraphicsPipelineID pipeline) override { state.SetPipeline(static_cast<u16>(pipeline)); numStateCommands++; }
+        void SetPipeline(CommandListID /*commandListID*/, MaterialPipelineID pipeline) override { state.SetPipeline(MATERIAL_PIPELINE_OFFSET + static_cast<u16>(pipeline)); numStateCommands++; }
+        void SetViewport(CommandListID /*commandListID*/, Viewport viewport) override { state.viewportWidth = viewport.width; numStateCommands++; }
+        void SetScissorRect(CommandListID /*commandListID*/, ScissorRect scissorRect) override { state.scissorRight = scissorRect.right; numStateCommands++; }
+        void SetConstantBuffer(CommandListID /*commandListID*/, u32 slot, void* gpuResource) override { state.constantBuffers[slot] = gpuResource; numStateCommands++; }
+
+        void Draw(CommandListID /*commandListID*/, ModelID model) override
+        {
+            DrawState drawState = state;
+            drawState.model = static_cast<u16>(model);
+            draws.push_back(drawState);
+        }
+
+        DrawState state;
+        std::vector<DrawState> draws;
+        u32 numStateCommands = 0;
+    };
+
+    void Record(CommandList& commandList, const std::vector<Op>& ops)
+    {
+        for (const Op& op : ops)
+        {
+            switch (op.type)
+            {
+                case OP_TYPE_GRAPHICS_PIPELINE: commandList.SetPipeline(GraphicsPipelineID(static_cast<u16>(op.value))); break;
+                case OP_TYPE_MATERIAL_PIPELINE: commandList.SetPipeline(MaterialPipelineID(static_cast<u16>(op.value))); break;
+                case OP_TYPE_VIEWPORT: commandList.SetViewport(0.0f, 0.0f, static_cast<f32>(op.value), 1.0f, 0.0f, 1.0f); break;
+                case OP_TYPE_SCISSOR_RECT: commandList.SetScissorRect(0, op.value, 0, 1); break;
+                case OP_TYPE_CONSTANT_BUFFER: commandList.SetConstantBuffer(op.slot, &_constantBuffers[op.value]); break;
+                case OP_TYPE_DRAW: commandList.Draw(ModelID(static_cast<u16>(op.value))); break;
+                default: break;
+            }
+        }
+    }
+
+    // What every draw sees when every command reaches the backend
+    std::vector<DrawState> GetUnfilteredDraws(const std::vector<std::vector<Op>>& passes, u32& numStateCommands)
+    {
+        DrawState state;
+        std::vector<DrawState> draws;
+        numStateCommands = 0;
+
+        for (const std::vector<Op>& ops : passes)
+        {
+            for (const Op& op : ops)
+            {
+                numStateCommands += op.type != OP_TYPE_DRAW ? 1 : 0;
+                switch (op.type)
+                {
+                    case OP_TYPE_GRAPHICS_PIPELINE: state.SetPipeline(static_cast<i32>(op.value)); break;
+                    case OP_TYPE_MATERIAL_PIPELINE: state.SetPipeline(MATERIAL_PIPELINE_OFFSET + static_cast<i32>(op.value)); break;
+                    case OP_TYPE_VIEWPORT: state.viewportWidth = static_cast<f32>(op.value); break;
+                    case OP_TYPE_SCISSOR_RECT: state.scissorRight = static_cast<i32>(op.value); break;
+                    case OP_TYPE_CONSTANT_BUFFER: state.constantBuffers[op.slot] = &_constantBuffers[op.value]; break;
+                    case OP_TYPE_DRAW:
+                    {
+                        DrawState drawState = state;
+                        drawState.model = op.value;
+                        draws.push_back(drawState);
+                        break;
+                    }
+                    default: break;
+                }
+            }
+        }
+
+        return draws;
+    }
+
+    struct PassData
+    {
+    };
+
+    // Records every list of ops as its own pass of one frame, the passes all draw to the same image so they share a render pass and state carries over between them.
+    // Returns the commands filtered according to FrameStats
+    u64 RecordFrame(StateTrackingRenderer& renderer, const std::vector<std::vector<Op>>& passes, Memory::PerThreadStackAllocator* threadAllocator)
+    {
+        ImageDesc imageDesc;
+        imageDesc.debugName = "Target";
+        imageDesc.dimensions = Vector2i(64, 64);
+        imageDesc.format = IMAGE_FORMAT_R8G8B8A8_UNORM;
+        ImageID target = renderer.CreateImage(imageDesc);
+
+        Memory::StackAllocator allocator(ALLOCATOR_SIZE);
+        allocator.Init();
+
+        RenderGraphDesc desc;
+        desc.allocator = &allocator;
+        desc.threadAllocator = threadAllocator;
+        RenderGraph renderGraph = renderer.CreateRenderGraph(desc);
+
+        for (const std::vector<Op>& ops : passes)
+        {
+            const std::vector<Op>* passOps = &ops;
+            renderGraph.AddPass<PassData>("Pass",
+                [target](PassData&, Builder& builder)
+                {
+                    builder.Write(target, Builder::WRITE_MODE_RENDERTARGET, Builder::LOAD_MODE_LOAD);
+                    return true;
+                },
+                [passOps](PassData&, CommandList& commandList)
+                {
+                    Record(commandList, *passOps);
+                });
+        }
+
+        Profiling::FrameStats::EndFrame(); // Leaves whatever was counted before this frame in the last one
+        renderGraph.Setup();
+        renderGraph.Execute();
+        Profiling::FrameStats::EndFrame();
+
+        if (threadAllocator != nullptr)
+        {
+            threadAllocator->Reset();
+        }
+
+        return Profiling::FrameStats::GetLastFrameCounter(Profiling::FRAME_COUNTER_COMMANDS_FILTERED);
+    }
+
+    std::vector<std::vector<Op>> GetRandomPasses(std::mt19937& random)
+    {
+        // Few distinct values so most commands repeat what's already bound
+        std::vector<std::vector<Op>> passes(1 + random() % 4);
+        for (std::vector<Op>& ops : passes)
+        {
+            u32 numOps = 50 + random() % 100;
+            for (u32 i = 0; i < numOps; i++)
+            {
+                Op op;
+                op.type = static_cast<OpType>(random() % OP_TYPE_COUNT);
+                switch (op.type)
+                {
+                    case OP_TYPE_GRAPHICS_PIPELINE: op.value = random() % 3; break;
+                    case OP_TYPE_MATERIAL_PIPELINE: op.value = random() % 2; break;
+                    case OP_TYPE_VIEWPORT: op.value = 1 + random() % 2; break;
+                    case OP_TYPE_SCISSOR_RECT: op.value = 1 + random() % 2; break;
+                    case OP_TYPE_CONSTANT_BUFFER: op.value = random() % 3; op.slot = random() % NUM_SLOTS; break;
+                    default: op.value = random() % 5; break;
+                }
+                ops.push_back(op);
+            }
+        }
+        return passes;
+    }
+}
+
+TEST(StateFilteringDropsRedundantMaterialState)
+{
+    // Like the Demo's material loop, every material sets its pipeline, scissor rect, viewport and view constants and then every instance sets its own constants.
+    // The second and third material share a pipeline
+    std::vector<Op> ops;
+    const u32 materialPipelines[] = { 0, 1, 1 };
+    for (u32 materialPipeline : materialPipelines)
+    {
+        ops.push_back({ OP_TYPE_MATERIAL_PIPELINE, materialPipeline });
+        ops.push_back({ OP_TYPE_SCISSOR_RECT, 1280 });
+        ops.push_back({ OP_TYPE_VIEWPORT, 1280 });
+        ops.push_back({ OP_TYPE_CONSTANT_BUFFER, 0, 0 });
+        for (u32 instance = 1; instance < 4; instance++)
+        {
+            ops.push_back({ OP_TYPE_CONSTANT_BUFFER, instance, 1 });
+            ops.push_back({ OP_TYPE_DRAW, instance });
+        }
+    }
+    std::vector<std::vector<Op>> passes = { ops };
+
+    StateTrackingRenderer renderer;
+    u64 numFiltered = RecordFrame(renderer, passes, nullptr);
+
+    u32 numStateCommands = 0;
+    std::vector<DrawState> unfilteredDraws = GetUnfilteredDraws(passes, numStateCommands);
+
+    // The second material keeps the scissor rect and viewport, the third also keeps the pipeline and view constants
+    CHECK(numFiltered == 6);
+    CHECK(renderer.numStateCommands + numFiltered == numStateCommands);
+    CHECK(renderer.draws == unfilteredDraws);
+
+    renderer.Deinit();
+}
+
+TEST(StateFilteringMatchesUnfilteredCommands)
+{
+    const u32 NUM_SEQUENCES = 100;
+
+    u64 totalFiltered = 0;
+    u32 numMismatches = 0;
+    for (u32 seed = 0; seed < NUM_SEQUENCES; seed++)
+    {
+        std::mt19937 random(seed);
+        std::vector<std::vector<Op>> passes = GetRandomPasses(random);
+
+        StateTrackingRenderer renderer;
+        u64 numFiltered = RecordFrame(renderer, passes, nullptr);
+
+        u32 numStateCommands = 0;
+        std::vector<DrawState> unfilteredDraws = GetUnfilteredDraws(passes, numStateCommands);
+
+        numMismatches += renderer.draws == unfilteredDraws && renderer.numStateCommands + numFiltered == numStateCommands ? 0 : 1;
+        totalFiltered += numFiltered;
+
+        renderer.Deinit();
+    }
+
+    CHECK(numMismatches == 0);
+    CHECK(totalFiltered > 0);
+}
+
+TEST(StateFilteringMatchesUnfilteredCommandsRecordedInParallel)
+{
+    const u32 NUM_SEQUENCES = 100;
+
+    // Every pass gets recorded into its own list on a worker and appended after the others, so filtering starts over for every pass
+    Jobs::JobSystemDesc jobSystemDesc;
+    jobSystemDesc.numWorkers = 3;
+    Jobs::JobSystem::Init(jobSystemDesc);
+
+    Memory::PerThreadStackAllocator threadAllocator(THREAD_ALLOCATOR_SIZE);
+    threadAllocator.Init();
+
+    u64 totalFiltered = 0;
+    u32 numMismatches = 0;
+    for (u32 seed = 0; seed < NUM_SEQUENCES; seed++)
+    {
+        std::mt19937 random(seed);
+        std::vector<std::vector<Op>> passes = GetRandomPasses(random);
+
+        StateTrackingRenderer renderer;
+        u64 numFiltered = RecordFrame(renderer, passes, &threadAllocator);
+
+        u32 numStateCommands = 0;
+        std::vector<DrawState> unfilteredDraws = GetUnfilteredDraws(passes, numStateCommands);
+
+        numMismatches += renderer.draws == unfilteredDraws && renderer.numStateCommands + numFiltered == numStateCommands ? 0 : 1;
+        totalFiltered += numFiltered;
+
+        renderer.Deinit();
+    }
+
+    CHECK(numMismatches == 0);
+    CHECK(totalFiltered > 0);
+
+    Jobs::JobSystem::Shutdown();
+}
\ No newline at end of file
@@ -0,0 +1,67 @@
+#pragma once
+#include <Core.h>
+#include <chrono>
+
+// A minimal test runner, TEST and BENCHMARK register a function that main runs by name.
+// Tests run by default, benchmarks only with --benchmarks since they take a while and their results need reading.
+namespace Tests
+{
+    typedef void (*TestFunction)();
+
+    struct TestCase
+    {
+        const char* name = nullptr;
+        TestFunction function = nullptr;
+        bool isBenchmark = false;
+    };
+
+    class TestRegistry
+    {
+    public:
+        static void Register(const char* name, TestFunction function, bool isBenchmark);
+        static int Run(int argc, char* argv[]);
+
+        // Called by CHECK, marks the running test as failed but lets it carry on
+        static void Fail(const char* file, int line, const char* expression);
+
+    private:
+        static const u32 MAX_TESTS = 256;
+        static TestCase _tests[MAX_TESTS];
+        static u32 _numTests;
+        static u32 _numFailedChecks;
+    };
+
+    struct TestRegistrar
+    {
+        TestRegistrar(const char* name, TestFunction function, bool isBenchmark) { TestRegistry::Register(name, function, isBenchmark); }
+    };
+
+    // Milliseconds function takes, the fastest of iterations runs
+    template <typename Function>
+    f64 MeasureMS(u32 iterations, const Function& function)
+    {
+        f64 fastest = 0.0;
+        for (u32 i = 0; i < iterations; i++)
+        {
+            std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+            function();
+            f64 ms = std::chrono::duration<f64, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+            fastest = (i == 0 || ms < fastest) ? ms : fastest;
+        }
+        return fastest;
+    }
+}
+
+#define TEST(name) \
+    static void name(); \
+    static Tests::TestRegistrar name##Registrar(#name, name, false); \
+    static void name()
+
+#define BENCHMARK(name) \
+    static void name(); \
+    static Tests::TestRegistrar name##Registrar(#name, name, true); \
+    static void name()
+
+#define CHECK(expression) \
+    do { if (!(expression)) Tests::TestRegistry::Fail(__FILE__, __LINE__, #expression); } while (false)
\ No newline at end of file
@@ -0,0 +1,87 @@
+#include <Core.h>
+#include <Logging/Logger.h>
+
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+
+#include "Test.h"
+
+namespace Tests
+{
+    TestCase TestRegistry::_tests[TestRegistry::MAX_TESTS];
+    u32 TestRegistry::_numTests = 0;
+    u32 TestRegistry::_numFailedChecks = 0;
+
+    void TestRegistry::Register(const char* name, TestFunction function, bool isBenchmark)
+    {
+        assert(_numTests < MAX_TESTS); // Bump MAX_TESTS
+        _tests[_numTests].name = name;
+        _tests[_numTests].function = function;
+        _tests[_numTests].isBenchmark = isBenchmark;
+        _numTests++;
+    }
+
+    void TestRegistry::Fail(const char* file, int line, const char* expression)
+    {
+        printf("    %s(%i): CHECK(%s) failed\n", file, line, expression);
+        _numFailedChecks++;
+    }
+
+    // Tests [--benchmarks] [filter], filter runs only the tests and benchmarks with it in their name
+    int TestRegistry::Run(int argc, char* argv[])
+    {
+        bool runBenchmarks = false;
+        const char* filter = nullptr;
+        for (int i = 1; i < argc; i++)
+        {
+            if (strcmp(argv[i], "--benchmarks") == 0)
+            {
+                runBenchmarks = true;
+            }
+            else
+            {
+                filter = argv[i];
+            }
+        }
+
+        u32 numRun = 0;
+        u32 numFailed = 0;
+        for (u32 i = 0; i < _numTests; i++)
+        {
+            const TestCase& test = _tests[i];
+            if (test.isBenchmark && !runBenchmarks)
+                continue;
+
+            if (filter != nullptr && strstr(test.name, filter) == nullptr)
+                continue;
+
+            printf("%s %s\n", test.isBenchmark ? "[BENCHMARK]" : "[TEST]", test.name);
+
+            u32 failedChecksBefore = _numFailedChecks;
+            test.function();
+
+            numRun++;
+            if (_numFailedChecks != failedChecksBefore)
+            {
+                printf("    FAILED\n");
+                numFailed++;
+            }
+        }
+
+        printf("%u run, %u failed\n", numRun, numFailed);
+        return numFailed == 0 ? 0 : 1;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    Logging::LoggerDesc loggerDesc;
+    loggerDesc.minSeverity = LOG_SEVERITY_WARNING; // Keep the job system's startup messages out of the results
+    Logging::Logger::Init(loggerDesc);
+
+    int result = Tests::TestRegistry::Run(argc, argv);
+
+    Logging::Logger::Shutdown();
+    return result;
+}
\ No newline at end of file
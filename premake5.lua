@@ -21,4 +21,5 @@ dofile("Engine/premake5.lua")
 dofile("Cooker/premake5.lua")
 dofile("Shaders/premake5.lua")
 dofile("Content/premake5.lua")
-dofile("Demo/premake5.lua")
\ No newline at end of file
+dofile("Demo/premake5.lua")
+dofile("Tests/premake5.lua")
\ No newline at end of file